@@ -13,13 +13,36 @@
 #include "EnhancedInputSubsystems.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "PlayerSettingsSave.h"
+#include "AsyncSpringArmComponent.h"
+#include "PlayerSettingsComponent.h"
 #include "Engine/Engine.h"
 #include "Engine/GameViewportClient.h"
-
-AAnimCppChar::AAnimCppChar()
+#include "HAL/IConsoleManager.h"
+#include "AnimDemoStats.h"
+#include "AnimDemoMemory.h"
+#include "FootPlacementSubsystem.h"
+#include "AnimHibernationSubsystem.h"
+#include "AnimLODSubsystem.h"
+#include "PoseSearchSubsystem.h"
+#include "Engine/GameInstance.h"
+
+static TAutoConsoleVariable<bool> CVarAnimTraceRecord(
+    TEXT("AnimDemo.Trace.Record"),
+    false,
+    TEXT("Record input, locomotion and anim state transitions of locally controlled AAnimCppChar to Saved/Profiling/AnimTraces.\n")
+    TEXT("Takes effect for characters that begin play after it is set."));
+
+static TAutoConsoleVariable<float> CVarStateMachineFixedStepHz(
+    TEXT("AnimDemo.StateMachine.FixedStepHz"),
+    0.f,
+    TEXT("Rate in Hz the AAnimCppChar state machine logic steps at, independent of the frame rate. 0 steps once per frame.\n")
+    TEXT("Takes effect for characters that begin play after it is set."));
+
+AAnimCppChar::AAnimCppChar(const FObjectInitializer& ObjectInitializer)
+    : Super(UAsyncSpringArmComponent::SkipRigOnDedicatedServer(ObjectInitializer, TEXT("CameraBoom"), TEXT("FollowCamera")))
 {
+    LLM_SCOPE_BYTAG(AnimDemo_Characters);
+    
     PrimaryActorTick.bCanEverTick = true;
     
     CurrentAnimState = ECharacterAnimState::Idle;
@@ -43,20 +66,39 @@ AAnimCppChar::AAnimCppChar()
         UE_LOG(LogTemp, Error, TEXT("Failed to load skeletal mesh! Check the path."));
     }
     
-    // Create spring arm
-    CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
-    CameraBoom->SetupAttachment(RootComponent);
-    CameraBoom->TargetArmLength = 300.0f; // how far back the camera follows
-    CameraBoom->bUsePawnControlRotation = true; // rotate the arm based on controller
+    // Look input settings and the settings menu, bound while a local player possesses this character
+    PlayerSettings = CreateDefaultSubobject<UPlayerSettingsComponent>(TEXT("PlayerSettings"));
+    
+    // Dedicated servers never render, so their instances skip the camera rig; the class default
+    // object has it on every target
+    LLM_SCOPE_BYTAG(AnimDemo_Camera);
+    
+    // Create spring arm, its collision probe is an async sweep
+    CameraBoom = CreateOptionalDefaultSubobject<UAsyncSpringArmComponent>(TEXT("CameraBoom"));
+    if (CameraBoom)
+    {
+        CameraBoom->SetupAttachment(RootComponent);
+        CameraBoom->TargetArmLength = 300.0f; // how far back the camera follows
+        CameraBoom->bUsePawnControlRotation = true; // rotate the arm based on controller
+    }
 
     // Create follow camera
-    FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
-    FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
-    FollowCamera->bUsePawnControlRotation = false; // camera doesn't rotate relative to arm
+    FollowCamera = CreateOptionalDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
+    if (FollowCamera)
+    {
+        FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
+        FollowCamera->bUsePawnControlRotation = false; // camera doesn't rotate relative to arm
+    }
 }
 
 void AAnimCppChar::BeginPlay()
 {
+    // Dedicated servers never render, so they get no pose evaluation
+    if (IsRunningDedicatedServer())
+    {
+        GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+    }
+    
     Super::BeginPlay();
     
     // Cache AnimInstance
@@ -65,6 +107,7 @@ void AAnimCppChar::BeginPlay()
     {
         UE_LOG(LogTemp, Error, TEXT("AnimInstance is not of type UMyAnimInstance!"));
     }
+    FullAnimInstanceClass = GetMesh()->GetAnimClass();
     
     // Debug: Check if animations are loaded
     UE_LOG(LogTemp, Warning, TEXT("IdleAnimation: %s"), IdleAnimation ? *IdleAnimation->GetName() : TEXT("NULL"));
@@ -72,9 +115,41 @@ void AAnimCppChar::BeginPlay()
     UE_LOG(LogTemp, Warning, TEXT("RunAnimation: %s"), RunAnimation ? *RunAnimation->GetName() : TEXT("NULL"));
     UE_LOG(LogTemp, Warning, TEXT("JumpAnimation: %s"), JumpAnimation ? *JumpAnimation->GetName() : TEXT("NULL"));
     
+    {
+        LLM_SCOPE_BYTAG(AnimDemo_StateMachine);
+        AnimStateMachine = NewObject<UAnimationStateMachine>(this, TEXT("AnimStateMachine"));
+    }
+    if (IsRunningDedicatedServer())
+    {
+        // Only the transition logic matters on a dedicated server
+        AnimStateMachine->SetLogicOnly(true);
+        GetMesh()->SetComponentTickEnabled(false);
+    }
+    
+    AnimStateMachine->SetFixedStepRate(CVarStateMachineFixedStepHz.GetValueOnGameThread());
     SetupAnimationStateMachine();
     
-    if (APlayerController* PC = Cast<APlayerController>(GetController()))
+    // Not created on dedicated servers
+    if (UFootPlacementSubsystem* FootPlacement = GetWorld()->GetSubsystem<UFootPlacementSubsystem>())
+    {
+        FootPlacement->Register(this, OwningAnimInstance);
+    }
+    if (UAnimLODSubsystem* AnimLODs = GetWorld()->GetSubsystem<UAnimLODSubsystem>())
+    {
+        AnimLODs->Register(this);
+    }
+    
+    if (CVarAnimTraceRecord.GetValueOnGameThread() && IsLocallyControlled())
+    {
+        LLM_SCOPE_BYTAG(AnimDemo_Trace);
+        TraceWriter = MakeUnique<FAnimTraceWriter>(FAnimTraceWriter::MakeDefaultFilename(GetName()), AnimStateMachine->GetFixedStepRate());
+        AnimStateMachine->OnTransition().AddUObject(this, &AAnimCppChar::HandleAnimStateTransition);
+    }
+    
+    // Remote players are also driven by a PlayerController on the server, but only
+    // a local controller gets input mappings and player settings
+    APlayerController* PC = Cast<APlayerController>(GetController());
+    if (PC && PC->IsLocalController())
     {
         if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PC->GetLocalPlayer()))
         {
@@ -89,29 +164,8 @@ void AAnimCppChar::BeginPlay()
             }
         }
         
-        if (SettingsWidgetClass) // UPROPERTY TSubclassOf<UPlayerSettingsWidget> set in editor
-        {
-            SettingsWidget = CreateWidget<UPlayerSettingsWidget>(GetWorld(), SettingsWidgetClass);
-            if (SettingsWidget)
-            {
-                UE_LOG(LogTemp, Warning, TEXT("SettingsWidget created successfully."));
-                SettingsWidget->AddToViewport();
-                SettingsWidget->SetVisibility(ESlateVisibility::Hidden);
-
-                // Bind delegates to character functions
-                SettingsWidget->OnSensitivityChanged.AddDynamic(this, &AAnimCppChar::SetMouseSensitivity);
-                SettingsWidget->OnSmoothingChanged.AddDynamic(this, &AAnimCppChar::SetMouseSmoothing);
-                SettingsWidget->OnInvertYChanged.AddDynamic(this, &AAnimCppChar::SetInvertY);
-                SettingsWidget->OnCloseButtonPressed.AddDynamic(this, &AAnimCppChar::ToggleSettingsMenu);
-            }
-            else
-            {
-                UE_LOG(LogTemp, Error, TEXT("SettingsWidget creation FAILED!"));
-            }
-        }
-        
-        // Load Player Settings
-        LoadPlayerSettings();
+        // Follow the local player's settings; they are already in memory
+        PlayerSettings->Bind();
     }
 }
 
@@ -126,92 +180,325 @@ void AAnimCppChar::SetupAnimationStateMachine()
     UE_LOG(LogTemp, Warning, TEXT("Setting up animation state machine"));
     
     // Initialize the state machine
-    AnimStateMachine->Initialize(GetMesh());
+    AnimStateMachine->Initialize(AnimStateMachine->IsLogicOnly() ? nullptr : GetMesh());
     
-    // Register animations for each state
-    if (IdleAnimation)
+    // Characters with the same assets and tuning share one definition, built by the first of
+    // them; the walk and run sequences stay out of it, the locomotion blend space covers both.
+    // Transitions are evaluated against the per-tick LocomotionSnapshot.
+    FLocomotionArchetype Archetype;
+    Archetype.IdleAnimation = IdleAnimation;
+    Archetype.JumpAnimation = JumpAnimation;
+    Archetype.LocomotionBlendSpace = MovementBlendSpace;
+    Archetype.Tuning = LocomotionTuning;
+    AnimStateMachine->SetDefinition(AnimDemoLocomotion::GetDefinition(Archetype), &LocomotionSnapshot);
+}
+
+void AAnimCppChar::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // Flushes and closes the trace file
+    TraceWriter.Reset();
+    LeaveHibernation();
+    
+    if (UFootPlacementSubsystem* FootPlacement = GetWorld()->GetSubsystem<UFootPlacementSubsystem>())
     {
-        AnimStateMachine->RegisterStateAnimation(ECharacterAnimState::Idle, IdleAnimation, true, 1.0f);
-        UE_LOG(LogTemp, Warning, TEXT("Registered Idle animation"));
+        FootPlacement->Unregister(this);
     }
-    /*
-    if (WalkAnimation)
+    if (UAnimLODSubsystem* AnimLODs = GetWorld()->GetSubsystem<UAnimLODSubsystem>())
+    {
+        AnimLODs->Unregister(this);
+    }
+    
+    Super::EndPlay(EndPlayReason);
+}
+
+void AAnimCppChar::OnReleasedToPool()
+{
+    TraceWriter.Reset();
+    LeaveHibernation();
+    
+    if (UFootPlacementSubsystem* FootPlacement = GetWorld()->GetSubsystem<UFootPlacementSubsystem>())
+    {
+        FootPlacement->Unregister(this);
+    }
+    if (UAnimLODSubsystem* AnimLODs = GetWorld()->GetSubsystem<UAnimLODSubsystem>())
+    {
+        AnimLODs->Unregister(this);
+    }
+    
+    if (UCharacterMovementComponent* MoveComp = GetCharacterMovement())
+    {
+        MoveComp->StopMovementImmediately();
+        MoveComp->Deactivate();
+    }
+    
+    SetMeshTickEnabled(false);
+    if (UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance())
+    {
+        AnimInstance->StopAllMontages(0.f);
+    }
+    
+    // Next life starts from a clean Idle, like a freshly spawned character
+    if (AnimStateMachine)
+    {
+        AnimStateMachine->Reset();
+    }
+    LocomotionSnapshot = FLocomotionSnapshot();
+    CurrentAnimState = ECharacterAnimState::Idle;
+    CurrentBlendSpaceInput = 0.f;
+    PoseSearchTrajectory.Reset();
+    PoseSearchSelector.Reset();
+}
+
+void AAnimCppChar::OnAcquiredFromPool()
+{
+    if (UCharacterMovementComponent* MoveComp = GetCharacterMovement())
+    {
+        MoveComp->Activate(true);
+        MoveComp->SetMovementMode(MOVE_Falling);
+    }
+    
+    SetMeshTickEnabled(true);
+    
+    // Not created on dedicated servers
+    if (UFootPlacementSubsystem* FootPlacement = GetWorld()->GetSubsystem<UFootPlacementSubsystem>())
+    {
+        FootPlacement->Register(this, OwningAnimInstance);
+    }
+    if (UAnimLODSubsystem* AnimLODs = GetWorld()->GetSubsystem<UAnimLODSubsystem>())
     {
-        AnimStateMachine->RegisterStateAnimation(ECharacterAnimState::Walk, WalkAnimation, true, 1.0f);
-        UE_LOG(LogTemp, Warning, TEXT("Registered Walk animation"));
+        AnimLODs->Register(this);
     }
+}
+
+void AAnimCppChar::SaveSnapshot(FAnimCppCharSnapshot& OutSnapshot) const
+{
+    OutSnapshot.Location = GetActorLocation();
+    OutSnapshot.Rotation = GetActorQuat();
+    OutSnapshot.ControlRotation = Controller ? Controller->GetControlRotation() : GetActorRotation();
     
-    if (RunAnimation)
+    if (const UCharacterMovementComponent* MoveComp = GetCharacterMovement())
     {
-        AnimStateMachine->RegisterStateAnimation(ECharacterAnimState::Run, RunAnimation, true, 1.0f);
-        UE_LOG(LogTemp, Warning, TEXT("Registered Run animation"));
-    } */
+        OutSnapshot.Velocity = MoveComp->Velocity;
+        OutSnapshot.MovementMode = MoveComp->MovementMode;
+        OutSnapshot.CustomMovementMode = MoveComp->CustomMovementMode;
+    }
+    OutSnapshot.JumpCurrentCount = JumpCurrentCount;
     
-    if (JumpAnimation)
+    OutSnapshot.Locomotion = LocomotionSnapshot;
+    OutSnapshot.CurrentAnimState = CurrentAnimState;
+    OutSnapshot.CurrentBlendSpaceInput = CurrentBlendSpaceInput;
+    
+    if (AnimStateMachine)
+    {
+        AnimStateMachine->SaveSnapshot(OutSnapshot.StateMachine);
+    }
+    if (OwningAnimInstance)
     {
-        AnimStateMachine->RegisterStateAnimation(ECharacterAnimState::Jump, JumpAnimation, false, 1.0f);
-        UE_LOG(LogTemp, Warning, TEXT("Registered Jump animation"));
+        OwningAnimInstance->SaveSnapshot(OutSnapshot.AnimInstance);
     }
+    else
+    {
+        OutSnapshot.AnimInstance = FullAnimInstanceState;
+    }
+}
+
+void AAnimCppChar::RestoreSnapshot(const FAnimCppCharSnapshot& Snapshot)
+{
+    WakeFromHibernation();
     
-    // Instead of separate walk/run animations, use a blend space
-    if (MovementBlendSpace)
+    SetActorLocationAndRotation(Snapshot.Location, Snapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+    if (Controller)
     {
-        AnimStateMachine->RegisterStateBlendSpace(
-            ECharacterAnimState::Locomotion,
-            MovementBlendSpace,
-            true,
-            1.0f
-        );
-        UE_LOG(LogTemp, Warning, TEXT("Registered BlendSpace animation"));
+        Controller->SetControlRotation(Snapshot.ControlRotation);
     }
     
-    // Setup transitions with lambda conditions
-    AnimStateMachine->AddTransition(
-        ECharacterAnimState::Idle,
-        ECharacterAnimState::Locomotion,
-        [this]() { return ShouldWalk(); }
-    );
+    if (UCharacterMovementComponent* MoveComp = GetCharacterMovement())
+    {
+        MoveComp->SetMovementMode(static_cast<EMovementMode>(Snapshot.MovementMode), Snapshot.CustomMovementMode);
+        MoveComp->Velocity = Snapshot.Velocity;
+        MoveComp->ClearAccumulatedForces();
+    }
+    ConsumeMovementInputVector();
+    ResetJumpState();
+    JumpCurrentCount = Snapshot.JumpCurrentCount;
     
-   
-    AnimStateMachine->AddTransition(
-        ECharacterAnimState::Locomotion,
-        ECharacterAnimState::Idle,
-        [this]() { return ShouldIdle(); }
-    );
+    LocomotionSnapshot = Snapshot.Locomotion;
+    CurrentAnimState = Snapshot.CurrentAnimState;
+    CurrentBlendSpaceInput = Snapshot.CurrentBlendSpaceInput;
     
-   
-    // Jump transitions from any ground state
-    AnimStateMachine->AddTransition(
-        ECharacterAnimState::Idle,
-        ECharacterAnimState::Jump,
-        [this]() { return ShouldJump(); }
-    );
+    if (AnimStateMachine)
+    {
+        AnimStateMachine->RestoreSnapshot(Snapshot.StateMachine);
+    }
+    if (OwningAnimInstance)
+    {
+        OwningAnimInstance->RestoreSnapshot(Snapshot.AnimInstance);
+    }
+    else
+    {
+        FullAnimInstanceState = Snapshot.AnimInstance;
+    }
     
-    AnimStateMachine->AddTransition(
-        ECharacterAnimState::Locomotion,
-        ECharacterAnimState::Jump,
-        [this]() { return ShouldJump(); }
-    );
+    PoseSearchTrajectory.Reset();
+    PoseSearchSelector.Reset();
+}
 
+void AAnimCppChar::HandleAnimStateTransition(ECharacterAnimState From, ECharacterAnimState To, float Duration)
+{
+    if (TraceWriter)
+    {
+        TraceWriter->AddTransition(From, To, Duration);
+    }
 }
 
 void AAnimCppChar::Tick(float DeltaTime)
 {
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(CharacterTick);
+    
     Super::Tick(DeltaTime);
     
-    // Update animation inputs
-    UpdateAnimationInputs();
-    UpdateAnimationState(DeltaTime);
+    if (const UCharacterMovementComponent* MoveComp = GetCharacterMovement())
+    {
+        LocomotionSnapshot.Capture(GetVelocity(), *MoveComp);
+    }
+    
+    // Update animation inputs (nothing consumes them on a dedicated server)
+    if (!IsRunningDedicatedServer())
+    {
+        UpdateAnimationInputs();
+        UpdateAnimationState(DeltaTime);
+        UpdatePoseSearch(DeltaTime);
+    }
     
     // Tick the state machine
     if (AnimStateMachine)
     {
         AnimStateMachine->Tick(DeltaTime);
     }
+    
+    const ECharacterAnimState TickState = AnimStateMachine ? AnimStateMachine->GetCurrentState() : CurrentAnimState;
+    AnimDemoStats::CountCharacterInState(TickState);
+    
+    if (TraceWriter)
+    {
+        TraceWriter->EndFrame(DeltaTime, LocomotionSnapshot, TickState);
+    }
+    
+    UpdateHibernation(DeltaTime);
+}
+
+void AAnimCppChar::UpdateHibernation(float DeltaTime)
+{
+    const bool bHadInput = bInputThisFrame;
+    bInputThisFrame = false;
+    
+    const bool bStableIdle = !bHadInput
+        && !bPressedJump
+        && GetPendingMovementInputVector().IsNearlyZero()
+        && UAnimHibernationSubsystem::IsSettledIdle(LocomotionSnapshot, AnimStateMachine);
+    
+    if (UAnimHibernationSubsystem::UpdateStableIdleTime(StableIdleTime, bStableIdle, DeltaTime, UAnimHibernationSubsystem::GetIdleSeconds()))
+    {
+        Hibernate();
+    }
+}
+
+bool AAnimCppChar::CanTickMesh()
+{
+    // Dedicated servers switch the mesh tick off in BeginPlay and never turn it back on; pooling,
+    // hibernation and anim LOD only ever toggle it on clients
+    return !IsRunningDedicatedServer();
+}
+
+void AAnimCppChar::SetMeshTickEnabled(bool bEnabled)
+{
+    if (CanTickMesh())
+    {
+        GetMesh()->SetComponentTickEnabled(bEnabled);
+    }
+}
+
+void AAnimCppChar::Hibernate()
+{
+    UAnimHibernationSubsystem* Hibernation = GetWorld()->GetSubsystem<UAnimHibernationSubsystem>();
+    if (!Hibernation || bHibernating) return;
+    
+    bHibernating = true;
+    SetActorTickEnabled(false);
+    
+    if (CanTickMesh())
+    {
+        USkeletalMeshComponent* Mesh = GetMesh();
+        AwakeMeshTickInterval = Mesh->GetComponentTickInterval();
+        
+        // Either keep the idle montage looping at a low rate or hold the last evaluated pose
+        const float IdleLoopHz = UAnimHibernationSubsystem::GetIdleLoopHz();
+        if (IdleLoopHz > 0.f)
+        {
+            Mesh->SetComponentTickInterval(1.f / IdleLoopHz);
+        }
+        else
+        {
+            Mesh->SetComponentTickEnabled(false);
+        }
+    }
+    
+    Hibernation->Register(this);
+}
+
+void AAnimCppChar::LeaveHibernation()
+{
+    if (!bHibernating) return;
+    
+    bHibernating = false;
+    StableIdleTime = 0.f;
+    
+    if (CanTickMesh())
+    {
+        GetMesh()->SetComponentTickInterval(AwakeMeshTickInterval);
+    }
+    
+    if (UAnimHibernationSubsystem* Hibernation = GetWorld()->GetSubsystem<UAnimHibernationSubsystem>())
+    {
+        Hibernation->Unregister(this);
+    }
+}
+
+void AAnimCppChar::WakeFromHibernation()
+{
+    if (!bHibernating) return;
+    
+    LeaveHibernation();
+    SetActorTickEnabled(true);
+    SetMeshTickEnabled(true);
+    
+    AnimDemoStats::CountHibernationWake();
+}
+
+bool AAnimCppChar::ShouldWakeFromHibernation() const
+{
+    // Pushed, launched, falling or about to move
+    const UCharacterMovementComponent* MoveComp = GetCharacterMovement();
+    return !MoveComp
+        || !MoveComp->IsMovingOnGround()
+        || !MoveComp->Velocity.IsNearlyZero(1.f)
+        || !GetPendingMovementInputVector().IsNearlyZero()
+        || bPressedJump;
+}
+
+void AAnimCppChar::NoteInput()
+{
+    bInputThisFrame = true;
+    if (bHibernating)
+    {
+        WakeFromHibernation();
+    }
 }
 
 void AAnimCppChar::UpdateAnimationInputs()
 {
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(UpdateAnimationInputs);
+    
     /*
     if (AnimStateMachine)
     {
@@ -223,8 +510,8 @@ void AAnimCppChar::UpdateAnimationInputs()
     
     if (!OwningAnimInstance) return;
 
-    FString DisplayName = UEnum::GetDisplayValueAsText(CurrentAnimState).ToString();
-    UE_LOG(LogTemp, Warning, TEXT("Current Anim State = %s"), *DisplayName);
+    // Formatted only when the verbosity is raised, this runs every frame
+    UE_LOG(LogTemp, VeryVerbose, TEXT("Current Anim State = %s"), *UEnum::GetDisplayValueAsText(CurrentAnimState).ToString());
     
     UCharacterMovementComponent* MoveComp = GetCharacterMovement();
     if (!MoveComp) return;
@@ -242,9 +529,15 @@ void AAnimCppChar::UpdateAnimationInputs()
 
 void AAnimCppChar::UpdateAnimationState(float DeltaTime)
 {
-    if (!OwningAnimInstance) return;
+    if (!OwningAnimInstance && !LiteAnimInstance) return;
 
     bool bIsInAir = GetCharacterMovement()->IsFalling();
+    
+    // UpdateAnimationInputs only feeds the full anim instance
+    if (LiteAnimInstance)
+    {
+        CurrentBlendSpaceInput = GetVelocity().Size();
+    }
 
     if (bIsInAir)
     {
@@ -259,31 +552,162 @@ void AAnimCppChar::UpdateAnimationState(float DeltaTime)
         CurrentAnimState = ECharacterAnimState::Idle;
     }
 
-    OwningAnimInstance->SetCurrentAnimState(CurrentAnimState);
+    if (OwningAnimInstance)
+    {
+        OwningAnimInstance->SetCurrentAnimState(CurrentAnimState);
+    }
+    else
+    {
+        UpdateLiteAnimation();
+    }
+}
+
+void AAnimCppChar::UpdateLiteAnimation(float StartTime)
+{
+    if (!LiteAnimInstance) return;
+    
+    // Only hands over a new sequence on a state change, the instance runs on its own otherwise
+    bool bLooping = true;
+    UAnimSequence* Sequence = GetLiteSequence(CurrentAnimState, CurrentBlendSpaceInput, bLooping);
+    LiteAnimInstance->PlayState(CurrentAnimState, Sequence, bLooping, StartTime);
+}
+
+UAnimSequence* AAnimCppChar::GetLiteSequence(ECharacterAnimState State, float Speed, bool& bOutLooping) const
+{
+    bOutLooping = true;
+    switch (State)
+    {
+    case ECharacterAnimState::Locomotion:
+        if (Speed >= LocomotionTuning.RunSpeed && RunAnimation) return RunAnimation;
+        return WalkAnimation ? WalkAnimation : RunAnimation;
+    case ECharacterAnimState::Jump:
+        bOutLooping = false;
+        return JumpAnimation;
+    default:
+        return IdleAnimation;
+    }
+}
+
+void AAnimCppChar::SetAnimLOD(EAnimDemoAnimLOD NewLOD)
+{
+    if (NewLOD == AnimLOD || !CanTickMesh()) return;
+    
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(AnimLODSwap);
+    
+    USkeletalMeshComponent* Mesh = GetMesh();
+    UFootPlacementSubsystem* FootPlacement = GetWorld()->GetSubsystem<UFootPlacementSubsystem>();
+    
+    if (NewLOD == EAnimDemoAnimLOD::Lite)
+    {
+        if (!OwningAnimInstance) return;
+        
+        OwningAnimInstance->SaveSnapshot(FullAnimInstanceState);
+        const float Time = OwningAnimInstance->GetStateMontagePosition();
+        if (FootPlacement)
+        {
+            FootPlacement->Unregister(this);
+        }
+        
+        Mesh->SetAnimInstanceClass(UAnimDemoLiteAnimInstance::StaticClass());
+        OwningAnimInstance = nullptr;
+        LiteAnimInstance = Cast<UAnimDemoLiteAnimInstance>(Mesh->GetAnimInstance());
+        AnimLOD = EAnimDemoAnimLOD::Lite;
+        
+        // The lite instance only plays sequences, the Locomotion blend space becomes a walk or run loop
+        UpdateLiteAnimation(CurrentAnimState == ECharacterAnimState::Locomotion ? 0.f : Time);
+    }
+    else
+    {
+        const float Time = LiteAnimInstance ? LiteAnimInstance->GetTime() : 0.f;
+        
+        Mesh->SetAnimInstanceClass(FullAnimInstanceClass ? *FullAnimInstanceClass : UMyAnimInstance::StaticClass());
+        LiteAnimInstance = nullptr;
+        OwningAnimInstance = Cast<UMyAnimInstance>(Mesh->GetAnimInstance());
+        AnimLOD = EAnimDemoAnimLOD::Full;
+        
+        if (OwningAnimInstance)
+        {
+            OwningAnimInstance->RestoreSnapshot(FullAnimInstanceState);
+            OwningAnimInstance->ResumeState(CurrentAnimState, Time);
+            if (FootPlacement)
+            {
+                FootPlacement->Register(this, OwningAnimInstance);
+            }
+        }
+    }
+}
+
+void AAnimCppChar::UpdatePoseSearch(float DeltaTime)
+{
+    if (!OwningAnimInstance) return;
+    
+    const UPoseSearchSubsystem* PoseSearch = GetGameInstance() ? GetGameInstance()->GetSubsystem<UPoseSearchSubsystem>() : nullptr;
+    const FPoseSearchDatabase* Database = PoseSearch ? PoseSearch->GetDatabase() : nullptr;
+    if (!Database)
+    {
+        if (PoseSearchSelector.HasSelection())
+        {
+            PoseSearchSelector.Reset();
+            OwningAnimInstance->ClearPoseSearchMatch();
+        }
+        return;
+    }
+    
+    PoseSearchTrajectory.AddSample(DeltaTime, GetVelocity());
+    
+    float Query[AnimDemoPoseSearch::NumFeatures];
+    PoseSearchTrajectory.BuildQuery(GetActorRotation(), Query);
+    
+    const bool bJumped = PoseSearchSelector.Update(*Database, Query, DeltaTime);
+    if (PoseSearchSelector.HasSelection())
+    {
+        UAnimSequence* Sequence = GetPoseSearchSequence(Database->GetSource(PoseSearchSelector.GetSource()));
+        OwningAnimInstance->SetPoseSearchMatch(Sequence, PoseSearchSelector.GetTime(), bJumped);
+    }
+}
+
+UAnimSequence* AAnimCppChar::GetPoseSearchSequence(const FPoseSearchSourceRecord& Source) const
+{
+    switch (Source.Kind)
+    {
+    case ECharacterAnimState::Idle:
+        return IdleAnimation;
+    case ECharacterAnimState::Walk:
+        return WalkAnimation;
+    case ECharacterAnimState::Run:
+        return RunAnimation;
+    case ECharacterAnimState::Jump:
+        return JumpAnimation;
+    case ECharacterAnimState::Locomotion:
+        if (MovementBlendSpace && MovementBlendSpace->GetBlendSamples().IsValidIndex(Source.BlendSampleIndex))
+        {
+            return MovementBlendSpace->GetBlendSample(Source.BlendSampleIndex).Animation;
+        }
+        return nullptr;
+    default:
+        return nullptr;
+    }
 }
 
 // Transition condition implementations
 bool AAnimCppChar::ShouldWalk() const
 {
-    float Speed = GetVelocity().Size();
-    return Speed > 10.0f && Speed < 300.0f && GetCharacterMovement()->IsMovingOnGround();
+    return LocomotionSnapshot.ShouldWalk(LocomotionTuning);
 }
 
 bool AAnimCppChar::ShouldRun() const
 {
-    float Speed = GetVelocity().Size();
-    return Speed >= 300.0f && GetCharacterMovement()->IsMovingOnGround();
+    return LocomotionSnapshot.ShouldRun(LocomotionTuning);
 }
 
 bool AAnimCppChar::ShouldJump() const
 {
-    return GetCharacterMovement()->IsFalling() && GetVelocity().Z > 0.0f;
+    return LocomotionSnapshot.ShouldJump();
 }
 
 bool AAnimCppChar::ShouldIdle() const
 {
-    float Speed = GetVelocity().Size();
-    return Speed <= 10.0f && GetCharacterMovement()->IsMovingOnGround();
+    return LocomotionSnapshot.ShouldIdle(LocomotionTuning);
 }
 
 void AAnimCppChar::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -355,7 +779,14 @@ void AAnimCppChar::SetupPlayerInputComponent(UInputComponent* PlayerInputCompone
 
 void AAnimCppChar::Move(const FInputActionValue& Value)
 {
+    NoteInput();
+    
     FVector2D MovementVector = Value.Get<FVector2D>();
+    
+    if (TraceWriter)
+    {
+        TraceWriter->AddMoveInput(MovementVector);
+    }
 
     /*
      UE_LOG(LogTemp, Warning, TEXT("Controller=%s (Type: %s) MovementVector=(%.2f, %.2f)"),
@@ -380,145 +811,104 @@ void AAnimCppChar::Move(const FInputActionValue& Value)
 
 void AAnimCppChar::Turn(const FInputActionValue& Value)
 {
-    const float RawYaw = Value.Get<float>() * MouseSensitivity;
-    SmoothedYaw = FMath::FInterpTo(SmoothedYaw, RawYaw, GetWorld()->GetDeltaSeconds(), MouseSmoothing);
+    NoteInput();
+    
+    if (TraceWriter)
+    {
+        TraceWriter->AddTurnInput(Value.Get<float>());
+    }
+    
+    const float RawYaw = Value.Get<float>() * PlayerSettings->GetMouseSensitivity();
+    SmoothedYaw = FMath::FInterpTo(SmoothedYaw, RawYaw, GetWorld()->GetDeltaSeconds(), PlayerSettings->GetMouseSmoothing());
     AddControllerYawInput(SmoothedYaw);
 }
 
 void AAnimCppChar::LookUp(const FInputActionValue& Value)
 {
-    float RawPitch = Value.Get<float>() * MouseSensitivity;
+    NoteInput();
+    
+    if (TraceWriter)
+    {
+        TraceWriter->AddLookUpInput(Value.Get<float>());
+    }
+    
+    float RawPitch = Value.Get<float>() * PlayerSettings->GetMouseSensitivity();
 
-    if (bInvertY)
+    if (PlayerSettings->GetInvertY())
     {
         RawPitch *= -1.0f;
     }
 
-    SmoothedPitch = FMath::FInterpTo(SmoothedPitch, RawPitch, GetWorld()->GetDeltaSeconds(), MouseSmoothing);
+    SmoothedPitch = FMath::FInterpTo(SmoothedPitch, RawPitch, GetWorld()->GetDeltaSeconds(), PlayerSettings->GetMouseSmoothing());
 
     AddControllerPitchInput(SmoothedPitch);
 }
 
 
-void AAnimCppChar::SavePlayerSettings()
+void AAnimCppChar::Jump()
 {
-    UPlayerSettingsSave* SaveGameInstance = Cast<UPlayerSettingsSave>(
-        UGameplayStatics::CreateSaveGameObject(UPlayerSettingsSave::StaticClass())
-    );
+    NoteInput();
+    
+    if (TraceWriter)
+    {
+        TraceWriter->AddJumpInput();
+    }
+    
+    Super::Jump();
+}
 
-    SaveGameInstance->MouseSensitivity = MouseSensitivity;
-    SaveGameInstance->MouseSmoothing = MouseSmoothing;
-    SaveGameInstance->bInvertY = bInvertY;
 
-    UGameplayStatics::SaveGameToSlot(SaveGameInstance, TEXT("PlayerSettings"), 0);
+void AAnimCppChar::SavePlayerSettings()
+{
+    PlayerSettings->SaveSettings();
 }
 
 
 void AAnimCppChar::LoadPlayerSettings()
 {
-    if (UGameplayStatics::DoesSaveGameExist(TEXT("PlayerSettings"), 0))
-    {
-        UPlayerSettingsSave* Loaded = Cast<UPlayerSettingsSave>(
-            UGameplayStatics::LoadGameFromSlot(TEXT("PlayerSettings"), 0)
-        );
+    PlayerSettings->LoadSettings();
+}
 
-        if (Loaded)
-        {
-            MouseSensitivity = Loaded->MouseSensitivity;
-            MouseSmoothing = Loaded->MouseSmoothing;
-            bInvertY = Loaded->bInvertY;
-        }
-    }
+
+void AAnimCppChar::NotifyControllerChanged()
+{
+    Super::NotifyControllerChanged();
+    
+    // Possession changes only move the subscription to the new local player
+    PlayerSettings->Bind();
 }
 
 
 void AAnimCppChar::HideSettingsWidget()
 {
-    UE_LOG(LogTemp, Warning, TEXT("Saving Settings and Hiding Settings Window..."));
-    SavePlayerSettings();
-    
-    SettingsWidget->SetVisibility(ESlateVisibility::Hidden);
-    UE_LOG(LogTemp, Warning, TEXT("Settings saved."));
+    PlayerSettings->HideSettingsWidget();
 }
 
 
 void AAnimCppChar::ShowSettingsWidget()
 {
-    UE_LOG(LogTemp, Warning, TEXT("Showing Settings Window and Loading Settings."));
-    
-    SettingsWidget->SetVisibility(ESlateVisibility::Visible);
-    LoadPlayerSettings();
-    
-    // Update UI with loaded values
-    SettingsWidget->SetMouseSensitivity(MouseSensitivity);
-    SettingsWidget->SetMouseSmoothing(MouseSmoothing);
-    SettingsWidget->SetInvertY(bInvertY);
-    
-    UE_LOG(LogTemp, Warning, TEXT("Settings loaded."));
+    PlayerSettings->ShowSettingsWidget();
 }
 
 void AAnimCppChar::ToggleSettingsMenu()
 {
-    UE_LOG(LogTemp, Warning, TEXT("ToggleSettingsMenu called!"));
-    // Add small debounce to skip rapid key repeats
-    if (bIsToggling) return;
-
-    bIsToggling = true;
-    GetWorld()->GetTimerManager().SetTimerForNextTick([this]()
-    {
-        bIsToggling = false;
-    });
-    
-    if (!SettingsWidget) return;
-    
-    APlayerController* PC = Cast<APlayerController>(GetController());
-    if (!PC) return;
-
-    const bool bIsVisible = SettingsWidget->IsVisible();
-    
-    UE_LOG(LogTemp, Warning, TEXT("bIsVisible=%s"), bIsVisible ? TEXT("true") : TEXT("false"));
-    if (bIsVisible)
-    {
-        HideSettingsWidget();
-        
-        GetWorld()->GetTimerManager().SetTimerForNextTick([this, PC]()
-        {
-            FInputModeGameOnly InputMode;
-            PC->SetInputMode(InputMode);
-            PC->bShowMouseCursor = false;
-            PC->SetIgnoreLookInput(false);      // Ensure look input is restored
-            PC->SetIgnoreMoveInput(false);      // Ensure move input is restored
-        });
-    }
-    else
-    {
-        ShowSettingsWidget();
-
-        // Set UI input mode with slight delay
-        GetWorld()->GetTimerManager().SetTimerForNextTick([this, PC]()
-        {
-            FInputModeUIOnly InputMode;
-            InputMode.SetWidgetToFocus(SettingsWidget->TakeWidget());
-            PC->SetInputMode(InputMode);
-            PC->bShowMouseCursor = true;
-        });
-    }
+    PlayerSettings->ToggleSettingsMenu(SettingsWidgetClass);
 }
 
 
 void AAnimCppChar::SetMouseSensitivity(float Value)
 {
-    MouseSensitivity = FMath::Clamp(Value, 0.1f, 10.0f);
+    PlayerSettings->SetMouseSensitivity(Value);
 }
 
 
 void AAnimCppChar::SetMouseSmoothing(float Value)
 {
-    MouseSmoothing = FMath::Clamp(Value, 0.f, 20.f);
+    PlayerSettings->SetMouseSmoothing(Value);
 }
 
 
 void AAnimCppChar::SetInvertY(bool bInvert)
 {
-    bInvertY = bInvert;
+    PlayerSettings->SetInvertY(bInvert);
 }
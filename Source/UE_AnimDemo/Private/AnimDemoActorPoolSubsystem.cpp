@@ -0,0 +1,204 @@
+//
+//  AnimDemoActorPoolSubsystem.cpp
+//
+#include "AnimDemoActorPoolSubsystem.h"
+#include "AnimDemoPoolable.h"
+#include "AnimDemoStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<float> CVarPoolSpawnBudgetMs(
+    TEXT("AnimDemo.Pool.SpawnBudgetMs"),
+    2.f,
+    TEXT("Game thread milliseconds per frame spent serving queued spawn requests. At least one request is served every frame."));
+
+static TAutoConsoleVariable<float> CVarPoolPrewarmBudgetMs(
+    TEXT("AnimDemo.Pool.PrewarmBudgetMs"),
+    8.f,
+    TEXT("Game thread milliseconds per frame spent building pre-warmed pool instances."));
+
+namespace AnimDemoActorPool
+{
+    // Parked actors wait out of sight with collision off, so they can all share one spot
+    static const FVector ParkingLocation(0.f, 0.f, -100000.f);
+}
+
+void UAnimDemoActorPoolSubsystem::Deinitialize()
+{
+    PrewarmQueue.Reset();
+    SpawnQueue.Reset();
+    SpawnQueueHead = 0;
+    Pools.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UAnimDemoActorPoolSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UAnimDemoActorPoolSubsystem, STATGROUP_Tickables);
+}
+
+void UAnimDemoActorPoolSubsystem::Prewarm(TSubclassOf<AActor> Class, int32 Count)
+{
+    if (Class && Count > 0)
+    {
+        PrewarmQueue.Add({ Class, Count });
+    }
+}
+
+void UAnimDemoActorPoolSubsystem::RequestSpawn(TSubclassOf<AActor> Class, const FTransform& Transform, FOnPooledActorSpawned OnSpawned)
+{
+    if (Class)
+    {
+        SpawnQueue.Add({ Class, Transform, MoveTemp(OnSpawned) });
+    }
+}
+
+void UAnimDemoActorPoolSubsystem::Tick(float DeltaTime)
+{
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(PoolTick);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    if (GetNumPendingSpawns() > 0)
+    {
+        const double SpawnBudget = CVarPoolSpawnBudgetMs.GetValueOnGameThread() / 1000.0;
+
+        // Always serve one so the queue drains even when a single spawn exceeds the budget
+        do
+        {
+            FSpawnRequest Request = MoveTemp(SpawnQueue[SpawnQueueHead++]);
+            AActor* Actor = Acquire(Request.Class, Request.Transform);
+            Request.OnSpawned.ExecuteIfBound(Actor);
+        }
+        while (GetNumPendingSpawns() > 0 && FPlatformTime::Seconds() - StartTime < SpawnBudget);
+
+        if (GetNumPendingSpawns() == 0)
+        {
+            SpawnQueue.Reset();
+            SpawnQueueHead = 0;
+        }
+
+        Timings.MaxFrameMs = FMath::Max(Timings.MaxFrameMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        SET_DWORD_STAT(STAT_AnimDemo_PoolPendingSpawns, GetNumPendingSpawns());
+    }
+
+    if (PrewarmQueue.Num() > 0)
+    {
+        const double PrewarmBudget = CVarPoolPrewarmBudgetMs.GetValueOnGameThread() / 1000.0;
+        while (PrewarmQueue.Num() > 0 && FPlatformTime::Seconds() - StartTime < PrewarmBudget)
+        {
+            FPrewarmRequest& Request = PrewarmQueue[0];
+            if (AActor* Actor = SpawnParked(Request.Class))
+            {
+                Pools.FindOrAdd(Request.Class).Actors.Add(Actor);
+            }
+
+            if (--Request.Remaining <= 0)
+            {
+                PrewarmQueue.RemoveAt(0);
+            }
+        }
+    }
+}
+
+AActor* UAnimDemoActorPoolSubsystem::Acquire(TSubclassOf<AActor> Class, const FTransform& Transform)
+{
+    if (!Class)
+        return nullptr;
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    AActor* Actor = nullptr;
+    if (FAnimDemoActorPoolBucket* Bucket = Pools.Find(Class))
+    {
+        // Entries are nulled if something destroyed a parked actor
+        while (!Actor && Bucket->Actors.Num() > 0)
+        {
+            Actor = Bucket->Actors.Pop(EAllowShrinking::No);
+        }
+    }
+
+    const bool bReused = Actor != nullptr;
+    if (!bReused)
+    {
+        Actor = SpawnParked(Class);
+        if (!Actor)
+            return nullptr;
+    }
+
+    Activate(Actor, Transform);
+
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    if (bReused)
+    {
+        ++Timings.NumReused;
+        Timings.ReuseMs += ElapsedMs;
+        Timings.MaxReuseMs = FMath::Max(Timings.MaxReuseMs, ElapsedMs);
+        INC_DWORD_STAT(STAT_AnimDemo_PoolHits);
+    }
+    else
+    {
+        ++Timings.NumSpawned;
+        Timings.SpawnMs += ElapsedMs;
+        Timings.MaxSpawnMs = FMath::Max(Timings.MaxSpawnMs, ElapsedMs);
+        INC_DWORD_STAT(STAT_AnimDemo_PoolMisses);
+    }
+
+    return Actor;
+}
+
+void UAnimDemoActorPoolSubsystem::Release(AActor* Actor)
+{
+    if (!IsValid(Actor))
+        return;
+
+    Park(Actor);
+    Pools.FindOrAdd(Actor->GetClass()).Actors.Add(Actor);
+}
+
+int32 UAnimDemoActorPoolSubsystem::GetNumPooled(TSubclassOf<AActor> Class) const
+{
+    const FAnimDemoActorPoolBucket* Bucket = Pools.Find(Class);
+    return Bucket ? Bucket->Actors.Num() : 0;
+}
+
+AActor* UAnimDemoActorPoolSubsystem::SpawnParked(UClass* Class)
+{
+    FActorSpawnParameters Params;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+    AActor* Actor = GetWorld()->SpawnActor<AActor>(Class, AnimDemoActorPool::ParkingLocation, FRotator::ZeroRotator, Params);
+    if (Actor)
+    {
+        Park(Actor);
+    }
+    return Actor;
+}
+
+void UAnimDemoActorPoolSubsystem::Park(AActor* Actor)
+{
+    Actor->SetActorHiddenInGame(true);
+    Actor->SetActorEnableCollision(false);
+    Actor->SetActorTickEnabled(false);
+    Actor->SetActorLocation(AnimDemoActorPool::ParkingLocation, false, nullptr, ETeleportType::ResetPhysics);
+
+    if (IAnimDemoPoolable* Poolable = Cast<IAnimDemoPoolable>(Actor))
+    {
+        Poolable->OnReleasedToPool();
+    }
+}
+
+void UAnimDemoActorPoolSubsystem::Activate(AActor* Actor, const FTransform& Transform)
+{
+    Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+    Actor->SetActorHiddenInGame(false);
+    Actor->SetActorEnableCollision(true);
+    Actor->SetActorTickEnabled(true);
+
+    if (IAnimDemoPoolable* Poolable = Cast<IAnimDemoPoolable>(Actor))
+    {
+        Poolable->OnAcquiredFromPool();
+    }
+}
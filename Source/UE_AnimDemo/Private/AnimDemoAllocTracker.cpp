@@ -0,0 +1,373 @@
+//
+//  AnimDemoAllocTracker.cpp
+//
+#include "AnimDemoAllocTracker.h"
+
+#if ANIMDEMO_ALLOC_TRACKING
+
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MallocBase.h"
+#include "HAL/PlatformStackWalk.h"
+#include "Containers/Ticker.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DelayedAutoRegister.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Class.h"
+#include "UObject/UObjectArray.h"
+
+bool GAnimDemoAllocTrackingActive = false;
+
+struct FAnimDemoAllocTracker
+{
+    // Innermost open scope of the calling thread
+    static thread_local FAnimDemoAllocScope* CurrentScope;
+
+    // Set while the tracker itself allocates, so its own bookkeeping is never counted
+    static thread_local bool bInTracker;
+
+    static bool bCaptureSites;
+    static FCriticalSection ResultsLock;
+    static TMap<const TCHAR*, FAnimDemoAllocScopeResult> Results;
+    static TArray<FAnimDemoAllocSite> Sites;
+
+    static constexpr int32 MaxReportedSites = 32;
+
+    static void CaptureSite(FAnimDemoAllocScope& Scope, SIZE_T Size, const UClass* Class)
+    {
+        bInTracker = true;
+        FAnimDemoAllocScope::FPendingSite& Site = Scope.PendingSites[Scope.NumPendingSites++];
+        Site.Depth = FPlatformStackWalk::CaptureStackBackTrace(Site.Frames, FAnimDemoAllocScope::MaxSiteDepth);
+        Site.Size = Size;
+        Site.Class = Class;
+        bInTracker = false;
+    }
+
+    static FORCEINLINE void RecordAlloc(SIZE_T Size)
+    {
+        FAnimDemoAllocScope* Scope = CurrentScope;
+        if (!Scope || bInTracker)
+            return;
+
+        ++Scope->NumAllocs;
+        Scope->AllocBytes += Size;
+
+        if (bCaptureSites && Scope->NumPendingSites < FAnimDemoAllocScope::MaxSitesPerScope)
+        {
+            CaptureSite(*Scope, Size, nullptr);
+        }
+    }
+
+    static void RecordObject(const UClass* Class)
+    {
+        FAnimDemoAllocScope* Scope = CurrentScope;
+        if (!Scope || bInTracker)
+            return;
+
+        ++Scope->NumObjects;
+
+        if (bCaptureSites && Scope->NumPendingSites < FAnimDemoAllocScope::MaxSitesPerScope)
+        {
+            CaptureSite(*Scope, 0, Class);
+        }
+    }
+
+    static FString Symbolicate(const FAnimDemoAllocScope::FPendingSite& Site)
+    {
+        FString Callstack;
+        ANSICHAR Line[1024];
+
+        // The first frames are the tracker and the allocator proxy
+        for (int32 Depth = 3; Depth < Site.Depth; ++Depth)
+        {
+            Line[0] = '\0';
+            FPlatformStackWalk::ProgramCounterToHumanReadableString(Depth, Site.Frames[Depth], Line, UE_ARRAY_COUNT(Line));
+            Callstack += TEXT("      ");
+            Callstack += ANSI_TO_TCHAR(Line);
+            Callstack += TEXT("\n");
+        }
+        return Callstack;
+    }
+};
+
+thread_local FAnimDemoAllocScope* FAnimDemoAllocTracker::CurrentScope = nullptr;
+thread_local bool FAnimDemoAllocTracker::bInTracker = false;
+bool FAnimDemoAllocTracker::bCaptureSites = false;
+FCriticalSection FAnimDemoAllocTracker::ResultsLock;
+TMap<const TCHAR*, FAnimDemoAllocScopeResult> FAnimDemoAllocTracker::Results;
+TArray<FAnimDemoAllocSite> FAnimDemoAllocTracker::Sites;
+
+namespace AnimDemoAllocTracker
+{
+    // Forwards everything to the allocator it replaced and counts allocations made in open scopes
+    class FCountingMalloc final : public FMalloc
+    {
+    public:
+        explicit FCountingMalloc(FMalloc* InInner)
+            : Inner(InInner)
+        {}
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            FAnimDemoAllocTracker::RecordAlloc(Count);
+            return Inner->Malloc(Count, Alignment);
+        }
+
+        virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+        {
+            FAnimDemoAllocTracker::RecordAlloc(Count);
+            return Inner->TryMalloc(Count, Alignment);
+        }
+
+        virtual void* MallocZeroed(SIZE_T Count, uint32 Alignment) override
+        {
+            FAnimDemoAllocTracker::RecordAlloc(Count);
+            return Inner->MallocZeroed(Count, Alignment);
+        }
+
+        virtual void* TryMallocZeroed(SIZE_T Count, uint32 Alignment) override
+        {
+            FAnimDemoAllocTracker::RecordAlloc(Count);
+            return Inner->TryMallocZeroed(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                FAnimDemoAllocTracker::RecordAlloc(Count);
+            }
+            return Inner->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                FAnimDemoAllocTracker::RecordAlloc(Count);
+            }
+            return Inner->TryRealloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override { Inner->Free(Original); }
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+        virtual void MarkTLSCachesAsUsedOnCurrentThread() override { Inner->MarkTLSCachesAsUsedOnCurrentThread(); }
+        virtual void MarkTLSCachesAsUnusedOnCurrentThread() override { Inner->MarkTLSCachesAsUnusedOnCurrentThread(); }
+        virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+        virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+        virtual void UpdateStats() override { Inner->UpdateStats(); }
+        virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+        virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+        virtual void OnMallocInitialized() override { Inner->OnMallocInitialized(); }
+        virtual void OnPreFork() override { Inner->OnPreFork(); }
+        virtual void OnPostFork() override { Inner->OnPostFork(); }
+        virtual const TCHAR* GetDescriptiveName() override { return TEXT("AnimDemoCountingMalloc"); }
+
+    private:
+        FMalloc* Inner;
+    };
+
+    class FObjectListener final : public FUObjectArray::FUObjectCreateListener
+    {
+    public:
+        virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override
+        {
+            FAnimDemoAllocTracker::RecordObject(Object->GetClass());
+        }
+
+        virtual void OnUObjectArrayShutdown() override
+        {
+            GUObjectArray.RemoveUObjectCreateListener(this);
+        }
+    };
+
+    static FObjectListener ObjectListener;
+    static bool bMallocInstalled = false;
+
+    // Once the command line is known and before the task graph starts, so no other thread can be
+    // inside GMalloc while it is swapped. Modular builds load the module after that point and
+    // are left alone.
+    static FDelayedAutoRegisterHelper InstallMalloc(EDelayedRegisterRunPhase::FileSystemReady, []
+    {
+        if (!FAnimDemoAllocScope::IsRequested())
+            return;
+
+        if (FTaskGraphInterface::IsRunning())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("-AnimDemoAllocTracking ignored: the module loaded after startup, allocation tracking needs a monolithic build."));
+            return;
+        }
+
+        // Stays installed for the rest of the run; outside a capture it only forwards
+        GMalloc = new FCountingMalloc(GMalloc);
+        bMallocInstalled = true;
+    });
+
+    static FAutoConsoleCommand CaptureCommand(
+        TEXT("AnimDemo.Alloc.Capture"),
+        TEXT("AnimDemo.Alloc.Capture <NumFrames=60> [sites] - reports allocations and new UObjects per frame in each hot scope of the running game."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            if (FAnimDemoAllocScope::IsCapturing())
+            {
+                return;
+            }
+
+            const int32 NumFrames = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 60;
+            const bool bCaptureSites = Args.Num() > 1 && Args[1].Equals(TEXT("sites"), ESearchCase::IgnoreCase);
+
+            if (!FAnimDemoAllocScope::StartCapture(bCaptureSites))
+            {
+                return;
+            }
+
+            TSharedRef<int32> Frame = MakeShared<int32>(0);
+            FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Frame, NumFrames](float)
+            {
+                if (++(*Frame) < NumFrames)
+                {
+                    return true;
+                }
+                FAnimDemoAllocScope::StopCapture(*Frame).Log(TEXT("Alloc capture"));
+                return false;
+            }));
+        }));
+}
+
+bool FAnimDemoAllocScope::IsRequested()
+{
+    return FParse::Param(FCommandLine::Get(), TEXT("AnimDemoAllocTracking"));
+}
+
+bool FAnimDemoAllocScope::IsAvailable()
+{
+    return AnimDemoAllocTracker::bMallocInstalled;
+}
+
+void FAnimDemoAllocScope::Enter(const TCHAR* InName)
+{
+    Name = InName;
+    Parent = FAnimDemoAllocTracker::CurrentScope;
+    FAnimDemoAllocTracker::CurrentScope = this;
+}
+
+void FAnimDemoAllocScope::Leave()
+{
+    FAnimDemoAllocTracker::CurrentScope = Parent;
+
+    if (GAnimDemoAllocTrackingActive)
+    {
+        TGuardValue<bool> InTracker(FAnimDemoAllocTracker::bInTracker, true);
+        FScopeLock Lock(&FAnimDemoAllocTracker::ResultsLock);
+
+        FAnimDemoAllocScopeResult& Result = FAnimDemoAllocTracker::Results.FindOrAdd(Name);
+        Result.Name = Name;
+        ++Result.NumCalls;
+        Result.NumAllocs += NumAllocs;
+        Result.AllocBytes += AllocBytes;
+        Result.NumObjects += NumObjects;
+
+        for (int32 Index = 0; Index < NumPendingSites && FAnimDemoAllocTracker::Sites.Num() < FAnimDemoAllocTracker::MaxReportedSites; ++Index)
+        {
+            const FPendingSite& Pending = PendingSites[Index];
+            FAnimDemoAllocSite& Site = FAnimDemoAllocTracker::Sites.AddDefaulted_GetRef();
+            Site.Scope = Name;
+            Site.What = Pending.Class
+                ? FString::Printf(TEXT("new %s"), *Pending.Class->GetName())
+                : FString::Printf(TEXT("%llu bytes"), static_cast<uint64>(Pending.Size));
+            Site.Callstack = FAnimDemoAllocTracker::Symbolicate(Pending);
+        }
+    }
+
+    Name = nullptr;
+}
+
+bool FAnimDemoAllocScope::StartCapture(bool bCaptureSites)
+{
+    check(IsInGameThread());
+
+    if (!AnimDemoAllocTracker::bMallocInstalled)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Allocation tracking is not installed; run a monolithic build with -AnimDemoAllocTracking."));
+        return false;
+    }
+
+    GUObjectArray.AddUObjectCreateListener(&AnimDemoAllocTracker::ObjectListener);
+
+    {
+        FScopeLock Lock(&FAnimDemoAllocTracker::ResultsLock);
+        FAnimDemoAllocTracker::Results.Reset();
+        FAnimDemoAllocTracker::Sites.Reset();
+    }
+
+    FAnimDemoAllocTracker::bCaptureSites = bCaptureSites;
+    GAnimDemoAllocTrackingActive = true;
+    return true;
+}
+
+FAnimDemoAllocReport FAnimDemoAllocScope::StopCapture(int32 NumFrames)
+{
+    check(IsInGameThread());
+
+    GAnimDemoAllocTrackingActive = false;
+    GUObjectArray.RemoveUObjectCreateListener(&AnimDemoAllocTracker::ObjectListener);
+
+    FAnimDemoAllocReport Report;
+    Report.NumFrames = NumFrames;
+
+    FScopeLock Lock(&FAnimDemoAllocTracker::ResultsLock);
+    FAnimDemoAllocTracker::Results.GenerateValueArray(Report.Scopes);
+    Report.Scopes.Sort([](const FAnimDemoAllocScopeResult& A, const FAnimDemoAllocScopeResult& B)
+    {
+        return A.NumAllocs + A.NumObjects > B.NumAllocs + B.NumObjects;
+    });
+    Report.Sites = MoveTemp(FAnimDemoAllocTracker::Sites);
+    FAnimDemoAllocTracker::Results.Reset();
+
+    return Report;
+}
+
+uint64 FAnimDemoAllocReport::GetTotalAllocs() const
+{
+    uint64 Total = 0;
+    for (const FAnimDemoAllocScopeResult& Scope : Scopes)
+    {
+        Total += Scope.NumAllocs;
+    }
+    return Total;
+}
+
+uint64 FAnimDemoAllocReport::GetTotalObjects() const
+{
+    uint64 Total = 0;
+    for (const FAnimDemoAllocScopeResult& Scope : Scopes)
+    {
+        Total += Scope.NumObjects;
+    }
+    return Total;
+}
+
+void FAnimDemoAllocReport::Log(const TCHAR* Title) const
+{
+    const double Frames = FMath::Max(NumFrames, 1);
+
+    UE_LOG(LogTemp, Display, TEXT("%s: %d frames, %llu allocations, %llu new UObjects"), Title, NumFrames, GetTotalAllocs(), GetTotalObjects());
+    for (const FAnimDemoAllocScopeResult& Scope : Scopes)
+    {
+        UE_LOG(LogTemp, Display, TEXT("  %-24s %8llu calls %8.2f allocs/frame %10.1f bytes/frame %6.2f objects/frame"),
+            Scope.Name, Scope.NumCalls, Scope.NumAllocs / Frames, Scope.AllocBytes / Frames, Scope.NumObjects / Frames);
+    }
+
+    for (const FAnimDemoAllocSite& Site : Sites)
+    {
+        UE_LOG(LogTemp, Display, TEXT("  %s: %s at\n%s"), Site.Scope, *Site.What, *Site.Callstack);
+    }
+}
+
+#endif
@@ -0,0 +1,188 @@
+//
+//  AnimDemoAnimLODBenchmark.cpp
+//
+//  Compares the game thread cost of a bot-driven crowd with every character on the full Anim
+//  Blueprint instance, every character on the lite instance and the LOD picked by distance, e.g.
+//
+//      UE_AnimDemo <Map> -log -ExecCmds="AnimDemo.Bench.AnimLOD 500 300 quit"
+//
+//  Hibernation is off for the run so idle bots keep animating in every phase.
+//
+#include "AnimCppChar.h"
+#include "AnimDemoBenchmarkUtils.h"
+#include "AnimLODSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace AnimDemoAnimLODBenchmark
+{
+    enum class EPhase : uint8
+    {
+        Baseline,
+        Settle,
+        Measure,
+    };
+
+    // AnimDemo.AnimLOD.Force value of each measured mode, in run order
+    static constexpr int32 Modes[] = { 0, 1, -1 };
+    static const TCHAR* const ModeNames[] = { TEXT("all full"), TEXT("all lite"), TEXT("by distance") };
+    static constexpr int32 NumModes = UE_ARRAY_COUNT(Modes);
+
+    // Least frames to settle after the swaps are done, so the new instances are warm
+    static constexpr int32 MinSettleFrames = 30;
+
+    struct FModeResult
+    {
+        double Ms = 0.0;
+        int32 NumFull = 0;
+        int32 NumLite = 0;
+        int32 SettleFrames = 0;
+    };
+
+    struct FRun : AnimDemoBenchmark::TFrameRun<EPhase>
+    {
+        TArray<TWeakObjectPtr<AAnimCppChar>> Spawned;
+        int32 NumCharacters = 0;
+        int32 NumFrames = 0;
+        int32 Mode = 0;
+        double BaselineMs = 0.0;
+        FModeResult Results[NumModes];
+        int64 SwapsAtStart = 0;
+        uint64 SwapCyclesAtStart = 0;
+        int32 SavedForce = -1;
+        float SavedIdleSeconds = 0.f;
+    };
+
+    static IConsoleVariable* FindCVar(const TCHAR* Name)
+    {
+        return IConsoleManager::Get().FindConsoleVariable(Name);
+    }
+
+    static void SetForce(int32 Force)
+    {
+        if (IConsoleVariable* CVar = FindCVar(TEXT("AnimDemo.AnimLOD.Force")))
+        {
+            CVar->Set(Force, ECVF_SetByConsole);
+        }
+    }
+
+    static void Finish(FRun& Run, UAnimLODSubsystem& AnimLODs)
+    {
+        const int32 NumSpawned = Run.Spawned.Num();
+        AnimDemoBenchmark::DestroyCharacters(Run.Spawned);
+
+        SetForce(Run.SavedForce);
+        if (IConsoleVariable* CVar = FindCVar(TEXT("AnimDemo.Hibernate.IdleSeconds")))
+        {
+            CVar->Set(Run.SavedIdleSeconds, ECVF_SetByConsole);
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("AnimLOD benchmark: %d bot-driven characters, %d frames per mode"), NumSpawned, Run.NumFrames);
+        UE_LOG(LogTemp, Display, TEXT("  baseline game thread: %.3f ms/frame"), Run.BaselineMs);
+
+        for (int32 Mode = 0; Mode < NumModes; ++Mode)
+        {
+            const FModeResult& Result = Run.Results[Mode];
+            const double PerCharacterUs = NumSpawned > 0 ? (Result.Ms - Run.BaselineMs) * 1000.0 / NumSpawned : 0.0;
+            UE_LOG(LogTemp, Display, TEXT("  %-11s %8.3f ms/frame  %6.2f us/character  %5d full  %5d lite  settled in %d frames"),
+                ModeNames[Mode], Result.Ms, PerCharacterUs, Result.NumFull, Result.NumLite, Result.SettleFrames);
+        }
+
+        if (NumSpawned > 0)
+        {
+            const double FullUs = (Run.Results[0].Ms - Run.BaselineMs) * 1000.0 / NumSpawned;
+            const double LiteUs = (Run.Results[1].Ms - Run.BaselineMs) * 1000.0 / NumSpawned;
+            UE_LOG(LogTemp, Display, TEXT("  lite saves %.2f us per character per frame (%.1f%% of full)"),
+                FullUs - LiteUs, FullUs > 0.0 ? 100.0 * (FullUs - LiteUs) / FullUs : 0.0);
+        }
+
+        const int64 NumSwaps = AnimLODs.GetNumSwaps() - Run.SwapsAtStart;
+        const double SwapUs = FPlatformTime::ToMilliseconds64(AnimLODs.GetSwapCycles() - Run.SwapCyclesAtStart) * 1000.0;
+        UE_LOG(LogTemp, Display, TEXT("  %lld swaps, %.2f us per swap"), NumSwaps, NumSwaps > 0 ? SwapUs / NumSwaps : 0.0);
+    }
+
+    static bool Step(FRun& Run, UWorld& World)
+    {
+        UAnimLODSubsystem* AnimLODs = World.GetSubsystem<UAnimLODSubsystem>();
+        if (!AnimLODs)
+        {
+            UE_LOG(LogTemp, Error, TEXT("AnimLOD benchmark aborted: the world runs without anim LODs."));
+            return false;
+        }
+
+        const double FrameMs = AnimDemoBenchmark::GetGameThreadMs();
+
+        switch (Run.Phase)
+        {
+        case EPhase::Baseline:
+            Run.BaselineMs += FrameMs / Run.NumFrames;
+            if (Run.Frame >= Run.NumFrames)
+            {
+                AnimDemoBenchmark::SpawnBots(&World, Run.NumCharacters, Run.Spawned);
+
+                Run.SwapsAtStart = AnimLODs->GetNumSwaps();
+                Run.SwapCyclesAtStart = AnimLODs->GetSwapCycles();
+                SetForce(Modes[Run.Mode]);
+                Run.BeginPhase(EPhase::Settle);
+            }
+            break;
+
+        case EPhase::Settle:
+            // Swaps are budgeted per frame, so switching the whole crowd takes a while
+            if (Run.Frame >= MinSettleFrames && AnimLODs->GetNumPendingSwaps() == 0)
+            {
+                Run.Results[Run.Mode].SettleFrames = Run.Frame;
+                Run.BeginPhase(EPhase::Measure);
+            }
+            break;
+
+        case EPhase::Measure:
+            Run.Results[Run.Mode].Ms += FrameMs / Run.NumFrames;
+            if (Run.Frame >= Run.NumFrames)
+            {
+                Run.Results[Run.Mode].NumFull = AnimLODs->GetNumCharacters(EAnimDemoAnimLOD::Full);
+                Run.Results[Run.Mode].NumLite = AnimLODs->GetNumCharacters(EAnimDemoAnimLOD::Lite);
+
+                if (++Run.Mode >= NumModes)
+                {
+                    Finish(Run, *AnimLODs);
+                    return false;
+                }
+                SetForce(Modes[Run.Mode]);
+                Run.BeginPhase(EPhase::Settle);
+            }
+            break;
+        }
+        return true;
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs AnimLODCommand(
+        TEXT("AnimDemo.Bench.AnimLOD"),
+        TEXT("AnimDemo.Bench.AnimLOD <NumCharacters=500> <NumFrames=300> [quit] - spawns a bot-driven crowd and compares game thread cost with full, lite and distance-based anim LODs."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World)
+            {
+                return;
+            }
+
+            TSharedRef<FRun> Run = MakeShared<FRun>();
+            Run->World = World;
+            Run->NumCharacters = AnimDemoBenchmark::GetIntArg(Args, 0, 500);
+            Run->NumFrames = AnimDemoBenchmark::GetIntArg(Args, 1, 300);
+            Run->bQuitWhenDone = AnimDemoBenchmark::HasFlag(Args, TEXT("quit"), 2);
+
+            if (IConsoleVariable* CVar = FindCVar(TEXT("AnimDemo.AnimLOD.Force")))
+            {
+                Run->SavedForce = CVar->GetInt();
+            }
+            if (IConsoleVariable* CVar = FindCVar(TEXT("AnimDemo.Hibernate.IdleSeconds")))
+            {
+                Run->SavedIdleSeconds = CVar->GetFloat();
+                CVar->Set(0.f, ECVF_SetByConsole);
+            }
+
+            AnimDemoBenchmark::StartFrameRun(TEXT("AnimLOD"), Run, &Step);
+        }));
+}
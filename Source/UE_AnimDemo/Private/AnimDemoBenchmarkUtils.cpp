@@ -0,0 +1,107 @@
+//
+//  AnimDemoBenchmarkUtils.cpp
+//
+#include "AnimDemoBenchmarkUtils.h"
+#include "AnimCppChar.h"
+#include "AnimDemoBotController.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreGlobals.h"
+
+UClass* AnimDemoBenchmark::GetCharacterClass(UWorld* World)
+{
+    if (AGameModeBase* GameMode = World->GetAuthGameMode())
+    {
+        // Prefer the configured Blueprint pawn so the animation assets are assigned
+        if (GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(AAnimCppChar::StaticClass()))
+        {
+            return GameMode->DefaultPawnClass;
+        }
+    }
+    return AAnimCppChar::StaticClass();
+}
+
+FVector AnimDemoBenchmark::GetGridLocation(int32 Index, int32 NumCharacters, float Spacing)
+{
+    const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumCharacters)));
+    return FVector((Index % Side) * Spacing, (Index / Side) * Spacing, 300.f);
+}
+
+void AnimDemoBenchmark::SpawnCharacters(UWorld* World, int32 NumCharacters, TArray<TWeakObjectPtr<AAnimCppChar>>& OutSpawned, float Spacing,
+    TSubclassOf<AController> ControllerClass)
+{
+    UClass* PawnClass = GetCharacterClass(World);
+
+    FActorSpawnParameters Params;
+    Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+    for (int32 Index = 0; Index < NumCharacters; ++Index)
+    {
+        const FVector Location = GetGridLocation(Index, NumCharacters, Spacing);
+        if (AAnimCppChar* Character = World->SpawnActor<AAnimCppChar>(PawnClass, Location, FRotator::ZeroRotator, Params))
+        {
+            if (!ControllerClass)
+            {
+                Character->SpawnDefaultController();
+            }
+            else if (AController* Controller = World->SpawnActor<AController>(ControllerClass, Location, FRotator::ZeroRotator, Params))
+            {
+                Controller->Possess(Character);
+            }
+            OutSpawned.Add(Character);
+        }
+    }
+}
+
+void AnimDemoBenchmark::SpawnBots(UWorld* World, int32 NumCharacters, TArray<TWeakObjectPtr<AAnimCppChar>>& OutSpawned, float Spacing)
+{
+    const int32 FirstIndex = OutSpawned.Num();
+    SpawnCharacters(World, NumCharacters, OutSpawned, Spacing, AAnimDemoBotController::StaticClass());
+
+    for (int32 Index = FirstIndex; Index < OutSpawned.Num(); ++Index)
+    {
+        if (AAnimDemoBotController* Bot = Cast<AAnimDemoBotController>(OutSpawned[Index]->GetController()))
+        {
+            Bot->Restart(Index - FirstIndex);
+        }
+    }
+}
+
+void AnimDemoBenchmark::DestroyCharacters(TArray<TWeakObjectPtr<AAnimCppChar>>& Spawned)
+{
+    for (const TWeakObjectPtr<AAnimCppChar>& Character : Spawned)
+    {
+        if (Character.IsValid())
+        {
+            if (AController* Controller = Character->GetController())
+            {
+                Controller->Destroy();
+            }
+            Character->Destroy();
+        }
+    }
+    Spawned.Reset();
+}
+
+int32 AnimDemoBenchmark::GetIntArg(const TArray<FString>& Args, int32 Index, int32 Default, int32 Min)
+{
+    return Args.IsValidIndex(Index) ? FMath::Max(Min, FCString::Atoi(*Args[Index])) : Default;
+}
+
+bool AnimDemoBenchmark::HasFlag(const TArray<FString>& Args, const TCHAR* Flag, int32 FirstIndex)
+{
+    for (int32 Index = FirstIndex; Index < Args.Num(); ++Index)
+    {
+        if (Args[Index].Equals(Flag, ESearchCase::IgnoreCase))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+double AnimDemoBenchmark::GetGameThreadMs()
+{
+    return FPlatformTime::ToMilliseconds(GGameThreadTime);
+}
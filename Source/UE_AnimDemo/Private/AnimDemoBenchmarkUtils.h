@@ -0,0 +1,90 @@
+//
+//  AnimDemoBenchmarkUtils.h
+//
+//  Helpers shared by the AnimDemo.Bench.* console commands: argument parsing, crowd spawning and
+//  the runner of benchmarks that advance one phase step per engine frame.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Templates/SubclassOf.h"
+
+class AAnimCppChar;
+class AController;
+class UWorld;
+
+namespace AnimDemoBenchmark
+{
+    // The GameMode's default pawn class when it is an AAnimCppChar, so the Blueprint's animation
+    // assets are assigned, otherwise AAnimCppChar itself
+    UClass* GetCharacterClass(UWorld* World);
+    
+    // Location of the Index-th of NumCharacters on the square spawn grid
+    FVector GetGridLocation(int32 Index, int32 NumCharacters, float Spacing = 200.f);
+    
+    // Spawns NumCharacters of GetCharacterClass() on a square grid, each possessed by a new ControllerClass,
+    // or by its default controller when none is given
+    void SpawnCharacters(UWorld* World, int32 NumCharacters, TArray<TWeakObjectPtr<AAnimCppChar>>& OutSpawned, float Spacing = 200.f,
+        TSubclassOf<AController> ControllerClass = nullptr);
+
+    // SpawnCharacters with an AAnimDemoBotController each, seeded by index so the crowd does not
+    // move in lockstep and reruns repeat exactly
+    void SpawnBots(UWorld* World, int32 NumCharacters, TArray<TWeakObjectPtr<AAnimCppChar>>& OutSpawned, float Spacing = 200.f);
+
+    // Destroys the characters and their controllers
+    void DestroyCharacters(TArray<TWeakObjectPtr<AAnimCppChar>>& Spawned);
+
+    // The Index-th argument as an integer of at least Min, or Default when it is missing
+    int32 GetIntArg(const TArray<FString>& Args, int32 Index, int32 Default, int32 Min = 1);
+
+    // Whether any argument from FirstIndex on is Flag, ignoring case
+    bool HasFlag(const TArray<FString>& Args, const TCHAR* Flag, int32 FirstIndex = 0);
+
+    // Game thread time of the previous frame; a benchmark step runs before the world ticks
+    double GetGameThreadMs();
+
+    // State of a benchmark that runs in phases over engine frames. Runs derive from it and add
+    // their own settings and results; Frame counts the frames since the current phase began.
+    template <typename PhaseType>
+    struct TFrameRun
+    {
+        TWeakObjectPtr<UWorld> World;
+        PhaseType Phase{};
+        int32 Frame = 0;
+        bool bQuitWhenDone = false;
+
+        void BeginPhase(PhaseType NewPhase)
+        {
+            Phase = NewPhase;
+            Frame = 0;
+        }
+    };
+
+    // Calls Step once per engine frame, after advancing Run->Frame, until it returns false or the
+    // world goes away, then exits the process when the run was started with quit
+    template <typename RunType>
+    void StartFrameRun(const TCHAR* Name, TSharedRef<RunType> Run, bool (*Step)(RunType&, UWorld&))
+    {
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Name, Run, Step](float)
+        {
+            UWorld* World = Run->World.Get();
+            if (!World)
+            {
+                UE_LOG(LogTemp, Error, TEXT("%s benchmark aborted: world went away."), Name);
+            }
+            else
+            {
+                ++Run->Frame;
+                if (Step(*Run, *World))
+                    return true;
+            }
+
+            if (Run->bQuitWhenDone)
+            {
+                FPlatformMisc::RequestExit(false);
+            }
+            return false;
+        }));
+    }
+}
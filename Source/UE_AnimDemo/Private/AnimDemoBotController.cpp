@@ -0,0 +1,204 @@
+//
+//  AnimDemoBotController.cpp
+//
+#include "AnimDemoBotController.h"
+#include "AnimCppChar.h"
+#include "AnimDemoStats.h"
+#include "EnhancedInputComponent.h"
+#include "HAL/PlatformTime.h"
+
+namespace AnimDemoBot
+{
+    // Look input a moving bot glances around with, in input units per second
+    static constexpr float LookAmplitude = 20.f;
+    static constexpr float LookFrequency = 1.5f;
+    static constexpr float MaxPitch = 60.f;
+}
+
+AAnimDemoBotController::AAnimDemoBotController()
+{
+    PrimaryActorTick.bCanEverTick = true;
+    bWantsPlayerState = false;
+}
+
+FAnimDemoBotCounters& AAnimDemoBotController::GetCounters()
+{
+    static FAnimDemoBotCounters Counters;
+    return Counters;
+}
+
+void AAnimDemoBotController::OnPossess(APawn* InPawn)
+{
+    Super::OnPossess(InPawn);
+
+    AAnimCppChar* Character = Cast<AAnimCppChar>(InPawn);
+    if (!Character)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s only drives AAnimCppChar, %s gets no input."), *GetName(), *GetNameSafe(InPawn));
+        return;
+    }
+
+    // The same bindings a local player gets, built into a component only this bot fires
+    BotInput = NewObject<UEnhancedInputComponent>(this);
+    Character->SetupPlayerInputComponent(BotInput);
+
+    Bindings.Reset();
+    for (const TUniquePtr<FEnhancedInputActionEventBinding>& Binding : BotInput->GetActionEventBindings())
+    {
+        if (Binding->GetTriggerEvent() == ETriggerEvent::Triggered)
+        {
+            Bindings.Add({ Binding->GetAction(), Binding.Get() });
+        }
+    }
+
+    MoveAction = Character->IA_Move;
+    TurnAction = Character->IA_Turn;
+    LookUpAction = Character->IA_LookUp;
+    JumpAction = Character->IA_Jump;
+
+    Restart(RandomSeed);
+}
+
+void AAnimDemoBotController::OnUnPossess()
+{
+    Bindings.Reset();
+    BotInput = nullptr;
+
+    Super::OnUnPossess();
+}
+
+void AAnimDemoBotController::Restart(int32 InRandomSeed)
+{
+    RandomSeed = InRandomSeed;
+    Random.Initialize(RandomSeed);
+    StepIndex = INDEX_NONE;
+    StepTime = 0.f;
+    JumpCooldown = 0.f;
+    LookPhase = Random.FRandRange(0.f, UE_TWO_PI);
+}
+
+void AAnimDemoBotController::SaveSnapshot(FAnimDemoBotSnapshot& OutSnapshot) const
+{
+    OutSnapshot.CurrentStep = CurrentStep;
+    OutSnapshot.RandomState = Random.GetCurrentSeed();
+    OutSnapshot.StepIndex = StepIndex;
+    OutSnapshot.StepTime = StepTime;
+    OutSnapshot.JumpCooldown = JumpCooldown;
+    OutSnapshot.LookPhase = LookPhase;
+}
+
+void AAnimDemoBotController::RestoreSnapshot(const FAnimDemoBotSnapshot& Snapshot)
+{
+    CurrentStep = Snapshot.CurrentStep;
+    Random.Initialize(Snapshot.RandomState);
+    StepIndex = Snapshot.StepIndex;
+    StepTime = Snapshot.StepTime;
+    JumpCooldown = Snapshot.JumpCooldown;
+    LookPhase = Snapshot.LookPhase;
+}
+
+void AAnimDemoBotController::NextStep()
+{
+    StepTime = 0.f;
+    JumpCooldown = 0.f;
+
+    if (Script.Num() > 0)
+    {
+        StepIndex = (StepIndex + 1) % Script.Num();
+        CurrentStep = Script[StepIndex];
+        return;
+    }
+
+    StepIndex = 0;
+    const float Roll = Random.FRand();
+    CurrentStep.Behavior = Roll < 0.25f ? EAnimDemoBotBehavior::Idle
+        : Roll < 0.6f ? EAnimDemoBotBehavior::Walk
+        : Roll < 0.8f ? EAnimDemoBotBehavior::Run
+        : EAnimDemoBotBehavior::JumpSpam;
+    CurrentStep.Duration = Random.FRandRange(1.f, 5.f);
+    CurrentStep.TurnRate = Random.FRandRange(-60.f, 60.f);
+}
+
+void AAnimDemoBotController::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!BotInput || !GetPawn())
+        return;
+
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(BotInput);
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    StepTime += DeltaTime;
+    if (StepIndex == INDEX_NONE || StepTime >= CurrentStep.Duration)
+    {
+        NextStep();
+    }
+
+    float MoveInput = 0.f;
+    switch (CurrentStep.Behavior)
+    {
+    case EAnimDemoBotBehavior::Walk:
+        MoveInput = WalkInput;
+        break;
+    case EAnimDemoBotBehavior::Run:
+    case EAnimDemoBotBehavior::JumpSpam:
+        MoveInput = 1.f;
+        break;
+    default:
+        break;
+    }
+
+    // A released stick or a still mouse fires no Triggered event, so an idle bot sends nothing
+    if (MoveInput > 0.f)
+    {
+        Dispatch(MoveAction.Get(), FInputActionValue(FVector2D(MoveInput, 0.f)));
+
+        const float Yaw = CurrentStep.TurnRate * DeltaTime;
+        LookPhase += AnimDemoBot::LookFrequency * DeltaTime;
+        const float Pitch = AnimDemoBot::LookAmplitude * FMath::Sin(LookPhase) * DeltaTime;
+
+        if (Yaw != 0.f)
+        {
+            Dispatch(TurnAction.Get(), FInputActionValue(Yaw));
+        }
+        Dispatch(LookUpAction.Get(), FInputActionValue(Pitch));
+
+        // APawn::AddControllerYawInput only feeds player controllers, so the bot applies the rotation
+        // itself, as APlayerController::UpdateRotation would
+        FRotator Rotation = GetControlRotation();
+        Rotation.Yaw = FRotator::NormalizeAxis(Rotation.Yaw + Yaw);
+        Rotation.Pitch = FMath::Clamp(FRotator::NormalizeAxis(Rotation.Pitch + Pitch), -AnimDemoBot::MaxPitch, AnimDemoBot::MaxPitch);
+        SetControlRotation(Rotation);
+    }
+
+    if (CurrentStep.Behavior == EAnimDemoBotBehavior::JumpSpam)
+    {
+        JumpCooldown -= DeltaTime;
+        if (JumpCooldown <= 0.f)
+        {
+            Dispatch(JumpAction.Get(), FInputActionValue(true));
+            ++GetCounters().NumJumpPresses;
+            JumpCooldown = JumpInterval;
+        }
+    }
+
+    GetCounters().DispatchCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void AAnimDemoBotController::Dispatch(const UInputAction* Action, const FInputActionValue& Value)
+{
+    if (!Action)
+        return;
+
+    ActionInstance.Set(Value);
+    for (const FBotBinding& Binding : Bindings)
+    {
+        if (Binding.Action == Action)
+        {
+            Binding.Binding->Execute(ActionInstance);
+            ++GetCounters().NumInputEvents;
+            INC_DWORD_STAT(STAT_AnimDemo_BotInputEvents);
+        }
+    }
+}
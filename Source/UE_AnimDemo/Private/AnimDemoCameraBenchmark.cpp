@@ -0,0 +1,98 @@
+//
+//  AnimDemoCameraBenchmark.cpp
+//
+//  Compares the async camera boom probe with the stock synchronous sweep on whatever cameras
+//  are active, e.g. while walking the benchmark map:
+//
+//      AnimDemo.Bench.CameraBoom 600
+//
+//  Each mode runs for the given number of frames with clipping detection on, and the command
+//  logs the game-thread cost per arm update, the sweeps issued and the clipping incidents.
+//
+#include "AnimDemoBenchmarkUtils.h"
+#include "AsyncSpringArmComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace AnimDemoCameraBenchmark
+{
+    enum class EPhase : uint8
+    {
+        Async,
+        Sync,
+    };
+
+    struct FRun : AnimDemoBenchmark::TFrameRun<EPhase>
+    {
+        int32 NumFrames = 0;
+        FAsyncSpringArmCounters AsyncResult;
+        int32 SavedAsyncProbe = 1;
+        int32 SavedCountClipping = 0;
+    };
+
+    static IConsoleVariable* FindCVar(const TCHAR* Name)
+    {
+        IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(Name);
+        check(CVar);
+        return CVar;
+    }
+
+    static void BeginMode(FRun& Run, EPhase Phase)
+    {
+        Run.BeginPhase(Phase);
+        FindCVar(TEXT("AnimDemo.Camera.AsyncProbe"))->Set(Phase == EPhase::Async ? 1 : 0, ECVF_SetByConsole);
+        UAsyncSpringArmComponent::GetCounters() = FAsyncSpringArmCounters();
+    }
+
+    static void LogMode(const TCHAR* Mode, const FAsyncSpringArmCounters& Counters, int32 NumFrames)
+    {
+        const double UpdateUs = Counters.NumUpdates > 0 ? FPlatformTime::ToMilliseconds64(Counters.UpdateCycles) * 1000.0 / Counters.NumUpdates : 0.0;
+        UE_LOG(LogTemp, Display, TEXT("  %-6s %8llu updates %8.2f us/update %8llu sync sweeps %8llu async sweeps %6llu clip incidents (%.2f%% of frames)"),
+            Mode, Counters.NumUpdates, UpdateUs, Counters.NumSyncSweeps, Counters.NumAsyncSweeps, Counters.NumClipIncidents,
+            Counters.NumUpdates > 0 ? 100.0 * Counters.NumClipIncidents / Counters.NumUpdates : 0.0);
+    }
+
+    static bool Step(FRun& Run, UWorld& World)
+    {
+        if (Run.Frame < Run.NumFrames)
+            return true;
+
+        if (Run.Phase == EPhase::Async)
+        {
+            Run.AsyncResult = UAsyncSpringArmComponent::GetCounters();
+            BeginMode(Run, EPhase::Sync);
+            return true;
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("CameraBoom benchmark: %d frames per mode"), Run.NumFrames);
+        LogMode(TEXT("async"), Run.AsyncResult, Run.NumFrames);
+        LogMode(TEXT("sync"), UAsyncSpringArmComponent::GetCounters(), Run.NumFrames);
+
+        FindCVar(TEXT("AnimDemo.Camera.AsyncProbe"))->Set(Run.SavedAsyncProbe, ECVF_SetByConsole);
+        FindCVar(TEXT("AnimDemo.Camera.CountClipping"))->Set(Run.SavedCountClipping, ECVF_SetByConsole);
+        return false;
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs CameraBoomCommand(
+        TEXT("AnimDemo.Bench.CameraBoom"),
+        TEXT("AnimDemo.Bench.CameraBoom <NumFrames=600> - compares async and synchronous camera boom probes on the active cameras."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World)
+            {
+                return;
+            }
+
+            TSharedRef<FRun> Run = MakeShared<FRun>();
+            Run->World = World;
+            Run->NumFrames = AnimDemoBenchmark::GetIntArg(Args, 0, 600);
+            Run->SavedAsyncProbe = FindCVar(TEXT("AnimDemo.Camera.AsyncProbe"))->GetInt();
+            Run->SavedCountClipping = FindCVar(TEXT("AnimDemo.Camera.CountClipping"))->GetInt();
+
+            FindCVar(TEXT("AnimDemo.Camera.CountClipping"))->Set(1, ECVF_SetByConsole);
+            BeginMode(*Run, EPhase::Async);
+
+            AnimDemoBenchmark::StartFrameRun(TEXT("CameraBoom"), Run, &Step);
+        }));
+}
@@ -0,0 +1,115 @@
+//
+//  AnimDemoCrowdBenchmark.cpp
+//
+//  Times the crowd spatial hash build and separation pass on synthetic crowds of increasing
+//  size, without actors:
+//
+//      AnimDemo.Bench.CrowdSeparation 10000
+//
+//  Agents are scattered at a constant density, so the neighbors per agent stay the same and
+//  the cost per agent should stay flat as the crowd grows.
+//
+#include "AnimDemoBenchmarkUtils.h"
+#include "CrowdSpatialHash.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace AnimDemoCrowdBenchmark
+{
+    static constexpr float Radius = 120.f;
+
+    // About three agents within the separation radius of each other
+    static constexpr float AreaPerAgent = 15000.f;
+
+    struct FResult
+    {
+        int32 NumAgents = 0;
+        double BuildUs = 0.0;
+        double SeparationUs = 0.0;
+    };
+
+    static FResult Measure(int32 NumAgents, int32 NumIterations)
+    {
+        FRandomStream Random(NumAgents);
+        const float Side = FMath::Sqrt(NumAgents * AreaPerAgent);
+
+        TArray<float> PosX;
+        TArray<float> PosY;
+        PosX.SetNumUninitialized(NumAgents);
+        PosY.SetNumUninitialized(NumAgents);
+        for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+        {
+            PosX[Agent] = Random.FRandRange(0.f, Side);
+            PosY[Agent] = Random.FRandRange(0.f, Side);
+        }
+
+        TArray<float> PushX;
+        TArray<float> PushY;
+        PushX.SetNumZeroed(NumAgents);
+        PushY.SetNumZeroed(NumAgents);
+
+        // One untimed run sizes the hash's arrays and warms the caches
+        FCrowdSpatialHash Hash;
+        Hash.Build(PosX, PosY, Radius);
+        CrowdSeparation::ComputeSeparation(Hash, Radius, PushX, PushY);
+
+        uint64 BuildCycles = 0;
+        uint64 SeparationCycles = 0;
+        for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            const uint64 BuildStart = FPlatformTime::Cycles64();
+            Hash.Build(PosX, PosY, Radius);
+            const uint64 SeparationStart = FPlatformTime::Cycles64();
+            CrowdSeparation::ComputeSeparation(Hash, Radius, PushX, PushY);
+            const uint64 End = FPlatformTime::Cycles64();
+
+            BuildCycles += SeparationStart - BuildStart;
+            SeparationCycles += End - SeparationStart;
+
+            // Move the crowd as the subsystem would, so every iteration rebuilds a changed hash
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                PosX[Agent] += PushX[Agent];
+                PosY[Agent] += PushY[Agent];
+            }
+        }
+
+        FResult Result;
+        Result.NumAgents = NumAgents;
+        Result.BuildUs = FPlatformTime::ToMilliseconds64(BuildCycles) * 1000.0 / NumIterations;
+        Result.SeparationUs = FPlatformTime::ToMilliseconds64(SeparationCycles) * 1000.0 / NumIterations;
+        return Result;
+    }
+
+    static FAutoConsoleCommand CrowdSeparationCommand(
+        TEXT("AnimDemo.Bench.CrowdSeparation"),
+        TEXT("AnimDemo.Bench.CrowdSeparation <MaxAgents=10000> <Iterations=50> - times the crowd spatial hash and separation pass at increasing crowd sizes."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const int32 MaxAgents = AnimDemoBenchmark::GetIntArg(Args, 0, 10000);
+            const int32 NumIterations = AnimDemoBenchmark::GetIntArg(Args, 1, 50);
+
+            TArray<int32> Sizes;
+            for (int32 NumAgents = 625; NumAgents < MaxAgents; NumAgents *= 2)
+            {
+                Sizes.Add(NumAgents);
+            }
+            Sizes.Add(MaxAgents);
+
+            UE_LOG(LogTemp, Display, TEXT("CrowdSeparation benchmark: radius %.0f, %d iterations per size"), Radius, NumIterations);
+            double BaselineNsPerAgent = 0.0;
+            for (const int32 NumAgents : Sizes)
+            {
+                const FResult Result = Measure(NumAgents, NumIterations);
+                const double NsPerAgent = (Result.BuildUs + Result.SeparationUs) * 1000.0 / NumAgents;
+                if (BaselineNsPerAgent == 0.0)
+                {
+                    BaselineNsPerAgent = NsPerAgent;
+                }
+
+                UE_LOG(LogTemp, Display, TEXT("  %6d agents  build %9.1f us  separation %9.1f us  %7.1f ns/agent  (%.2fx the smallest crowd)"),
+                    NumAgents, Result.BuildUs, Result.SeparationUs, NsPerAgent, NsPerAgent / BaselineNsPerAgent);
+            }
+        }));
+}
@@ -0,0 +1,131 @@
+//
+//  AnimDemoCrowdPoseBenchmark.cpp
+//
+//  Times batched crowd pose sampling on synthetic clips, without actors or assets, at every
+//  worker count from 1 to the calling thread plus all task graph workers:
+//
+//      AnimDemo.Bench.CrowdPose 5000
+//
+//  The log shows the speedup and parallel efficiency per worker count and a CSV of the same
+//  table is written to Saved/Profiling/CrowdPose for plotting. A last row samples the crowd
+//  unsorted with one instance per job at every worker, the way per-component evaluation tasks
+//  schedule, to show what batching saves.
+//
+#include "AnimDemoBenchmarkUtils.h"
+#include "CrowdPoseBatch.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace AnimDemoCrowdPoseBenchmark
+{
+    // Four sequences of one second at 30 Hz, as a crowd would share a handful of loops
+    static constexpr int32 NumClips = 4;
+    static constexpr int32 NumKeys = 31;
+    static constexpr float SampleHz = 30.f;
+
+    // Output per chunk in the subsystem's default AnimDemo.CrowdPose.ChunkKB
+    static constexpr int32 ChunkBytes = 64 * 1024;
+
+    static void MakeClip(FCrowdPoseClip& Clip, int32 NumBones, FRandomStream& Random)
+    {
+        // Spine-like runs with a branch every few bones, parents always before their children
+        TArray<int32> Parents;
+        Parents.SetNumUninitialized(NumBones);
+        for (int32 Bone = 0; Bone < NumBones; ++Bone)
+        {
+            Parents[Bone] = Bone == 0 ? INDEX_NONE : FMath::Max(0, Bone - 1 - (Bone % 4 == 0 ? 3 : 0));
+        }
+        Clip.Init(MoveTemp(Parents), NumKeys, SampleHz);
+
+        for (int32 Key = 0; Key < NumKeys; ++Key)
+        {
+            for (FTransform3f& Local : Clip.GetKey(Key))
+            {
+                const FRotator3f Rotation(Random.FRandRange(-30.f, 30.f), Random.FRandRange(-30.f, 30.f), Random.FRandRange(-30.f, 30.f));
+                Local = FTransform3f(Rotation.Quaternion(), FVector3f(Random.FRandRange(0.f, 20.f), 0.f, 0.f));
+            }
+        }
+    }
+
+    static double Measure(TConstArrayView<FCrowdPoseItem> Items, int32 ChunkSize, int32 NumWorkers, int32 NumIterations)
+    {
+        // One untimed run wakes the workers and faults the output in
+        CrowdPoseBatch::Sample(Items, ChunkSize, NumWorkers);
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+        {
+            CrowdPoseBatch::Sample(Items, ChunkSize, NumWorkers);
+        }
+        return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 / NumIterations;
+    }
+
+    static FAutoConsoleCommand CrowdPoseCommand(
+        TEXT("AnimDemo.Bench.CrowdPose"),
+        TEXT("AnimDemo.Bench.CrowdPose <NumInstances=5000> <Iterations=20> <Bones=70> - times batched crowd pose sampling from 1 to all cores."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const int32 NumInstances = AnimDemoBenchmark::GetIntArg(Args, 0, 5000);
+            const int32 NumIterations = AnimDemoBenchmark::GetIntArg(Args, 1, 20);
+            const int32 NumBones = AnimDemoBenchmark::GetIntArg(Args, 2, 70);
+
+            FRandomStream Random(NumInstances);
+            TArray<FCrowdPoseClip> Clips;
+            Clips.SetNum(NumClips);
+            for (FCrowdPoseClip& Clip : Clips)
+            {
+                MakeClip(Clip, NumBones, Random);
+            }
+
+            TArray<FTransform> Output;
+            Output.SetNumUninitialized(NumInstances * NumBones);
+
+            TArray<FCrowdPoseItem> Items;
+            Items.SetNumUninitialized(NumInstances);
+            for (int32 Instance = 0; Instance < NumInstances; ++Instance)
+            {
+                const FCrowdPoseClip& Clip = Clips[Random.RandHelper(NumClips)];
+                Items[Instance] = { &Clip, Random.FRandRange(0.f, Clip.GetLength()), Output.GetData() + Instance * NumBones };
+            }
+            const TArray<FCrowdPoseItem> Unsorted = Items;
+            CrowdPoseBatch::SortItems(Items);
+
+            const int32 MaxWorkers = CrowdPoseBatch::GetMaxWorkers();
+            const int32 ChunkSize = CrowdPoseBatch::GetChunkSize(NumBones, ChunkBytes);
+
+            UE_LOG(LogTemp, Display, TEXT("CrowdPose benchmark: %d instances of %d bones, %d clips, %d per chunk, %d iterations, up to %d workers"),
+                NumInstances, NumBones, NumClips, ChunkSize, NumIterations, MaxWorkers);
+
+            FString Csv = TEXT("Workers,ChunkSize,Sorted,UsPerFrame,NsPerInstance,Speedup,Efficiency\n");
+            double SingleUs = 0.0;
+            auto Report = [&](const TCHAR* Label, int32 Workers, int32 RowChunkSize, bool bSorted, double Us)
+            {
+                const double Speedup = Us > 0.0 ? SingleUs / Us : 0.0;
+                UE_LOG(LogTemp, Display, TEXT("  %-10s %3d workers  %10.1f us  %7.1f ns/instance  %5.2fx  %5.1f%% efficiency"),
+                    Label, Workers, Us, Us * 1000.0 / NumInstances, Speedup, 100.0 * Speedup / Workers);
+                Csv += FString::Printf(TEXT("%d,%d,%d,%.1f,%.1f,%.3f,%.3f\n"),
+                    Workers, RowChunkSize, bSorted ? 1 : 0, Us, Us * 1000.0 / NumInstances, Speedup, Speedup / Workers);
+            };
+
+            for (int32 Workers = 1; Workers <= MaxWorkers; ++Workers)
+            {
+                const double Us = Measure(Items, ChunkSize, Workers, NumIterations);
+                if (Workers == 1)
+                {
+                    SingleUs = Us;
+                }
+                Report(TEXT("batched"), Workers, ChunkSize, true, Us);
+            }
+            Report(TEXT("per-item"), MaxWorkers, 1, false, Measure(Unsorted, 1, MaxWorkers, NumIterations));
+
+            const FString ReportPath = FPaths::ProfilingDir() / TEXT("CrowdPose") / FString::Printf(TEXT("Scaling-%s.csv"), *FDateTime::Now().ToString());
+            if (FFileHelper::SaveStringToFile(Csv, *ReportPath))
+            {
+                UE_LOG(LogTemp, Display, TEXT("Scaling table written to %s"), *FPaths::ConvertRelativePathToFull(ReportPath));
+            }
+        }));
+}
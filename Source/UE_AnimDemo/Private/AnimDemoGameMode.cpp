@@ -1,5 +1,6 @@
 #include "AnimDemoGameMode.h"
 #include "AnimTestCharacter.h"
+#include "AnimDemoActorPoolSubsystem.h"
 #include "UObject/ConstructorHelpers.h"
 
 AAnimDemoGameMode::AAnimDemoGameMode()
@@ -11,3 +12,16 @@ AAnimDemoGameMode::AAnimDemoGameMode()
         DefaultPawnClass = PlayerPawnBPClass.Class;
     }
 }
+
+void AAnimDemoGameMode::BeginPlay()
+{
+    Super::BeginPlay();
+    
+    if (UAnimDemoActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UAnimDemoActorPoolSubsystem>())
+    {
+        for (const TPair<TSubclassOf<AActor>, int32>& Entry : PrewarmActors)
+        {
+            Pool->Prewarm(Entry.Key, Entry.Value);
+        }
+    }
+}
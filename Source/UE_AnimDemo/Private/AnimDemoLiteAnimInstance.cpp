@@ -0,0 +1,78 @@
+//
+//  AnimDemoLiteAnimInstance.cpp
+//
+#include "AnimDemoLiteAnimInstance.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/AnimNodeBase.h"
+#include "Animation/AnimSequence.h"
+
+void FAnimDemoLiteAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+    FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+    // Game thread; the only hand-over from the instance
+    UAnimDemoLiteAnimInstance* Instance = CastChecked<UAnimDemoLiteAnimInstance>(InAnimInstance);
+    if (Instance->bRestart)
+    {
+        Sequence = Instance->Sequence;
+        Time = Instance->Time;
+        bLooping = Instance->bLooping;
+        Instance->bRestart = false;
+    }
+}
+
+void FAnimDemoLiteAnimInstanceProxy::Update(float DeltaSeconds)
+{
+    if (!Sequence)
+        return;
+
+    // A sequence that does not loop holds its last frame
+    const float Length = Sequence->GetPlayLength();
+    Time += DeltaSeconds;
+    if (Length > 0.f && Time > Length)
+    {
+        Time = bLooping ? FMath::Fmod(Time, Length) : Length;
+    }
+}
+
+void FAnimDemoLiteAnimInstanceProxy::PostUpdate(UAnimInstance* InAnimInstance) const
+{
+    FAnimInstanceProxy::PostUpdate(InAnimInstance);
+
+    CastChecked<UAnimDemoLiteAnimInstance>(InAnimInstance)->Time = Time;
+}
+
+bool FAnimDemoLiteAnimInstanceProxy::Evaluate(FPoseContext& Output)
+{
+    if (!Sequence)
+    {
+        Output.ResetToRefPose();
+        return true;
+    }
+
+    FAnimationPoseData PoseData(Output);
+    Sequence->GetAnimationPose(PoseData, FAnimExtractContext(static_cast<double>(Time), false));
+    return true;
+}
+
+void UAnimDemoLiteAnimInstance::PlayState(ECharacterAnimState InState, UAnimSequence* InSequence, bool bInLooping, float InTime)
+{
+    if (State == InState && Sequence == InSequence)
+        return;
+
+    State = InState;
+    Sequence = InSequence;
+    bLooping = bInLooping;
+    Time = InTime;
+    bRestart = true;
+}
+
+FAnimInstanceProxy* UAnimDemoLiteAnimInstance::CreateAnimInstanceProxy()
+{
+    return new FAnimDemoLiteAnimInstanceProxy(this);
+}
+
+void UAnimDemoLiteAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+    delete static_cast<FAnimDemoLiteAnimInstanceProxy*>(InProxy);
+}
@@ -0,0 +1,173 @@
+//
+//  AnimDemoMemory.cpp
+//
+//  LLM tag definitions and the AnimDemo.MemReport console command, which prints bytes and object
+//  counts per subsystem and per character type in the current world, e.g.
+//
+//      UE_AnimDemo <Map> -llm -ExecCmds="AnimDemo.MemReport"
+//
+#include "AnimDemoMemory.h"
+#include "AnimCppChar.h"
+#include "AnimTestActor.h"
+#include "AnimTestCharacter.h"
+#include "AnimationStateMachine.h"
+#include "MyAnimInstance.h"
+#include "PlayerSettingsSave.h"
+#include "PlayerSettingsWidget.h"
+#include "Animation/AnimMontage.h"
+#include "Camera/CameraComponent.h"
+#include "EngineUtils.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+#include "UObject/UObjectIterator.h"
+
+LLM_DEFINE_TAG(AnimDemo);
+LLM_DEFINE_TAG(AnimDemo_Characters);
+LLM_DEFINE_TAG(AnimDemo_StateMachine);
+LLM_DEFINE_TAG(AnimDemo_Montages);
+LLM_DEFINE_TAG(AnimDemo_Camera);
+LLM_DEFINE_TAG(AnimDemo_SettingsUI);
+LLM_DEFINE_TAG(AnimDemo_SaveGame);
+LLM_DEFINE_TAG(AnimDemo_Trace);
+LLM_DEFINE_TAG(AnimDemo_PoseSearch);
+
+namespace AnimDemoMemory
+{
+    struct FRow
+    {
+        int32 NumObjects = 0;
+        SIZE_T Bytes = 0;
+    };
+
+    // Estimated total covers the object itself plus whatever its GetResourceSizeEx reports
+    // (property containers, non-reflected arrays); shared assets are not included
+    static SIZE_T GetObjectBytes(UObject* Object)
+    {
+        return Object->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+    }
+
+    template<typename ObjectType, typename PredicateType>
+    static FRow MeasureObjects(PredicateType Predicate)
+    {
+        FRow Row;
+        for (TObjectIterator<ObjectType> It; It; ++It)
+        {
+            if (It->IsTemplate() || !Predicate(**It))
+                continue;
+
+            ++Row.NumObjects;
+            Row.Bytes += GetObjectBytes(*It);
+        }
+        return Row;
+    }
+
+    template<typename ObjectType>
+    static FRow MeasureObjects()
+    {
+        return MeasureObjects<ObjectType>([](const ObjectType&) { return true; });
+    }
+
+    static bool IsOwnedByDemoCharacter(const UActorComponent& Component)
+    {
+        const AActor* Owner = Component.GetOwner();
+        return Owner && (Owner->IsA<AAnimCppChar>() || Owner->IsA<AAnimTestCharacter>());
+    }
+
+    // Each instance is the actor plus everything outered to it: components, the state machine and,
+    // through the mesh component, the anim instance and its montage instances
+    template<typename ActorType>
+    static FRow MeasureCharacters(UWorld* World)
+    {
+        FRow Row;
+        TArray<UObject*> Inners;
+        for (TActorIterator<ActorType> It(World); It; ++It)
+        {
+            ++Row.NumObjects;
+            Row.Bytes += GetObjectBytes(*It);
+
+            Inners.Reset();
+            GetObjectsWithOuter(*It, Inners, true);
+            for (UObject* Inner : Inners)
+            {
+                Row.Bytes += GetObjectBytes(Inner);
+            }
+        }
+        return Row;
+    }
+
+    static void LogRow(const TCHAR* Name, const FRow& Row)
+    {
+        UE_LOG(LogTemp, Display, TEXT("  %-24s %6d objects %10.1f KB"), Name, Row.NumObjects, Row.Bytes / 1024.0);
+    }
+
+    static void LogCharacterRow(const TCHAR* Name, const FRow& Row)
+    {
+        const double PerInstance = Row.NumObjects > 0 ? static_cast<double>(Row.Bytes) / Row.NumObjects : 0.0;
+        UE_LOG(LogTemp, Display, TEXT("  %-24s %6d instances %10.1f KB %10.0f bytes/instance"), Name, Row.NumObjects, Row.Bytes / 1024.0, PerInstance);
+    }
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+    static void LogTag(const TCHAR* Name, const FLLMTagDeclaration& Tag)
+    {
+        const int64 Bytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, Tag.GetUniqueName(), ELLMTagSet::None);
+        UE_LOG(LogTemp, Display, TEXT("  %-24s %10.1f KB"), Name, Bytes / 1024.0);
+    }
+#endif
+
+    static void Report(UWorld* World)
+    {
+        UE_LOG(LogTemp, Display, TEXT("AnimDemo memory report"));
+
+        UE_LOG(LogTemp, Display, TEXT("Per subsystem (all worlds):"));
+        LogRow(TEXT("State machines"), MeasureObjects<UAnimationStateMachine>());
+        LogRow(TEXT("Anim instances"), MeasureObjects<UMyAnimInstance>());
+        // PlaySlotAnimationAsDynamicMontage creates its montages in the transient package
+        LogRow(TEXT("Dynamic montages"), MeasureObjects<UAnimMontage>([](const UAnimMontage& Montage)
+        {
+            return Montage.GetOuter() == GetTransientPackage();
+        }));
+        LogRow(TEXT("Camera booms"), MeasureObjects<USpringArmComponent>(&IsOwnedByDemoCharacter));
+        LogRow(TEXT("Cameras"), MeasureObjects<UCameraComponent>(&IsOwnedByDemoCharacter));
+        LogRow(TEXT("Settings widgets"), MeasureObjects<UPlayerSettingsWidget>());
+        LogRow(TEXT("Settings saves"), MeasureObjects<UPlayerSettingsSave>());
+
+        if (World)
+        {
+            UE_LOG(LogTemp, Display, TEXT("Per character type (%s):"), *World->GetName());
+            LogCharacterRow(TEXT("AAnimCppChar"), MeasureCharacters<AAnimCppChar>(World));
+            LogCharacterRow(TEXT("AAnimTestCharacter"), MeasureCharacters<AAnimTestCharacter>(World));
+            LogCharacterRow(TEXT("AAnimTestActor"), MeasureCharacters<AAnimTestActor>(World));
+        }
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+        if (FLowLevelMemTracker::IsEnabled())
+        {
+            // Everything allocated under the tags, including non-UObject memory such as transition functors
+            UE_LOG(LogTemp, Display, TEXT("LLM tags:"));
+            LogTag(TEXT("AnimDemo (total)"), LLM_TAGDECLARATION_BYNAME(AnimDemo));
+            LogTag(TEXT("Characters"), LLM_TAGDECLARATION_BYNAME(AnimDemo_Characters));
+            LogTag(TEXT("StateMachine"), LLM_TAGDECLARATION_BYNAME(AnimDemo_StateMachine));
+            LogTag(TEXT("Montages"), LLM_TAGDECLARATION_BYNAME(AnimDemo_Montages));
+            LogTag(TEXT("Camera"), LLM_TAGDECLARATION_BYNAME(AnimDemo_Camera));
+            LogTag(TEXT("SettingsUI"), LLM_TAGDECLARATION_BYNAME(AnimDemo_SettingsUI));
+            LogTag(TEXT("SaveGame"), LLM_TAGDECLARATION_BYNAME(AnimDemo_SaveGame));
+            LogTag(TEXT("Trace"), LLM_TAGDECLARATION_BYNAME(AnimDemo_Trace));
+            LogTag(TEXT("PoseSearch"), LLM_TAGDECLARATION_BYNAME(AnimDemo_PoseSearch));
+        }
+        else
+#endif
+        {
+            UE_LOG(LogTemp, Display, TEXT("LLM tags: run with -llm to include them."));
+        }
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs MemReportCommand(
+        TEXT("AnimDemo.MemReport"),
+        TEXT("AnimDemo.MemReport - prints bytes and object counts per AnimDemo subsystem and per character type."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            Report(World);
+        }));
+}
@@ -0,0 +1,38 @@
+//
+//  AnimDemoMetrics.cpp
+//
+#include "AnimDemoMetrics.h"
+
+#if ANIMDEMO_METRICS
+
+bool GAnimDemoMetricsActive = false;
+
+namespace AnimDemoMetricsImpl
+{
+    static std::atomic<const FAnimDemoMetricTimer*> FirstTimer{ nullptr };
+}
+
+FAnimDemoMetricTimer::FAnimDemoMetricTimer(const TCHAR* InName)
+    : Name(InName)
+{
+    // Scopes on several threads may create their timers at once
+    const FAnimDemoMetricTimer* Head = AnimDemoMetricsImpl::FirstTimer.load(std::memory_order_relaxed);
+    do
+    {
+        Next = Head;
+    }
+    while (!AnimDemoMetricsImpl::FirstTimer.compare_exchange_weak(Head, this, std::memory_order_release, std::memory_order_relaxed));
+}
+
+const FAnimDemoMetricTimer* FAnimDemoMetricTimer::GetFirst()
+{
+    return AnimDemoMetricsImpl::FirstTimer.load(std::memory_order_acquire);
+}
+
+AnimDemoMetrics::FCounters& AnimDemoMetrics::GetCounters()
+{
+    static FCounters Counters;
+    return Counters;
+}
+
+#endif
@@ -0,0 +1,382 @@
+//
+//  AnimDemoMetricsSubsystem.cpp
+//
+#include "AnimDemoMetricsSubsystem.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreGlobals.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectIterator.h"
+
+#if ANIMDEMO_METRICS
+#include "HttpPath.h"
+#include "HttpRouteHandle.h"
+#include "HttpServerModule.h"
+#include "HttpServerRequest.h"
+#include "HttpServerResponse.h"
+#include "IHttpRouter.h"
+
+struct UAnimDemoMetricsSubsystem::FEndpoint
+{
+    TSharedPtr<IHttpRouter> Router;
+    TArray<FHttpRouteHandle> Routes;
+};
+#endif
+
+static TAutoConsoleVariable<int32> CVarMetricsPort(
+    TEXT("AnimDemo.Metrics.Port"),
+    0,
+    TEXT("Port the metrics endpoint listens on when the game instance starts, e.g. -dpcvars=AnimDemo.Metrics.Port=9100.\n")
+    TEXT("0 leaves it off; AnimDemo.Metrics.Start starts it later."));
+
+static TAutoConsoleVariable<float> CVarMetricsWindowSeconds(
+    TEXT("AnimDemo.Metrics.WindowSeconds"),
+    1.f,
+    TEXT("Length of the window the endpoint's averages and rates cover."));
+
+void UAnimDemoMetricsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    const int32 StartupPort = CVarMetricsPort.GetValueOnGameThread();
+    if (StartupPort > 0)
+    {
+        Start(StartupPort);
+    }
+}
+
+void UAnimDemoMetricsSubsystem::Deinitialize()
+{
+    Stop();
+
+    Super::Deinitialize();
+}
+
+bool UAnimDemoMetricsSubsystem::Start(int32 InPort)
+{
+#if ANIMDEMO_METRICS
+    Stop();
+
+    // The listener binds to HTTPServer.Listeners' DefaultBindAddress, which DefaultEngine.ini sets to loopback
+    TSharedPtr<IHttpRouter> Router = FHttpServerModule::Get().GetHttpRouter(InPort, /*bFailOnBindFailure*/ true);
+    if (!Router)
+    {
+        UE_LOG(LogTemp, Error, TEXT("AnimDemo metrics: could not listen on port %d."), InPort);
+        return false;
+    }
+
+    // The HTTP server processes requests from its ticker on the game thread
+    const TPair<const TCHAR*, FHttpRequestHandler> Handlers[] =
+    {
+        { TEXT("/metrics"), FHttpRequestHandler::CreateWeakLambda(this, [this](const FHttpServerRequest&, const FHttpResultCallback& OnComplete)
+            {
+                OnComplete(FHttpServerResponse::Create(FormatPrometheus(), TEXT("text/plain; version=0.0.4; charset=utf-8")));
+                return true;
+            }) },
+        { TEXT("/metrics.json"), FHttpRequestHandler::CreateWeakLambda(this, [this](const FHttpServerRequest&, const FHttpResultCallback& OnComplete)
+            {
+                OnComplete(FHttpServerResponse::Create(FormatJson(), TEXT("application/json")));
+                return true;
+            }) },
+    };
+    TArray<FHttpRouteHandle> Routes;
+    for (const TPair<const TCHAR*, FHttpRequestHandler>& Handler : Handlers)
+    {
+        // Null when the path is already bound on this port, e.g. by a second PIE instance
+        FHttpRouteHandle Route = Router->BindRoute(FHttpPath(Handler.Key), EHttpServerRequestVerbs::VERB_GET, Handler.Value);
+        if (!Route.IsValid())
+        {
+            UE_LOG(LogTemp, Error, TEXT("AnimDemo metrics: %s is already served on port %d."), Handler.Key, InPort);
+            for (const FHttpRouteHandle& Bound : Routes)
+            {
+                Router->UnbindRoute(Bound);
+            }
+            return false;
+        }
+        Routes.Add(MoveTemp(Route));
+    }
+    Endpoint = MakePimpl<FEndpoint>();
+    Endpoint->Router = MoveTemp(Router);
+    Endpoint->Routes = MoveTemp(Routes);
+
+    // Listeners only start on request; when none was running before, the ones started here are
+    // this subsystem's to stop again
+    bStartedListeners = FHttpServerModule::Get().HasPendingListeners();
+    FHttpServerModule::Get().StartAllListeners();
+
+    Port = InPort;
+    StartTime = FPlatformTime::Seconds();
+    TotalFrames = 0;
+    TotalGCs = 0;
+    TotalGCSeconds = 0.0;
+    Published = FWindow();
+    WindowFrames = 0;
+
+    GAnimDemoMetricsActive = true;
+    for (std::atomic<uint32>& Count : AnimDemoMetrics::GetCounters().CharactersInState)
+    {
+        Count.store(0, std::memory_order_relaxed);
+    }
+    Publish(StartTime);
+
+    PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UAnimDemoMetricsSubsystem::OnPreGarbageCollect);
+    PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UAnimDemoMetricsSubsystem::OnPostGarbageCollect);
+    TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UAnimDemoMetricsSubsystem::Tick));
+
+    UE_LOG(LogTemp, Display, TEXT("AnimDemo metrics: serving http://localhost:%d/metrics and /metrics.json"), Port);
+    return true;
+#else
+    UE_LOG(LogTemp, Warning, TEXT("AnimDemo metrics: this build has ANIMDEMO_METRICS off."));
+    return false;
+#endif
+}
+
+void UAnimDemoMetricsSubsystem::Stop()
+{
+#if ANIMDEMO_METRICS
+    if (!Endpoint)
+        return;
+
+    for (const FHttpRouteHandle& Route : Endpoint->Routes)
+    {
+        Endpoint->Router->UnbindRoute(Route);
+    }
+    Endpoint.Reset();
+
+    // Listeners that were already up belong to another user of the HTTP server and stay up
+    if (bStartedListeners)
+    {
+        FHttpServerModule::Get().StopAllListeners();
+        bStartedListeners = false;
+    }
+
+    FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+    FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+    GAnimDemoMetricsActive = false;
+
+    UE_LOG(LogTemp, Display, TEXT("AnimDemo metrics: stopped serving on port %d."), Port);
+#endif
+}
+
+#if ANIMDEMO_METRICS
+
+// Runs once per engine frame before the world ticks, so the state counts are the previous frame's
+bool UAnimDemoMetricsSubsystem::Tick(float DeltaTime)
+{
+    AnimDemoMetrics::FCounters& Counters = AnimDemoMetrics::GetCounters();
+    for (int32 State = 0; State < AnimDemoMetrics::NumStates; ++State)
+    {
+        CharactersInState[State] = Counters.CharactersInState[State].exchange(0, std::memory_order_relaxed);
+    }
+
+    ++WindowFrames;
+    ++TotalFrames;
+    WindowFrameSeconds += DeltaTime;
+    WindowMaxFrameSeconds = FMath::Max(WindowMaxFrameSeconds, static_cast<double>(DeltaTime));
+    WindowGameThreadMs += FPlatformTime::ToMilliseconds(GGameThreadTime);
+
+    const double Now = FPlatformTime::Seconds();
+    if (Now - WindowStart >= FMath::Max(0.1f, CVarMetricsWindowSeconds.GetValueOnGameThread()))
+    {
+        Publish(Now);
+    }
+    return true;
+}
+
+void UAnimDemoMetricsSubsystem::Publish(double Now)
+{
+    const AnimDemoMetrics::FCounters& Counters = AnimDemoMetrics::GetCounters();
+    const uint64 Transitions = Counters.TransitionsTaken.load(std::memory_order_relaxed);
+    const uint64 Montages = Counters.MontagesStarted.load(std::memory_order_relaxed);
+
+    const double Seconds = Now - WindowStart;
+    if (WindowFrames > 0 && Seconds > 0.0)
+    {
+        Published.Seconds = Seconds;
+        Published.NumFrames = WindowFrames;
+        Published.FrameMs = WindowFrameSeconds * 1000.0 / WindowFrames;
+        Published.MaxFrameMs = WindowMaxFrameSeconds * 1000.0;
+        Published.GameThreadMs = WindowGameThreadMs / WindowFrames;
+        Published.TransitionsPerSecond = (Transitions - TransitionsAtStart) / Seconds;
+        Published.MontagesStartedPerSecond = (Montages - MontagesAtStart) / Seconds;
+        Published.NumGCs = WindowGCs;
+        Published.GCMs = WindowGCSeconds * 1000.0;
+        Published.MaxGCMs = WindowMaxGCSeconds * 1000.0;
+    }
+
+    Published.Stages.Reset();
+    for (const FAnimDemoMetricTimer* Timer = FAnimDemoMetricTimer::GetFirst(); Timer; Timer = Timer->Next)
+    {
+        const uint64 Cycles = Timer->Cycles.load(std::memory_order_relaxed);
+        const uint64 Calls = Timer->NumCalls.load(std::memory_order_relaxed);
+        TPair<uint64, uint64>& AtStart = TimersAtStart.FindOrAdd(Timer, TPair<uint64, uint64>(Cycles, Calls));
+        if (WindowFrames > 0)
+        {
+            Published.Stages.Add({ Timer->Name,
+                FPlatformTime::ToMilliseconds64(Cycles - AtStart.Key) / WindowFrames,
+                static_cast<double>(Calls - AtStart.Value) / WindowFrames });
+        }
+        AtStart = TPair<uint64, uint64>(Cycles, Calls);
+    }
+    Published.Stages.Sort([](const FStageSample& A, const FStageSample& B) { return FCString::Strcmp(A.Name, B.Name) < 0; });
+
+    WindowStart = Now;
+    WindowFrames = 0;
+    WindowFrameSeconds = 0.0;
+    WindowMaxFrameSeconds = 0.0;
+    WindowGameThreadMs = 0.0;
+    WindowGCs = 0;
+    WindowGCSeconds = 0.0;
+    WindowMaxGCSeconds = 0.0;
+    TransitionsAtStart = Transitions;
+    MontagesAtStart = Montages;
+}
+
+void UAnimDemoMetricsSubsystem::OnPreGarbageCollect()
+{
+    GCStart = FPlatformTime::Seconds();
+}
+
+void UAnimDemoMetricsSubsystem::OnPostGarbageCollect()
+{
+    const double Seconds = FPlatformTime::Seconds() - GCStart;
+    ++WindowGCs;
+    ++TotalGCs;
+    WindowGCSeconds += Seconds;
+    WindowMaxGCSeconds = FMath::Max(WindowMaxGCSeconds, Seconds);
+    TotalGCSeconds += Seconds;
+}
+
+int32 UAnimDemoMetricsSubsystem::CountDynamicMontages()
+{
+    // PlaySlotAnimationAsDynamicMontage creates its montages in the transient package
+    int32 NumMontages = 0;
+    for (TObjectIterator<UAnimMontage> It; It; ++It)
+    {
+        NumMontages += It->GetOuter() == GetTransientPackage() ? 1 : 0;
+    }
+    return NumMontages;
+}
+
+FString UAnimDemoMetricsSubsystem::FormatPrometheus() const
+{
+    FString Out;
+    auto AddHeader = [&Out](const TCHAR* Name, const TCHAR* Type, const TCHAR* Help)
+    {
+        Out += FString::Printf(TEXT("# HELP %s %s\n# TYPE %s %s\n"), Name, Help, Name, Type);
+    };
+    auto AddGauge = [&Out, &AddHeader](const TCHAR* Name, const TCHAR* Help, double Value)
+    {
+        AddHeader(Name, TEXT("gauge"), Help);
+        Out += FString::Printf(TEXT("%s %.6g\n"), Name, Value);
+    };
+    auto AddCounter = [&Out, &AddHeader](const TCHAR* Name, const TCHAR* Help, double Value)
+    {
+        AddHeader(Name, TEXT("counter"), Help);
+        Out += FString::Printf(TEXT("%s %.6g\n"), Name, Value);
+    };
+
+    AddGauge(TEXT("animdemo_window_seconds"), TEXT("Length of the window the averages and rates cover."), Published.Seconds);
+    AddGauge(TEXT("animdemo_frame_time_ms"), TEXT("Average frame time."), Published.FrameMs);
+    AddGauge(TEXT("animdemo_frame_time_max_ms"), TEXT("Longest frame."), Published.MaxFrameMs);
+    AddGauge(TEXT("animdemo_game_thread_ms"), TEXT("Average game thread time per frame."), Published.GameThreadMs);
+    AddCounter(TEXT("animdemo_frames_total"), TEXT("Frames since the endpoint started."), static_cast<double>(TotalFrames));
+
+    AddHeader(TEXT("animdemo_characters"), TEXT("gauge"), TEXT("Characters in each animation state in the last frame, hibernated ones as Idle."));
+    const UEnum* StateEnum = StaticEnum<ECharacterAnimState>();
+    for (int32 State = 0; State < AnimDemoMetrics::NumStates; ++State)
+    {
+        Out += FString::Printf(TEXT("animdemo_characters{state=\"%s\"} %u\n"), *StateEnum->GetNameStringByValue(State), CharactersInState[State]);
+    }
+
+    AddGauge(TEXT("animdemo_transitions_per_second"), TEXT("State machine transitions taken per second."), Published.TransitionsPerSecond);
+    AddGauge(TEXT("animdemo_montages_started_per_second"), TEXT("Dynamic montages started per second."), Published.MontagesStartedPerSecond);
+    AddGauge(TEXT("animdemo_dynamic_montages"), TEXT("Dynamic montages alive, the montage pool's size."), CountDynamicMontages());
+
+    AddGauge(TEXT("animdemo_gc_ms"), TEXT("Time spent in garbage collection during the window."), Published.GCMs);
+    AddGauge(TEXT("animdemo_gc_max_ms"), TEXT("Longest garbage collection during the window."), Published.MaxGCMs);
+    AddCounter(TEXT("animdemo_gc_total"), TEXT("Garbage collections since the endpoint started."), static_cast<double>(TotalGCs));
+    AddCounter(TEXT("animdemo_gc_seconds_total"), TEXT("Seconds spent in garbage collection since the endpoint started."), TotalGCSeconds);
+
+    AddHeader(TEXT("animdemo_stage_ms"), TEXT("gauge"), TEXT("Average time per frame in each ANIMDEMO_SCOPE_CYCLE_COUNTER scope, summed over threads."));
+    for (const FStageSample& Stage : Published.Stages)
+    {
+        Out += FString::Printf(TEXT("animdemo_stage_ms{stage=\"%s\"} %.6g\n"), Stage.Name, Stage.MsPerFrame);
+    }
+    AddHeader(TEXT("animdemo_stage_calls"), TEXT("gauge"), TEXT("Average calls per frame of each scope."));
+    for (const FStageSample& Stage : Published.Stages)
+    {
+        Out += FString::Printf(TEXT("animdemo_stage_calls{stage=\"%s\"} %.6g\n"), Stage.Name, Stage.CallsPerFrame);
+    }
+
+    AddGauge(TEXT("animdemo_uptime_seconds"), TEXT("Seconds since the endpoint started."), FPlatformTime::Seconds() - StartTime);
+    return Out;
+}
+
+FString UAnimDemoMetricsSubsystem::FormatJson() const
+{
+    FString Out = TEXT("{");
+    Out += FString::Printf(TEXT("\"window_seconds\":%.6g,\"frames\":%d,\"frames_total\":%lld,"), Published.Seconds, Published.NumFrames, TotalFrames);
+    Out += FString::Printf(TEXT("\"frame_time_ms\":%.6g,\"frame_time_max_ms\":%.6g,\"game_thread_ms\":%.6g,"),
+        Published.FrameMs, Published.MaxFrameMs, Published.GameThreadMs);
+
+    Out += TEXT("\"characters\":{");
+    const UEnum* StateEnum = StaticEnum<ECharacterAnimState>();
+    for (int32 State = 0; State < AnimDemoMetrics::NumStates; ++State)
+    {
+        Out += FString::Printf(TEXT("%s\"%s\":%u"), State > 0 ? TEXT(",") : TEXT(""), *StateEnum->GetNameStringByValue(State), CharactersInState[State]);
+    }
+    Out += TEXT("},");
+
+    Out += FString::Printf(TEXT("\"transitions_per_second\":%.6g,\"montages_started_per_second\":%.6g,\"dynamic_montages\":%d,"),
+        Published.TransitionsPerSecond, Published.MontagesStartedPerSecond, CountDynamicMontages());
+    Out += FString::Printf(TEXT("\"gc\":{\"ms\":%.6g,\"max_ms\":%.6g,\"count\":%d,\"total\":%lld,\"seconds_total\":%.6g},"),
+        Published.GCMs, Published.MaxGCMs, Published.NumGCs, TotalGCs, TotalGCSeconds);
+
+    Out += TEXT("\"stages\":{");
+    for (int32 Index = 0; Index < Published.Stages.Num(); ++Index)
+    {
+        const FStageSample& Stage = Published.Stages[Index];
+        Out += FString::Printf(TEXT("%s\"%s\":{\"ms\":%.6g,\"calls\":%.6g}"), Index > 0 ? TEXT(",") : TEXT(""), Stage.Name, Stage.MsPerFrame, Stage.CallsPerFrame);
+    }
+    Out += FString::Printf(TEXT("},\"uptime_seconds\":%.6g}"), FPlatformTime::Seconds() - StartTime);
+    return Out;
+}
+
+namespace AnimDemoMetricsCommands
+{
+    static UAnimDemoMetricsSubsystem* GetSubsystem(UWorld* World)
+    {
+        UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+        return GameInstance ? GameInstance->GetSubsystem<UAnimDemoMetricsSubsystem>() : nullptr;
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs StartCommand(
+        TEXT("AnimDemo.Metrics.Start"),
+        TEXT("AnimDemo.Metrics.Start <Port=9100> - serves live metrics on http://localhost:<Port>/metrics and /metrics.json."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (UAnimDemoMetricsSubsystem* Metrics = GetSubsystem(World))
+            {
+                Metrics->Start(Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 9100);
+            }
+        }));
+
+    static FAutoConsoleCommandWithWorld StopCommand(
+        TEXT("AnimDemo.Metrics.Stop"),
+        TEXT("Stops serving live metrics."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            if (UAnimDemoMetricsSubsystem* Metrics = GetSubsystem(World))
+            {
+                Metrics->Stop();
+            }
+        }));
+}
+
+#endif
@@ -0,0 +1,160 @@
+//
+//  AnimDemoPoseSearchBenchmark.cpp
+//
+//  Times pose search queries against databases of increasing size, KD-tree against a brute
+//  force SIMD scan:
+//
+//      AnimDemo.Bench.PoseSearch 65536
+//
+//  The databases are synthetic, built from random walking, running, turning and jumping
+//  trajectories with the same builder and feature layout as the real one, so sizes well
+//  beyond the project's animation set can be measured. The built database is measured too
+//  when one is present.
+//
+#include "AnimDemoBenchmarkUtils.h"
+#include "PoseSearchDatabase.h"
+#include "PoseSearchSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/Paths.h"
+
+using namespace AnimDemoPoseSearch;
+
+namespace AnimDemoPoseSearchBenchmark
+{
+    // Poses per synthetic source, one second at 30 Hz
+    static constexpr int32 PosesPerSource = 30;
+
+    // Raw features of a character moving at Speed along Heading while turning and accelerating
+    static void MakeTrajectory(FRandomStream& Random, float OutFeatures[NumFeatures])
+    {
+        const float Speed = Random.FRand() < 0.15f ? 0.f : Random.FRandRange(50.f, 600.f);
+        const float Heading = Random.FRandRange(-PI, PI);
+        const float TurnRate = FMath::DegreesToRadians(Random.FRandRange(-120.f, 120.f));
+        const float Acceleration = Random.FRandRange(-400.f, 400.f);
+
+        auto VelocityAt = [=](float Time)
+        {
+            const float SpeedAt = FMath::Max(0.f, Speed + Acceleration * Time);
+            const float HeadingAt = Heading + TurnRate * Time;
+            return FVector2f(FMath::Cos(HeadingAt), FMath::Sin(HeadingAt)) * SpeedAt;
+        };
+
+        const FVector2f Current = VelocityAt(0.f);
+        const FVector2f Past = VelocityAt(-PastVelocityTime);
+        OutFeatures[0] = Current.X;
+        OutFeatures[1] = Current.Y;
+        OutFeatures[2] = Past.X;
+        OutFeatures[3] = Past.Y;
+
+        static constexpr int32 Steps = 15;
+        for (int32 Future = 0; Future < UE_ARRAY_COUNT(FutureTimes); ++Future)
+        {
+            FVector2f Offset = FVector2f::ZeroVector;
+            const float Step = FutureTimes[Future] / Steps;
+            for (int32 Index = 0; Index < Steps; ++Index)
+            {
+                Offset += VelocityAt((Index + 0.5f) * Step) * Step;
+            }
+            OutFeatures[4 + Future * 2] = Offset.X;
+            OutFeatures[5 + Future * 2] = Offset.Y;
+        }
+
+        OutFeatures[10] = Random.FRand() < 0.1f ? Random.FRandRange(-500.f, 420.f) : 0.f;
+        OutFeatures[11] = 0.f;
+    }
+
+    static bool MakeDatabase(int32 NumPoses, FPoseSearchDatabase& OutDatabase)
+    {
+        FRandomStream Random(NumPoses);
+        FPoseSearchDatabaseBuilder Builder;
+        for (int32 Pose = 0; Pose < NumPoses; ++Pose)
+        {
+            if (Pose % PosesPerSource == 0)
+            {
+                Builder.AddSource(ECharacterAnimState::Locomotion, 0, 1.f, true);
+            }
+
+            float Features[NumFeatures];
+            MakeTrajectory(Random, Features);
+            Builder.AddPose(Pose / PosesPerSource, static_cast<float>(Pose % PosesPerSource) / PosesPerSource, Features);
+        }
+
+        float Weights[NumFeatures];
+        GetDefaultWeights(Weights);
+        return OutDatabase.InitFromMemory(Builder.Build(Weights, PosesPerSource));
+    }
+
+    static void Measure(const TCHAR* Name, const FPoseSearchDatabase& Database, int32 NumQueries)
+    {
+        FRandomStream Random(1234);
+        TArray<float> Queries;
+        Queries.SetNumUninitialized(NumQueries * NumFeatures);
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            float Raw[NumFeatures];
+            MakeTrajectory(Random, Raw);
+            Database.NormalizeQuery(Raw, &Queries[Query * NumFeatures]);
+        }
+
+        TArray<FPoseSearchResult> TreeResults;
+        TArray<FPoseSearchResult> BruteResults;
+        TreeResults.SetNumUninitialized(NumQueries);
+        BruteResults.SetNumUninitialized(NumQueries);
+
+        const uint64 TreeStart = FPlatformTime::Cycles64();
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            TreeResults[Query] = Database.Search(&Queries[Query * NumFeatures]);
+        }
+        const uint64 BruteStart = FPlatformTime::Cycles64();
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            BruteResults[Query] = Database.SearchBruteForce(&Queries[Query * NumFeatures]);
+        }
+        const uint64 End = FPlatformTime::Cycles64();
+
+        // The tree is exact; a different pose is only acceptable on a tie
+        int32 NumMismatches = 0;
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            if (!FMath::IsNearlyEqual(TreeResults[Query].Cost, BruteResults[Query].Cost, 1.e-4f))
+            {
+                ++NumMismatches;
+            }
+        }
+
+        const double TreeUs = FPlatformTime::ToMilliseconds64(BruteStart - TreeStart) * 1000.0 / NumQueries;
+        const double BruteUs = FPlatformTime::ToMilliseconds64(End - BruteStart) * 1000.0 / NumQueries;
+        UE_LOG(LogTemp, Display, TEXT("  %-10s %7d poses %9lld bytes  kd-tree %8.3f us/query  brute force %8.3f us/query  %d mismatches"),
+            Name, Database.GetNumPoses(), Database.GetSizeBytes(), TreeUs, BruteUs, NumMismatches);
+    }
+
+    static FAutoConsoleCommand PoseSearchCommand(
+        TEXT("AnimDemo.Bench.PoseSearch"),
+        TEXT("AnimDemo.Bench.PoseSearch <MaxPoses=65536> <Queries=10000> - times pose search queries against databases of increasing size."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const int32 MaxPoses = AnimDemoBenchmark::GetIntArg(Args, 0, 65536, PosesPerSource);
+            const int32 NumQueries = AnimDemoBenchmark::GetIntArg(Args, 1, 10000);
+
+            UE_LOG(LogTemp, Display, TEXT("PoseSearch benchmark: %d queries per database"), NumQueries);
+
+            const FString Path = UPoseSearchSubsystem::GetDefaultDatabasePath();
+            FPoseSearchDatabase Built;
+            if (FPaths::FileExists(Path) && Built.Load(Path))
+            {
+                Measure(TEXT("built"), Built, NumQueries);
+            }
+
+            for (int32 NumPoses = 1024; NumPoses <= MaxPoses; NumPoses *= 4)
+            {
+                FPoseSearchDatabase Synthetic;
+                if (MakeDatabase(NumPoses, Synthetic))
+                {
+                    Measure(TEXT("synthetic"), Synthetic, NumQueries);
+                }
+            }
+        }));
+}
@@ -0,0 +1,118 @@
+//
+//  AnimDemoScenarioBenchmark.cpp
+//
+//  Runs whatever is in the world for a number of frames, restores the crowd snapshot taken at
+//  the start and repeats, so one process measures many iterations of the same scenario, e.g.
+//
+//      UE_AnimDemoServer <CrowdMap> -log -ExecCmds="AnimDemo.Bench.ScenarioReset 120 200 quit"
+//
+#include "AnimDemoBenchmarkUtils.h"
+#include "CrowdSnapshotSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace AnimDemoScenarioBenchmark
+{
+    enum class EPhase : uint8
+    {
+        Capture,
+        Iterate,
+    };
+
+    struct FRun : AnimDemoBenchmark::TFrameRun<EPhase>
+    {
+        FCrowdSnapshot Snapshot;
+        int32 FramesPerIteration = 0;
+        int32 NumIterations = 0;
+        int32 Iteration = 0;
+        double IterationMs = 0.0;
+        double MinIterationMs = TNumericLimits<double>::Max();
+        double MaxIterationMs = 0.0;
+        double TotalIterationMs = 0.0;
+        double CaptureMs = 0.0;
+        double RestoreMs = 0.0;
+        double MaxRestoreMs = 0.0;
+        int32 NumMissing = 0;
+    };
+
+    static void Finish(FRun& Run)
+    {
+        const int32 NumActors = Run.Snapshot.GetNumCharacters() + Run.Snapshot.GetNumTestActors();
+        const double AverageRestoreMs = Run.NumIterations > 0 ? Run.RestoreMs / Run.NumIterations : 0.0;
+
+        UE_LOG(LogTemp, Display, TEXT("ScenarioReset benchmark: %d iterations of %d frames, %d characters, %d test actors, %lld byte snapshot"),
+            Run.NumIterations, Run.FramesPerIteration, Run.Snapshot.GetNumCharacters(), Run.Snapshot.GetNumTestActors(), Run.Snapshot.GetSizeBytes());
+        UE_LOG(LogTemp, Display, TEXT("  capture: %.3f ms"), Run.CaptureMs);
+        UE_LOG(LogTemp, Display, TEXT("  restore: %.3f ms avg, %.3f ms max, %.2f us per actor"),
+            AverageRestoreMs, Run.MaxRestoreMs, NumActors > 0 ? AverageRestoreMs * 1000.0 / NumActors : 0.0);
+        UE_LOG(LogTemp, Display, TEXT("  game thread per iteration: %.3f ms/frame avg, %.3f min, %.3f max"),
+            Run.TotalIterationMs / Run.NumIterations, Run.MinIterationMs, Run.MaxIterationMs);
+
+        if (Run.NumMissing > 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("  %d actors were destroyed during the run and could not be restored."), Run.NumMissing);
+        }
+    }
+
+    static bool Step(FRun& Run, UWorld& World)
+    {
+        UCrowdSnapshotSubsystem* Subsystem = World.GetSubsystem<UCrowdSnapshotSubsystem>();
+        if (!Subsystem)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ScenarioReset benchmark aborted: the world has no crowd snapshots."));
+            return false;
+        }
+
+        if (Run.Phase == EPhase::Capture)
+        {
+            const double StartTime = FPlatformTime::Seconds();
+            Subsystem->Capture(Run.Snapshot);
+            Run.CaptureMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+            Run.BeginPhase(EPhase::Iterate);
+            return true;
+        }
+
+        Run.IterationMs += AnimDemoBenchmark::GetGameThreadMs() / Run.FramesPerIteration;
+        if (Run.Frame < Run.FramesPerIteration)
+            return true;
+
+        Run.MinIterationMs = FMath::Min(Run.MinIterationMs, Run.IterationMs);
+        Run.MaxIterationMs = FMath::Max(Run.MaxIterationMs, Run.IterationMs);
+        Run.TotalIterationMs += Run.IterationMs;
+        Run.IterationMs = 0.0;
+        Run.BeginPhase(EPhase::Iterate);
+
+        const double StartTime = FPlatformTime::Seconds();
+        Run.NumMissing = FMath::Max(Run.NumMissing, Subsystem->Restore(Run.Snapshot));
+        const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+        Run.RestoreMs += ElapsedMs;
+        Run.MaxRestoreMs = FMath::Max(Run.MaxRestoreMs, ElapsedMs);
+
+        if (++Run.Iteration >= Run.NumIterations)
+        {
+            Finish(Run);
+            return false;
+        }
+        return true;
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs ScenarioResetCommand(
+        TEXT("AnimDemo.Bench.ScenarioReset"),
+        TEXT("AnimDemo.Bench.ScenarioReset <FramesPerIteration=120> <Iterations=100> [quit] - reruns the current scene from a crowd snapshot and reports restore cost and iteration spread."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World)
+            {
+                return;
+            }
+
+            TSharedRef<FRun> Run = MakeShared<FRun>();
+            Run->World = World;
+            Run->FramesPerIteration = AnimDemoBenchmark::GetIntArg(Args, 0, 120);
+            Run->NumIterations = AnimDemoBenchmark::GetIntArg(Args, 1, 100);
+            Run->bQuitWhenDone = AnimDemoBenchmark::HasFlag(Args, TEXT("quit"), 2);
+
+            AnimDemoBenchmark::StartFrameRun(TEXT("ScenarioReset"), Run, &Step);
+        }));
+}
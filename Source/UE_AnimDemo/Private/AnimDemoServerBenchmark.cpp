@@ -0,0 +1,128 @@
+//
+//  AnimDemoServerBenchmark.cpp
+//
+//  Headless server benchmark. Samples game-thread time without and then with a crowd of
+//  AAnimCppChar pawns and reports the difference per player, e.g.
+//
+//      UE_AnimDemoServer <Map> -log -ExecCmds="AnimDemo.Bench.ServerTick 500 300 quit"
+//
+//  With the bots option every pawn is driven by an AAnimDemoBotController, which walks, runs,
+//  idles and jumps through the pawn's Enhanced Input bindings like a player would.
+//
+#include "AnimCppChar.h"
+#include "AnimDemoBenchmarkUtils.h"
+#include "AnimDemoBotController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreGlobals.h"
+
+namespace AnimDemoServerBenchmark
+{
+    enum class EPhase : uint8
+    {
+        Baseline,
+        Warmup,
+        Loaded,
+    };
+
+    struct FRun : AnimDemoBenchmark::TFrameRun<EPhase>
+    {
+        TArray<TWeakObjectPtr<AAnimCppChar>> Spawned;
+        int32 NumPlayers = 0;
+        int32 NumFrames = 0;
+        int32 WarmupFrames = 30;
+        double BaselineMs = 0.0;
+        double LoadedMs = 0.0;
+        bool bBots = false;
+        FAnimDemoBotCounters BotCountersAtStart;
+    };
+
+    static void Finish(FRun& Run)
+    {
+        const int32 NumSpawned = Run.Spawned.Num();
+        AnimDemoBenchmark::DestroyCharacters(Run.Spawned);
+
+        const double PerPlayerUs = NumSpawned > 0 ? (Run.LoadedMs - Run.BaselineMs) * 1000.0 / NumSpawned : 0.0;
+
+        UE_LOG(LogTemp, Display, TEXT("ServerTick benchmark: %d players, %d frames, dedicated server=%s"),
+            NumSpawned, Run.NumFrames, IsRunningDedicatedServer() ? TEXT("true") : TEXT("false"));
+        UE_LOG(LogTemp, Display, TEXT("  baseline game thread: %.3f ms/frame"), Run.BaselineMs);
+        UE_LOG(LogTemp, Display, TEXT("  loaded game thread:   %.3f ms/frame"), Run.LoadedMs);
+        UE_LOG(LogTemp, Display, TEXT("  tick cost per player: %.2f us/frame"), PerPlayerUs);
+
+        if (Run.bBots && NumSpawned > 0)
+        {
+            const FAnimDemoBotCounters& Counters = AAnimDemoBotController::GetCounters();
+            const uint64 NumEvents = Counters.NumInputEvents - Run.BotCountersAtStart.NumInputEvents;
+            const double DispatchUs = FPlatformTime::ToSeconds64(Counters.DispatchCycles - Run.BotCountersAtStart.DispatchCycles) * 1.0e6;
+            const double NumPlayerFrames = static_cast<double>(NumSpawned) * Run.NumFrames;
+
+            UE_LOG(LogTemp, Display, TEXT("  bot input per player: %.2f events/frame, %.2f us/frame, %llu jump presses"),
+                NumEvents / NumPlayerFrames, DispatchUs / NumPlayerFrames,
+                Counters.NumJumpPresses - Run.BotCountersAtStart.NumJumpPresses);
+        }
+    }
+
+    static bool Step(FRun& Run, UWorld& World)
+    {
+        const double FrameMs = AnimDemoBenchmark::GetGameThreadMs();
+
+        switch (Run.Phase)
+        {
+        case EPhase::Baseline:
+            Run.BaselineMs += FrameMs / Run.NumFrames;
+            if (Run.Frame >= Run.NumFrames)
+            {
+                if (Run.bBots)
+                {
+                    AnimDemoBenchmark::SpawnBots(&World, Run.NumPlayers, Run.Spawned);
+                }
+                else
+                {
+                    AnimDemoBenchmark::SpawnCharacters(&World, Run.NumPlayers, Run.Spawned);
+                }
+                Run.BeginPhase(EPhase::Warmup);
+            }
+            break;
+
+        case EPhase::Warmup:
+            if (Run.Frame >= Run.WarmupFrames)
+            {
+                Run.BotCountersAtStart = AAnimDemoBotController::GetCounters();
+                Run.BeginPhase(EPhase::Loaded);
+            }
+            break;
+
+        case EPhase::Loaded:
+            Run.LoadedMs += FrameMs / Run.NumFrames;
+            if (Run.Frame >= Run.NumFrames)
+            {
+                Finish(Run);
+                return false;
+            }
+            break;
+        }
+        return true;
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs ServerTickCommand(
+        TEXT("AnimDemo.Bench.ServerTick"),
+        TEXT("AnimDemo.Bench.ServerTick <NumPlayers=100> <NumFrames=300> [quit] [bots] - spawns a crowd and reports game thread cost per player. bots drives them with scripted input."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World)
+            {
+                return;
+            }
+
+            TSharedRef<FRun> Run = MakeShared<FRun>();
+            Run->World = World;
+            Run->NumPlayers = AnimDemoBenchmark::GetIntArg(Args, 0, 100);
+            Run->NumFrames = AnimDemoBenchmark::GetIntArg(Args, 1, 300);
+            Run->bQuitWhenDone = AnimDemoBenchmark::HasFlag(Args, TEXT("quit"), 2);
+            Run->bBots = AnimDemoBenchmark::HasFlag(Args, TEXT("bots"), 2);
+
+            AnimDemoBenchmark::StartFrameRun(TEXT("ServerTick"), Run, &Step);
+        }));
+}
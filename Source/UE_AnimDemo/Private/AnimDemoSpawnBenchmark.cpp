@@ -0,0 +1,175 @@
+//
+//  AnimDemoSpawnBenchmark.cpp
+//
+//  Measures the hitch of a character wave spawned directly and through the actor pool:
+//
+//      AnimDemo.Bench.SpawnWave 100
+//
+//  The direct wave spawns every character in one frame, as the game did before pooling. The
+//  pooled wave first pre-warms the pool, then requests the same wave and lets the pool serve it
+//  within AnimDemo.Pool.SpawnBudgetMs. Each phase logs its worst frame against an idle baseline.
+//
+#include "AnimCppChar.h"
+#include "AnimDemoActorPoolSubsystem.h"
+#include "AnimDemoBenchmarkUtils.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace AnimDemoSpawnBenchmark
+{
+    // Frames the world runs between phases, so the previous phase's work has settled
+    static constexpr int32 SettleFrames = 30;
+
+    enum class EPhase : uint8
+    {
+        Baseline,
+        DirectWave,
+        Prewarm,
+        PooledWave,
+        Done
+    };
+
+    struct FRun : AnimDemoBenchmark::TFrameRun<EPhase>
+    {
+        int32 NumCharacters = 0;
+        double LastFrameTime = 0.0;
+        double MaxFrameMs = 0.0;
+
+        double BaselineMaxFrameMs = 0.0;
+        double DirectSpawnMs = 0.0;
+        double DirectMaxFrameMs = 0.0;
+        double PooledMaxFrameMs = 0.0;
+        int32 PooledFramesToServe = 0;
+        FAnimDemoSpawnTimings PooledTimings;
+
+        TArray<TWeakObjectPtr<AAnimCppChar>> Spawned;
+    };
+
+    static void BeginPhase(FRun& Run, EPhase Phase)
+    {
+        Run.BeginPhase(Phase);
+        Run.MaxFrameMs = 0.0;
+    }
+
+    static void ReleaseToPool(FRun& Run, UAnimDemoActorPoolSubsystem& Pool)
+    {
+        for (const TWeakObjectPtr<AAnimCppChar>& Character : Run.Spawned)
+        {
+            Pool.Release(Character.Get());
+        }
+        Run.Spawned.Reset();
+    }
+
+    static void LogResults(const FRun& Run)
+    {
+        const FAnimDemoSpawnTimings& Timings = Run.PooledTimings;
+        UE_LOG(LogTemp, Display, TEXT("SpawnWave benchmark: %d characters"), Run.NumCharacters);
+        UE_LOG(LogTemp, Display, TEXT("  baseline  worst frame %8.2f ms"), Run.BaselineMaxFrameMs);
+        UE_LOG(LogTemp, Display, TEXT("  direct    worst frame %8.2f ms, spawning took %.2f ms in one frame (%.3f ms/character)"),
+            Run.DirectMaxFrameMs, Run.DirectSpawnMs, Run.DirectSpawnMs / FMath::Max(1, Run.NumCharacters));
+        UE_LOG(LogTemp, Display, TEXT("  pooled    worst frame %8.2f ms, served over %d frames, at most %.2f ms per frame"),
+            Run.PooledMaxFrameMs, Run.PooledFramesToServe, Timings.MaxFrameMs);
+        UE_LOG(LogTemp, Display, TEXT("            %d reused (%.3f ms avg, %.3f ms max), %d spawned (%.3f ms avg, %.3f ms max)"),
+            Timings.NumReused, Timings.NumReused > 0 ? Timings.ReuseMs / Timings.NumReused : 0.0, Timings.MaxReuseMs,
+            Timings.NumSpawned, Timings.NumSpawned > 0 ? Timings.SpawnMs / Timings.NumSpawned : 0.0, Timings.MaxSpawnMs);
+    }
+
+    static bool Step(FRun& Run, UWorld& World)
+    {
+        UAnimDemoActorPoolSubsystem* Pool = World.GetSubsystem<UAnimDemoActorPoolSubsystem>();
+        check(Pool);
+
+        const double Now = FPlatformTime::Seconds();
+        Run.MaxFrameMs = FMath::Max(Run.MaxFrameMs, (Now - Run.LastFrameTime) * 1000.0);
+        Run.LastFrameTime = Now;
+
+        switch (Run.Phase)
+        {
+        case EPhase::Baseline:
+            if (Run.Frame < SettleFrames)
+                return true;
+
+            Run.BaselineMaxFrameMs = Run.MaxFrameMs;
+            BeginPhase(Run, EPhase::DirectWave);
+            {
+                const double SpawnStart = FPlatformTime::Seconds();
+                AnimDemoBenchmark::SpawnCharacters(&World, Run.NumCharacters, Run.Spawned);
+                Run.DirectSpawnMs = (FPlatformTime::Seconds() - SpawnStart) * 1000.0;
+            }
+            return true;
+
+        case EPhase::DirectWave:
+            if (Run.Frame < SettleFrames)
+                return true;
+
+            Run.DirectMaxFrameMs = Run.MaxFrameMs;
+            AnimDemoBenchmark::DestroyCharacters(Run.Spawned);
+            Pool->Prewarm(AnimDemoBenchmark::GetCharacterClass(&World), Run.NumCharacters);
+            BeginPhase(Run, EPhase::Prewarm);
+            return true;
+
+        case EPhase::Prewarm:
+            if (Pool->IsPrewarming() || Run.Frame < SettleFrames)
+                return true;
+
+            BeginPhase(Run, EPhase::PooledWave);
+            Pool->ResetTimings();
+            for (int32 Index = 0; Index < Run.NumCharacters; ++Index)
+            {
+                const FTransform Transform(AnimDemoBenchmark::GetGridLocation(Index, Run.NumCharacters));
+                Pool->RequestSpawn(AnimDemoBenchmark::GetCharacterClass(&World), Transform,
+                    FOnPooledActorSpawned::CreateLambda([&Run](AActor* Actor)
+                    {
+                        if (AAnimCppChar* Character = Cast<AAnimCppChar>(Actor))
+                        {
+                            if (!Character->GetController())
+                            {
+                                Character->SpawnDefaultController();
+                            }
+                            Run.Spawned.Add(Character);
+                        }
+                    }));
+            }
+            return true;
+
+        case EPhase::PooledWave:
+            if (Pool->GetNumPendingSpawns() > 0)
+            {
+                Run.PooledFramesToServe = Run.Frame;
+                return true;
+            }
+            if (Run.Frame < Run.PooledFramesToServe + SettleFrames)
+                return true;
+
+            Run.PooledMaxFrameMs = Run.MaxFrameMs;
+            Run.PooledTimings = Pool->GetTimings();
+            ReleaseToPool(Run, *Pool);
+            LogResults(Run);
+            BeginPhase(Run, EPhase::Done);
+            return false;
+
+        default:
+            return false;
+        }
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs SpawnWaveCommand(
+        TEXT("AnimDemo.Bench.SpawnWave"),
+        TEXT("AnimDemo.Bench.SpawnWave <NumCharacters=100> - compares the hitch of a character wave spawned directly and through the actor pool."),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (!World || !World->GetSubsystem<UAnimDemoActorPoolSubsystem>())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("AnimDemo.Bench.SpawnWave needs a game world"));
+                return;
+            }
+
+            TSharedRef<FRun> Run = MakeShared<FRun>();
+            Run->World = World;
+            Run->NumCharacters = AnimDemoBenchmark::GetIntArg(Args, 0, 100);
+            Run->LastFrameTime = FPlatformTime::Seconds();
+
+            AnimDemoBenchmark::StartFrameRun(TEXT("SpawnWave"), Run, &Step);
+        }));
+}
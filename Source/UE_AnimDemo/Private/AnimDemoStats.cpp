@@ -0,0 +1,127 @@
+//
+//  AnimDemoStats.cpp
+//
+#include "AnimDemoStats.h"
+
+DEFINE_STAT(STAT_AnimDemo_CharacterTick);
+DEFINE_STAT(STAT_AnimDemo_UpdateAnimationInputs);
+DEFINE_STAT(STAT_AnimDemo_StateMachineTick);
+DEFINE_STAT(STAT_AnimDemo_UpdateTransitions);
+DEFINE_STAT(STAT_AnimDemo_PlayAnimations);
+DEFINE_STAT(STAT_AnimDemo_CrowdGather);
+DEFINE_STAT(STAT_AnimDemo_CrowdHashBuild);
+DEFINE_STAT(STAT_AnimDemo_CrowdSeparation);
+DEFINE_STAT(STAT_AnimDemo_CrowdMove);
+DEFINE_STAT(STAT_AnimDemo_FootPlacementIssue);
+DEFINE_STAT(STAT_AnimDemo_FootPlacementSolve);
+DEFINE_STAT(STAT_AnimDemo_CameraBoomUpdate);
+DEFINE_STAT(STAT_AnimDemo_TransitionEventDrain);
+DEFINE_STAT(STAT_AnimDemo_PoseSearchQuery);
+DEFINE_STAT(STAT_AnimDemo_PoolTick);
+DEFINE_STAT(STAT_AnimDemo_BotInput);
+DEFINE_STAT(STAT_AnimDemo_HibernationCheck);
+DEFINE_STAT(STAT_AnimDemo_AnimLODUpdate);
+DEFINE_STAT(STAT_AnimDemo_AnimLODSwap);
+DEFINE_STAT(STAT_AnimDemo_CrowdPoseGather);
+DEFINE_STAT(STAT_AnimDemo_CrowdPoseSample);
+DEFINE_STAT(STAT_AnimDemo_CrowdPoseWriteBack);
+
+DEFINE_STAT(STAT_AnimDemo_NumStateMachines);
+DEFINE_STAT(STAT_AnimDemo_NumStateMachineDefinitions);
+DEFINE_STAT(STAT_AnimDemo_CrowdWalkers);
+DEFINE_STAT(STAT_AnimDemo_PoolPendingSpawns);
+DEFINE_STAT(STAT_AnimDemo_CharactersHibernated);
+DEFINE_STAT(STAT_AnimDemo_CharactersFullLOD);
+DEFINE_STAT(STAT_AnimDemo_CharactersLiteLOD);
+DEFINE_STAT(STAT_AnimDemo_CrowdPoseInstances);
+DEFINE_STAT(STAT_AnimDemo_CrowdPoseClips);
+DEFINE_STAT(STAT_AnimDemo_PoolHits);
+DEFINE_STAT(STAT_AnimDemo_PoolMisses);
+DEFINE_STAT(STAT_AnimDemo_TransitionsTaken);
+DEFINE_STAT(STAT_AnimDemo_TransitionEvents);
+DEFINE_STAT(STAT_AnimDemo_TransitionEventsDropped);
+DEFINE_STAT(STAT_AnimDemo_StateMachineSteps);
+DEFINE_STAT(STAT_AnimDemo_StateMachineStepsSaved);
+DEFINE_STAT(STAT_AnimDemo_BotInputEvents);
+DEFINE_STAT(STAT_AnimDemo_MontagesStarted);
+DEFINE_STAT(STAT_AnimDemo_HibernationWakes);
+DEFINE_STAT(STAT_AnimDemo_AnimLODSwaps);
+DEFINE_STAT(STAT_AnimDemo_FootTraces);
+DEFINE_STAT(STAT_AnimDemo_CameraSyncSweeps);
+DEFINE_STAT(STAT_AnimDemo_CameraAsyncSweeps);
+DEFINE_STAT(STAT_AnimDemo_CameraClipIncidents);
+DEFINE_STAT(STAT_AnimDemo_CharactersIdle);
+DEFINE_STAT(STAT_AnimDemo_CharactersLocomotion);
+DEFINE_STAT(STAT_AnimDemo_CharactersJump);
+DEFINE_STAT(STAT_AnimDemo_CharactersOther);
+
+CSV_DEFINE_CATEGORY_MODULE(UE_ANIMDEMO_API, AnimDemo, true);
+
+void AnimDemoStats::CountCharacterInState(ECharacterAnimState State)
+{
+    AnimDemoMetrics::CountCharactersInState(State);
+    
+    switch (State)
+    {
+    case ECharacterAnimState::Idle:
+        INC_DWORD_STAT(STAT_AnimDemo_CharactersIdle);
+        CSV_CUSTOM_STAT(AnimDemo, CharactersIdle, 1, ECsvCustomStatOp::Accumulate);
+        break;
+        
+    case ECharacterAnimState::Locomotion:
+        INC_DWORD_STAT(STAT_AnimDemo_CharactersLocomotion);
+        CSV_CUSTOM_STAT(AnimDemo, CharactersLocomotion, 1, ECsvCustomStatOp::Accumulate);
+        break;
+        
+    case ECharacterAnimState::Jump:
+        INC_DWORD_STAT(STAT_AnimDemo_CharactersJump);
+        CSV_CUSTOM_STAT(AnimDemo, CharactersJump, 1, ECsvCustomStatOp::Accumulate);
+        break;
+        
+    default:
+        INC_DWORD_STAT(STAT_AnimDemo_CharactersOther);
+        CSV_CUSTOM_STAT(AnimDemo, CharactersOther, 1, ECsvCustomStatOp::Accumulate);
+        break;
+    }
+}
+
+void AnimDemoStats::CountTransitionTaken()
+{
+    INC_DWORD_STAT(STAT_AnimDemo_TransitionsTaken);
+    AnimDemoMetrics::CountTransitionTaken();
+    CSV_CUSTOM_STAT(AnimDemo, TransitionsTaken, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void AnimDemoStats::CountStateMachineSteps(int32 NumSteps)
+{
+    INC_DWORD_STAT_BY(STAT_AnimDemo_StateMachineSteps, NumSteps);
+    CSV_CUSTOM_STAT(AnimDemo, StateMachineSteps, NumSteps, ECsvCustomStatOp::Accumulate);
+    
+    if (NumSteps == 0)
+    {
+        INC_DWORD_STAT(STAT_AnimDemo_StateMachineStepsSaved);
+        CSV_CUSTOM_STAT(AnimDemo, StateMachineTicksWithoutStep, 1, ECsvCustomStatOp::Accumulate);
+    }
+}
+
+void AnimDemoStats::CountMontageStarted()
+{
+    INC_DWORD_STAT(STAT_AnimDemo_MontagesStarted);
+    AnimDemoMetrics::CountMontageStarted();
+    CSV_CUSTOM_STAT(AnimDemo, MontagesStarted, 1, ECsvCustomStatOp::Accumulate);
+}
+
+void AnimDemoStats::CountHibernatedCharacters(int32 NumCharacters)
+{
+    SET_DWORD_STAT(STAT_AnimDemo_CharactersHibernated, NumCharacters);
+    INC_DWORD_STAT_BY(STAT_AnimDemo_CharactersIdle, NumCharacters);
+    AnimDemoMetrics::CountCharactersInState(ECharacterAnimState::Idle, NumCharacters);
+    CSV_CUSTOM_STAT(AnimDemo, CharactersHibernated, NumCharacters, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(AnimDemo, CharactersIdle, NumCharacters, ECsvCustomStatOp::Accumulate);
+}
+
+void AnimDemoStats::CountHibernationWake()
+{
+    INC_DWORD_STAT(STAT_AnimDemo_HibernationWakes);
+    CSV_CUSTOM_STAT(AnimDemo, HibernationWakes, 1, ECsvCustomStatOp::Accumulate);
+}
@@ -0,0 +1,66 @@
+//
+//  AnimDemoTrace.cpp
+//
+#include "AnimDemoTrace.h"
+
+#if ANIMDEMO_TRACE_ENABLED
+
+#include "Animation/AnimSequenceBase.h"
+
+UE_TRACE_CHANNEL_DEFINE(AnimDemoChannel)
+
+UE_TRACE_EVENT_BEGIN(AnimDemo, StateTransition)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint64, ConditionCycles)
+    UE_TRACE_EVENT_FIELD(uint32, ActorId)
+    UE_TRACE_EVENT_FIELD(float, Duration)
+    UE_TRACE_EVENT_FIELD(uint8, FromState)
+    UE_TRACE_EVENT_FIELD(uint8, ToState)
+    UE_TRACE_EVENT_FIELD(uint8, Kind)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(AnimDemo, PlayStateAnimation)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, ActorId)
+    UE_TRACE_EVENT_FIELD(uint32, AnimationId)
+    UE_TRACE_EVENT_FIELD(uint8, State)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(AnimDemo, MontageStarted)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, ActorId)
+    UE_TRACE_EVENT_FIELD(uint32, AnimationId)
+    UE_TRACE_EVENT_FIELD(uint8, State)
+UE_TRACE_EVENT_END()
+
+void FAnimDemoTrace::OutputTransition(uint32 ActorId, ECharacterAnimState From, ECharacterAnimState To, float Duration, uint64 ConditionCycles, EAnimDemoTransitionKind Kind)
+{
+    UE_TRACE_LOG(AnimDemo, StateTransition, AnimDemoChannel)
+        << StateTransition.Cycle(FPlatformTime::Cycles64())
+        << StateTransition.ConditionCycles(ConditionCycles)
+        << StateTransition.ActorId(ActorId)
+        << StateTransition.Duration(Duration)
+        << StateTransition.FromState(static_cast<uint8>(From))
+        << StateTransition.ToState(static_cast<uint8>(To))
+        << StateTransition.Kind(static_cast<uint8>(Kind));
+}
+
+void FAnimDemoTrace::OutputPlayStateAnimation(uint32 ActorId, ECharacterAnimState State, const UAnimSequenceBase* Animation)
+{
+    UE_TRACE_LOG(AnimDemo, PlayStateAnimation, AnimDemoChannel)
+        << PlayStateAnimation.Cycle(FPlatformTime::Cycles64())
+        << PlayStateAnimation.ActorId(ActorId)
+        << PlayStateAnimation.AnimationId(Animation ? Animation->GetUniqueID() : 0)
+        << PlayStateAnimation.State(static_cast<uint8>(State));
+}
+
+void FAnimDemoTrace::OutputMontageStarted(uint32 ActorId, ECharacterAnimState State, const UAnimSequenceBase* Animation)
+{
+    UE_TRACE_LOG(AnimDemo, MontageStarted, AnimDemoChannel)
+        << MontageStarted.Cycle(FPlatformTime::Cycles64())
+        << MontageStarted.ActorId(ActorId)
+        << MontageStarted.AnimationId(Animation ? Animation->GetUniqueID() : 0)
+        << MontageStarted.State(static_cast<uint8>(State));
+}
+
+#endif // ANIMDEMO_TRACE_ENABLED
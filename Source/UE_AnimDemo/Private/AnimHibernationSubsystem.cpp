@@ -0,0 +1,111 @@
+//
+//  AnimHibernationSubsystem.cpp
+//
+#include "AnimHibernationSubsystem.h"
+#include "AnimCppChar.h"
+#include "AnimationStateMachine.h"
+#include "LocomotionSnapshot.h"
+#include "AnimDemoStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarHibernateIdleSeconds(
+    TEXT("AnimDemo.Hibernate.IdleSeconds"),
+    3.f,
+    TEXT("Seconds an AAnimCppChar has to stand still without input before its tick, state machine and anim update are suspended.\n")
+    TEXT("0 disables hibernation and wakes every hibernated character."));
+
+static TAutoConsoleVariable<float> CVarHibernateIdleLoopHz(
+    TEXT("AnimDemo.Hibernate.IdleLoopHz"),
+    0.f,
+    TEXT("Rate in Hz the mesh of a hibernated character keeps playing its idle loop at. 0 freezes the last evaluated pose.\n")
+    TEXT("Takes effect for characters that hibernate after it is set."));
+
+float UAnimHibernationSubsystem::GetIdleSeconds()
+{
+    return FMath::Max(0.f, CVarHibernateIdleSeconds.GetValueOnGameThread());
+}
+
+float UAnimHibernationSubsystem::GetIdleLoopHz()
+{
+    return FMath::Max(0.f, CVarHibernateIdleLoopHz.GetValueOnGameThread());
+}
+
+bool UAnimHibernationSubsystem::IsSettledIdle(const FLocomotionSnapshot& Locomotion, const UAnimationStateMachine* Machine)
+{
+    return Locomotion.bIsMovingOnGround
+        && Locomotion.Velocity.IsNearlyZero(1.f)
+        && (!Machine || (Machine->GetCurrentState() == ECharacterAnimState::Idle && Machine->GetTransitionAlpha() >= 1.f));
+}
+
+bool UAnimHibernationSubsystem::UpdateStableIdleTime(float& StableIdleTime, bool bStableIdle, float DeltaTime, float IdleSeconds)
+{
+    bStableIdle = bStableIdle && IdleSeconds > 0.f;
+    StableIdleTime = bStableIdle ? StableIdleTime + DeltaTime : 0.f;
+    return bStableIdle && StableIdleTime >= IdleSeconds;
+}
+
+void UAnimHibernationSubsystem::Deinitialize()
+{
+    Hibernating.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UAnimHibernationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UAnimHibernationSubsystem, STATGROUP_Tickables);
+}
+
+void UAnimHibernationSubsystem::Register(AAnimCppChar* Character)
+{
+    if (Character)
+    {
+        Hibernating.AddUnique(Character);
+    }
+}
+
+void UAnimHibernationSubsystem::Unregister(AAnimCppChar* Character)
+{
+    Hibernating.RemoveSingleSwap(Character, EAllowShrinking::No);
+}
+
+void UAnimHibernationSubsystem::WakeAll()
+{
+    // Waking unregisters, so work on a copy
+    const TArray<TWeakObjectPtr<AAnimCppChar>> Characters = Hibernating;
+    for (const TWeakObjectPtr<AAnimCppChar>& Character : Characters)
+    {
+        if (Character.IsValid())
+        {
+            Character->WakeFromHibernation();
+        }
+    }
+    Hibernating.Reset();
+}
+
+void UAnimHibernationSubsystem::Tick(float DeltaTime)
+{
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(HibernationCheck);
+
+    if (GetIdleSeconds() <= 0.f && Hibernating.Num() > 0)
+    {
+        WakeAll();
+    }
+
+    for (int32 Index = Hibernating.Num() - 1; Index >= 0; --Index)
+    {
+        AAnimCppChar* Character = Hibernating[Index].Get();
+        if (!Character)
+        {
+            Hibernating.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        }
+        else if (Character->ShouldWakeFromHibernation())
+        {
+            // Unregisters the character, which only swaps in an entry already visited
+            Character->WakeFromHibernation();
+        }
+    }
+
+    AnimDemoStats::CountHibernatedCharacters(Hibernating.Num());
+}
@@ -0,0 +1,152 @@
+//
+//  AnimLODSubsystem.cpp
+//
+#include "AnimLODSubsystem.h"
+#include "AnimCppChar.h"
+#include "AnimDemoStats.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<float> CVarAnimLODLiteDistance(
+    TEXT("AnimDemo.AnimLOD.LiteDistance"),
+    4000.f,
+    TEXT("AAnimCppChar further than this from every local player's camera use the lite native anim instance. 0 keeps every character at full fidelity."));
+
+static TAutoConsoleVariable<float> CVarAnimLODHysteresis(
+    TEXT("AnimDemo.AnimLOD.Hysteresis"),
+    500.f,
+    TEXT("A lite character goes back to full fidelity only once it is this much closer than AnimDemo.AnimLOD.LiteDistance."));
+
+static TAutoConsoleVariable<int32> CVarAnimLODSwapsPerFrame(
+    TEXT("AnimDemo.AnimLOD.SwapsPerFrame"),
+    8,
+    TEXT("Most anim instance swaps per frame; each re-creates the mesh's anim instance."));
+
+static TAutoConsoleVariable<int32> CVarAnimLODForce(
+    TEXT("AnimDemo.AnimLOD.Force"),
+    -1,
+    TEXT("-1 picks the anim LOD by distance, 0 forces full fidelity and 1 the lite anim instance on every character."));
+
+bool UAnimLODSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Dedicated servers never animate the mesh
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UAnimLODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UAnimLODSubsystem::Deinitialize()
+{
+    Characters.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UAnimLODSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UAnimLODSubsystem, STATGROUP_Tickables);
+}
+
+void UAnimLODSubsystem::Register(AAnimCppChar* Character)
+{
+    if (Character)
+    {
+        Characters.AddUnique(Character);
+    }
+}
+
+void UAnimLODSubsystem::Unregister(AAnimCppChar* Character)
+{
+    Characters.RemoveSingleSwap(Character, EAllowShrinking::No);
+}
+
+void UAnimLODSubsystem::Tick(float DeltaTime)
+{
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(AnimLODUpdate);
+
+    Characters.RemoveAllSwap([](const TWeakObjectPtr<AAnimCppChar>& Character) { return !Character.IsValid(); }, EAllowShrinking::No);
+
+    TArray<FVector, TInlineAllocator<4>> ViewLocations;
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PC = It->Get();
+        if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+        {
+            ViewLocations.Add(PC->PlayerCameraManager->GetCameraLocation());
+        }
+    }
+
+    const int32 Force = CVarAnimLODForce.GetValueOnGameThread();
+    const float LiteDistance = CVarAnimLODLiteDistance.GetValueOnGameThread();
+    const float FullDistance = FMath::Max(0.f, LiteDistance - CVarAnimLODHysteresis.GetValueOnGameThread());
+
+    ToFull.Reset();
+    ToLite.Reset();
+    NumCharacters[0] = NumCharacters[1] = 0;
+
+    for (const TWeakObjectPtr<AAnimCppChar>& CharacterPtr : Characters)
+    {
+        AAnimCppChar* Character = CharacterPtr.Get();
+        const EAnimDemoAnimLOD LOD = Character->GetAnimLOD();
+        ++NumCharacters[static_cast<int32>(LOD)];
+
+        // A hibernated mesh does not tick, a new anim instance would show the reference pose
+        if (Character->IsHibernating())
+            continue;
+
+        EAnimDemoAnimLOD Wanted = EAnimDemoAnimLOD::Full;
+        if (Force >= 0)
+        {
+            Wanted = Force > 0 ? EAnimDemoAnimLOD::Lite : EAnimDemoAnimLOD::Full;
+        }
+        else if (LiteDistance > 0.f && ViewLocations.Num() > 0)
+        {
+            float ClosestDistSq = TNumericLimits<float>::Max();
+            for (const FVector& ViewLocation : ViewLocations)
+            {
+                ClosestDistSq = FMath::Min(ClosestDistSq, static_cast<float>(FVector::DistSquared(ViewLocation, Character->GetActorLocation())));
+            }
+
+            const float Distance = LOD == EAnimDemoAnimLOD::Lite ? FullDistance : LiteDistance;
+            Wanted = ClosestDistSq > FMath::Square(Distance) ? EAnimDemoAnimLOD::Lite : EAnimDemoAnimLOD::Full;
+        }
+
+        if (Wanted != LOD)
+        {
+            (Wanted == EAnimDemoAnimLOD::Full ? ToFull : ToLite).Add(Character);
+        }
+    }
+
+    const int32 SwapsPerFrame = FMath::Max(1, CVarAnimLODSwapsPerFrame.GetValueOnGameThread());
+    int32 Budget = SwapsPerFrame;
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    auto Swap = [this, &Budget](TConstArrayView<AAnimCppChar*> Swaps, EAnimDemoAnimLOD LOD)
+    {
+        for (int32 Index = 0; Index < Swaps.Num() && Budget > 0; ++Index, --Budget)
+        {
+            AAnimCppChar* Character = Swaps[Index];
+            const EAnimDemoAnimLOD PreviousLOD = Character->GetAnimLOD();
+            Character->SetAnimLOD(LOD);
+            --NumCharacters[static_cast<int32>(PreviousLOD)];
+            ++NumCharacters[static_cast<int32>(Character->GetAnimLOD())];
+            ++NumSwaps;
+            INC_DWORD_STAT(STAT_AnimDemo_AnimLODSwaps);
+        }
+    };
+    Swap(ToFull, EAnimDemoAnimLOD::Full);
+    Swap(ToLite, EAnimDemoAnimLOD::Lite);
+
+    SwapCycles += FPlatformTime::Cycles64() - StartCycles;
+    NumPendingSwaps = ToFull.Num() + ToLite.Num() - (SwapsPerFrame - Budget);
+
+    SET_DWORD_STAT(STAT_AnimDemo_CharactersFullLOD, NumCharacters[static_cast<int32>(EAnimDemoAnimLOD::Full)]);
+    SET_DWORD_STAT(STAT_AnimDemo_CharactersLiteLOD, NumCharacters[static_cast<int32>(EAnimDemoAnimLOD::Lite)]);
+    CSV_CUSTOM_STAT(AnimDemo, CharactersFullLOD, NumCharacters[static_cast<int32>(EAnimDemoAnimLOD::Full)], ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(AnimDemo, CharactersLiteLOD, NumCharacters[static_cast<int32>(EAnimDemoAnimLOD::Lite)], ECsvCustomStatOp::Set);
+}
@@ -0,0 +1,572 @@
+//
+//  AnimSimSweepCommandlet.cpp
+//
+#include "AnimSimSweepCommandlet.h"
+#include "AnimCppChar.h"
+#include "AnimDemoBenchmarkUtils.h"
+#include "AnimDemoBotController.h"
+#include "AnimDemoGameMode.h"
+#include "AnimationStateMachine.h"
+#include "LocomotionSnapshot.h"
+#include "Async/ParallelFor.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace AnimSimSweep
+{
+    constexpr int32 NumStates = static_cast<int32>(ECharacterAnimState::None) + 1;
+
+    // UCharacterMovementComponent defaults for a walking character
+    static constexpr float MaxWalkSpeed = 600.f;
+    static constexpr float MaxAcceleration = 2048.f;
+    static constexpr float BrakingDeceleration = 2048.f;
+
+    // A transition back to the state just left within this many seconds counts as a flicker
+    static constexpr float FlickerSeconds = 0.5f;
+
+    // Half the side of the floor every world's crowd walks on, far beyond where a bot gets to
+    static constexpr float FloorHalfExtent = 500000.f;
+
+    struct FResult
+    {
+        int64 Frames = 0;
+        int64 Transitions = 0;
+        int64 Flickers = 0;
+        double StateSeconds[NumStates] = {};
+        uint64 Cycles = 0;
+    };
+
+    struct FCharacter
+    {
+        // World mode: the spawned character, Machine is its state machine
+        TWeakObjectPtr<AAnimCppChar> Actor;
+        FLocomotionSnapshot Snapshot;
+        UAnimationStateMachine* Machine = nullptr;
+        FRandomStream Random;
+        float StickInput = 0.f;
+        float StepTime = 0.f;
+        float StepDuration = 0.f;
+        float Speed = 0.f;
+        float TimeInState = 0.f;
+        ECharacterAnimState LastFrom = ECharacterAnimState::None;
+    };
+
+    struct FSimulation
+    {
+        FLocomotionTuning Tuning;
+        int32 Seed = 0;
+        UWorld* World = nullptr;
+        TArray<FCharacter> Characters;
+        FResult Result;
+    };
+
+    struct FOptions
+    {
+        TArray<float> IdleSpeeds = { 10.f };
+        TArray<float> RunSpeeds = { 300.f };
+        TArray<float> Blends = { 0.25f };
+        int32 Seeds = 1;
+        int32 FirstSeed = 0;
+        int32 NumCharacters = 0;
+        int32 Jobs = 0;
+        bool bFast = false;
+        bool bInProcess = false;
+        float Seconds = 60.f;
+        float TickHz = 60.f;
+        float FixedStepHz = 0.f;
+        FString Report;
+    };
+
+    static void ParseList(const FString& Params, const TCHAR* Key, float Min, TArray<float>& OutValues)
+    {
+        FString List;
+        if (!FParse::Value(*Params, Key, List))
+            return;
+
+        TArray<FString> Items;
+        List.ParseIntoArray(Items, TEXT(","));
+
+        OutValues.Reset();
+        for (const FString& Item : Items)
+        {
+            OutValues.AddUnique(FMath::Max(FCString::Atof(*Item), Min));
+        }
+    }
+
+    // Idle a quarter of the time, otherwise hold the stick at a random deflection, so speeds
+    // land on both sides of every threshold
+    static void NextStep(FCharacter& Character)
+    {
+        Character.StepTime = 0.f;
+        Character.StepDuration = Character.Random.FRandRange(1.f, 5.f);
+        Character.StickInput = Character.Random.FRand() < 0.25f ? 0.f : Character.Random.FRandRange(0.1f, 1.f);
+    }
+
+    // Fast mode: a kinematic stand-in for the character movement feeds the machine directly
+    static void Step(FCharacter& Character, FResult& Result, float DeltaTime)
+    {
+        Character.StepTime += DeltaTime;
+        if (Character.StepTime >= Character.StepDuration)
+        {
+            NextStep(Character);
+        }
+
+        // Accelerate towards the analog target speed, brake when above it
+        const float TargetSpeed = Character.StickInput * MaxWalkSpeed;
+        const float Rate = TargetSpeed > Character.Speed ? MaxAcceleration : BrakingDeceleration;
+        Character.Speed = FMath::FInterpConstantTo(Character.Speed, TargetSpeed, DeltaTime, Rate);
+
+        Character.Snapshot.Velocity = FVector(Character.Speed, 0.f, 0.f);
+        Character.Snapshot.bIsFalling = false;
+        Character.Snapshot.bIsMovingOnGround = true;
+
+        Character.TimeInState += DeltaTime;
+        Character.Machine->Tick(DeltaTime);
+        Result.StateSeconds[static_cast<int32>(Character.Machine->GetCurrentState())] += DeltaTime;
+    }
+
+    static void Run(FSimulation& Simulation, int32 NumFrames, float DeltaTime)
+    {
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            for (FCharacter& Character : Simulation.Characters)
+            {
+                Step(Character, Simulation.Result, DeltaTime);
+            }
+        }
+
+        Simulation.Result.Frames = NumFrames;
+        Simulation.Result.Cycles = FPlatformTime::Cycles64() - StartCycles;
+    }
+    static void BindTransitions(FCharacter& Character, FResult& Result)
+    {
+        FCharacter* CharacterPtr = &Character;
+        FResult* ResultPtr = &Result;
+        Character.Machine->OnTransition().AddLambda([CharacterPtr, ResultPtr](ECharacterAnimState From, ECharacterAnimState To, float)
+        {
+            ++ResultPtr->Transitions;
+            if (To == CharacterPtr->LastFrom && CharacterPtr->TimeInState < FlickerSeconds)
+            {
+                ++ResultPtr->Flickers;
+            }
+            CharacterPtr->LastFrom = From;
+            CharacterPtr->TimeInState = 0.f;
+        });
+    }
+
+    // The default game mode's pawn, so the Blueprint's input actions and animation assets are
+    // assigned; the world has no game mode of its own to ask
+    static UClass* GetPawnClass()
+    {
+        const AAnimDemoGameMode* GameMode = GetDefault<AAnimDemoGameMode>();
+        if (GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(AAnimCppChar::StaticClass()))
+        {
+            return GameMode->DefaultPawnClass;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("No AAnimCppChar Blueprint pawn in AAnimDemoGameMode, bots have no input actions and will stand still."));
+        return AAnimCppChar::StaticClass();
+    }
+
+    // An empty game world with a floor, begun without a game mode
+    static UWorld* CreateWorld(int32 Index)
+    {
+        UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, *FString::Printf(TEXT("AnimSimSweep_%d"), Index));
+        FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+        Context.SetCurrentWorld(World);
+
+        World->InitializeActorsForPlay(FURL());
+        World->BeginPlay();
+        if (!World->HasBegunPlay())
+        {
+            World->GetWorldSettings()->NotifyBeginPlay();
+        }
+
+        AActor* Floor = World->SpawnActor<AActor>();
+        UBoxComponent* Box = NewObject<UBoxComponent>(Floor, TEXT("Floor"));
+        Box->SetBoxExtent(FVector(FloorHalfExtent, FloorHalfExtent, 50.f));
+        Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+        Floor->SetRootComponent(Box);
+        Box->RegisterComponent();
+        Floor->SetActorLocation(FVector(0.f, 0.f, -50.f));
+
+        return World;
+    }
+
+    static void DestroyWorld(UWorld* World)
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+    }
+
+    // Characters of the sweep's tuning, each driven by a bot seeded like the fast mode's stick input
+    static void SpawnCrowd(FSimulation& Simulation, UClass* PawnClass, int32 NumCharacters, float FixedStepHz)
+    {
+        UWorld* World = Simulation.World;
+
+        FActorSpawnParameters Params;
+        Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+        Simulation.Characters.SetNum(NumCharacters);
+        for (int32 Index = 0; Index < NumCharacters; ++Index)
+        {
+            const FTransform Transform(AnimDemoBenchmark::GetGridLocation(Index, NumCharacters));
+
+            // Deferred so BeginPlay builds the machine from this simulation's tuning
+            AAnimCppChar* Actor = World->SpawnActorDeferred<AAnimCppChar>(PawnClass, Transform, nullptr, nullptr, Params.SpawnCollisionHandlingOverride);
+            if (!Actor)
+                continue;
+
+            Actor->LocomotionTuning = Simulation.Tuning;
+            Actor->FinishSpawning(Transform);
+
+            if (AAnimDemoBotController* Bot = World->SpawnActor<AAnimDemoBotController>(Transform.GetLocation(), FRotator::ZeroRotator, Params))
+            {
+                Bot->Possess(Actor);
+                Bot->Restart(HashCombine(GetTypeHash(Simulation.Seed), GetTypeHash(Index)));
+            }
+
+            FCharacter& Character = Simulation.Characters[Index];
+            Character.Actor = Actor;
+            Character.Machine = Actor->GetAnimStateMachine();
+            if (Character.Machine)
+            {
+                Character.Machine->SetFixedStepRate(FixedStepHz);
+                BindTransitions(Character, Simulation.Result);
+            }
+        }
+    }
+
+    // One frame of a world: movement, bots, anim and the state machines all tick as in game
+    static void TickWorld(FSimulation& Simulation, float DeltaTime)
+    {
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+
+        for (FCharacter& Character : Simulation.Characters)
+        {
+            Character.TimeInState += DeltaTime;
+        }
+
+        Simulation.World->Tick(LEVELTICK_All, DeltaTime);
+
+        for (FCharacter& Character : Simulation.Characters)
+        {
+            if (const AAnimCppChar* Actor = Character.Actor.Get())
+            {
+                if (const UAnimationStateMachine* Machine = Actor->GetAnimStateMachine())
+                {
+                    Simulation.Result.StateSeconds[static_cast<int32>(Machine->GetCurrentState())] += DeltaTime;
+                }
+            }
+        }
+
+        ++Simulation.Result.Frames;
+        Simulation.Result.Cycles += FPlatformTime::Cycles64() - StartCycles;
+    }
+    // World mode runs every simulation in a child process of its own, since worlds only tick on
+    // their process's game thread. The child is this commandlet with -InProcess and one
+    // combination of values, and reports through a CSV of one row.
+    static FProcHandle LaunchChild(const FSimulation& Simulation, const FOptions& Options, const FString& ReportPath)
+    {
+        const FString Args = FString::Printf(
+            TEXT("\"%s\" -run=AnimSimSweep -InProcess -IdleSpeed=%g -RunSpeed=%g -Blend=%g -FirstSeed=%d -Seeds=1")
+            TEXT(" -Characters=%d -Seconds=%g -TickHz=%g -FixedStepHz=%g -Report=\"%s\" -unattended -nullrhi -nosplash -nopause"),
+            *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()),
+            Simulation.Tuning.IdleSpeed, Simulation.Tuning.RunSpeed, Simulation.Tuning.IdleToLocomotionBlend, Simulation.Seed,
+            Options.NumCharacters, Options.Seconds, Options.TickHz, Options.FixedStepHz, *ReportPath);
+
+        return FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Args, false, true, true, nullptr, 0, nullptr, nullptr);
+    }
+
+    // Reads back the row a child wrote, in the column order of the report below
+    static bool ReadChildResult(const FString& ReportPath, int32 NumCharacters, float DeltaTime, FResult& OutResult)
+    {
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *ReportPath) || Lines.Num() < 2)
+            return false;
+
+        TArray<FString> Columns;
+        Lines[1].ParseIntoArray(Columns, TEXT(","));
+        if (Columns.Num() < 15)
+            return false;
+
+        OutResult.Frames = FCString::Atoi64(*Columns[6]);
+        OutResult.Transitions = FCString::Atoi64(*Columns[7]);
+        OutResult.Flickers = FCString::Atoi64(*Columns[9]);
+
+        const double CharacterSeconds = NumCharacters * OutResult.Frames * DeltaTime;
+        OutResult.StateSeconds[static_cast<int32>(ECharacterAnimState::Idle)] = FCString::Atod(*Columns[10]) * CharacterSeconds;
+        OutResult.StateSeconds[static_cast<int32>(ECharacterAnimState::Locomotion)] = FCString::Atod(*Columns[11]) * CharacterSeconds;
+        OutResult.StateSeconds[static_cast<int32>(ECharacterAnimState::Jump)] = FCString::Atod(*Columns[12]) * CharacterSeconds;
+        OutResult.Cycles = static_cast<uint64>(FCString::Atod(*Columns[13]) / 1000.0 / FPlatformTime::GetSecondsPerCycle64());
+        return true;
+    }
+
+    // Runs the simulations in child processes, at most Options.Jobs at a time; false if any failed
+    static bool RunChildren(TArray<FSimulation>& Simulations, const FOptions& Options, float DeltaTime)
+    {
+        struct FChild
+        {
+            FProcHandle Process;
+            FString ReportPath;
+        };
+        TArray<FChild> Children;
+        Children.SetNum(Simulations.Num());
+
+        int32 NextToLaunch = 0;
+        int32 NumRunning = 0;
+        int32 NumFailed = 0;
+        while (NextToLaunch < Simulations.Num() || NumRunning > 0)
+        {
+            while (NextToLaunch < Simulations.Num() && NumRunning < Options.Jobs)
+            {
+                FChild& Child = Children[NextToLaunch];
+                Child.ReportPath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("AnimSimSweep"), TEXT(".csv"));
+                Child.Process = LaunchChild(Simulations[NextToLaunch], Options, Child.ReportPath);
+                if (Child.Process.IsValid())
+                {
+                    ++NumRunning;
+                }
+                else
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Could not launch the child for simulation %d."), NextToLaunch);
+                    ++NumFailed;
+                }
+                ++NextToLaunch;
+            }
+
+            for (int32 Index = 0; Index < NextToLaunch; ++Index)
+            {
+                FChild& Child = Children[Index];
+                if (!Child.Process.IsValid() || FPlatformProcess::IsProcRunning(Child.Process))
+                    continue;
+
+                int32 ReturnCode = -1;
+                FPlatformProcess::GetProcReturnCode(Child.Process, &ReturnCode);
+                FPlatformProcess::CloseProc(Child.Process);
+                --NumRunning;
+
+                if (ReturnCode != 0 || !ReadChildResult(Child.ReportPath, Options.NumCharacters, DeltaTime, Simulations[Index].Result))
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Simulation %d failed (exit code %d), see its log."), Index, ReturnCode);
+                    ++NumFailed;
+                }
+                IFileManager::Get().Delete(*Child.ReportPath);
+            }
+
+            FPlatformProcess::Sleep(0.05f);
+        }
+
+        return NumFailed == 0;
+    }
+}
+
+UAnimSimSweepCommandlet::UAnimSimSweepCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UAnimSimSweepCommandlet::Main(const FString& Params)
+{
+    using namespace AnimSimSweep;
+
+    FOptions Options;
+    ParseList(Params, TEXT("IdleSpeed="), 0.f, Options.IdleSpeeds);
+    ParseList(Params, TEXT("RunSpeed="), 0.f, Options.RunSpeeds);
+    ParseList(Params, TEXT("Blend="), 0.f, Options.Blends);
+    FParse::Value(*Params, TEXT("Seeds="), Options.Seeds);
+    FParse::Value(*Params, TEXT("FirstSeed="), Options.FirstSeed);
+    FParse::Value(*Params, TEXT("Jobs="), Options.Jobs);
+    FParse::Value(*Params, TEXT("Characters="), Options.NumCharacters);
+    FParse::Value(*Params, TEXT("Seconds="), Options.Seconds);
+    FParse::Value(*Params, TEXT("TickHz="), Options.TickHz);
+    FParse::Value(*Params, TEXT("FixedStepHz="), Options.FixedStepHz);
+    FParse::Value(*Params, TEXT("Report="), Options.Report);
+    Options.bFast = FParse::Param(*Params, TEXT("Fast"));
+    Options.bInProcess = FParse::Param(*Params, TEXT("InProcess"));
+    Options.Jobs = Options.Jobs > 0 ? Options.Jobs : FMath::Max(1, FPlatformMisc::NumberOfCores() / 2);
+    Options.Seeds = FMath::Max(1, Options.Seeds);
+    // Full characters cost far more per frame than bare machines
+    Options.NumCharacters = Options.NumCharacters > 0 ? Options.NumCharacters : Options.bFast ? 500 : 50;
+    Options.TickHz = FMath::Max(1.f, Options.TickHz);
+
+    const float DeltaTime = 1.f / Options.TickHz;
+    const int32 NumFrames = FMath::Max(1, FMath::RoundToInt(Options.Seconds * Options.TickHz));
+
+    TArray<FSimulation> Simulations;
+    for (const float IdleSpeed : Options.IdleSpeeds)
+    {
+        for (const float RunSpeed : Options.RunSpeeds)
+        {
+            for (const float Blend : Options.Blends)
+            {
+                for (int32 Seed = Options.FirstSeed; Seed < Options.FirstSeed + Options.Seeds; ++Seed)
+                {
+                    FSimulation& Simulation = Simulations.AddDefaulted_GetRef();
+                    Simulation.Tuning.IdleSpeed = IdleSpeed;
+                    Simulation.Tuning.RunSpeed = RunSpeed;
+                    Simulation.Tuning.IdleToLocomotionBlend = Blend;
+                    Simulation.Tuning.LocomotionToIdleBlend = Blend;
+                    Simulation.Seed = Seed;
+                }
+            }
+        }
+    }
+
+    double WallSeconds = 0.0;
+    bool bSucceeded = true;
+    if (Options.bFast)
+    {
+        // Machines are created up front on the game thread; the parallel part only ticks
+        // logic-only machines and touches no UObject globals. Bound after the arrays stop
+        // growing so the captured pointers stay valid.
+        for (FSimulation& Simulation : Simulations)
+        {
+            // Every character of a simulation shares its definition
+            FLocomotionArchetype Archetype;
+            Archetype.Tuning = Simulation.Tuning;
+            const TSharedRef<const FAnimStateMachineDefinition> Definition = AnimDemoLocomotion::GetDefinition(Archetype);
+            
+            Simulation.Characters.SetNum(Options.NumCharacters);
+            for (int32 Index = 0; Index < Simulation.Characters.Num(); ++Index)
+            {
+                FCharacter& Character = Simulation.Characters[Index];
+                Character.Random.Initialize(HashCombine(GetTypeHash(Simulation.Seed), GetTypeHash(Index)));
+                NextStep(Character);
+
+                Character.Machine = UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), Definition, &Character.Snapshot);
+                Character.Machine->AddToRoot();
+                Character.Machine->SetFixedStepRate(Options.FixedStepHz);
+                BindTransitions(Character, Simulation.Result);
+            }
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("Running %d world-less simulations of %d characters for %d frames at %.0f Hz..."),
+            Simulations.Num(), Options.NumCharacters, NumFrames, Options.TickHz);
+
+        const double StartTime = FPlatformTime::Seconds();
+        ParallelFor(Simulations.Num(), [&Simulations, NumFrames, DeltaTime](int32 Index)
+        {
+            Run(Simulations[Index], NumFrames, DeltaTime);
+        }, EParallelForFlags::Unbalanced);
+        WallSeconds = FPlatformTime::Seconds() - StartTime;
+    }
+    else if (Options.bInProcess)
+    {
+        // UWorld ticks only on the game thread, so worlds in one process take turns: every frame
+        // steps each world once, with real character movement, bots and anim instances
+        UClass* PawnClass = GetPawnClass();
+        for (int32 Index = 0; Index < Simulations.Num(); ++Index)
+        {
+            FSimulation& Simulation = Simulations[Index];
+            Simulation.World = CreateWorld(Index);
+            SpawnCrowd(Simulation, PawnClass, Options.NumCharacters, Options.FixedStepHz);
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("Running %d worlds of %d characters for %d frames at %.0f Hz..."),
+            Simulations.Num(), Options.NumCharacters, NumFrames, Options.TickHz);
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            for (FSimulation& Simulation : Simulations)
+            {
+                TickWorld(Simulation, DeltaTime);
+            }
+        }
+        WallSeconds = FPlatformTime::Seconds() - StartTime;
+    }
+    else
+    {
+        UE_LOG(LogTemp, Display, TEXT("Running %d worlds of %d characters for %d frames at %.0f Hz, %d processes at a time..."),
+            Simulations.Num(), Options.NumCharacters, NumFrames, Options.TickHz, Options.Jobs);
+
+        const double StartTime = FPlatformTime::Seconds();
+        bSucceeded = RunChildren(Simulations, Options, DeltaTime);
+        WallSeconds = FPlatformTime::Seconds() - StartTime;
+    }
+
+    FString Csv = TEXT("Mode,IdleSpeed,RunSpeed,Blend,Seed,Characters,Frames,Transitions,TransitionsPerCharMin,Flickers,IdleFraction,LocomotionFraction,JumpFraction,CpuMs,NsPerCharFrame\n");
+    uint64 TotalCycles = 0;
+
+    UE_LOG(LogTemp, Display, TEXT("  %9s %8s %6s %4s %12s %10s %9s %9s %9s %10s"),
+        TEXT("IdleSpeed"), TEXT("RunSpeed"), TEXT("Blend"), TEXT("Seed"), TEXT("Trans/ch/min"), TEXT("Flickers"), TEXT("Idle"), TEXT("Loco"), TEXT("Jump"), TEXT("ns/ch/fr"));
+
+    for (FSimulation& Simulation : Simulations)
+    {
+        const FResult& Result = Simulation.Result;
+        if (Result.Frames == 0)
+            continue;
+
+        const double CharacterMinutes = Options.NumCharacters * Result.Frames * DeltaTime / 60.0;
+        const double CharacterSeconds = CharacterMinutes * 60.0;
+        const double CpuMs = FPlatformTime::ToMilliseconds64(Result.Cycles);
+        const double NsPerCharacterFrame = CpuMs * 1.0e6 / (static_cast<double>(Options.NumCharacters) * Result.Frames);
+        const double IdleFraction = Result.StateSeconds[static_cast<int32>(ECharacterAnimState::Idle)] / CharacterSeconds;
+        const double LocomotionFraction = Result.StateSeconds[static_cast<int32>(ECharacterAnimState::Locomotion)] / CharacterSeconds;
+        const double JumpFraction = Result.StateSeconds[static_cast<int32>(ECharacterAnimState::Jump)] / CharacterSeconds;
+        const double TransitionsPerCharacterMinute = Result.Transitions / CharacterMinutes;
+        TotalCycles += Result.Cycles;
+
+        UE_LOG(LogTemp, Display, TEXT("  %9.1f %8.1f %6.2f %4d %12.2f %10lld %8.1f%% %8.1f%% %8.1f%% %10.1f"),
+            Simulation.Tuning.IdleSpeed, Simulation.Tuning.RunSpeed, Simulation.Tuning.IdleToLocomotionBlend, Simulation.Seed,
+            TransitionsPerCharacterMinute, Result.Flickers, IdleFraction * 100.0, LocomotionFraction * 100.0, JumpFraction * 100.0, NsPerCharacterFrame);
+
+        Csv += FString::Printf(TEXT("%s,%g,%g,%g,%d,%d,%lld,%lld,%.3f,%lld,%.4f,%.4f,%.4f,%.3f,%.1f\n"),
+            Options.bFast ? TEXT("Fast") : TEXT("World"), Simulation.Tuning.IdleSpeed, Simulation.Tuning.RunSpeed, Simulation.Tuning.IdleToLocomotionBlend, Simulation.Seed,
+            Options.NumCharacters, Result.Frames, Result.Transitions, TransitionsPerCharacterMinute, Result.Flickers,
+            IdleFraction, LocomotionFraction, JumpFraction, CpuMs, NsPerCharacterFrame);
+
+        if (Simulation.World)
+        {
+            DestroyWorld(Simulation.World);
+        }
+        else
+        {
+            for (FCharacter& Character : Simulation.Characters)
+            {
+                Character.Machine->RemoveFromRoot();
+            }
+        }
+    }
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+
+    const double CpuSeconds = FPlatformTime::ToSeconds64(TotalCycles);
+    if (Options.bInProcess)
+    {
+        UE_LOG(LogTemp, Display, TEXT("%d simulations in %.3f s wall, %.3f s cpu, one after another"),
+            Simulations.Num(), WallSeconds, CpuSeconds);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Display, TEXT("%d simulations in %.3f s wall, %.3f s cpu, %.1fx concurrency"),
+            Simulations.Num(), WallSeconds, CpuSeconds, WallSeconds > 0.0 ? CpuSeconds / WallSeconds : 0.0);
+    }
+
+    const FString ReportPath = !Options.Report.IsEmpty() ? Options.Report
+        : FPaths::ProfilingDir() / TEXT("AnimSimSweep") / FString::Printf(TEXT("Sweep-%s.csv"), *FDateTime::Now().ToString());
+    if (!FFileHelper::SaveStringToFile(Csv, *ReportPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Could not write the report to '%s'."), *ReportPath);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("Report written to %s"), *FPaths::ConvertRelativePathToFull(ReportPath));
+    return bSucceeded ? 0 : 1;
+}
@@ -0,0 +1,491 @@
+//
+//  AnimStateMachineBenchCommandlet.cpp
+//
+#include "AnimStateMachineBenchCommandlet.h"
+#include "AnimationStateMachine.h"
+#include "AnimDemoAllocTracker.h"
+#include "LocomotionSnapshot.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "UObject/UObjectGlobals.h"
+
+#if PLATFORM_LINUX
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace AnimStateMachineBench
+{
+    static_assert(sizeof(ECharacterAnimState) == 1, "Synthetic states span the enum's uint8 range");
+
+    constexpr int32 MaxStates = 256;
+    constexpr float TickSeconds = 1.f / 60.f;
+
+    // Ticks each movement phase of the driven snapshot sequence lasts
+    constexpr int32 PhaseTicks = 30;
+
+    // Keeps the predicate loops from being optimized away
+    static volatile int32 PredicateSink = 0;
+
+    // Last level cache misses of this thread, user space only
+    class FCacheMissCounter
+    {
+    public:
+        FCacheMissCounter()
+        {
+#if PLATFORM_LINUX
+            perf_event_attr Attr;
+            FMemory::Memzero(Attr);
+            Attr.type = PERF_TYPE_HARDWARE;
+            Attr.size = sizeof(Attr);
+            Attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            Attr.disabled = 1;
+            Attr.exclude_kernel = 1;
+            Attr.exclude_hv = 1;
+            Fd = static_cast<int32>(syscall(__NR_perf_event_open, &Attr, 0, -1, -1, 0));
+#endif
+        }
+
+        ~FCacheMissCounter()
+        {
+#if PLATFORM_LINUX
+            if (Fd >= 0)
+            {
+                close(Fd);
+            }
+#endif
+        }
+
+        UE_NONCOPYABLE(FCacheMissCounter);
+
+        bool IsAvailable() const { return Fd >= 0; }
+
+        void Start()
+        {
+#if PLATFORM_LINUX
+            if (Fd >= 0)
+            {
+                ioctl(Fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(Fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        // Misses since Start, -1 if they cannot be counted
+        int64 Stop()
+        {
+#if PLATFORM_LINUX
+            if (Fd >= 0)
+            {
+                ioctl(Fd, PERF_EVENT_IOC_DISABLE, 0);
+                uint64 Value = 0;
+                if (read(Fd, &Value, sizeof(Value)) == sizeof(Value))
+                {
+                    return static_cast<int64>(Value);
+                }
+            }
+#endif
+            return -1;
+        }
+
+    private:
+        int32 Fd = -1;
+    };
+
+    struct FResult
+    {
+        double NsPerOp = 0.0;
+        double AllocsPerOp = -1.0;
+        double BytesPerOp = -1.0;
+        double MissesPerOp = -1.0;
+    };
+
+    // Prepare runs untimed before every pass; Run performs NumOps operations
+    template <typename PrepareType, typename RunType>
+    static FResult Measure(FCacheMissCounter& Misses, int64 NumOps, PrepareType&& Prepare, RunType&& Run)
+    {
+        FResult Result;
+
+        // Warm-up, so the timed pass sees warm caches and resolved code paths
+        Prepare();
+        Run();
+
+        Prepare();
+        Misses.Start();
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        Run();
+        const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+        const int64 NumMisses = Misses.Stop();
+
+        Result.NsPerOp = FPlatformTime::ToSeconds64(Cycles) * 1.0e9 / NumOps;
+        Result.MissesPerOp = NumMisses >= 0 ? static_cast<double>(NumMisses) / NumOps : -1.0;
+
+#if ANIMDEMO_ALLOC_TRACKING
+        // Counted on a pass of its own since the counting allocator slows down every allocation
+        if (FAnimDemoAllocScope::IsAvailable())
+        {
+            Prepare();
+            FAnimDemoAllocScope::StartCapture(false);
+            {
+                ANIMDEMO_ALLOC_SCOPE(StateMachineBench);
+                Run();
+            }
+            const FAnimDemoAllocReport Report = FAnimDemoAllocScope::StopCapture(1);
+            Result.AllocsPerOp = static_cast<double>(Report.GetTotalAllocs()) / NumOps;
+
+            uint64 AllocBytes = 0;
+            for (const FAnimDemoAllocScopeResult& Scope : Report.Scopes)
+            {
+                AllocBytes += Scope.AllocBytes;
+            }
+            Result.BytesPerOp = static_cast<double>(AllocBytes) / NumOps;
+        }
+#endif
+
+        return Result;
+    }
+
+    static void LogResult(const TCHAR* Name, int32 NumStates, int32 NumTransitions, const FResult& Result)
+    {
+        const FString States = NumStates > 0 ? FString::FromInt(NumStates) : TEXT("-");
+        const FString Transitions = NumTransitions > 0 ? FString::FromInt(NumTransitions) : TEXT("-");
+        const FString Allocs = Result.AllocsPerOp >= 0.0 ? FString::Printf(TEXT("%.3f"), Result.AllocsPerOp) : TEXT("n/a");
+        const FString Bytes = Result.BytesPerOp >= 0.0 ? FString::Printf(TEXT("%.1f"), Result.BytesPerOp) : TEXT("n/a");
+        const FString Misses = Result.MissesPerOp >= 0.0 ? FString::Printf(TEXT("%.3f"), Result.MissesPerOp) : TEXT("n/a");
+
+        UE_LOG(LogTemp, Display, TEXT("  %-22s %6s %6s %12.1f %10s %10s %10s"), Name, *States, *Transitions, Result.NsPerOp, *Allocs, *Bytes, *Misses);
+    }
+
+    static ECharacterAnimState ToState(int32 Index)
+    {
+        return static_cast<ECharacterAnimState>(static_cast<uint8>(Index));
+    }
+
+    // The four predicate patterns of AAnimCppChar, cycled over a state's outgoing transitions
+    static FAnimStateCondition MakeCondition(int32 Pattern)
+    {
+        switch (Pattern % 4)
+        {
+        case 0:  return [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldWalk(); };
+        case 1:  return [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldRun(); };
+        case 2:  return [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldJump(); };
+        default: return [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldIdle(); };
+        }
+    }
+
+    static void AddSyntheticTransitions(FAnimStateMachineDefinition& Definition, int32 NumStates, int32 NumTransitions)
+    {
+        for (int32 From = 0; From < NumStates; ++From)
+        {
+            for (int32 Index = 0; Index < NumTransitions; ++Index)
+            {
+                const int32 To = (From + 1 + Index % (NumStates - 1)) % NumStates;
+                Definition.AddTransition(ToState(From), ToState(To), MakeCondition(Index));
+            }
+        }
+    }
+
+    static TArray<TSharedRef<FAnimStateMachineDefinition>> NewDefinitions(int32 NumDefinitions)
+    {
+        TArray<TSharedRef<FAnimStateMachineDefinition>> Definitions;
+        Definitions.Reserve(NumDefinitions);
+        for (int32 Index = 0; Index < NumDefinitions; ++Index)
+        {
+            Definitions.Add(MakeShared<FAnimStateMachineDefinition>());
+        }
+        return Definitions;
+    }
+
+    // Idle, walk, run, jump and fall phases with a random heading, as a character would report them
+    static TArray<FLocomotionSnapshot> MakeSnapshotSequence()
+    {
+        FRandomStream Random(42);
+
+        TArray<FLocomotionSnapshot> Sequence;
+        for (int32 Phase = 0; Phase < 5; ++Phase)
+        {
+            for (int32 Tick = 0; Tick < PhaseTicks; ++Tick)
+            {
+                const float Angle = Random.FRandRange(0.f, UE_TWO_PI);
+                const FVector Heading(FMath::Cos(Angle), FMath::Sin(Angle), 0.f);
+
+                FLocomotionSnapshot& Snapshot = Sequence.AddDefaulted_GetRef();
+                switch (Phase)
+                {
+                case 0: Snapshot.Velocity = Heading * Random.FRandRange(0.f, 5.f); break;
+                case 1: Snapshot.Velocity = Heading * Random.FRandRange(50.f, 250.f); break;
+                case 2: Snapshot.Velocity = Heading * Random.FRandRange(350.f, 600.f); break;
+                case 3: Snapshot.Velocity = FVector(0.f, 0.f, 420.f); break;
+                default: Snapshot.Velocity = FVector(0.f, 0.f, -300.f); break;
+                }
+
+                Snapshot.bIsFalling = Phase >= 3;
+                Snapshot.bIsMovingOnGround = Phase < 3;
+            }
+        }
+        return Sequence;
+    }
+
+    struct FOptions
+    {
+        TArray<int32> States = { 4, 16, 64, 256 };
+        TArray<int32> Transitions = { 1, 4, 16, 64 };
+        int32 Characters = 5000;
+        int64 Ops = 200000;
+        FString Filter;
+
+        bool Includes(const TCHAR* Name) const { return Filter.IsEmpty() || FCString::Stristr(Name, *Filter) != nullptr; }
+    };
+
+    static void ParseList(const FString& Params, const TCHAR* Key, int32 Min, int32 Max, TArray<int32>& OutValues)
+    {
+        FString List;
+        if (!FParse::Value(*Params, Key, List))
+            return;
+
+        TArray<FString> Items;
+        List.ParseIntoArray(Items, TEXT(","));
+
+        OutValues.Reset();
+        for (const FString& Item : Items)
+        {
+            OutValues.AddUnique(FMath::Clamp(FCString::Atoi(*Item), Min, Max));
+        }
+    }
+}
+
+UAnimStateMachineBenchCommandlet::UAnimStateMachineBenchCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UAnimStateMachineBenchCommandlet::Main(const FString& Params)
+{
+    using namespace AnimStateMachineBench;
+
+    FOptions Options;
+    ParseList(Params, TEXT("States="), 2, MaxStates, Options.States);
+    ParseList(Params, TEXT("Transitions="), 1, 1024, Options.Transitions);
+    FParse::Value(*Params, TEXT("Characters="), Options.Characters);
+    FParse::Value(*Params, TEXT("Ops="), Options.Ops);
+    FParse::Value(*Params, TEXT("Filter="), Options.Filter);
+    Options.Ops = FMath::Max<int64>(Options.Ops, 1000);
+    Options.Characters = FMath::Max(Options.Characters, 1);
+
+    FCacheMissCounter Misses;
+    if (!Misses.IsAvailable())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Cache miss counter unavailable on this platform or denied by the kernel, misses are reported as n/a."));
+    }
+#if !ANIMDEMO_ALLOC_TRACKING
+    UE_LOG(LogTemp, Warning, TEXT("Allocation tracking is compiled out of this configuration, allocations are reported as n/a."));
+#endif
+
+    const TArray<FLocomotionSnapshot> Sequence = MakeSnapshotSequence();
+
+    // Falling with no upward velocity satisfies none of the predicates, so every tick scans all transitions
+    FLocomotionSnapshot NoMatch;
+    NoMatch.Velocity = FVector(0.f, 0.f, -300.f);
+    NoMatch.bIsFalling = true;
+    NoMatch.bIsMovingOnGround = false;
+
+    UE_LOG(LogTemp, Display, TEXT("  %-22s %6s %6s %12s %10s %10s %10s"), TEXT("Case"), TEXT("States"), TEXT("T/S"), TEXT("ns/op"), TEXT("allocs/op"), TEXT("bytes/op"), TEXT("misses/op"));
+
+    // The predicates on their own, one call per op
+    using FPredicate = bool (*)(const FLocomotionSnapshot&);
+    const TPair<const TCHAR*, FPredicate> Predicates[] =
+    {
+        { TEXT("ShouldWalk"), [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldWalk(); } },
+        { TEXT("ShouldRun"), [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldRun(); } },
+        { TEXT("ShouldJump"), [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldJump(); } },
+        { TEXT("ShouldIdle"), [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldIdle(); } },
+    };
+    for (const TPair<const TCHAR*, FPredicate>& Predicate : Predicates)
+    {
+        if (!Options.Includes(Predicate.Key))
+            continue;
+
+        const FPredicate Function = Predicate.Value;
+        const FResult Result = Measure(Misses, Options.Ops, [] {}, [&Sequence, &Options, Function]
+        {
+            int32 Matches = 0;
+            for (int64 Op = 0; Op < Options.Ops; ++Op)
+            {
+                Matches += Function(Sequence[static_cast<int32>(Op % Sequence.Num())]) ? 1 : 0;
+            }
+            PredicateSink = PredicateSink + Matches;
+        });
+        LogResult(Predicate.Key, 0, 0, Result);
+    }
+
+    // The machine AAnimCppChar builds, driven through the movement phases
+    if (Options.Includes(TEXT("LocomotionTick")))
+    {
+        FLocomotionSnapshot Snapshot;
+        UAnimationStateMachine* Machine = UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), AnimDemoLocomotion::GetDefinition(FLocomotionArchetype()), &Snapshot);
+
+        const FResult Result = Measure(Misses, Options.Ops, [Machine] { Machine->Reset(); }, [Machine, &Snapshot, &Sequence, &Options]
+        {
+            for (int64 Op = 0; Op < Options.Ops; ++Op)
+            {
+                Snapshot = Sequence[static_cast<int32>(Op % Sequence.Num())];
+                Machine->Tick(TickSeconds);
+            }
+        });
+        LogResult(TEXT("LocomotionTick"), 0, 0, Result);
+    }
+
+    // Setting up a crowd of AAnimCppChar's machines, per character: each with a definition of its
+    // own as characters used to build, then all sharing the archetype's. Both create the machine.
+    {
+        FLocomotionSnapshot Snapshot;
+        const FLocomotionArchetype Archetype;
+        TArray<UAnimationStateMachine*> Machines;
+        auto PrepareMachines = [&Machines] { Machines.Reset(); };
+
+        if (Options.Includes(TEXT("SetupUnshared")))
+        {
+            const FResult Result = Measure(Misses, Options.Characters, PrepareMachines, [&Machines, &Snapshot, &Archetype, &Options]
+            {
+                for (int32 Index = 0; Index < Options.Characters; ++Index)
+                {
+                    TSharedRef<FAnimStateMachineDefinition> Definition = MakeShared<FAnimStateMachineDefinition>();
+                    Definition->RegisterStateAnimation(ECharacterAnimState::Idle, Archetype.IdleAnimation, true, 1.0f);
+                    Definition->RegisterStateAnimation(ECharacterAnimState::Jump, Archetype.JumpAnimation, false, 1.0f);
+                    Definition->RegisterStateBlendSpace(ECharacterAnimState::Locomotion, Archetype.LocomotionBlendSpace, true, 1.0f);
+                    AnimDemoLocomotion::AddLocomotionTransitions(*Definition, Archetype.Tuning);
+
+                    Machines.Add(UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), Definition, &Snapshot));
+                }
+            });
+            LogResult(TEXT("SetupUnshared"), 0, 0, Result);
+
+            Machines.Reset();
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+
+        if (Options.Includes(TEXT("SetupShared")))
+        {
+            const FResult Result = Measure(Misses, Options.Characters, PrepareMachines, [&Machines, &Snapshot, &Archetype, &Options]
+            {
+                for (int32 Index = 0; Index < Options.Characters; ++Index)
+                {
+                    Machines.Add(UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), AnimDemoLocomotion::GetDefinition(Archetype), &Snapshot));
+                }
+            });
+            LogResult(TEXT("SetupShared"), 0, 0, Result);
+
+            Machines.Reset();
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("  Setup cases are per character for %d characters; the runtime record each keeps is %d bytes."),
+            Options.Characters, static_cast<int32>(sizeof(FAnimStateMachineRuntime)));
+    }
+
+    for (const int32 NumStates : Options.States)
+    {
+        if (Options.Includes(TEXT("RegisterStateAnimation")))
+        {
+            // Fresh definitions every pass, so every call inserts rather than replaces
+            const int32 NumDefinitions = static_cast<int32>(FMath::DivideAndRoundUp<int64>(Options.Ops, NumStates));
+            TArray<TSharedRef<FAnimStateMachineDefinition>> Definitions;
+
+            const FResult Result = Measure(Misses, static_cast<int64>(NumDefinitions) * NumStates,
+                [&Definitions, NumDefinitions] { Definitions = NewDefinitions(NumDefinitions); },
+                [&Definitions, NumStates]
+                {
+                    for (const TSharedRef<FAnimStateMachineDefinition>& Definition : Definitions)
+                    {
+                        for (int32 State = 0; State < NumStates; ++State)
+                        {
+                            Definition->RegisterStateAnimation(ToState(State), nullptr);
+                        }
+                    }
+                });
+            LogResult(TEXT("RegisterStateAnimation"), NumStates, 0, Result);
+        }
+
+        if (Options.Includes(TEXT("StartTransition")))
+        {
+            // ForceState only starts a transition when none is running, so each op resets first
+            UAnimationStateMachine* Machine = UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), MakeShared<FAnimStateMachineDefinition>(), nullptr);
+            const FResult Result = Measure(Misses, Options.Ops, [] {}, [Machine, NumStates, &Options]
+            {
+                for (int64 Op = 0; Op < Options.Ops; ++Op)
+                {
+                    const int32 From = static_cast<int32>(Op % NumStates);
+                    Machine->Reset(ToState(From));
+                    Machine->ForceState(ToState((From + 1) % NumStates));
+                }
+            });
+            LogResult(TEXT("StartTransition"), NumStates, 0, Result);
+        }
+
+        for (const int32 NumTransitions : Options.Transitions)
+        {
+            const int64 NumTotal = static_cast<int64>(NumStates) * NumTransitions;
+            FLocomotionSnapshot Snapshot;
+
+            if (Options.Includes(TEXT("AddTransition")))
+            {
+                const int32 NumDefinitions = static_cast<int32>(FMath::DivideAndRoundUp<int64>(Options.Ops, NumTotal));
+                TArray<TSharedRef<FAnimStateMachineDefinition>> Definitions;
+
+                const FResult Result = Measure(Misses, NumDefinitions * NumTotal,
+                    [&Definitions, NumDefinitions] { Definitions = NewDefinitions(NumDefinitions); },
+                    [&Definitions, NumStates, NumTransitions]
+                    {
+                        for (const TSharedRef<FAnimStateMachineDefinition>& Definition : Definitions)
+                        {
+                            AddSyntheticTransitions(*Definition, NumStates, NumTransitions);
+                        }
+                    });
+                LogResult(TEXT("AddTransition"), NumStates, NumTransitions, Result);
+            }
+
+            // Every tick visits the current state's transitions, so keep the work per case roughly constant
+            const int64 NumTicks = FMath::Clamp<int64>(Options.Ops * 64 / NumTotal, 1000, Options.Ops);
+            TSharedRef<FAnimStateMachineDefinition> Definition = MakeShared<FAnimStateMachineDefinition>();
+            AddSyntheticTransitions(*Definition, NumStates, NumTransitions);
+            UAnimationStateMachine* Machine = UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), Definition, &Snapshot);
+
+            if (Options.Includes(TEXT("UpdateTransitions")))
+            {
+                // Nothing matches, so each tick is one UpdateTransitions with every condition of the state evaluated
+                const FResult Result = Measure(Misses, NumTicks, [Machine, &Snapshot, &NoMatch] { Machine->Reset(); Snapshot = NoMatch; },
+                    [Machine, NumTicks]
+                    {
+                        for (int64 Op = 0; Op < NumTicks; ++Op)
+                        {
+                            Machine->Tick(TickSeconds);
+                        }
+                    });
+                LogResult(TEXT("UpdateTransitions"), NumStates, NumTransitions, Result);
+            }
+
+            if (Options.Includes(TEXT("Tick")))
+            {
+                const FResult Result = Measure(Misses, NumTicks, [Machine] { Machine->Reset(); },
+                    [Machine, &Snapshot, &Sequence, NumTicks]
+                    {
+                        for (int64 Op = 0; Op < NumTicks; ++Op)
+                        {
+                            Snapshot = Sequence[static_cast<int32>(Op % Sequence.Num())];
+                            Machine->Tick(TickSeconds);
+                        }
+                    });
+                LogResult(TEXT("Tick"), NumStates, NumTransitions, Result);
+            }
+        }
+
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    return 0;
+}
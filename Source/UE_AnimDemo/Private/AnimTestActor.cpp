@@ -1,8 +1,15 @@
 #include "AnimTestActor.h"
 #include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimSingleNodeInstance.h"
+#include "AnimDemoStats.h"
+#include "AnimDemoMemory.h"
+#include "CrowdSeparationSubsystem.h"
+#include "CrowdPoseSubsystem.h"
 
 AAnimTestActor::AAnimTestActor()
 {
+    LLM_SCOPE_BYTAG(AnimDemo_Characters);
+    
     PrimaryActorTick.bCanEverTick = false;
 
     // Create the skeletal mesh component and make it the root
@@ -14,6 +21,103 @@ void AAnimTestActor::BeginPlay()
 {
     Super::BeginPlay();
 
+    if (!StartBatchedPose())
+    {
+        PlayOnMesh();
+    }
+    
+    if (UCrowdSeparationSubsystem* Crowd = GetWorld()->GetSubsystem<UCrowdSeparationSubsystem>())
+    {
+        Crowd->Register(this);
+    }
+}
+
+void AAnimTestActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    StopBatchedPose();
+    
+    if (UCrowdSeparationSubsystem* Crowd = GetWorld()->GetSubsystem<UCrowdSeparationSubsystem>())
+    {
+        Crowd->Unregister(this);
+    }
+    
+    Super::EndPlay(EndPlayReason);
+}
+
+void AAnimTestActor::OnReleasedToPool()
+{
+    StopBatchedPose();
+    SkeletalMeshComp->Stop();
+    SkeletalMeshComp->SetComponentTickEnabled(false);
+    
+    if (UCrowdSeparationSubsystem* Crowd = GetWorld()->GetSubsystem<UCrowdSeparationSubsystem>())
+    {
+        Crowd->Unregister(this);
+    }
+}
+
+void AAnimTestActor::OnAcquiredFromPool()
+{
+    // Start the loop over, as BeginPlay would
+    if (!StartBatchedPose())
+    {
+        SkeletalMeshComp->SetComponentTickEnabled(true);
+        
+        // An actor batched in its previous life never handed its animation to the mesh
+        const UAnimSingleNodeInstance* SingleNode = SkeletalMeshComp->GetSingleNodeInstance();
+        if (SingleNode && SingleNode->GetAnimationAsset())
+        {
+            SkeletalMeshComp->SetPosition(0.f, false);
+            SkeletalMeshComp->Play(true);
+        }
+        else
+        {
+            PlayOnMesh();
+        }
+    }
+    
+    if (UCrowdSeparationSubsystem* Crowd = GetWorld()->GetSubsystem<UCrowdSeparationSubsystem>())
+    {
+        Crowd->Register(this);
+    }
+}
+
+void AAnimTestActor::SaveSnapshot(FAnimTestActorSnapshot& OutSnapshot) const
+{
+    OutSnapshot.Location = GetActorLocation();
+    OutSnapshot.Rotation = GetActorQuat();
+    OutSnapshot.AnimPosition = bBatchedPose ? BatchedPoseTime : SkeletalMeshComp->GetPosition();
+    OutSnapshot.bPlaying = bBatchedPose ? !bBatchedPosePaused : SkeletalMeshComp->IsPlaying();
+}
+
+void AAnimTestActor::RestoreSnapshot(const FAnimTestActorSnapshot& Snapshot)
+{
+    SetActorLocationAndRotation(Snapshot.Location, Snapshot.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+    
+    if (bBatchedPose)
+    {
+        BatchedPoseTime = Snapshot.AnimPosition;
+        bBatchedPosePaused = !Snapshot.bPlaying;
+        return;
+    }
+    
+    SkeletalMeshComp->SetPosition(Snapshot.AnimPosition, false);
+    
+    if (Snapshot.bPlaying != SkeletalMeshComp->IsPlaying())
+    {
+        if (Snapshot.bPlaying)
+        {
+            SkeletalMeshComp->Play(true);
+        }
+        else
+        {
+            SkeletalMeshComp->Stop();
+        }
+    }
+}
+
+void AAnimTestActor::PlayOnMesh()
+{
     if (AnimationToPlay)
     {
         SkeletalMeshComp->PlayAnimation(AnimationToPlay, true); // true = loop
@@ -25,10 +129,35 @@ void AAnimTestActor::BeginPlay()
     }
 }
 
-void AAnimTestActor::Tick(float DeltaTime)
+UAnimSequence* AAnimTestActor::GetBatchedSequence() const
 {
-    Super::Tick(DeltaTime);
+    return RunAnim ? Cast<UAnimSequence>(RunAnim) : AnimationToPlay;
+}
 
-    // Move forward constantly
-    AddActorWorldOffset(GetActorForwardVector() * 100.f * DeltaTime);
+bool AAnimTestActor::StartBatchedPose()
+{
+    UCrowdPoseSubsystem* CrowdPose = GetWorld()->GetSubsystem<UCrowdPoseSubsystem>();
+    if (!CrowdPose || !UCrowdPoseSubsystem::IsBatchingEnabled() || !CrowdPose->Register(this, GetBatchedSequence()))
+        return false;
+    
+    // The subsystem writes the component-space pose, the component only renders it
+    SkeletalMeshComp->SetComponentTickEnabled(false);
+    SkeletalMeshComp->bNoSkeletonUpdate = true;
+    bBatchedPose = true;
+    bBatchedPosePaused = false;
+    BatchedPoseTime = 0.f;
+    return true;
+}
+
+void AAnimTestActor::StopBatchedPose()
+{
+    if (!bBatchedPose)
+        return;
+    
+    if (UCrowdPoseSubsystem* CrowdPose = GetWorld()->GetSubsystem<UCrowdPoseSubsystem>())
+    {
+        CrowdPose->Unregister(this);
+    }
+    SkeletalMeshComp->bNoSkeletonUpdate = false;
+    bBatchedPose = false;
 }
@@ -5,14 +5,18 @@
 #include "EnhancedInputSubsystems.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
-#include "Kismet/GameplayStatics.h"
-#include "PlayerSettingsSave.h"
+#include "AsyncSpringArmComponent.h"
+#include "PlayerSettingsComponent.h"
 #include "Engine/Engine.h"
 #include "Engine/GameViewportClient.h"
+#include "AnimDemoMemory.h"
 
 
-AAnimTestCharacter::AAnimTestCharacter()
+AAnimTestCharacter::AAnimTestCharacter(const FObjectInitializer& ObjectInitializer)
+    : Super(UAsyncSpringArmComponent::SkipRigOnDedicatedServer(ObjectInitializer, TEXT("CameraBoom"), TEXT("FollowCamera")))
 {
+    LLM_SCOPE_BYTAG(AnimDemo_Characters);
+    
     PrimaryActorTick.bCanEverTick = true;
 
     // Character already has Mesh (USkeletalMeshComponent*) and CapsuleComponent
@@ -37,24 +41,50 @@ AAnimTestCharacter::AAnimTestCharacter()
         GetMesh()->SetAnimInstanceClass(AnimBP);
     }
     
-    // Create spring arm
-    CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
-    CameraBoom->SetupAttachment(RootComponent);
-    CameraBoom->TargetArmLength = 300.0f; // how far back the camera follows
-    CameraBoom->bUsePawnControlRotation = true; // rotate the arm based on controller
+    // Look input settings and the settings menu, bound while a local player possesses this character
+    PlayerSettings = CreateDefaultSubobject<UPlayerSettingsComponent>(TEXT("PlayerSettings"));
+    
+    // Dedicated servers never render, so their instances skip the camera rig; the class default
+    // object has it on every target
+    LLM_SCOPE_BYTAG(AnimDemo_Camera);
+    
+    // Create spring arm, its collision probe is an async sweep
+    CameraBoom = CreateOptionalDefaultSubobject<UAsyncSpringArmComponent>(TEXT("CameraBoom"));
+    if (CameraBoom)
+    {
+        CameraBoom->SetupAttachment(RootComponent);
+        CameraBoom->TargetArmLength = 300.0f; // how far back the camera follows
+        CameraBoom->bUsePawnControlRotation = true; // rotate the arm based on controller
+    }
 
     // Create follow camera
-    FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
-    FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
-    FollowCamera->bUsePawnControlRotation = false; // camera doesn't rotate relative to arm
+    FollowCamera = CreateOptionalDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
+    if (FollowCamera)
+    {
+        FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
+        FollowCamera->bUsePawnControlRotation = false; // camera doesn't rotate relative to arm
+    }
 }
 
-
 void AAnimTestCharacter::BeginPlay()
 {
+    // Dedicated servers never render, so they get no pose evaluation
+    if (IsRunningDedicatedServer())
+    {
+        GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+    }
+    
     Super::BeginPlay();
 
-    if (APlayerController* PC = Cast<APlayerController>(GetController()))
+    if (IsRunningDedicatedServer())
+    {
+        GetMesh()->SetComponentTickEnabled(false);
+    }
+
+    // Remote players are also driven by a PlayerController on the server, but only
+    // a local controller gets input mappings and player settings
+    APlayerController* PC = Cast<APlayerController>(GetController());
+    if (PC && PC->IsLocalController())
     {
         if (UEnhancedInputLocalPlayerSubsystem* Subsystem = ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PC->GetLocalPlayer()))
         {
@@ -69,33 +99,19 @@ void AAnimTestCharacter::BeginPlay()
             }
         }
         
-        if (SettingsWidgetClass) // UPROPERTY TSubclassOf<UPlayerSettingsWidget> set in editor
-        {
-            SettingsWidget = CreateWidget<UPlayerSettingsWidget>(GetWorld(), SettingsWidgetClass);
-            if (SettingsWidget)
-            {
-                UE_LOG(LogTemp, Warning, TEXT("SettingsWidget created successfully."));
-                SettingsWidget->AddToViewport();
-                SettingsWidget->SetVisibility(ESlateVisibility::Hidden);
-
-                // Bind delegates to character functions
-                SettingsWidget->OnSensitivityChanged.AddDynamic(this, &AAnimTestCharacter::SetMouseSensitivity);
-                SettingsWidget->OnSmoothingChanged.AddDynamic(this, &AAnimTestCharacter::SetMouseSmoothing);
-                SettingsWidget->OnInvertYChanged.AddDynamic(this, &AAnimTestCharacter::SetInvertY);
-                SettingsWidget->OnCloseButtonPressed.AddDynamic(this, &AAnimTestCharacter::ToggleSettingsMenu);
-            }
-            else
-            {
-                UE_LOG(LogTemp, Error, TEXT("SettingsWidget creation FAILED!"));
-            }
-        }
-        
-        // Load Player Settings
-        LoadPlayerSettings();
+        // Follow the local player's settings; they are already in memory
+        PlayerSettings->Bind();
     }
 }
 
 
+void AAnimTestCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    
+    Super::EndPlay(EndPlayReason);
+}
+
+
 void AAnimTestCharacter::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
@@ -195,145 +211,77 @@ void AAnimTestCharacter::Move(const FInputActionValue& Value)
 
 void AAnimTestCharacter::Turn(const FInputActionValue& Value)
 {
-    float TargetYaw = Value.Get<float>() * MouseSensitivity;
-    SmoothedYaw = FMath::FInterpTo(SmoothedYaw, TargetYaw, GetWorld()->GetDeltaSeconds(), MouseSmoothing);
+    float TargetYaw = Value.Get<float>() * PlayerSettings->GetMouseSensitivity();
+    SmoothedYaw = FMath::FInterpTo(SmoothedYaw, TargetYaw, GetWorld()->GetDeltaSeconds(), PlayerSettings->GetMouseSmoothing());
     AddControllerYawInput(SmoothedYaw);
 }
 
 void AAnimTestCharacter::LookUp(const FInputActionValue& Value)
 {
-    float RawPitch = Value.Get<float>() * MouseSensitivity;
+    float RawPitch = Value.Get<float>() * PlayerSettings->GetMouseSensitivity();
 
     // Apply invert Y if enabled
-    if (bInvertY)
+    if (PlayerSettings->GetInvertY())
     {
         RawPitch *= -1.0f;
     }
 
-    SmoothedPitch = FMath::FInterpTo(SmoothedPitch, RawPitch, GetWorld()->GetDeltaSeconds(), MouseSmoothing);
+    SmoothedPitch = FMath::FInterpTo(SmoothedPitch, RawPitch, GetWorld()->GetDeltaSeconds(), PlayerSettings->GetMouseSmoothing());
     AddControllerPitchInput(SmoothedPitch);
 }
 
 
 void AAnimTestCharacter::SavePlayerSettings()
 {
-    UPlayerSettingsSave* SaveGameInstance = Cast<UPlayerSettingsSave>(
-        UGameplayStatics::CreateSaveGameObject(UPlayerSettingsSave::StaticClass())
-    );
-
-    SaveGameInstance->MouseSensitivity = MouseSensitivity;
-    SaveGameInstance->MouseSmoothing = MouseSmoothing;
-    SaveGameInstance->bInvertY = bInvertY;
-
-    UGameplayStatics::SaveGameToSlot(SaveGameInstance, TEXT("PlayerSettings"), 0);
+    PlayerSettings->SaveSettings();
 }
 
 
 void AAnimTestCharacter::LoadPlayerSettings()
 {
-    if (UGameplayStatics::DoesSaveGameExist(TEXT("PlayerSettings"), 0))
-    {
-        UPlayerSettingsSave* Loaded = Cast<UPlayerSettingsSave>(
-            UGameplayStatics::LoadGameFromSlot(TEXT("PlayerSettings"), 0)
-        );
+    PlayerSettings->LoadSettings();
+}
 
-        if (Loaded)
-        {
-            MouseSensitivity = Loaded->MouseSensitivity;
-            MouseSmoothing = Loaded->MouseSmoothing;
-            bInvertY = Loaded->bInvertY;
-        }
-    }
+
+void AAnimTestCharacter::NotifyControllerChanged()
+{
+    Super::NotifyControllerChanged();
+    
+    // Possession changes only move the subscription to the new local player
+    PlayerSettings->Bind();
 }
 
 
 void AAnimTestCharacter::HideSettingsWidget()
 {
-    UE_LOG(LogTemp, Warning, TEXT("Saving Settings and Hiding Settings Window..."));
-    SavePlayerSettings();
-    
-    SettingsWidget->SetVisibility(ESlateVisibility::Hidden);
-    UE_LOG(LogTemp, Warning, TEXT("Settings saved."));
+    PlayerSettings->HideSettingsWidget();
 }
 
 
 void AAnimTestCharacter::ShowSettingsWidget()
 {
-    UE_LOG(LogTemp, Warning, TEXT("Showing Settings Window and Loading Settings."));
-    
-    SettingsWidget->SetVisibility(ESlateVisibility::Visible);
-    LoadPlayerSettings();
-    
-    // Update UI with loaded values
-    SettingsWidget->SetMouseSensitivity(MouseSensitivity);
-    SettingsWidget->SetMouseSmoothing(MouseSmoothing);
-    SettingsWidget->SetInvertY(bInvertY);
-    
-    UE_LOG(LogTemp, Warning, TEXT("Settings loaded."));
+    PlayerSettings->ShowSettingsWidget();
 }
 
 void AAnimTestCharacter::ToggleSettingsMenu()
 {
-    UE_LOG(LogTemp, Warning, TEXT("ToggleSettingsMenu called!"));
-    // Add small debounce to skip rapid key repeats
-    if (bIsToggling) return;
-
-    bIsToggling = true;
-    GetWorld()->GetTimerManager().SetTimerForNextTick([this]()
-    {
-        bIsToggling = false;
-    });
-    
-    if (!SettingsWidget) return;
-    
-    APlayerController* PC = Cast<APlayerController>(GetController());
-    if (!PC) return;
-
-    const bool bIsVisible = SettingsWidget->IsVisible();
-    
-    UE_LOG(LogTemp, Warning, TEXT("bIsVisible=%s"), bIsVisible ? TEXT("true") : TEXT("false"));
-    if (bIsVisible)
-    {
-        HideSettingsWidget();
-        
-        GetWorld()->GetTimerManager().SetTimerForNextTick([this, PC]()
-        {
-            FInputModeGameOnly InputMode;
-            PC->SetInputMode(InputMode);
-            PC->bShowMouseCursor = false;
-            PC->SetIgnoreLookInput(false);      // Ensure look input is restored
-            PC->SetIgnoreMoveInput(false);      // Ensure move input is restored
-        });
-    }
-    else
-    {
-        ShowSettingsWidget();
-
-        // Set UI input mode with slight delay
-        GetWorld()->GetTimerManager().SetTimerForNextTick([this, PC]()
-        {
-            FInputModeUIOnly InputMode;
-            InputMode.SetWidgetToFocus(SettingsWidget->TakeWidget());
-            PC->SetInputMode(InputMode);
-            PC->bShowMouseCursor = true;
-        });
-    }
+    PlayerSettings->ToggleSettingsMenu(SettingsWidgetClass);
 }
 
 
 void AAnimTestCharacter::SetMouseSensitivity(float Value)
 {
-    MouseSensitivity = FMath::Clamp(Value, 0.1f, 10.0f);
+    PlayerSettings->SetMouseSensitivity(Value);
 }
 
 
 void AAnimTestCharacter::SetMouseSmoothing(float Value)
 {
-    MouseSmoothing = FMath::Clamp(Value, 0.f, 20.f);
+    PlayerSettings->SetMouseSmoothing(Value);
 }
 
 
 void AAnimTestCharacter::SetInvertY(bool bInvert)
 {
-    bInvertY = bInvert;
+    PlayerSettings->SetInvertY(bInvert);
 }
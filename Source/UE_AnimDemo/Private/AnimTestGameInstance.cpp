@@ -5,35 +5,25 @@
 //  Created by Derrick Auyoung on 21/08/2025.
 //
 #include "AnimTestGameInstance.h"
-#include "Kismet/GameplayStatics.h"
 #include "AnimCppChar.h"
+#include "Engine/LocalPlayer.h"
+#include "PlayerSettingsSubsystem.h"
 
-void UAnimTestGameInstance::Init()
+void UAnimTestGameInstance::SavePlayerSettings()
 {
-    Super::Init();
-
-    if (UGameplayStatics::DoesSaveGameExist(TEXT("PlayerSettingsSlot"), 0))
-    {
-        PlayerSettings = Cast<UPlayerSettingsSave>(
-            UGameplayStatics::LoadGameFromSlot(TEXT("PlayerSettingsSlot"), 0));
-    }
-    else
+    for (ULocalPlayer* LocalPlayer : GetLocalPlayers())
     {
-        PlayerSettings = Cast<UPlayerSettingsSave>(
-            UGameplayStatics::CreateSaveGameObject(UPlayerSettingsSave::StaticClass()));
+        if (UPlayerSettingsSubsystem* Settings = ULocalPlayer::GetSubsystem<UPlayerSettingsSubsystem>(LocalPlayer))
+        {
+            Settings->Flush();
+        }
     }
 }
 
-void UAnimTestGameInstance::SavePlayerSettings()
-{
-    UGameplayStatics::SaveGameToSlot(PlayerSettings, TEXT("PlayerSettingsSlot"), 0);
-}
-
 void UAnimTestGameInstance::ApplySettingsToCharacter(AAnimCppChar* Character)
 {
-    if (!PlayerSettings || !Character) return;
+    if (!Character) return;
 
-    Character->SetMouseSensitivity(PlayerSettings->MouseSensitivity);
-    Character->SetMouseSmoothing(PlayerSettings->MouseSmoothing);
-    Character->SetInvertY(PlayerSettings->bInvertY);
+    // Characters already follow their local player's settings; this re-applies the cached values
+    Character->LoadPlayerSettings();
 }
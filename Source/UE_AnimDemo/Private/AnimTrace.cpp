@@ -0,0 +1,245 @@
+//
+//  AnimTrace.cpp
+//
+#include "AnimTrace.h"
+#include "AnimDemoMemory.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FLocomotionSnapshot FAnimTraceFrame::ToSnapshot() const
+{
+    FLocomotionSnapshot Snapshot;
+    Snapshot.Velocity = FVector(Velocity);
+    Snapshot.bIsFalling = EnumHasAnyFlags(Flags, EAnimTraceFrameFlags::Falling);
+    Snapshot.bIsMovingOnGround = EnumHasAnyFlags(Flags, EAnimTraceFrameFlags::MovingOnGround);
+    return Snapshot;
+}
+
+FAnimTraceWriter::FAnimTraceWriter(const FString& InFilename, float InFixedStepHz)
+    : Filename(InFilename)
+    , WritePipe(TEXT("AnimTraceWriter"))
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+    
+    FileHandle = MakeShareable(PlatformFile.OpenWrite(*Filename));
+    if (!FileHandle)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to open anim trace '%s' for writing."), *Filename);
+        return;
+    }
+    
+    bIsOpen = true;
+    
+    LLM_SCOPE_BYTAG(AnimDemo_Trace);
+    Block.Reserve(BlockSize);
+    
+    FAnimTraceHeader Header;
+    Header.FrameSize = sizeof(FAnimTraceFrame);
+    Header.TransitionSize = sizeof(FAnimTraceTransition);
+    Header.FixedStepHz = InFixedStepHz;
+    Block.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+}
+
+FAnimTraceWriter::~FAnimTraceWriter()
+{
+    Close();
+}
+
+bool FAnimTraceWriter::Close()
+{
+    if (!bIsOpen)
+        return !bWriteFailed;
+    
+    FlushBlock();
+    WritePipe.WaitUntilEmpty();
+    bIsOpen = false;
+    
+    const bool bWritten = !bWriteFailed && FileHandle->Flush();
+    FileHandle.Reset();
+    
+    if (!bWritten)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Anim trace '%s' could not be written completely (disk full?); deleting the truncated file."), *Filename);
+        IFileManager::Get().Delete(*Filename);
+        return false;
+    }
+    
+    UE_LOG(LogTemp, Display, TEXT("Anim trace written to '%s'."), *Filename);
+    return true;
+}
+
+void FAnimTraceWriter::AddMoveInput(const FVector2D& Value)
+{
+    CurrentFrame.MoveX += Value.X;
+    CurrentFrame.MoveY += Value.Y;
+}
+
+void FAnimTraceWriter::AddTurnInput(float Value)
+{
+    CurrentFrame.Turn += Value;
+}
+
+void FAnimTraceWriter::AddLookUpInput(float Value)
+{
+    CurrentFrame.LookUp += Value;
+}
+
+void FAnimTraceWriter::AddJumpInput()
+{
+    CurrentFrame.Flags |= EAnimTraceFrameFlags::JumpPressed;
+}
+
+void FAnimTraceWriter::AddTransition(ECharacterAnimState From, ECharacterAnimState To, float Duration)
+{
+    // NumTransitions is a uint8; more than that in one frame means the machine is oscillating
+    if (CurrentTransitions.Num() < MAX_uint8)
+    {
+        FAnimTraceTransition& Transition = CurrentTransitions.AddDefaulted_GetRef();
+        Transition.Duration = Duration;
+        Transition.From = From;
+        Transition.To = To;
+    }
+}
+
+void FAnimTraceWriter::EndFrame(float DeltaTime, const FLocomotionSnapshot& Snapshot, ECharacterAnimState State)
+{
+    if (!bIsOpen || bWriteFailed)
+        return;
+    
+    CurrentFrame.DeltaTime = DeltaTime;
+    CurrentFrame.Velocity = FVector3f(Snapshot.Velocity);
+    CurrentFrame.State = State;
+    CurrentFrame.NumTransitions = static_cast<uint8>(CurrentTransitions.Num());
+    if (Snapshot.bIsFalling)
+    {
+        CurrentFrame.Flags |= EAnimTraceFrameFlags::Falling;
+    }
+    if (Snapshot.bIsMovingOnGround)
+    {
+        CurrentFrame.Flags |= EAnimTraceFrameFlags::MovingOnGround;
+    }
+    
+    Block.Append(reinterpret_cast<const uint8*>(&CurrentFrame), sizeof(CurrentFrame));
+    Block.Append(reinterpret_cast<const uint8*>(CurrentTransitions.GetData()), CurrentTransitions.Num() * sizeof(FAnimTraceTransition));
+    
+    CurrentFrame = FAnimTraceFrame();
+    CurrentTransitions.Reset();
+    
+    if (Block.Num() >= BlockSize)
+    {
+        FlushBlock();
+    }
+}
+
+void FAnimTraceWriter::FlushBlock()
+{
+    if (Block.Num() == 0)
+        return;
+    
+    LLM_SCOPE_BYTAG(AnimDemo_Trace);
+    
+    TArray<uint8> Pending = MoveTemp(Block);
+    Block.Reserve(BlockSize);
+    
+    // The pipe runs its tasks one after another, so blocks land in the file in order. Close
+    // waits for the pipe, so the writer outlives every task.
+    WritePipe.Launch(UE_SOURCE_LOCATION, [this, Handle = FileHandle, Data = MoveTemp(Pending)]()
+    {
+        if (bWriteFailed)
+            return;
+        
+        if (!Handle->Write(Data.GetData(), Data.Num()))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to write %d bytes to anim trace '%s'; recording stopped."), Data.Num(), *Filename);
+            bWriteFailed = true;
+        }
+    });
+}
+
+FString FAnimTraceWriter::MakeDefaultFilename(const FString& Prefix)
+{
+    return FPaths::ProfilingDir() / TEXT("AnimTraces") / FString::Printf(TEXT("%s_%s.animtrace"), *Prefix, *FDateTime::Now().ToString());
+}
+
+FAnimTraceReader::FAnimTraceReader(const FString& InFilename)
+    : Filename(InFilename)
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    
+    MappedHandle.Reset(PlatformFile.OpenMapped(*Filename));
+    if (MappedHandle && MappedHandle->GetFileSize() > 0)
+    {
+        MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+    }
+    
+    if (MappedRegion)
+    {
+        Data = MappedRegion->GetMappedPtr();
+        Size = MappedRegion->GetMappedSize();
+    }
+    else if (FFileHelper::LoadFileToArray(FallbackData, *Filename))
+    {
+        Data = FallbackData.GetData();
+        Size = FallbackData.Num();
+    }
+    
+    const FAnimTraceHeader* Header = Data && Size >= static_cast<int64>(sizeof(FAnimTraceHeader))
+        ? reinterpret_cast<const FAnimTraceHeader*>(Data)
+        : nullptr;
+    
+    if (!Header
+        || Header->Magic != FAnimTraceHeader::MagicValue
+        || Header->Version != FAnimTraceHeader::CurrentVersion
+        || Header->FrameSize != sizeof(FAnimTraceFrame)
+        || Header->TransitionSize != sizeof(FAnimTraceTransition))
+    {
+        UE_LOG(LogTemp, Error, TEXT("'%s' is not a valid anim trace."), *Filename);
+        Data = nullptr;
+        Size = 0;
+        return;
+    }
+    
+    FixedStepHz = Header->FixedStepHz;
+    Rewind();
+}
+
+FAnimTraceReader::~FAnimTraceReader()
+{
+    // The region has to go before the handle it was mapped from
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+}
+
+void FAnimTraceReader::Rewind()
+{
+    Cursor = sizeof(FAnimTraceHeader);
+    bTruncated = false;
+}
+
+bool FAnimTraceReader::NextFrame(const FAnimTraceFrame*& OutFrame, TArrayView<const FAnimTraceTransition>& OutTransitions)
+{
+    if (!Data || Cursor + static_cast<int64>(sizeof(FAnimTraceFrame)) > Size)
+    {
+        bTruncated = Data && Cursor < Size;
+        return false;
+    }
+    
+    const FAnimTraceFrame* Frame = reinterpret_cast<const FAnimTraceFrame*>(Data + Cursor);
+    const int64 TransitionBytes = Frame->NumTransitions * static_cast<int64>(sizeof(FAnimTraceTransition));
+    if (Cursor + static_cast<int64>(sizeof(FAnimTraceFrame)) + TransitionBytes > Size)
+    {
+        bTruncated = true;
+        return false;
+    }
+    
+    Cursor += sizeof(FAnimTraceFrame);
+    OutFrame = Frame;
+    OutTransitions = MakeArrayView(reinterpret_cast<const FAnimTraceTransition*>(Data + Cursor), Frame->NumTransitions);
+    Cursor += TransitionBytes;
+    return true;
+}
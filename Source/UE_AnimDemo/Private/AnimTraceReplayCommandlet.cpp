@@ -0,0 +1,191 @@
+//
+//  AnimTraceReplayCommandlet.cpp
+//
+#include "AnimTraceReplayCommandlet.h"
+#include "AnimTrace.h"
+#include "AnimationStateMachine.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+namespace AnimTraceReplay
+{
+    constexpr int32 NumStates = static_cast<int32>(ECharacterAnimState::None) + 1;
+    
+    struct FStats
+    {
+        int64 Frames = 0;
+        int64 RecordedTransitions = 0;
+        int64 ReplayedTransitions = 0;
+        int64 StateMismatchFrames = 0;
+        uint64 Cycles = 0;
+        int32 TransitionCounts[NumStates][NumStates] = {};
+        
+        void Accumulate(const FStats& Other)
+        {
+            Frames += Other.Frames;
+            RecordedTransitions += Other.RecordedTransitions;
+            ReplayedTransitions += Other.ReplayedTransitions;
+            StateMismatchFrames += Other.StateMismatchFrames;
+            Cycles += Other.Cycles;
+            for (int32 From = 0; From < NumStates; ++From)
+            {
+                for (int32 To = 0; To < NumStates; ++To)
+                {
+                    TransitionCounts[From][To] += Other.TransitionCounts[From][To];
+                }
+            }
+        }
+    };
+    
+    struct FJob
+    {
+        TUniquePtr<FAnimTraceReader> Reader;
+        UAnimationStateMachine* Machine = nullptr;
+        FLocomotionSnapshot Snapshot;
+        FStats Stats;
+    };
+    
+    static void Replay(FJob& Job, int32 Repeat)
+    {
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        
+        for (int32 Pass = 0; Pass < Repeat; ++Pass)
+        {
+            Job.Reader->Rewind();
+            Job.Machine->Reset();
+            
+            const FAnimTraceFrame* Frame = nullptr;
+            TArrayView<const FAnimTraceTransition> Transitions;
+            while (Job.Reader->NextFrame(Frame, Transitions))
+            {
+                Job.Snapshot = Frame->ToSnapshot();
+                Job.Machine->Tick(Frame->DeltaTime);
+                
+                ++Job.Stats.Frames;
+                Job.Stats.RecordedTransitions += Transitions.Num();
+                if (Job.Machine->GetCurrentState() != Frame->State)
+                {
+                    ++Job.Stats.StateMismatchFrames;
+                }
+            }
+        }
+        
+        Job.Stats.Cycles = FPlatformTime::Cycles64() - StartCycles;
+    }
+}
+
+UAnimTraceReplayCommandlet::UAnimTraceReplayCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UAnimTraceReplayCommandlet::Main(const FString& Params)
+{
+    using namespace AnimTraceReplay;
+    
+    FString TraceDir = FPaths::ProfilingDir() / TEXT("AnimTraces");
+    FParse::Value(*Params, TEXT("Traces="), TraceDir);
+    
+    int32 Repeat = 1;
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    Repeat = FMath::Max(1, Repeat);
+    
+    // Defaults to the rate each trace was recorded with
+    float FixedStepHz = -1.f;
+    FParse::Value(*Params, TEXT("FixedStepHz="), FixedStepHz);
+    
+    TArray<FString> Files;
+    IFileManager::Get().FindFilesRecursive(Files, *TraceDir, TEXT("*.animtrace"), true, false);
+    if (Files.Num() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("No .animtrace files found under '%s'."), *TraceDir);
+        return 1;
+    }
+    
+    // Readers and machines are created up front on the game thread; the parallel part
+    // only ticks logic-only machines and touches no UObject globals
+    TArray<FJob> Jobs;
+    Jobs.Reserve(Files.Num());
+    for (const FString& File : Files)
+    {
+        TUniquePtr<FAnimTraceReader> Reader = MakeUnique<FAnimTraceReader>(File);
+        if (!Reader->IsValid())
+            continue;
+        
+        FJob& Job = Jobs.AddDefaulted_GetRef();
+        Job.Reader = MoveTemp(Reader);
+    }
+    
+    // Bound after the array stops growing so the captured pointers stay valid
+    const TSharedRef<const FAnimStateMachineDefinition> Definition = AnimDemoLocomotion::GetDefinition(FLocomotionArchetype());
+    for (FJob& Job : Jobs)
+    {
+        Job.Machine = UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), Definition, &Job.Snapshot);
+        Job.Machine->AddToRoot();
+        Job.Machine->SetFixedStepRate(FixedStepHz >= 0.f ? FixedStepHz : Job.Reader->GetFixedStepHz());
+        
+        FStats* Stats = &Job.Stats;
+        Job.Machine->OnTransition().AddLambda([Stats](ECharacterAnimState From, ECharacterAnimState To, float)
+        {
+            ++Stats->ReplayedTransitions;
+            ++Stats->TransitionCounts[static_cast<int32>(From)][static_cast<int32>(To)];
+        });
+    }
+    
+    const double StartTime = FPlatformTime::Seconds();
+    ParallelFor(Jobs.Num(), [&Jobs, Repeat](int32 Index)
+    {
+        Replay(Jobs[Index], Repeat);
+    });
+    const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+    
+    FStats Total;
+    int32 NumTruncated = 0;
+    for (FJob& Job : Jobs)
+    {
+        Total.Accumulate(Job.Stats);
+        Job.Machine->RemoveFromRoot();
+        
+        // A cut-off trace would otherwise show up as divergence
+        if (Job.Reader->IsTruncated())
+        {
+            UE_LOG(LogTemp, Error, TEXT("'%s' ends in a partial record; the recording is corrupt."), *Job.Reader->GetFilename());
+            ++NumTruncated;
+        }
+    }
+    
+    const double CpuSeconds = FPlatformTime::ToSeconds64(Total.Cycles);
+    UE_LOG(LogTemp, Display, TEXT("Replayed %d traces x%d: %lld frames in %.3f s wall, %.3f s cpu (%.1f ns/frame, %.2f Mframes/s)"),
+        Jobs.Num(), Repeat, Total.Frames, WallSeconds, CpuSeconds,
+        Total.Frames > 0 ? CpuSeconds * 1.0e9 / Total.Frames : 0.0,
+        WallSeconds > 0.0 ? Total.Frames / WallSeconds / 1.0e6 : 0.0);
+    UE_LOG(LogTemp, Display, TEXT("Transitions: %lld recorded, %lld replayed, %lld frames with a different state than recorded"),
+        Total.RecordedTransitions, Total.ReplayedTransitions, Total.StateMismatchFrames);
+    
+    const UEnum* StateEnum = StaticEnum<ECharacterAnimState>();
+    for (int32 From = 0; From < NumStates; ++From)
+    {
+        for (int32 To = 0; To < NumStates; ++To)
+        {
+            if (Total.TransitionCounts[From][To] > 0)
+            {
+                UE_LOG(LogTemp, Display, TEXT("  %s -> %s: %d"),
+                    *StateEnum->GetDisplayNameTextByValue(From).ToString(),
+                    *StateEnum->GetDisplayNameTextByValue(To).ToString(),
+                    Total.TransitionCounts[From][To]);
+            }
+        }
+    }
+    
+    if (NumTruncated > 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%d of %d traces are truncated."), NumTruncated, Jobs.Num());
+        return 3;
+    }
+    return Total.StateMismatchFrames > 0 ? 2 : 0;
+}
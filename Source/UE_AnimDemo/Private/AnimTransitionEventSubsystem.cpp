@@ -0,0 +1,75 @@
+//
+//  AnimTransitionEventSubsystem.cpp
+//
+#include "AnimTransitionEventSubsystem.h"
+#include "AnimDemoStats.h"
+#include "AnimDemoMemory.h"
+
+void UAnimTransitionEventSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    LLM_SCOPE_BYTAG(AnimDemo_StateMachine);
+    Queue = MakeShared<FAnimTransitionEventQueue>();
+}
+
+void UAnimTransitionEventSubsystem::Deinitialize()
+{
+    for (FOnAnimTransitionEvent (&Row)[NumStates] : Subscribers)
+    {
+        for (FOnAnimTransitionEvent& Event : Row)
+        {
+            Event.Clear();
+        }
+    }
+    Queue.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UAnimTransitionEventSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UAnimTransitionEventSubsystem, STATGROUP_Tickables);
+}
+
+FDelegateHandle UAnimTransitionEventSubsystem::Subscribe(ECharacterAnimState From, ECharacterAnimState To, FOnAnimTransitionEvent::FDelegate&& Delegate)
+{
+    return Subscribers[static_cast<int32>(From)][static_cast<int32>(To)].Add(MoveTemp(Delegate));
+}
+
+void UAnimTransitionEventSubsystem::Unsubscribe(ECharacterAnimState From, ECharacterAnimState To, FDelegateHandle Handle)
+{
+    Subscribers[static_cast<int32>(From)][static_cast<int32>(To)].Remove(Handle);
+}
+
+void UAnimTransitionEventSubsystem::Tick(float DeltaTime)
+{
+    if (!Queue)
+        return;
+
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(TransitionEventDrain);
+
+    const int32 NumEvents = Queue->Drain([this](const FAnimTransitionEvent& Event)
+    {
+        Dispatch(Event);
+    });
+    INC_DWORD_STAT_BY(STAT_AnimDemo_TransitionEvents, NumEvents);
+
+    if (const uint32 NumDropped = Queue->ConsumeNumDropped())
+    {
+        INC_DWORD_STAT_BY(STAT_AnimDemo_TransitionEventsDropped, NumDropped);
+        UE_LOG(LogTemp, Warning, TEXT("Dropped %u anim transition events, more than %u in one frame."), NumDropped, Queue->GetCapacity());
+    }
+}
+
+void UAnimTransitionEventSubsystem::Dispatch(const FAnimTransitionEvent& Event)
+{
+    const int32 From = static_cast<int32>(Event.From);
+    const int32 To = static_cast<int32>(Event.To);
+    const int32 Any = static_cast<int32>(ECharacterAnimState::None);
+
+    Subscribers[From][To].Broadcast(Event);
+    Subscribers[From][Any].Broadcast(Event);
+    Subscribers[Any][To].Broadcast(Event);
+    Subscribers[Any][Any].Broadcast(Event);
+}
@@ -9,174 +9,412 @@
 #include "Animation/AnimSequence.h"
 #include "Animation/BlendSpace1D.h"
 #include "Animation/AnimInstance.h"
+#include "AnimDemoStats.h"
+#include "AnimDemoTrace.h"
+#include "AnimDemoMemory.h"
+#include "GameFramework/Actor.h"
+#include "AnimTransitionEventSubsystem.h"
+#include "LocomotionSnapshot.h"
+#include "Engine/World.h"
+#include "Algo/BinarySearch.h"
 
-UAnimationStateMachine::UAnimationStateMachine()
+FAnimStateMachineDefinition::FAnimStateMachineDefinition()
 {
-    CurrentState = ECharacterAnimState::Idle;
-    PreviousState = ECharacterAnimState::Idle;
-    StateTime = 0.0f;
+    INC_DWORD_STAT(STAT_AnimDemo_NumStateMachineDefinitions);
+}
+
+FAnimStateMachineDefinition::FAnimStateMachineDefinition(const FAnimStateMachineDefinition& Other)
+    : FGCObject(Other)
+    , StateAnimations(Other.StateAnimations)
+    , Transitions(Other.Transitions)
+{
+    INC_DWORD_STAT(STAT_AnimDemo_NumStateMachineDefinitions);
+}
+
+FAnimStateMachineDefinition::~FAnimStateMachineDefinition()
+{
+    DEC_DWORD_STAT(STAT_AnimDemo_NumStateMachineDefinitions);
+}
+
+void FAnimStateMachineDefinition::RegisterStateAnimation(ECharacterAnimState State, UAnimSequence* Animation, bool bLooping, float PlayRate)
+{
+    LLM_SCOPE_BYTAG(AnimDemo_StateMachine);
+    
+    FAnimationStateData StateData;
+    StateData.Animation = Animation;
+    StateData.bLooping = bLooping;
+    StateData.PlayRate = PlayRate;
+    
+    StateAnimations.Add(State, StateData);
+}
+
+void FAnimStateMachineDefinition::RegisterStateBlendSpace(ECharacterAnimState State, UBlendSpace* BlendSpace, bool bLooping, float PlayRate)
+{
+    LLM_SCOPE_BYTAG(AnimDemo_StateMachine);
+    
+    FAnimationStateData StateData;
+    StateData.BlendSpace = BlendSpace;
+    StateData.bLooping = bLooping;
+    StateData.PlayRate = PlayRate;
+    
+    StateAnimations.Add(State, StateData);
+}
+
+void FAnimStateMachineDefinition::AddTransition(ECharacterAnimState FromState, ECharacterAnimState ToState, FAnimStateCondition Condition, float Duration)
+{
+    LLM_SCOPE_BYTAG(AnimDemo_StateMachine);
+    
+    // After the last transition of FromState; definitions are usually built state by state, so
+    // this is an append
+    const int32 Index = Algo::UpperBoundBy(Transitions, FromState, &FStateTransition::FromState);
+    FStateTransition& Transition = Transitions.EmplaceAt_GetRef(Index, FromState, ToState, Duration);
+    Transition.Condition = MoveTemp(Condition);
+}
+
+const FStateTransition* FAnimStateMachineDefinition::FindTransition(ECharacterAnimState State, const FLocomotionSnapshot& Context) const
+{
+    for (int32 Index = Algo::LowerBoundBy(Transitions, State, &FStateTransition::FromState);
+        Index < Transitions.Num() && Transitions[Index].FromState == State; ++Index)
+    {
+        const FStateTransition& Transition = Transitions[Index];
+        if (Transition.Condition && Transition.Condition(Context))
+        {
+            return &Transition;
+        }
+    }
+    return nullptr;
+}
+
+SIZE_T FAnimStateMachineDefinition::GetAllocatedSize() const
+{
+    return StateAnimations.GetAllocatedSize() + Transitions.GetAllocatedSize();
+}
+
+void FAnimStateMachineDefinition::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    for (TPair<ECharacterAnimState, FAnimationStateData>& Pair : StateAnimations)
+    {
+        Collector.AddReferencedObject(Pair.Value.Animation);
+        Collector.AddReferencedObject(Pair.Value.BlendSpace);
+    }
+}
+
+bool FAnimStateMachineRuntime::Advance(float StepSeconds)
+{
+    StateTime += StepSeconds;
+    
+    if (bIsTransitioning)
+    {
+        TransitionTime += StepSeconds;
+        
+        // Blend weights are applied by the anim instance; only completion matters here
+        if (TransitionTime >= CurrentTransitionDuration)
+        {
+            bIsTransitioning = false;
+            TransitionTime = 0.0f;
+            PreviousState = CurrentState;
+        }
+    }
+    
+    return !bIsTransitioning;
+}
+
+void FAnimStateMachineRuntime::Enter(ECharacterAnimState NewState, float Duration)
+{
+    PreviousState = CurrentState;
+    CurrentState = NewState;
+    CurrentTransitionDuration = Duration;
     TransitionTime = 0.0f;
-    CurrentTransitionDuration = 0.0f;
-    bIsTransitioning = false;
+    bIsTransitioning = true;
+    StateTime = 0.0f;
+}
+
+void FAnimStateMachineRuntime::Reset(ECharacterAnimState InitialState)
+{
+    *this = FAnimStateMachineRuntime();
+    CurrentState = InitialState;
+    PreviousState = InitialState;
+}
+
+UAnimationStateMachine::UAnimationStateMachine()
+{
+    Context = nullptr;
+    bOwnsDefinition = false;
+    bLogicOnly = false;
+    FixedStepSeconds = 0.0f;
+    bInitialized = false;
+    TraceActorId = 0;
     BlendSpaceInputValue = 0.0f;
     MeshComponent = nullptr;
 }
 
 void UAnimationStateMachine::Initialize(USkeletalMeshComponent* InMeshComponent)
 {
+    if (!bInitialized)
+    {
+        bInitialized = true;
+        INC_DWORD_STAT(STAT_AnimDemo_NumStateMachines);
+    }
+    
     MeshComponent = InMeshComponent;
     
+    // Trace events are keyed by the owning actor so they can be matched to it in Insights
+    const AActor* OwnerActor = GetTypedOuter<AActor>();
+    TraceActorId = OwnerActor ? OwnerActor->GetUniqueID() : GetUniqueID();
+    
+    // Offline tools have no world and publish nothing
+    UWorld* World = OwnerActor ? OwnerActor->GetWorld() : nullptr;
+    UAnimTransitionEventSubsystem* Events = World ? World->GetSubsystem<UAnimTransitionEventSubsystem>() : nullptr;
+    EventQueue = Events ? Events->GetQueue() : nullptr;
+    EventActor = const_cast<AActor*>(OwnerActor);
+    
     // Set initial state
     if (MeshComponent)
     {
-        PlayStateAnimation(CurrentState);
+        PlayStateAnimation(Runtime.CurrentState);
     }
 }
 
+void UAnimationStateMachine::BeginDestroy()
+{
+    if (bInitialized)
+    {
+        bInitialized = false;
+        DEC_DWORD_STAT(STAT_AnimDemo_NumStateMachines);
+    }
+    
+    Super::BeginDestroy();
+}
+
+void UAnimationStateMachine::GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize)
+{
+    Super::GetResourceSizeEx(CumulativeResourceSize);
+    
+    // Not reflected, so the property-based estimate misses them. A shared definition is counted
+    // by nobody here, it belongs to the archetype; the functors' own heap storage is only visible
+    // through the AnimDemo/StateMachine LLM tag.
+    if (bOwnsDefinition && Definition)
+    {
+        CumulativeResourceSize.AddDedicatedSystemMemoryBytes(sizeof(FAnimStateMachineDefinition) + Definition->GetAllocatedSize());
+    }
+    CumulativeResourceSize.AddDedicatedSystemMemoryBytes(TransitionEvent.GetAllocatedSize());
+}
+
 void UAnimationStateMachine::Tick(float DeltaTime)
 {
-    if (!MeshComponent)
-        return;
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(StateMachineTick);
     
-    StateTime += DeltaTime;
+    if (!MeshComponent && !bLogicOnly)
+        return;
     
-    // Update transitions if we're currently transitioning
-    if (bIsTransitioning)
+    if (FixedStepSeconds <= 0.0f)
+    {
+        StepLogic(DeltaTime);
+        AnimDemoStats::CountStateMachineSteps(1);
+    }
+    else
     {
-        TransitionTime += DeltaTime;
+        Runtime.StepAccumulator += DeltaTime;
         
-        float Alpha = FMath::Clamp(TransitionTime / CurrentTransitionDuration, 0.0f, 1.0f);
+        int32 NumSteps = 0;
+        while (Runtime.StepAccumulator >= FixedStepSeconds && NumSteps < MaxStepsPerTick)
+        {
+            StepLogic(FixedStepSeconds);
+            Runtime.StepAccumulator -= FixedStepSeconds;
+            ++NumSteps;
+        }
         
-        // Update blend weights or handle transition logic here
-        // For simplicity, we'll just check if transition is complete
-        if (Alpha >= 1.0f)
+        // After a hitch, drop the backlog rather than spiral trying to catch up
+        if (NumSteps == MaxStepsPerTick)
         {
-            bIsTransitioning = false;
-            TransitionTime = 0.0f;
-            PreviousState = CurrentState;
+            Runtime.StepAccumulator = FMath::Min(Runtime.StepAccumulator, FixedStepSeconds);
         }
+        
+        AnimDemoStats::CountStateMachineSteps(NumSteps);
     }
     
-    // Check for state transitions
-    if (!bIsTransitioning)
-    {
-        UpdateTransitions();
-    }
+    if (bLogicOnly)
+        return;
     
     // Update blend space inputs if current state uses one
-    if (StateAnimations.Contains(CurrentState))
+    const FAnimationStateData* StateData = Definition ? Definition->FindStateData(Runtime.CurrentState) : nullptr;
+    if (StateData && StateData->BlendSpace && MeshComponent->GetAnimInstance())
     {
-        FAnimationStateData& StateData = StateAnimations[CurrentState];
-        if (StateData.BlendSpace && MeshComponent->GetAnimInstance())
-        {
-            // Update blend space parameter - you'd typically expose this as a function parameter
-            // or get it from character movement component
-            // This is just an example of how you'd set blend space inputs
-        }
+        // Update blend space parameter - you'd typically expose this as a function parameter
+        // or get it from character movement component
+        // This is just an example of how you'd set blend space inputs
+    }
+}
+
+void UAnimationStateMachine::StepLogic(float StepSeconds)
+{
+    // Check for state transitions once any running one has finished
+    if (Runtime.Advance(StepSeconds))
+    {
+        UpdateTransitions();
     }
 }
 
+void UAnimationStateMachine::SetFixedStepRate(float Hz)
+{
+    FixedStepSeconds = Hz > 0.0f ? 1.0f / Hz : 0.0f;
+    Runtime.StepAccumulator = 0.0f;
+}
+
+float UAnimationStateMachine::GetTransitionAlpha() const
+{
+    if (!Runtime.bIsTransitioning || Runtime.CurrentTransitionDuration <= 0.0f)
+        return 1.0f;
+    
+    return FMath::Clamp((Runtime.TransitionTime + Runtime.StepAccumulator) / Runtime.CurrentTransitionDuration, 0.0f, 1.0f);
+}
+
 void UAnimationStateMachine::UpdateTransitions()
 {
-    // Check all registered transitions
-    for (const FStateTransition& Transition : Transitions)
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(UpdateTransitions);
+    
+    // Condition timing is only taken while the trace channel is recording
+    const bool bTimeConditions = ANIMDEMO_TRACE_IS_ENABLED();
+    const uint64 ConditionStartCycles = bTimeConditions ? FPlatformTime::Cycles64() : 0;
+    
+    if (!Definition)
+        return;
+    
+    // Machines built through the legacy AddTransition have no context; their conditions ignore it
+    static const FLocomotionSnapshot NoContext;
+    
+    // Take the first valid transition of the current state
+    if (const FStateTransition* Transition = Definition->FindTransition(Runtime.CurrentState, Context ? *Context : NoContext))
     {
-        if (Transition.FromState == CurrentState && Transition.Condition && Transition.Condition())
-        {
-            StartTransition(Transition.ToState, Transition.TransitionDuration);
-            break; // Take the first valid transition
-        }
+        const uint64 ConditionCycles = bTimeConditions ? FPlatformTime::Cycles64() - ConditionStartCycles : 0;
+        StartTransition(Transition->ToState, Transition->TransitionDuration, ConditionCycles);
     }
 }
 
-void UAnimationStateMachine::StartTransition(ECharacterAnimState NewState, float Duration)
+void UAnimationStateMachine::StartTransition(ECharacterAnimState NewState, float Duration, uint64 ConditionCycles, bool bForced)
 {
-    if (NewState == CurrentState)
+    if (NewState == Runtime.CurrentState)
         return;
     
-    PreviousState = CurrentState;
-    CurrentState = NewState;
-    CurrentTransitionDuration = Duration;
-    TransitionTime = 0.0f;
-    bIsTransitioning = true;
-    StateTime = 0.0f;
+    ANIMDEMO_TRACE_SCOPE(StartTransition);
+    ANIMDEMO_TRACE_TRANSITION(TraceActorId, Runtime.CurrentState, NewState, Duration, ConditionCycles,
+        bForced ? EAnimDemoTransitionKind::Forced : EAnimDemoTransitionKind::Condition);
+    
+    Runtime.Enter(NewState, Duration);
+    
+    AnimDemoStats::CountTransitionTaken();
+    TransitionEvent.Broadcast(Runtime.PreviousState, NewState, Duration);
+    
+    if (EventQueue)
+    {
+        FAnimTransitionEvent Event;
+        Event.Actor = EventActor;
+        Event.Duration = Duration;
+        Event.From = Runtime.PreviousState;
+        Event.To = NewState;
+        EventQueue->Push(Event);
+    }
     
     PlayStateAnimation(NewState);
 }
 
 void UAnimationStateMachine::PlayStateAnimation(ECharacterAnimState State)
 {
-    if (!MeshComponent || !MeshComponent->GetAnimInstance())
+    if (bLogicOnly || !MeshComponent || !MeshComponent->GetAnimInstance())
         return;
     
-    if (!StateAnimations.Contains(State))
+    const FAnimationStateData* StateDataPtr = Definition ? Definition->FindStateData(State) : nullptr;
+    if (!StateDataPtr)
         return;
     
-    const FAnimationStateData& StateData = StateAnimations[State];
-    UAnimInstance* AnimInstance = MeshComponent->GetAnimInstance();
+    ANIMDEMO_TRACE_SCOPE(PlayStateAnimation);
     
-    if (StateData.Animation)
-    {
-        // Stop any currently playing montages
-        AnimInstance->StopAllMontages(StateData.BlendOutTime);
-        
-        // Play the animation sequence
-        // Note: For a full implementation, you'd want to create and play montages
-        // or use a custom AnimInstance that handles state-based playback
-        
-        // This is a simplified approach - in a real implementation you'd typically
-        // create montages from sequences or use a custom AnimInstance
-    }
-    else if (StateData.BlendSpace)
-    {
-        // Handle blend space playback
-        // This would require custom AnimInstance integration
-    }
+    // The anim instance owns montage playback (UMyAnimInstance plays and stops the state montages
+    // itself), so the machine only reports which animation the state asks for and never stops
+    // montages it did not start
+    ANIMDEMO_TRACE_PLAY_STATE_ANIMATION(TraceActorId, State, StateDataPtr->Animation);
 }
 
 void UAnimationStateMachine::ForceState(ECharacterAnimState NewState)
 {
     if (CanTransitionTo(NewState))
     {
-        StartTransition(NewState, 0.1f); // Quick transition for forced states
+        StartTransition(NewState, 0.1f, 0, true); // Quick transition for forced states
     }
 }
 
+void UAnimationStateMachine::Reset(ECharacterAnimState InitialState)
+{
+    Runtime.Reset(InitialState);
+}
+
+void UAnimationStateMachine::SaveSnapshot(FAnimStateMachineSnapshot& OutSnapshot) const
+{
+    OutSnapshot = Runtime;
+}
+
+void UAnimationStateMachine::RestoreSnapshot(const FAnimStateMachineSnapshot& Snapshot)
+{
+    Runtime = Snapshot;
+}
+
 bool UAnimationStateMachine::CanTransitionTo(ECharacterAnimState NewState) const
 {
     // Add any global transition rules here
     // For example, you might not allow transitions while already transitioning
     // or have certain states that can't be interrupted
     
-    if (bIsTransitioning)
+    if (Runtime.bIsTransitioning)
         return false;
     
     return true;
 }
 
+UAnimationStateMachine* UAnimationStateMachine::CreateLogicOnly(UObject* Outer, const TSharedRef<const FAnimStateMachineDefinition>& InDefinition, const FLocomotionSnapshot* InContext)
+{
+    UAnimationStateMachine* Machine = NewObject<UAnimationStateMachine>(Outer);
+    Machine->SetLogicOnly(true);
+    Machine->Initialize(nullptr);
+    Machine->SetDefinition(InDefinition, InContext);
+    return Machine;
+}
+
+void UAnimationStateMachine::SetDefinition(const TSharedRef<const FAnimStateMachineDefinition>& InDefinition, const FLocomotionSnapshot* InContext)
+{
+    Definition = InDefinition;
+    Context = InContext;
+    bOwnsDefinition = false;
+}
+
+FAnimStateMachineDefinition& UAnimationStateMachine::GetOwnDefinition()
+{
+    if (!bOwnsDefinition)
+    {
+        LLM_SCOPE_BYTAG(AnimDemo_StateMachine);
+        
+        // Copy on write, the machines sharing the old definition keep it as it was
+        Definition = Definition ? MakeShared<FAnimStateMachineDefinition>(*Definition) : MakeShared<FAnimStateMachineDefinition>();
+        bOwnsDefinition = true;
+    }
+    return const_cast<FAnimStateMachineDefinition&>(*Definition);
+}
+
 void UAnimationStateMachine::RegisterStateAnimation(ECharacterAnimState State, UAnimSequence* Animation, bool bLooping, float PlayRate)
 {
-    FAnimationStateData StateData;
-    StateData.Animation = Animation;
-    StateData.bLooping = bLooping;
-    StateData.PlayRate = PlayRate;
-    
-    StateAnimations.Add(State, StateData);
+    GetOwnDefinition().RegisterStateAnimation(State, Animation, bLooping, PlayRate);
 }
 
 void UAnimationStateMachine::RegisterStateBlendSpace(ECharacterAnimState State, UBlendSpace* BlendSpace, bool bLooping, float PlayRate)
 {
-    FAnimationStateData StateData;
-    StateData.BlendSpace = BlendSpace;
-    StateData.bLooping = bLooping;
-    StateData.PlayRate = PlayRate;
-    
-    StateAnimations.Add(State, StateData);
+    GetOwnDefinition().RegisterStateBlendSpace(State, BlendSpace, bLooping, PlayRate);
 }
 
 void UAnimationStateMachine::AddTransition(ECharacterAnimState FromState, ECharacterAnimState ToState, TFunction<bool()> Condition, float Duration)
 {
-    FStateTransition Transition(FromState, ToState, Duration);
-    Transition.Condition = Condition;
-    Transitions.Add(Transition);
+    FAnimStateCondition ContextCondition;
+    if (Condition)
+    {
+        ContextCondition = [Legacy = MoveTemp(Condition)](const FLocomotionSnapshot&) { return Legacy(); };
+    }
+    GetOwnDefinition().AddTransition(FromState, ToState, MoveTemp(ContextCondition), Duration);
 }
@@ -0,0 +1,161 @@
+//
+//  AsyncSpringArmComponent.cpp
+//
+#include "AsyncSpringArmComponent.h"
+#include "AnimDemoStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarCameraAsyncProbe(
+    TEXT("AnimDemo.Camera.AsyncProbe"),
+    true,
+    TEXT("Probe camera boom collision with async sweeps, using the previous frame's result. 0 sweeps synchronously every frame."));
+
+static TAutoConsoleVariable<bool> CVarCameraCountClipping(
+    TEXT("AnimDemo.Camera.CountClipping"),
+    false,
+    TEXT("Test every final camera location for penetration and count the incidents. Diagnostic only, adds a synchronous overlap per camera."));
+
+const FObjectInitializer& UAsyncSpringArmComponent::SkipRigOnDedicatedServer(const FObjectInitializer& ObjectInitializer, FName BoomName, FName CameraName)
+{
+    if (!IsRunningDedicatedServer() || ObjectInitializer.GetObj()->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+        return ObjectInitializer;
+    
+    return ObjectInitializer.DoNotCreateDefaultSubobject(BoomName).DoNotCreateDefaultSubobject(CameraName);
+}
+
+FAsyncSpringArmCounters& UAsyncSpringArmComponent::GetCounters()
+{
+    static FAsyncSpringArmCounters Counters;
+    return Counters;
+}
+
+void UAsyncSpringArmComponent::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime)
+{
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(CameraBoomUpdate);
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    if (bDoTrace && CVarCameraAsyncProbe.GetValueOnGameThread())
+    {
+        UpdateArmWithAsyncProbe(bDoLocationLag, bDoRotationLag, DeltaTime);
+    }
+    else
+    {
+        bHasProbeResult = false;
+        Super::UpdateDesiredArmLocation(bDoTrace, bDoLocationLag, bDoRotationLag, DeltaTime);
+
+        if (bDoTrace)
+        {
+            ++GetCounters().NumSyncSweeps;
+            INC_DWORD_STAT(STAT_AnimDemo_CameraSyncSweeps);
+        }
+    }
+
+    FAsyncSpringArmCounters& Counters = GetCounters();
+    ++Counters.NumUpdates;
+    Counters.UpdateCycles += FPlatformTime::Cycles64() - StartCycles;
+
+    if (bDoTrace && CVarCameraCountClipping.GetValueOnGameThread())
+    {
+        CountClipping();
+    }
+}
+
+void UAsyncSpringArmComponent::UpdateArmWithAsyncProbe(bool bDoLocationLag, bool bDoRotationLag, float DeltaTime)
+{
+    // Lag and the unobstructed socket come from the stock arm; it leaves the arm origin and the
+    // desired location and rotation in the Previous* members
+    Super::UpdateDesiredArmLocation(false, bDoLocationLag, bDoRotationLag, DeltaTime);
+
+    const FVector Origin = PreviousArmOrigin;
+    const FVector Desired = PreviousDesiredLoc;
+    const FRotator DesiredRot = PreviousDesiredRot;
+
+    const bool bCameraCut = !bHasProbeResult
+        || FVector::DistSquared(Desired, LastDesiredLocation) > FMath::Square(CameraCutDistance)
+        || FQuat(DesiredRot).AngularDistance(FQuat(LastDesiredRotation)) > FMath::DegreesToRadians(CameraCutAngle);
+
+    LastDesiredLocation = Desired;
+    LastDesiredRotation = DesiredRot;
+
+    if (bCameraCut)
+    {
+        // A stale probe says nothing about the new view, and clipping through a wall on a cut is very visible
+        ProbeFraction = PreviousProbeFraction = SmoothedFraction = SweepSync(Origin, Desired);
+        bHasProbeResult = true;
+        ++GetCounters().NumSyncSweeps;
+        INC_DWORD_STAT(STAT_AnimDemo_CameraSyncSweeps);
+    }
+    else
+    {
+        // Extrapolate a closing obstruction one frame ahead, since the probe is a frame old
+        const float Trend = ProbeFraction - PreviousProbeFraction;
+        const float Target = Trend < 0.f ? FMath::Clamp(ProbeFraction + Trend, 0.f, 1.f) : ProbeFraction;
+
+        SmoothedFraction = Target < SmoothedFraction
+            ? Target
+            : FMath::FInterpTo(SmoothedFraction, Target, DeltaTime, ProbeRecoverySpeed);
+    }
+
+    bIsCameraFixed = SmoothedFraction < 1.f;
+    UnfixedCameraPosition = Desired;
+
+    if (bIsCameraFixed)
+    {
+        // The stock update already placed the socket at the unobstructed location
+        const FVector ResultLoc = Origin + (Desired - Origin) * SmoothedFraction;
+        const FTransform RelCamTM = FTransform(DesiredRot, ResultLoc).GetRelativeTransform(GetComponentTransform());
+        RelativeSocketLocation = RelCamTM.GetLocation();
+        UpdateChildTransforms();
+    }
+
+    // Queue the probe the next frame will use
+    UWorld* World = GetWorld();
+    if (!World)
+        return;
+
+    if (!ProbeDelegate.IsBound())
+    {
+        ProbeDelegate.BindUObject(this, &UAsyncSpringArmComponent::HandleProbeDone);
+    }
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AnimDemoAsyncSpringArm), false, GetOwner());
+    PendingProbe = World->AsyncSweepByChannel(EAsyncTraceType::Single, Origin, Desired, FQuat::Identity, ProbeChannel,
+        FCollisionShape::MakeSphere(ProbeSize), QueryParams, FCollisionResponseParams::DefaultResponseParam, &ProbeDelegate);
+
+    ++GetCounters().NumAsyncSweeps;
+    INC_DWORD_STAT(STAT_AnimDemo_CameraAsyncSweeps);
+}
+
+void UAsyncSpringArmComponent::HandleProbeDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if (Handle != PendingProbe)
+        return;
+
+    const FHitResult* Hit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit ? &Datum.OutHits[0] : nullptr;
+
+    PreviousProbeFraction = ProbeFraction;
+    ProbeFraction = Hit ? Hit->Time : 1.f;
+}
+
+float UAsyncSpringArmComponent::SweepSync(const FVector& Origin, const FVector& Desired) const
+{
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SpringArm), false, GetOwner());
+
+    FHitResult Hit;
+    GetWorld()->SweepSingleByChannel(Hit, Origin, Desired, FQuat::Identity, ProbeChannel, FCollisionShape::MakeSphere(ProbeSize), QueryParams);
+    return Hit.bBlockingHit ? Hit.Time : 1.f;
+}
+
+void UAsyncSpringArmComponent::CountClipping()
+{
+    const FVector CameraLocation = GetSocketLocation(SocketName);
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(AnimDemoCameraClipping), false, GetOwner());
+
+    // Half the probe radius still leaves the near plane inside the geometry
+    if (GetWorld()->OverlapBlockingTestByChannel(CameraLocation, FQuat::Identity, ProbeChannel, FCollisionShape::MakeSphere(ProbeSize * 0.5f), QueryParams))
+    {
+        ++GetCounters().NumClipIncidents;
+        INC_DWORD_STAT(STAT_AnimDemo_CameraClipIncidents);
+    }
+}
@@ -0,0 +1,157 @@
+//
+//  CrowdPoseBatch.cpp
+//
+#include "CrowdPoseBatch.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimationPoseData.h"
+#include "Animation/AttributesRuntime.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "BoneContainer.h"
+#include "BonePose.h"
+#include "Engine/SkeletalMesh.h"
+#include "ReferenceSkeleton.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+bool FCrowdPoseClip::Bake(const UAnimSequence& Sequence, USkeletalMesh& Mesh, float InSampleHz)
+{
+    const FReferenceSkeleton& RefSkeleton = Mesh.GetRefSkeleton();
+    const int32 NumMeshBones = RefSkeleton.GetNum();
+    const float SequenceLength = Sequence.GetPlayLength();
+    if (NumMeshBones == 0 || SequenceLength <= 0.f || InSampleHz <= 0.f)
+        return false;
+
+    TArray<int32> Parents;
+    TArray<FBoneIndexType> RequiredBones;
+    Parents.SetNumUninitialized(NumMeshBones);
+    RequiredBones.SetNumUninitialized(NumMeshBones);
+    for (int32 Bone = 0; Bone < NumMeshBones; ++Bone)
+    {
+        Parents[Bone] = RefSkeleton.GetParentIndex(Bone);
+        RequiredBones[Bone] = static_cast<FBoneIndexType>(Bone);
+    }
+
+    // A whole number of intervals, so the keys are evenly spaced all the way to the loop point
+    const int32 NumIntervals = FMath::Max(1, FMath::RoundToInt(SequenceLength * InSampleHz));
+    Init(MoveTemp(Parents), NumIntervals + 1, NumIntervals / SequenceLength);
+
+    FBoneContainer BoneContainer(RequiredBones, UE::Anim::FCurveFilterSettings(UE::Anim::ECurveFilterMode::DisallowAll), Mesh);
+    FCompactPose Pose;
+    Pose.SetBoneContainer(&BoneContainer);
+    FBlendedCurve Curve;
+    Curve.InitFrom(BoneContainer);
+    UE::Anim::FStackAttributeContainer Attributes;
+    FAnimationPoseData PoseData(Pose, Curve, Attributes);
+
+    const TArray<FTransform>& RefPose = RefSkeleton.GetRefBonePose();
+    for (int32 Key = 0; Key < NumIntervals; ++Key)
+    {
+        Sequence.GetAnimationPose(PoseData, FAnimExtractContext(static_cast<double>(Key / SampleHz), false));
+
+        TArrayView<FTransform3f> Out = GetKey(Key);
+        for (int32 Bone = 0; Bone < NumBones; ++Bone)
+        {
+            Out[Bone] = FTransform3f(RefPose[Bone]);
+        }
+        for (const FCompactPoseBoneIndex BoneIndex : Pose.ForEachBoneIndex())
+        {
+            Out[BoneContainer.MakeMeshPoseIndex(BoneIndex).GetInt()] = FTransform3f(Pose[BoneIndex]);
+        }
+    }
+
+    // Loop point
+    FMemory::Memcpy(GetKey(NumIntervals).GetData(), GetKey(0).GetData(), NumBones * sizeof(FTransform3f));
+    return true;
+}
+
+void FCrowdPoseClip::Init(TArray<int32> InParentIndices, int32 InNumKeys, float InSampleHz)
+{
+    check(InNumKeys >= 2 && InSampleHz > 0.f);
+
+    ParentIndices = MoveTemp(InParentIndices);
+    NumBones = ParentIndices.Num();
+    NumKeys = InNumKeys;
+    SampleHz = InSampleHz;
+    Length = (NumKeys - 1) / SampleHz;
+    Keys.SetNumZeroed(NumKeys * NumBones);
+}
+
+void FCrowdPoseClip::SamplePose(float Time, TArray<FTransform3f>& Scratch, FTransform* OutComponentSpace) const
+{
+    float Wrapped = FMath::Fmod(Time, Length);
+    if (Wrapped < 0.f)
+    {
+        Wrapped += Length;
+    }
+
+    const float Position = Wrapped * SampleHz;
+    const int32 Key = FMath::Clamp(FMath::FloorToInt32(Position), 0, NumKeys - 2);
+    const float Alpha = FMath::Clamp(Position - Key, 0.f, 1.f);
+    const FTransform3f* KeyA = Keys.GetData() + Key * NumBones;
+    const FTransform3f* KeyB = KeyA + NumBones;
+
+    Scratch.SetNumUninitialized(NumBones, EAllowShrinking::No);
+    for (int32 Bone = 0; Bone < NumBones; ++Bone)
+    {
+        FTransform3f Local;
+        Local.Blend(KeyA[Bone], KeyB[Bone], Alpha);
+
+        const int32 Parent = ParentIndices[Bone];
+        Scratch[Bone] = Parent == INDEX_NONE ? Local : Local * Scratch[Parent];
+        OutComponentSpace[Bone] = FTransform(Scratch[Bone]);
+    }
+}
+
+int32 CrowdPoseBatch::GetMaxWorkers()
+{
+    return FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+}
+
+int32 CrowdPoseBatch::GetChunkSize(int32 NumBones, int32 ChunkBytes)
+{
+    return FMath::Max(1, ChunkBytes / FMath::Max(1, NumBones * static_cast<int32>(sizeof(FTransform))));
+}
+
+void CrowdPoseBatch::SortItems(TArray<FCrowdPoseItem>& Items)
+{
+    Items.Sort([](const FCrowdPoseItem& A, const FCrowdPoseItem& B)
+    {
+        return A.Clip != B.Clip ? A.Clip < B.Clip : A.Time < B.Time;
+    });
+}
+
+void CrowdPoseBatch::Sample(TConstArrayView<FCrowdPoseItem> Items, int32 ChunkSize, int32 NumWorkers)
+{
+    const int32 NumItems = Items.Num();
+    if (NumItems == 0)
+        return;
+
+    ChunkSize = FMath::Max(1, ChunkSize);
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumItems, ChunkSize);
+    std::atomic<int32> NextChunk{ 0 };
+
+    // Every worker, the calling thread too, takes chunks off the cursor until it runs past the end
+    auto Work = [Items, ChunkSize, NumChunks, NumItems, &NextChunk]()
+    {
+        TArray<FTransform3f> Scratch;
+        for (int32 Chunk = NextChunk.fetch_add(1, std::memory_order_relaxed); Chunk < NumChunks; Chunk = NextChunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            const int32 End = FMath::Min(NumItems, (Chunk + 1) * ChunkSize);
+            for (int32 Index = Chunk * ChunkSize; Index < End; ++Index)
+            {
+                const FCrowdPoseItem& Item = Items[Index];
+                Item.Clip->SamplePose(Item.Time, Scratch, Item.Dest);
+            }
+        }
+    };
+
+    const int32 NumHelpers = FMath::Clamp(NumWorkers, 1, FMath::Min(GetMaxWorkers(), NumChunks)) - 1;
+    TArray<UE::Tasks::FTask, TInlineAllocator<64>> Helpers;
+    for (int32 Helper = 0; Helper < NumHelpers; ++Helper)
+    {
+        Helpers.Add(UE::Tasks::Launch(TEXT("CrowdPoseBatch"), Work));
+    }
+
+    Work();
+    UE::Tasks::Wait(Helpers);
+}
@@ -0,0 +1,164 @@
+//
+//  CrowdPoseSubsystem.cpp
+//
+#include "CrowdPoseSubsystem.h"
+#include "AnimTestActor.h"
+#include "AnimDemoStats.h"
+#include "AnimDemoMemory.h"
+#include "Animation/AnimSequence.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarCrowdPoseBatched(
+    TEXT("AnimDemo.CrowdPose.Batched"),
+    true,
+    TEXT("Sample the poses of AAnimTestActor crowds in batches instead of one anim evaluation per mesh.\n")
+    TEXT("Takes effect for actors that start playing after it is set."));
+
+static TAutoConsoleVariable<int32> CVarCrowdPoseWorkers(
+    TEXT("AnimDemo.CrowdPose.Workers"),
+    0,
+    TEXT("Most threads sampling crowd poses, the game thread included. 0 uses every task graph worker."));
+
+static TAutoConsoleVariable<int32> CVarCrowdPoseChunkKB(
+    TEXT("AnimDemo.CrowdPose.ChunkKB"),
+    64,
+    TEXT("Output size in KB of the chunk of instances a worker samples at a time; keep it within the L2 cache."));
+
+static TAutoConsoleVariable<float> CVarCrowdPoseBakeHz(
+    TEXT("AnimDemo.CrowdPose.BakeHz"),
+    30.f,
+    TEXT("Rate sequences are baked at for batched sampling. Takes effect for clips baked after it is set."));
+
+bool UCrowdPoseSubsystem::IsBatchingEnabled()
+{
+    return CVarCrowdPoseBatched.GetValueOnGameThread();
+}
+
+bool UCrowdPoseSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Dedicated servers never animate the mesh
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UCrowdPoseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCrowdPoseSubsystem::Deinitialize()
+{
+    Instances.Reset();
+    Clips.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UCrowdPoseSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCrowdPoseSubsystem, STATGROUP_Tickables);
+}
+
+const FCrowdPoseClip* UCrowdPoseSubsystem::FindOrBakeClip(UAnimSequence* Sequence, USkeletalMesh* Mesh)
+{
+    const TPair<TObjectKey<UAnimSequence>, TObjectKey<USkeletalMesh>> Key(Sequence, Mesh);
+    if (const TUniquePtr<FCrowdPoseClip>* Found = Clips.Find(Key))
+    {
+        return Found->Get();
+    }
+
+    LLM_SCOPE_BYTAG(AnimDemo_Characters);
+
+    // A failed bake is cached too, so the actors of an unusable pair do not retry every spawn
+    TUniquePtr<FCrowdPoseClip> Clip = MakeUnique<FCrowdPoseClip>();
+    if (!Clip->Bake(*Sequence, *Mesh, FMath::Max(1.f, CVarCrowdPoseBakeHz.GetValueOnGameThread())))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("CrowdPose: could not bake %s for %s, those actors animate on their own."),
+            *Sequence->GetName(), *Mesh->GetName());
+        Clip.Reset();
+    }
+    else
+    {
+        UE_LOG(LogTemp, Log, TEXT("CrowdPose: baked %s for %s, %d keys of %d bones, %llu bytes"),
+            *Sequence->GetName(), *Mesh->GetName(), Clip->GetNumKeys(), Clip->GetNumBones(), static_cast<uint64>(Clip->GetSizeBytes()));
+    }
+
+    return Clips.Add(Key, MoveTemp(Clip)).Get();
+}
+
+bool UCrowdPoseSubsystem::Register(AAnimTestActor* Actor, UAnimSequence* Sequence)
+{
+    USkeletalMesh* Mesh = Actor && Actor->SkeletalMeshComp ? Actor->SkeletalMeshComp->GetSkeletalMeshAsset() : nullptr;
+    if (!Sequence || !Mesh)
+        return false;
+
+    const FCrowdPoseClip* Clip = FindOrBakeClip(Sequence, Mesh);
+    if (!Clip)
+        return false;
+
+    Unregister(Actor);
+    Instances.Add({ Actor, Clip });
+    return true;
+}
+
+void UCrowdPoseSubsystem::Unregister(AAnimTestActor* Actor)
+{
+    const int32 Index = Instances.IndexOfByPredicate([Actor](const FInstance& Instance) { return Instance.Actor == Actor; });
+    if (Index != INDEX_NONE)
+    {
+        Instances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    }
+}
+
+void UCrowdPoseSubsystem::Tick(float DeltaTime)
+{
+    Instances.RemoveAllSwap([](const FInstance& Instance) { return !Instance.Actor.IsValid(); }, EAllowShrinking::No);
+
+    SET_DWORD_STAT(STAT_AnimDemo_CrowdPoseInstances, Instances.Num());
+    SET_DWORD_STAT(STAT_AnimDemo_CrowdPoseClips, Clips.Num());
+    if (Instances.Num() == 0)
+        return;
+
+    int32 MaxBones = 0;
+    {
+        ANIMDEMO_SCOPE_CYCLE_COUNTER(CrowdPoseGather);
+        Items.Reset();
+        for (const FInstance& Instance : Instances)
+        {
+            AAnimTestActor* Actor = Instance.Actor.Get();
+            if (Actor->bBatchedPosePaused)
+                continue;
+
+            Actor->BatchedPoseTime = FMath::Fmod(Actor->BatchedPoseTime + DeltaTime, Instance.Clip->GetLength());
+
+            // Sized to the reference skeleton once the mesh is registered, which the clip was baked from
+            TArray<FTransform>& ComponentSpace = Actor->SkeletalMeshComp->GetEditableComponentSpaceTransforms();
+            if (ComponentSpace.Num() != Instance.Clip->GetNumBones())
+                continue;
+
+            Items.Add({ Instance.Clip, Actor->BatchedPoseTime, ComponentSpace.GetData() });
+            MaxBones = FMath::Max(MaxBones, Instance.Clip->GetNumBones());
+        }
+        CrowdPoseBatch::SortItems(Items);
+    }
+    {
+        ANIMDEMO_SCOPE_CYCLE_COUNTER(CrowdPoseSample);
+        const int32 Workers = CVarCrowdPoseWorkers.GetValueOnGameThread();
+        const int32 ChunkSize = CrowdPoseBatch::GetChunkSize(MaxBones, FMath::Max(1, CVarCrowdPoseChunkKB.GetValueOnGameThread()) * 1024);
+        CrowdPoseBatch::Sample(Items, ChunkSize, Workers > 0 ? Workers : CrowdPoseBatch::GetMaxWorkers());
+    }
+    {
+        // Flips the double buffer, updates the bounds and sends the pose to the renderer at the end of the frame
+        ANIMDEMO_SCOPE_CYCLE_COUNTER(CrowdPoseWriteBack);
+        for (const FInstance& Instance : Instances)
+        {
+            AAnimTestActor* Actor = Instance.Actor.Get();
+            if (!Actor->bBatchedPosePaused && Actor->SkeletalMeshComp->GetNumComponentSpaceTransforms() == Instance.Clip->GetNumBones())
+            {
+                Actor->SkeletalMeshComp->ApplyEditedComponentSpaceTransforms();
+            }
+        }
+    }
+}
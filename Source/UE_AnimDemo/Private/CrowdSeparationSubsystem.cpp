@@ -0,0 +1,98 @@
+//
+//  CrowdSeparationSubsystem.cpp
+//
+#include "CrowdSeparationSubsystem.h"
+#include "AnimTestActor.h"
+#include "AnimDemoStats.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarCrowdSeparation(
+    TEXT("AnimDemo.Crowd.Separation"),
+    true,
+    TEXT("Push AAnimTestActor walkers apart so crowds do not interpenetrate. 0 walks them blindly forward."));
+
+static TAutoConsoleVariable<float> CVarCrowdSeparationRadius(
+    TEXT("AnimDemo.Crowd.SeparationRadius"),
+    120.f,
+    TEXT("Walkers closer than this push each other apart. Also the spatial hash cell size."));
+
+static TAutoConsoleVariable<float> CVarCrowdSeparationSpeed(
+    TEXT("AnimDemo.Crowd.SeparationSpeed"),
+    150.f,
+    TEXT("Largest speed in units/s at which a walker is pushed sideways by its neighbors."));
+
+void UCrowdSeparationSubsystem::Deinitialize()
+{
+    Walkers.Reset();
+
+    Super::Deinitialize();
+}
+
+TStatId UCrowdSeparationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCrowdSeparationSubsystem, STATGROUP_Tickables);
+}
+
+void UCrowdSeparationSubsystem::Register(AAnimTestActor* Walker)
+{
+    if (Walker)
+    {
+        Walkers.AddUnique(Walker);
+    }
+}
+
+void UCrowdSeparationSubsystem::Unregister(AAnimTestActor* Walker)
+{
+    Walkers.RemoveSingleSwap(Walker, EAllowShrinking::No);
+}
+
+void UCrowdSeparationSubsystem::Tick(float DeltaTime)
+{
+    Walkers.RemoveAllSwap([](const TWeakObjectPtr<AAnimTestActor>& Walker) { return !Walker.IsValid(); }, EAllowShrinking::No);
+
+    const int32 NumWalkers = Walkers.Num();
+    SET_DWORD_STAT(STAT_AnimDemo_CrowdWalkers, NumWalkers);
+    if (NumWalkers == 0)
+        return;
+
+    const bool bSeparate = CVarCrowdSeparation.GetValueOnGameThread();
+    const float Radius = FMath::Max(CVarCrowdSeparationRadius.GetValueOnGameThread(), 1.f);
+    const float MaxPushSpeed = CVarCrowdSeparationSpeed.GetValueOnGameThread();
+
+    PushX.SetNumZeroed(NumWalkers, EAllowShrinking::No);
+    PushY.SetNumZeroed(NumWalkers, EAllowShrinking::No);
+
+    if (bSeparate)
+    {
+        {
+            ANIMDEMO_SCOPE_CYCLE_COUNTER(CrowdGather);
+            PosX.SetNumUninitialized(NumWalkers, EAllowShrinking::No);
+            PosY.SetNumUninitialized(NumWalkers, EAllowShrinking::No);
+            for (int32 Index = 0; Index < NumWalkers; ++Index)
+            {
+                const FVector Location = Walkers[Index]->GetActorLocation();
+                PosX[Index] = static_cast<float>(Location.X);
+                PosY[Index] = static_cast<float>(Location.Y);
+            }
+        }
+        {
+            ANIMDEMO_SCOPE_CYCLE_COUNTER(CrowdHashBuild);
+            SpatialHash.Build(PosX, PosY, Radius);
+        }
+        {
+            ANIMDEMO_SCOPE_CYCLE_COUNTER(CrowdSeparation);
+            CrowdSeparation::ComputeSeparation(SpatialHash, Radius, PushX, PushY);
+        }
+    }
+
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(CrowdMove);
+    for (int32 Index = 0; Index < NumWalkers; ++Index)
+    {
+        AAnimTestActor* Walker = Walkers[Index].Get();
+
+        // The push sums linear weights, so a walker deep in a crowd is clamped to the max speed
+        const FVector Push = FVector(PushX[Index], PushY[Index], 0.f).GetClampedToMaxSize(1.f) * MaxPushSpeed;
+        const FVector Velocity = Walker->GetActorForwardVector() * Walker->WalkSpeed + Push;
+        Walker->SetActorLocation(Walker->GetActorLocation() + Velocity * DeltaTime);
+    }
+}
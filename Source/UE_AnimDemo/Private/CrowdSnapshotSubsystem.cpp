@@ -0,0 +1,183 @@
+//
+//  CrowdSnapshotSubsystem.cpp
+//
+#include "CrowdSnapshotSubsystem.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+void FCrowdSnapshot::Reset(int32 NumCharacters, int32 NumTestActors)
+{
+    const uint64 CharactersOffset = Align(sizeof(FCrowdSnapshotHeader), 16);
+    const uint64 TestActorsOffset = Align(CharactersOffset + NumCharacters * sizeof(FCrowdCharacterRecord), 16);
+    const uint64 Size = TestActorsOffset + NumTestActors * sizeof(FAnimTestActorSnapshot);
+
+    Buffer.SetNumUninitialized(static_cast<int32>(Size), EAllowShrinking::No);
+
+    FCrowdSnapshotHeader& Header = *reinterpret_cast<FCrowdSnapshotHeader*>(Buffer.GetData());
+    Header.NumCharacters = NumCharacters;
+    Header.NumTestActors = NumTestActors;
+    Header.CharactersOffset = CharactersOffset;
+    Header.TestActorsOffset = TestActorsOffset;
+}
+
+TArrayView<FCrowdCharacterRecord> FCrowdSnapshot::GetCharacterRecords()
+{
+    if (IsEmpty())
+        return {};
+
+    const FCrowdSnapshotHeader& Header = GetHeader();
+    return MakeArrayView(reinterpret_cast<FCrowdCharacterRecord*>(Buffer.GetData() + Header.CharactersOffset), Header.NumCharacters);
+}
+
+TArrayView<const FCrowdCharacterRecord> FCrowdSnapshot::GetCharacterRecords() const
+{
+    if (IsEmpty())
+        return {};
+
+    const FCrowdSnapshotHeader& Header = GetHeader();
+    return MakeArrayView(reinterpret_cast<const FCrowdCharacterRecord*>(Buffer.GetData() + Header.CharactersOffset), Header.NumCharacters);
+}
+
+TArrayView<FAnimTestActorSnapshot> FCrowdSnapshot::GetTestActorRecords()
+{
+    if (IsEmpty())
+        return {};
+
+    const FCrowdSnapshotHeader& Header = GetHeader();
+    return MakeArrayView(reinterpret_cast<FAnimTestActorSnapshot*>(Buffer.GetData() + Header.TestActorsOffset), Header.NumTestActors);
+}
+
+TArrayView<const FAnimTestActorSnapshot> FCrowdSnapshot::GetTestActorRecords() const
+{
+    if (IsEmpty())
+        return {};
+
+    const FCrowdSnapshotHeader& Header = GetHeader();
+    return MakeArrayView(reinterpret_cast<const FAnimTestActorSnapshot*>(Buffer.GetData() + Header.TestActorsOffset), Header.NumTestActors);
+}
+
+void UCrowdSnapshotSubsystem::Capture(FCrowdSnapshot& OutSnapshot) const
+{
+    UWorld* World = GetWorld();
+
+    OutSnapshot.Characters.Reset();
+    for (TActorIterator<AAnimCppChar> It(World); It; ++It)
+    {
+        OutSnapshot.Characters.Add(*It);
+    }
+
+    OutSnapshot.TestActors.Reset();
+    for (TActorIterator<AAnimTestActor> It(World); It; ++It)
+    {
+        OutSnapshot.TestActors.Add(*It);
+    }
+
+    OutSnapshot.Reset(OutSnapshot.Characters.Num(), OutSnapshot.TestActors.Num());
+
+    TArrayView<FCrowdCharacterRecord> CharacterRecords = OutSnapshot.GetCharacterRecords();
+    for (int32 Index = 0; Index < CharacterRecords.Num(); ++Index)
+    {
+        const AAnimCppChar* Character = OutSnapshot.Characters[Index].Get();
+        FCrowdCharacterRecord& Record = *new (&CharacterRecords[Index]) FCrowdCharacterRecord();
+        Character->SaveSnapshot(Record.Character);
+
+        if (const AAnimDemoBotController* Bot = Cast<AAnimDemoBotController>(Character->GetController()))
+        {
+            Bot->SaveSnapshot(Record.Bot);
+            Record.bHasBot = true;
+        }
+    }
+
+    TArrayView<FAnimTestActorSnapshot> TestActorRecords = OutSnapshot.GetTestActorRecords();
+    for (int32 Index = 0; Index < TestActorRecords.Num(); ++Index)
+    {
+        OutSnapshot.TestActors[Index]->SaveSnapshot(*new (&TestActorRecords[Index]) FAnimTestActorSnapshot());
+    }
+}
+
+int32 UCrowdSnapshotSubsystem::Restore(const FCrowdSnapshot& Snapshot) const
+{
+    int32 NumMissing = 0;
+
+    TArrayView<const FCrowdCharacterRecord> CharacterRecords = Snapshot.GetCharacterRecords();
+    for (int32 Index = 0; Index < CharacterRecords.Num(); ++Index)
+    {
+        AAnimCppChar* Character = Snapshot.Characters[Index].Get();
+        if (!Character)
+        {
+            ++NumMissing;
+            continue;
+        }
+
+        const FCrowdCharacterRecord& Record = CharacterRecords[Index];
+        Character->RestoreSnapshot(Record.Character);
+
+        AAnimDemoBotController* Bot = Record.bHasBot ? Cast<AAnimDemoBotController>(Character->GetController()) : nullptr;
+        if (Bot)
+        {
+            Bot->RestoreSnapshot(Record.Bot);
+        }
+    }
+
+    TArrayView<const FAnimTestActorSnapshot> TestActorRecords = Snapshot.GetTestActorRecords();
+    for (int32 Index = 0; Index < TestActorRecords.Num(); ++Index)
+    {
+        if (AAnimTestActor* TestActor = Snapshot.TestActors[Index].Get())
+        {
+            TestActor->RestoreSnapshot(TestActorRecords[Index]);
+        }
+        else
+        {
+            ++NumMissing;
+        }
+    }
+
+    return NumMissing;
+}
+
+namespace CrowdSnapshot
+{
+    static FAutoConsoleCommandWithWorld CaptureCommand(
+        TEXT("AnimDemo.Snapshot.Capture"),
+        TEXT("Captures the state of every character, bot and test actor in the world."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            UCrowdSnapshotSubsystem* Subsystem = World ? World->GetSubsystem<UCrowdSnapshotSubsystem>() : nullptr;
+            if (!Subsystem)
+                return;
+
+            FCrowdSnapshot& Snapshot = Subsystem->GetDefaultSnapshot();
+            const double StartTime = FPlatformTime::Seconds();
+            Subsystem->Capture(Snapshot);
+            const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            UE_LOG(LogTemp, Display, TEXT("Captured %d characters and %d test actors, %lld bytes, in %.3f ms."),
+                Snapshot.GetNumCharacters(), Snapshot.GetNumTestActors(), Snapshot.GetSizeBytes(), ElapsedMs);
+        }));
+
+    static FAutoConsoleCommandWithWorld RestoreCommand(
+        TEXT("AnimDemo.Snapshot.Restore"),
+        TEXT("Restores the state captured by AnimDemo.Snapshot.Capture."),
+        FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+        {
+            UCrowdSnapshotSubsystem* Subsystem = World ? World->GetSubsystem<UCrowdSnapshotSubsystem>() : nullptr;
+            if (!Subsystem)
+                return;
+
+            const FCrowdSnapshot& Snapshot = Subsystem->GetDefaultSnapshot();
+            if (Snapshot.IsEmpty())
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Nothing to restore, run AnimDemo.Snapshot.Capture first."));
+                return;
+            }
+
+            const double StartTime = FPlatformTime::Seconds();
+            const int32 NumMissing = Subsystem->Restore(Snapshot);
+            const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            UE_LOG(LogTemp, Display, TEXT("Restored %d characters and %d test actors in %.3f ms, %d no longer exist."),
+                Snapshot.GetNumCharacters(), Snapshot.GetNumTestActors(), ElapsedMs, NumMissing);
+        }));
+}
@@ -0,0 +1,162 @@
+//
+//  CrowdSpatialHash.cpp
+//
+#include "CrowdSpatialHash.h"
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
+
+namespace CrowdSpatialHashImpl
+{
+    // Agents per parallel task; small crowds run on the calling thread
+    static constexpr int32 ChunkSize = 1024;
+
+    static EParallelForFlags GetParallelFlags(int32 NumAgents)
+    {
+        return NumAgents > ChunkSize ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+    }
+
+    template<typename FuncType>
+    static void ParallelForChunks(int32 NumAgents, FuncType&& Func)
+    {
+        const int32 NumChunks = FMath::DivideAndRoundUp(NumAgents, ChunkSize);
+        ParallelFor(NumChunks, [&Func, NumAgents](int32 Chunk)
+        {
+            const int32 Begin = Chunk * ChunkSize;
+            Func(Begin, FMath::Min(Begin + ChunkSize, NumAgents));
+        }, GetParallelFlags(NumAgents));
+    }
+}
+
+void FCrowdSpatialHash::Build(TConstArrayView<float> X, TConstArrayView<float> Y, float InCellSize)
+{
+    check(X.Num() == Y.Num());
+    const int32 NumAgents = X.Num();
+
+    CellSize = FMath::Max(InCellSize, 1.f);
+    InvCellSize = 1.f / CellSize;
+
+    // About two buckets per agent keeps unrelated cells sharing a bucket rare
+    const uint32 NumBuckets = FMath::RoundUpToPowerOfTwo(FMath::Max(NumAgents * 2, 64));
+    BucketMask = NumBuckets - 1;
+
+    AgentBuckets.SetNumUninitialized(NumAgents, EAllowShrinking::No);
+    SortedIndices.SetNumUninitialized(NumAgents, EAllowShrinking::No);
+    SortedX.SetNumUninitialized(NumAgents, EAllowShrinking::No);
+    SortedY.SetNumUninitialized(NumAgents, EAllowShrinking::No);
+    BucketStart.SetNumZeroed(NumBuckets + 1, EAllowShrinking::No);
+
+    CrowdSpatialHashImpl::ParallelForChunks(NumAgents, [this, X, Y](int32 Begin, int32 End)
+    {
+        for (int32 Agent = Begin; Agent < End; ++Agent)
+        {
+            AgentBuckets[Agent] = HashCell(GetCellCoord(X[Agent]), GetCellCoord(Y[Agent]));
+        }
+    });
+
+    // Counting sort. These passes are a few cycles per agent and bound by memory bandwidth, so
+    // they stay serial, which also keeps the order within a bucket deterministic.
+    for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+    {
+        ++BucketStart[AgentBuckets[Agent] + 1];
+    }
+    for (uint32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+    {
+        BucketStart[Bucket + 1] += BucketStart[Bucket];
+    }
+
+    BucketCursor.Reset();
+    BucketCursor.Append(BucketStart.GetData(), NumBuckets);
+    for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+    {
+        SortedIndices[BucketCursor[AgentBuckets[Agent]]++] = Agent;
+    }
+
+    CrowdSpatialHashImpl::ParallelForChunks(NumAgents, [this, X, Y](int32 Begin, int32 End)
+    {
+        for (int32 Sorted = Begin; Sorted < End; ++Sorted)
+        {
+            SortedX[Sorted] = X[SortedIndices[Sorted]];
+            SortedY[Sorted] = Y[SortedIndices[Sorted]];
+        }
+    });
+}
+
+void CrowdSeparation::ComputeSeparation(const FCrowdSpatialHash& Hash, float Radius, TArrayView<float> OutPushX, TArrayView<float> OutPushY)
+{
+    check(OutPushX.Num() == Hash.Num() && OutPushY.Num() == Hash.Num());
+    checkSlow(Radius <= Hash.GetCellSize());
+
+    const TConstArrayView<float> SortedX = Hash.GetSortedX();
+    const TConstArrayView<float> SortedY = Hash.GetSortedY();
+    const TConstArrayView<int32> SortedIndices = Hash.GetSortedIndices();
+
+    const float RadiusSq = Radius * Radius;
+    const float InvRadius = 1.f / Radius;
+
+    // Coincident agents, including the agent itself, have no direction to push in
+    static constexpr float MinDistSq = 1.e-4f;
+
+    CrowdSpatialHashImpl::ParallelForChunks(Hash.Num(), [&](int32 Begin, int32 End)
+    {
+        const VectorRegister4Float VecRadiusSq = VectorSetFloat1(RadiusSq);
+        const VectorRegister4Float VecInvRadius = VectorSetFloat1(InvRadius);
+        const VectorRegister4Float VecMinDistSq = VectorSetFloat1(MinDistSq);
+        const VectorRegister4Float VecZero = VectorZeroFloat();
+
+        for (int32 Sorted = Begin; Sorted < End; ++Sorted)
+        {
+            const float PosX = SortedX[Sorted];
+            const float PosY = SortedY[Sorted];
+            const VectorRegister4Float VecPosX = VectorSetFloat1(PosX);
+            const VectorRegister4Float VecPosY = VectorSetFloat1(PosY);
+
+            VectorRegister4Float VecPushX = VecZero;
+            VectorRegister4Float VecPushY = VecZero;
+            float PushX = 0.f;
+            float PushY = 0.f;
+
+            Hash.ForEachNeighborRange(PosX, PosY, [&](int32 RangeBegin, int32 RangeEnd)
+            {
+                int32 Other = RangeBegin;
+                for (; Other + 4 <= RangeEnd; Other += 4)
+                {
+                    const VectorRegister4Float DeltaX = VectorSubtract(VecPosX, VectorLoad(&SortedX[Other]));
+                    const VectorRegister4Float DeltaY = VectorSubtract(VecPosY, VectorLoad(&SortedY[Other]));
+                    const VectorRegister4Float DistSq = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiply(DeltaY, DeltaY));
+                    const VectorRegister4Float InRange = VectorBitwiseAnd(VectorCompareLT(DistSq, VecRadiusSq), VectorCompareGT(DistSq, VecMinDistSq));
+
+                    // Out of range lanes may hold inf or NaN and are masked to zero before accumulating
+                    const VectorRegister4Float InvDist = VectorReciprocalSqrt(DistSq);
+                    const VectorRegister4Float Weight = VectorSubtract(GlobalVectorConstants::FloatOne, VectorMultiply(VectorMultiply(DistSq, InvDist), VecInvRadius));
+                    const VectorRegister4Float Scale = VectorSelect(InRange, VectorMultiply(Weight, InvDist), VecZero);
+
+                    VecPushX = VectorMultiplyAdd(DeltaX, Scale, VecPushX);
+                    VecPushY = VectorMultiplyAdd(DeltaY, Scale, VecPushY);
+                }
+
+                for (; Other < RangeEnd; ++Other)
+                {
+                    const float DeltaX = PosX - SortedX[Other];
+                    const float DeltaY = PosY - SortedY[Other];
+                    const float DistSq = DeltaX * DeltaX + DeltaY * DeltaY;
+                    if (DistSq < RadiusSq && DistSq > MinDistSq)
+                    {
+                        const float InvDist = FMath::InvSqrt(DistSq);
+                        const float Scale = (1.f - DistSq * InvDist * InvRadius) * InvDist;
+                        PushX += DeltaX * Scale;
+                        PushY += DeltaY * Scale;
+                    }
+                }
+            });
+
+            alignas(16) float LanesX[4];
+            alignas(16) float LanesY[4];
+            VectorStoreAligned(VecPushX, LanesX);
+            VectorStoreAligned(VecPushY, LanesY);
+
+            const int32 Agent = SortedIndices[Sorted];
+            OutPushX[Agent] = PushX + LanesX[0] + LanesX[1] + LanesX[2] + LanesX[3];
+            OutPushY[Agent] = PushY + LanesY[0] + LanesY[1] + LanesY[2] + LanesY[3];
+        }
+    });
+}
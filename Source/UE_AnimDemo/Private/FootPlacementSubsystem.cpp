@@ -0,0 +1,204 @@
+//
+//  FootPlacementSubsystem.cpp
+//
+#include "FootPlacementSubsystem.h"
+#include "AnimCppChar.h"
+#include "AnimDemoStats.h"
+#include "MyAnimInstance.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarFootIKEnable(
+    TEXT("AnimDemo.FootIK.Enable"),
+    true,
+    TEXT("Trace the ground under the feet of AAnimCppChar characters and place their feet on it."));
+
+static TAutoConsoleVariable<float> CVarFootIKFullRateDistance(
+    TEXT("AnimDemo.FootIK.FullRateDistance"),
+    1500.f,
+    TEXT("Moving characters closer than this to a local player's camera are traced every frame."));
+
+static TAutoConsoleVariable<float> CVarFootIKMaxDistance(
+    TEXT("AnimDemo.FootIK.MaxDistance"),
+    6000.f,
+    TEXT("Characters further than this from every local player's camera are not traced, and blend their foot placement out."));
+
+namespace AnimDemoFootPlacement
+{
+    static constexpr float TraceAbove = 50.f;
+    static constexpr float TraceBelow = 75.f;
+
+    static uint32 EncodeUserData(int32 Slot, int32 Foot) { return static_cast<uint32>(Slot * NumFeet + Foot); }
+}
+
+bool UFootPlacementSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Nobody sees the feet on a dedicated server
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+bool UFootPlacementSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFootPlacementSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    TraceDelegate.BindUObject(this, &UFootPlacementSubsystem::HandleTraceDone);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UFootPlacementSubsystem::IssueTraces);
+}
+
+void UFootPlacementSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    TraceDelegate.Unbind();
+    Entries.Reset();
+    FreeEntries.Reset();
+
+    Super::Deinitialize();
+}
+
+void UFootPlacementSubsystem::Register(AAnimCppChar* Character, UMyAnimInstance* AnimInstance)
+{
+    if (!Character || !AnimInstance)
+        return;
+
+    const int32 Slot = FreeEntries.Num() > 0 ? FreeEntries.Pop(EAllowShrinking::No) : Entries.AddDefaulted();
+    FEntry& Entry = Entries[Slot];
+    Entry = FEntry();
+    Entry.Character = Character;
+    Entry.AnimInstance = AnimInstance;
+}
+
+void UFootPlacementSubsystem::Unregister(AAnimCppChar* Character)
+{
+    for (int32 Slot = 0; Slot < Entries.Num(); ++Slot)
+    {
+        if (Entries[Slot].Character.Get() == Character)
+        {
+            // Results still in flight no longer match the reset handles and are dropped
+            Entries[Slot] = FEntry();
+            FreeEntries.Add(Slot);
+            return;
+        }
+    }
+}
+
+uint32 UFootPlacementSubsystem::GetTraceInterval(const AAnimCppChar& Character, TConstArrayView<FVector> ViewLocations) const
+{
+    const USkeletalMeshComponent* Mesh = Character.GetMesh();
+    if (!Mesh || !Mesh->WasRecentlyRendered(0.2f))
+        return 0;
+
+    float ClosestDistSq = TNumericLimits<float>::Max();
+    for (const FVector& ViewLocation : ViewLocations)
+    {
+        ClosestDistSq = FMath::Min(ClosestDistSq, static_cast<float>(FVector::DistSquared(ViewLocation, Character.GetActorLocation())));
+    }
+
+    const float MaxDistance = CVarFootIKMaxDistance.GetValueOnGameThread();
+    if (ClosestDistSq > FMath::Square(MaxDistance))
+        return 0;
+
+    // Standing still, the ground under the feet does not change
+    const UAnimationStateMachine* StateMachine = Character.GetAnimStateMachine();
+    const bool bIdle = StateMachine && StateMachine->GetCurrentState() == ECharacterAnimState::Idle && Character.GetVelocity().IsNearlyZero(1.f);
+
+    const float FullRateDistance = CVarFootIKFullRateDistance.GetValueOnGameThread();
+    if (ClosestDistSq <= FMath::Square(FullRateDistance))
+    {
+        return bIdle ? 4 : 1;
+    }
+    return bIdle ? 8 : 2;
+}
+
+void UFootPlacementSubsystem::IssueTraces(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    UWorld* World = GetWorld();
+    if (InWorld != World || TickType == LEVELTICK_ViewportsOnly)
+        return;
+
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(FootPlacementIssue);
+
+    ++FrameCounter;
+    const bool bEnabled = CVarFootIKEnable.GetValueOnGameThread();
+
+    TArray<FVector, TInlineAllocator<4>> ViewLocations;
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PC = It->Get();
+        if (PC && PC->IsLocalController() && PC->PlayerCameraManager)
+        {
+            ViewLocations.Add(PC->PlayerCameraManager->GetCameraLocation());
+        }
+    }
+
+    for (int32 Slot = 0; Slot < Entries.Num(); ++Slot)
+    {
+        FEntry& Entry = Entries[Slot];
+        AAnimCppChar* Character = Entry.Character.Get();
+        UMyAnimInstance* AnimInstance = Entry.AnimInstance.Get();
+        if (!Character || !AnimInstance)
+            continue;
+
+        const uint32 Interval = bEnabled ? GetTraceInterval(*Character, ViewLocations) : 0;
+        if (Interval == 0)
+        {
+            if (Entry.Input.bValid)
+            {
+                Entry.Input = FFootPlacementInput();
+                AnimInstance->SetFootPlacementInput(Entry.Input);
+            }
+            continue;
+        }
+
+        // Staggered so throttled characters do not all trace on the same frame
+        if ((FrameCounter + Slot) % Interval != 0)
+            continue;
+
+        const USkeletalMeshComponent* Mesh = Character->GetMesh();
+        const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+        Entry.TraceBaseZ = Character->GetActorLocation().Z - Capsule->GetScaledCapsuleHalfHeight();
+
+        FCollisionQueryParams Params(SCENE_QUERY_STAT(AnimDemoFootPlacement), false, Character);
+
+        for (int32 Foot = 0; Foot < AnimDemoFootPlacement::NumFeet; ++Foot)
+        {
+            const FVector FootLocation = Mesh->GetSocketLocation(AnimInstance->GetFootBoneName(Foot));
+            const FVector Start(FootLocation.X, FootLocation.Y, Entry.TraceBaseZ + AnimDemoFootPlacement::TraceAbove);
+            const FVector End(FootLocation.X, FootLocation.Y, Entry.TraceBaseZ - AnimDemoFootPlacement::TraceBelow);
+
+            Entry.Handles[Foot] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, Params,
+                FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, AnimDemoFootPlacement::EncodeUserData(Slot, Foot));
+        }
+
+        INC_DWORD_STAT_BY(STAT_AnimDemo_FootTraces, AnimDemoFootPlacement::NumFeet);
+    }
+}
+
+void UFootPlacementSubsystem::HandleTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    const int32 Slot = static_cast<int32>(Datum.UserData) / AnimDemoFootPlacement::NumFeet;
+    const int32 Foot = static_cast<int32>(Datum.UserData) % AnimDemoFootPlacement::NumFeet;
+    if (!Entries.IsValidIndex(Slot) || Entries[Slot].Handles[Foot] != Handle)
+        return;
+
+    FEntry& Entry = Entries[Slot];
+    UMyAnimInstance* AnimInstance = Entry.AnimInstance.Get();
+    if (!AnimInstance)
+        return;
+
+    const FHitResult* Hit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit ? &Datum.OutHits[0] : nullptr;
+    Entry.Input.bValid = true;
+    Entry.Input.bHit[Foot] = Hit != nullptr;
+    Entry.Input.GroundOffset[Foot] = Hit ? static_cast<float>(Hit->ImpactPoint.Z) - Entry.TraceBaseZ : 0.f;
+    Entry.Input.GroundNormal[Foot] = Hit ? FVector(Hit->ImpactNormal) : FVector::UpVector;
+
+    // Runs on the game thread at the start of the frame, before the anim update reads it
+    AnimInstance->SetFootPlacementInput(Entry.Input);
+}
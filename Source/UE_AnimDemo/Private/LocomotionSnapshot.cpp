@@ -0,0 +1,153 @@
+//
+//  LocomotionSnapshot.cpp
+//
+#include "LocomotionSnapshot.h"
+#include "AnimationStateMachine.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+void FLocomotionSnapshot::Capture(const FVector& InVelocity, const UCharacterMovementComponent& MoveComp)
+{
+    Velocity = InVelocity;
+    bIsFalling = MoveComp.IsFalling();
+    bIsMovingOnGround = MoveComp.IsMovingOnGround();
+}
+
+bool FLocomotionSnapshot::ShouldWalk(const FLocomotionTuning& Tuning) const
+{
+    const float Speed = GetSpeed();
+    return Speed > Tuning.IdleSpeed && Speed < Tuning.RunSpeed && bIsMovingOnGround;
+}
+
+bool FLocomotionSnapshot::ShouldRun(const FLocomotionTuning& Tuning) const
+{
+    return GetSpeed() >= Tuning.RunSpeed && bIsMovingOnGround;
+}
+
+bool FLocomotionSnapshot::ShouldJump() const
+{
+    return bIsFalling && Velocity.Z > 0.0f;
+}
+
+bool FLocomotionSnapshot::ShouldIdle(const FLocomotionTuning& Tuning) const
+{
+    return GetSpeed() <= Tuning.IdleSpeed && bIsMovingOnGround;
+}
+
+bool FLocomotionArchetype::operator==(const FLocomotionArchetype& Other) const
+{
+    return IdleAnimation == Other.IdleAnimation
+        && JumpAnimation == Other.JumpAnimation
+        && LocomotionBlendSpace == Other.LocomotionBlendSpace
+        && Tuning.IdleSpeed == Other.Tuning.IdleSpeed
+        && Tuning.RunSpeed == Other.Tuning.RunSpeed
+        && Tuning.IdleToLocomotionBlend == Other.Tuning.IdleToLocomotionBlend
+        && Tuning.LocomotionToIdleBlend == Other.Tuning.LocomotionToIdleBlend
+        && Tuning.JumpBlend == Other.Tuning.JumpBlend
+        && Tuning.LandBlend == Other.Tuning.LandBlend;
+}
+
+uint32 GetTypeHash(const FLocomotionArchetype& Archetype)
+{
+    uint32 Hash = GetTypeHash(Archetype.IdleAnimation);
+    Hash = HashCombineFast(Hash, GetTypeHash(Archetype.JumpAnimation));
+    Hash = HashCombineFast(Hash, GetTypeHash(Archetype.LocomotionBlendSpace));
+    Hash = HashCombineFast(Hash, GetTypeHash(Archetype.Tuning.IdleSpeed));
+    Hash = HashCombineFast(Hash, GetTypeHash(Archetype.Tuning.RunSpeed));
+    Hash = HashCombineFast(Hash, GetTypeHash(Archetype.Tuning.IdleToLocomotionBlend));
+    Hash = HashCombineFast(Hash, GetTypeHash(Archetype.Tuning.LocomotionToIdleBlend));
+    Hash = HashCombineFast(Hash, GetTypeHash(Archetype.Tuning.JumpBlend));
+    return HashCombineFast(Hash, GetTypeHash(Archetype.Tuning.LandBlend));
+}
+
+bool FLocomotionSnapshot::ShouldLandMoving(const FLocomotionTuning& Tuning) const
+{
+    // ShouldWalk and ShouldRun both require ground contact
+    return ShouldWalk(Tuning) || ShouldRun(Tuning);
+}
+
+void AnimDemoLocomotion::AddLocomotionTransitions(FAnimStateMachineDefinition& Definition, const FLocomotionTuning& Tuning)
+{
+    Definition.AddTransition(
+        ECharacterAnimState::Idle,
+        ECharacterAnimState::Locomotion,
+        [Tuning](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldWalk(Tuning); },
+        Tuning.IdleToLocomotionBlend
+    );
+    
+    // Jump transitions from any ground state, tried after the state's locomotion transition
+    Definition.AddTransition(
+        ECharacterAnimState::Idle,
+        ECharacterAnimState::Jump,
+        [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldJump(); },
+        Tuning.JumpBlend
+    );
+    
+    Definition.AddTransition(
+        ECharacterAnimState::Locomotion,
+        ECharacterAnimState::Idle,
+        [Tuning](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldIdle(Tuning); },
+        Tuning.LocomotionToIdleBlend
+    );
+    
+    Definition.AddTransition(
+        ECharacterAnimState::Locomotion,
+        ECharacterAnimState::Jump,
+        [](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldJump(); },
+        Tuning.JumpBlend
+    );
+    
+    // Landing, into whichever ground state the landing speed calls for
+    Definition.AddTransition(
+        ECharacterAnimState::Jump,
+        ECharacterAnimState::Idle,
+        [Tuning](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldIdle(Tuning); },
+        Tuning.LandBlend
+    );
+    
+    Definition.AddTransition(
+        ECharacterAnimState::Jump,
+        ECharacterAnimState::Locomotion,
+        [Tuning](const FLocomotionSnapshot& Snapshot) { return Snapshot.ShouldLandMoving(Tuning); },
+        Tuning.LandBlend
+    );
+}
+
+TSharedRef<const FAnimStateMachineDefinition> AnimDemoLocomotion::GetDefinition(const FLocomotionArchetype& Archetype)
+{
+    check(IsInGameThread());
+    
+    // Weak, so a definition and the assets it holds go away with the last machine using it
+    static TMap<FLocomotionArchetype, TWeakPtr<const FAnimStateMachineDefinition>> Definitions;
+    
+    if (TSharedPtr<const FAnimStateMachineDefinition> Existing = Definitions.FindRef(Archetype).Pin())
+    {
+        return Existing.ToSharedRef();
+    }
+    
+    TSharedRef<FAnimStateMachineDefinition> Definition = MakeShared<FAnimStateMachineDefinition>();
+    if (Archetype.IdleAnimation)
+    {
+        Definition->RegisterStateAnimation(ECharacterAnimState::Idle, Archetype.IdleAnimation, true, 1.0f);
+    }
+    if (Archetype.JumpAnimation)
+    {
+        Definition->RegisterStateAnimation(ECharacterAnimState::Jump, Archetype.JumpAnimation, false, 1.0f);
+    }
+    if (Archetype.LocomotionBlendSpace)
+    {
+        Definition->RegisterStateBlendSpace(ECharacterAnimState::Locomotion, Archetype.LocomotionBlendSpace, true, 1.0f);
+    }
+    AddLocomotionTransitions(*Definition, Archetype.Tuning);
+    
+    // Entries of archetypes nobody uses any more are dropped whenever a new one is added
+    for (auto It = Definitions.CreateIterator(); It; ++It)
+    {
+        if (!It.Value().IsValid())
+        {
+            It.RemoveCurrent();
+        }
+    }
+    Definitions.Add(Archetype, Definition);
+    
+    return Definition;
+}
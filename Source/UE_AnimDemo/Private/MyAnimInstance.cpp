@@ -8,27 +8,34 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "AnimCppChar.h"
 #include "Animation/AnimSequence.h"
+#include "Animation/AnimMontage.h"
 #include "Animation/AnimationPoseData.h"
 #include "Animation/BlendSpace.h"
+#include "AnimDemoStats.h"
+#include "AnimDemoTrace.h"
+#include "AnimDemoMemory.h"
+#include "UObject/ConstructorHelpers.h"
 
 UMyAnimInstance::UMyAnimInstance()
 {
     CurrentState = ECharacterAnimState::Idle;
+    
+    // Resolved once with the class instead of a blocking load in every instance's initialization
+    static ConstructorHelpers::FObjectFinder<UBlendSpace> BlendSpaceAsset(TEXT("/Game/Animations/IdleWalkRun_BS.IdleWalkRun_BS"));
+    if (BlendSpaceAsset.Succeeded())
+    {
+        LocomotionBlendSpace = BlendSpaceAsset.Object;
+    }
 }
 
 void UMyAnimInstance::NativeInitializeAnimation()
 {
     Super::NativeInitializeAnimation();
     OwningCharacter = Cast<AAnimCppChar>(TryGetPawnOwner());
-    
-    LocomotionBlendSpace = LoadObject<UBlendSpace>(
-        nullptr,
-        TEXT("/Game/Animations/IdleWalkRun_BS.IdleWalkRun_BS")
-    );
 
     if (!LocomotionBlendSpace)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to load LocomotionBlendSpace at runtime!"));
+        UE_LOG(LogTemp, Error, TEXT("LocomotionBlendSpace is not set, check the asset path in UMyAnimInstance's constructor!"));
     }
 }
 
@@ -39,26 +46,94 @@ void UMyAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
     PlayAnimations(DeltaSeconds);
 }
 
+void UMyAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+    Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+    
+    SolveFootPlacement(DeltaSeconds);
+}
+
+void UMyAnimInstance::SolveFootPlacement(float DeltaSeconds)
+{
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(FootPlacementSolve);
+    
+    // Only reads FootPlacementInput and writes the anim properties, so it is safe on a worker
+    const bool bPlaceFeet = FootPlacementInput.bValid && CurrentState != ECharacterAnimState::Jump;
+    FootPlacementAlpha = FMath::FInterpTo(FootPlacementAlpha, bPlaceFeet ? 1.f : 0.f, DeltaSeconds, FootInterpSpeed);
+    
+    FRotator FootRotations[AnimDemoFootPlacement::NumFeet];
+    for (int32 Foot = 0; Foot < AnimDemoFootPlacement::NumFeet; ++Foot)
+    {
+        const bool bHit = bPlaceFeet && FootPlacementInput.bHit[Foot];
+        const float TargetOffset = bHit ? FMath::Clamp(FootPlacementInput.GroundOffset[Foot], -MaxFootOffset, MaxFootOffset) : 0.f;
+        FootOffsets[Foot] = FMath::FInterpTo(FootOffsets[Foot], TargetOffset, DeltaSeconds, FootInterpSpeed);
+        
+        // Align the sole with the ground normal
+        const FVector Normal = bHit ? FootPlacementInput.GroundNormal[Foot] : FVector::UpVector;
+        FootRotations[Foot] = FRotator(
+            -FMath::RadiansToDegrees(FMath::Atan2(Normal.X, Normal.Z)),
+            0.f,
+            FMath::RadiansToDegrees(FMath::Atan2(Normal.Y, Normal.Z)));
+    }
+    
+    // The pelvis drops to the lower foot so the other leg can bend up to its ground
+    PelvisOffset = FMath::Min3(0.f, FootOffsets[AnimDemoFootPlacement::LeftFoot], FootOffsets[AnimDemoFootPlacement::RightFoot]);
+    
+    LeftFootEffectorOffset = FVector(0.f, 0.f, FootOffsets[AnimDemoFootPlacement::LeftFoot] - PelvisOffset);
+    RightFootEffectorOffset = FVector(0.f, 0.f, FootOffsets[AnimDemoFootPlacement::RightFoot] - PelvisOffset);
+    LeftFootRotation = FMath::RInterpTo(LeftFootRotation, FootRotations[AnimDemoFootPlacement::LeftFoot], DeltaSeconds, FootInterpSpeed);
+    RightFootRotation = FMath::RInterpTo(RightFootRotation, FootRotations[AnimDemoFootPlacement::RightFoot], DeltaSeconds, FootInterpSpeed);
+}
+
 void UMyAnimInstance::PlayAnimations(float DeltaSeconds)
 {
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(PlayAnimations);
+    LLM_SCOPE_BYTAG(AnimDemo_Montages);
+    
     if (CurrentState == ECharacterAnimState::None) return;
+    
+    static const FName DefaultSlotName(TEXT("DefaultSlot"));
+    
+    // Montages are only started on a state change or once the previous one is gone, every
+    // dynamic montage is a new UObject plus a montage instance
+    const bool bStateChanged = CurrentState != LastPlayedState;
+    LastPlayedState = CurrentState;
+    
+    // Resuming from a lite LOD, the pose on screen already is the montage's at ResumeTime
+    const bool bResuming = ResumeTime >= 0.f;
+    const float BlendInTime = bResuming ? 0.f : 0.25f;
 
     switch (CurrentState)
     {
     case ECharacterAnimState::Idle:
-        UE_LOG(LogTemp, Warning, TEXT("CharacterAnimState: Idle"));
-        if (IdleAnimation && bIsIdle)
+        UE_LOG(LogTemp, VeryVerbose, TEXT("CharacterAnimState: Idle"));
+        if (IdleAnimation && bIsIdle && !IsPlayingSlotAnimation(IdleAnimation, DefaultSlotName))
         {
-            UE_LOG(LogTemp, Warning, TEXT("IdleAnimation && bIsIdle"));
-            PlaySlotAnimationAsDynamicMontage(IdleAnimation, FName("DefaultSlot"), 0.25f, 0.25f, 1.f, 1);
+            UE_LOG(LogTemp, VeryVerbose, TEXT("IdleAnimation && bIsIdle"));
+            if (UAnimMontage* Montage = PlaySlotAnimationAsDynamicMontage(IdleAnimation, DefaultSlotName, BlendInTime, 0.25f, 1.f, 1))
+            {
+                // Loop the single section so the montage lasts as long as the state
+                Montage_SetNextSection(Montage->GetSectionName(0), Montage->GetSectionName(0), Montage);
+                if (bResuming)
+                {
+                    Montage_SetPosition(Montage, ResumeTime);
+                }
+            }
+            AnimDemoStats::CountMontageStarted();
+            ANIMDEMO_TRACE_MONTAGE_STARTED(GetOwningActor() ? GetOwningActor()->GetUniqueID() : 0, CurrentState, IdleAnimation);
         }
         break;
 
     case ECharacterAnimState::Locomotion:
-        UE_LOG(LogTemp, Warning, TEXT("CharacterAnimState: Locomotion"));
+        UE_LOG(LogTemp, VeryVerbose, TEXT("CharacterAnimState: Locomotion"));
+        if (bStateChanged)
+        {
+            // The looping idle montage would otherwise cover the blend space
+            StopSlotAnimation(0.25f, DefaultSlotName);
+        }
         if (LocomotionBlendSpace)
         {
-            UE_LOG(LogTemp, Warning, TEXT("LocomotionBlendSpace"));
+            UE_LOG(LogTemp, VeryVerbose, TEXT("LocomotionBlendSpace"));
             // Update blend space pose
             // In pure C++, you can call GetAnimationPose manually if needed,
             // or simply rely on AnimBP nodes to read LocomotionBlendSpaceInput
@@ -66,12 +141,94 @@ void UMyAnimInstance::PlayAnimations(float DeltaSeconds)
         break;
 
     case ECharacterAnimState::Jump:
-        UE_LOG(LogTemp, Warning, TEXT("CharacterAnimState: Jump"));
-        if (JumpAnimation && bIsJumping)
+        UE_LOG(LogTemp, VeryVerbose, TEXT("CharacterAnimState: Jump"));
+        if (JumpAnimation && bIsJumping && bStateChanged)
         {
-            UE_LOG(LogTemp, Warning, TEXT("JumpAnimation && bIsJumping"));
-            PlaySlotAnimationAsDynamicMontage(JumpAnimation, FName("DefaultSlot"), 0.25f, 0.25f, 1.f, 1);
+            UE_LOG(LogTemp, VeryVerbose, TEXT("JumpAnimation && bIsJumping"));
+            UAnimMontage* Montage = PlaySlotAnimationAsDynamicMontage(JumpAnimation, DefaultSlotName, BlendInTime, 0.25f, 1.f, 1);
+            if (Montage && bResuming)
+            {
+                Montage_SetPosition(Montage, ResumeTime);
+            }
+            AnimDemoStats::CountMontageStarted();
+            ANIMDEMO_TRACE_MONTAGE_STARTED(GetOwningActor() ? GetOwningActor()->GetUniqueID() : 0, CurrentState, JumpAnimation);
         }
         break;
     }
+    
+    ResumeTime = -1.f;
+}
+
+void UMyAnimInstance::ResumeState(ECharacterAnimState State, float Time)
+{
+    CurrentState = State;
+    LastPlayedState = ECharacterAnimState::None;
+    ResumeTime = FMath::Max(0.f, Time);
+}
+
+float UMyAnimInstance::GetStateMontagePosition() const
+{
+    return Montage_GetPosition(GetCurrentActiveMontage());
+}
+
+void UMyAnimInstance::SetPoseSearchMatch(UAnimSequence* Sequence, float Time, bool bJumped)
+{
+    bPoseSearchActive = Sequence != nullptr;
+    PoseSearchSequence = Sequence;
+    PoseSearchTime = Time;
+    if (bJumped)
+    {
+        ++PoseSearchJumpCount;
+    }
+}
+
+void UMyAnimInstance::ClearPoseSearchMatch()
+{
+    bPoseSearchActive = false;
+    PoseSearchSequence = nullptr;
+    PoseSearchTime = 0.f;
+}
+
+void UMyAnimInstance::SaveSnapshot(FMyAnimInstanceSnapshot& OutSnapshot) const
+{
+    OutSnapshot.LeftFootEffectorOffset = LeftFootEffectorOffset;
+    OutSnapshot.RightFootEffectorOffset = RightFootEffectorOffset;
+    OutSnapshot.LeftFootRotation = LeftFootRotation;
+    OutSnapshot.RightFootRotation = RightFootRotation;
+    for (int32 Foot = 0; Foot < AnimDemoFootPlacement::NumFeet; ++Foot)
+    {
+        OutSnapshot.FootOffsets[Foot] = FootOffsets[Foot];
+    }
+    OutSnapshot.PelvisOffset = PelvisOffset;
+    OutSnapshot.FootPlacementAlpha = FootPlacementAlpha;
+    OutSnapshot.LocomotionBlendSpaceInput = LocomotionBlendSpaceInput;
+    OutSnapshot.CurrentState = CurrentState;
+    OutSnapshot.bIsJumping = bIsJumping;
+    OutSnapshot.bIsIdle = bIsIdle;
+}
+
+void UMyAnimInstance::RestoreSnapshot(const FMyAnimInstanceSnapshot& Snapshot)
+{
+    LeftFootEffectorOffset = Snapshot.LeftFootEffectorOffset;
+    RightFootEffectorOffset = Snapshot.RightFootEffectorOffset;
+    LeftFootRotation = Snapshot.LeftFootRotation;
+    RightFootRotation = Snapshot.RightFootRotation;
+    for (int32 Foot = 0; Foot < AnimDemoFootPlacement::NumFeet; ++Foot)
+    {
+        FootOffsets[Foot] = Snapshot.FootOffsets[Foot];
+    }
+    PelvisOffset = Snapshot.PelvisOffset;
+    FootPlacementAlpha = Snapshot.FootPlacementAlpha;
+    LocomotionBlendSpaceInput = Snapshot.LocomotionBlendSpaceInput;
+    CurrentState = Snapshot.CurrentState;
+    bIsJumping = Snapshot.bIsJumping;
+    bIsIdle = Snapshot.bIsIdle;
+    
+    // The ground is traced again before the next update
+    FootPlacementInput = FFootPlacementInput();
+    
+    // Montages are not part of the snapshot; the restored state's one starts over
+    StopAllMontages(0.f);
+    LastPlayedState = ECharacterAnimState::None;
+    ClearPoseSearchMatch();
 }
@@ -0,0 +1,249 @@
+//
+//  PlayerSettingsComponent.cpp
+//
+#include "PlayerSettingsComponent.h"
+#include "PlayerSettingsSave.h"
+#include "PlayerSettingsSubsystem.h"
+#include "PlayerSettingsWidget.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+UPlayerSettingsComponent::UPlayerSettingsComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UPlayerSettingsComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    Unbind();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+
+void UPlayerSettingsComponent::Bind()
+{
+    Unbind();
+
+    UPlayerSettingsSubsystem* Subsystem = UPlayerSettingsSubsystem::Get(GetOwner<APawn>());
+    if (!Subsystem) return;
+
+    PlayerSettings = Subsystem;
+    PlayerSettingsChangedHandle = Subsystem->OnSettingsChanged().AddUObject(this, &UPlayerSettingsComponent::ApplySettings);
+    ApplySettings(Subsystem->GetSettings());
+}
+
+
+void UPlayerSettingsComponent::Unbind()
+{
+    ReleaseSettingsWidget();
+
+    if (UPlayerSettingsSubsystem* Subsystem = PlayerSettings.Get())
+    {
+        Subsystem->OnSettingsChanged().Remove(PlayerSettingsChangedHandle);
+    }
+
+    PlayerSettings.Reset();
+    PlayerSettingsChangedHandle.Reset();
+}
+
+
+void UPlayerSettingsComponent::ApplySettings(const UPlayerSettingsSave& Settings)
+{
+    MouseSensitivity = Settings.MouseSensitivity;
+    MouseSmoothing = Settings.MouseSmoothing;
+    bInvertY = Settings.bInvertY;
+}
+
+
+void UPlayerSettingsComponent::SaveSettings()
+{
+    // The settings subsystem persists changes itself; this only pushes the current values to it
+    if (UPlayerSettingsSubsystem* Subsystem = PlayerSettings.Get())
+    {
+        Subsystem->SetMouseSensitivity(MouseSensitivity);
+        Subsystem->SetMouseSmoothing(MouseSmoothing);
+        Subsystem->SetInvertY(bInvertY);
+    }
+}
+
+
+void UPlayerSettingsComponent::LoadSettings()
+{
+    // Served from memory, never from disk
+    if (UPlayerSettingsSubsystem* Subsystem = PlayerSettings.Get())
+    {
+        ApplySettings(Subsystem->GetSettings());
+    }
+}
+
+
+void UPlayerSettingsComponent::SetMouseSensitivity(float Value)
+{
+    if (UPlayerSettingsSubsystem* Subsystem = PlayerSettings.Get())
+    {
+        // Applied back to this component through the change notification
+        Subsystem->SetMouseSensitivity(Value);
+    }
+    else
+    {
+        MouseSensitivity = UPlayerSettingsSave::ClampMouseSensitivity(Value);
+    }
+}
+
+
+void UPlayerSettingsComponent::SetMouseSmoothing(float Value)
+{
+    if (UPlayerSettingsSubsystem* Subsystem = PlayerSettings.Get())
+    {
+        // Applied back to this component through the change notification
+        Subsystem->SetMouseSmoothing(Value);
+    }
+    else
+    {
+        MouseSmoothing = UPlayerSettingsSave::ClampMouseSmoothing(Value);
+    }
+}
+
+
+void UPlayerSettingsComponent::SetInvertY(bool bInvert)
+{
+    if (UPlayerSettingsSubsystem* Subsystem = PlayerSettings.Get())
+    {
+        // Applied back to this component through the change notification
+        Subsystem->SetInvertY(bInvert);
+    }
+    else
+    {
+        bInvertY = bInvert;
+    }
+}
+
+
+bool UPlayerSettingsComponent::AcquireSettingsWidget(TSubclassOf<UPlayerSettingsWidget> WidgetClass)
+{
+    if (SettingsWidget) return true;
+
+    UPlayerSettingsSubsystem* Subsystem = PlayerSettings.Get();
+    const APawn* Pawn = GetOwner<APawn>();
+    APlayerController* PC = Pawn ? Cast<APlayerController>(Pawn->GetController()) : nullptr;
+    if (!Subsystem || !PC || !WidgetClass) return false; // WidgetClass is set on the character in editor
+
+    SettingsWidget = Subsystem->GetOrCreateSettingsWidget(PC, WidgetClass);
+    if (!SettingsWidget)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SettingsWidget creation FAILED!"));
+        return false;
+    }
+
+    SettingsWidget->OnSensitivityChanged.AddDynamic(this, &UPlayerSettingsComponent::SetMouseSensitivity);
+    SettingsWidget->OnSmoothingChanged.AddDynamic(this, &UPlayerSettingsComponent::SetMouseSmoothing);
+    SettingsWidget->OnInvertYChanged.AddDynamic(this, &UPlayerSettingsComponent::SetInvertY);
+    SettingsWidget->OnCloseButtonPressed.AddDynamic(this, &UPlayerSettingsComponent::HandleCloseButtonPressed);
+    return true;
+}
+
+
+void UPlayerSettingsComponent::ReleaseSettingsWidget()
+{
+    if (!SettingsWidget) return;
+
+    // The widget outlives this pawn in the local player's pool
+    SettingsWidget->OnSensitivityChanged.RemoveAll(this);
+    SettingsWidget->OnSmoothingChanged.RemoveAll(this);
+    SettingsWidget->OnInvertYChanged.RemoveAll(this);
+    SettingsWidget->OnCloseButtonPressed.RemoveAll(this);
+    SettingsWidget->SetVisibility(ESlateVisibility::Collapsed);
+    SettingsWidget = nullptr;
+}
+
+
+void UPlayerSettingsComponent::HandleCloseButtonPressed()
+{
+    // The widget is already acquired, so no class is needed
+    ToggleSettingsMenu(nullptr);
+}
+
+
+void UPlayerSettingsComponent::HideSettingsWidget()
+{
+    if (!SettingsWidget) return;
+
+    UE_LOG(LogTemp, Warning, TEXT("Saving Settings and Hiding Settings Window..."));
+    SaveSettings();
+
+    SettingsWidget->SetVisibility(ESlateVisibility::Collapsed);
+    UE_LOG(LogTemp, Warning, TEXT("Settings save queued."));
+}
+
+
+void UPlayerSettingsComponent::ShowSettingsWidget()
+{
+    if (!SettingsWidget) return;
+
+    UE_LOG(LogTemp, Warning, TEXT("Showing Settings Window and Loading Settings."));
+
+    SettingsWidget->SetVisibility(ESlateVisibility::Visible);
+    LoadSettings();
+
+    // Update UI with loaded values
+    SettingsWidget->SetMouseSensitivity(MouseSensitivity);
+    SettingsWidget->SetMouseSmoothing(MouseSmoothing);
+    SettingsWidget->SetInvertY(bInvertY);
+
+    UE_LOG(LogTemp, Warning, TEXT("Settings loaded."));
+}
+
+
+void UPlayerSettingsComponent::ToggleSettingsMenu(TSubclassOf<UPlayerSettingsWidget> WidgetClass)
+{
+    UE_LOG(LogTemp, Warning, TEXT("ToggleSettingsMenu called!"));
+    // Add small debounce to skip rapid key repeats
+    if (bIsToggling) return;
+
+    bIsToggling = true;
+    GetWorld()->GetTimerManager().SetTimerForNextTick([this]()
+    {
+        bIsToggling = false;
+    });
+
+    // Nothing is built until the menu is opened for the first time
+    if (!AcquireSettingsWidget(WidgetClass)) return;
+
+    APlayerController* PC = Cast<APlayerController>(GetOwner<APawn>()->GetController());
+    if (!PC) return;
+
+    const bool bIsVisible = SettingsWidget->IsVisible();
+
+    UE_LOG(LogTemp, Warning, TEXT("bIsVisible=%s"), bIsVisible ? TEXT("true") : TEXT("false"));
+    if (bIsVisible)
+    {
+        HideSettingsWidget();
+
+        GetWorld()->GetTimerManager().SetTimerForNextTick([this, PC]()
+        {
+            FInputModeGameOnly InputMode;
+            PC->SetInputMode(InputMode);
+            PC->bShowMouseCursor = false;
+            PC->SetIgnoreLookInput(false);      // Ensure look input is restored
+            PC->SetIgnoreMoveInput(false);      // Ensure move input is restored
+        });
+    }
+    else
+    {
+        ShowSettingsWidget();
+
+        // Set UI input mode with slight delay
+        GetWorld()->GetTimerManager().SetTimerForNextTick([this, PC]()
+        {
+            if (!SettingsWidget) return;
+
+            FInputModeUIOnly InputMode;
+            InputMode.SetWidgetToFocus(SettingsWidget->TakeWidget());
+            PC->SetInputMode(InputMode);
+            PC->bShowMouseCursor = true;
+        });
+    }
+}
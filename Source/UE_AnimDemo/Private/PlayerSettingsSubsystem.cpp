@@ -0,0 +1,229 @@
+//
+//  PlayerSettingsSubsystem.cpp
+//
+#include "PlayerSettingsSubsystem.h"
+#include "PlayerSettingsSave.h"
+#include "PlayerSettingsWidget.h"
+#include "AnimDemoMemory.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+
+// Desktop platforms use the generic save game system, which overwrites the slot file in place;
+// there the slot is written to a temp file next to it and renamed over it instead
+#ifndef ANIMDEMO_SETTINGS_REPLACE_SLOT_FILE
+#define ANIMDEMO_SETTINGS_REPLACE_SLOT_FILE PLATFORM_DESKTOP
+#endif
+
+static TAutoConsoleVariable<float> CVarSettingsSaveDebounce(
+    TEXT("AnimDemo.Settings.SaveDebounce"),
+    0.5f,
+    TEXT("Seconds without a settings change before the player settings are written to disk."));
+
+void UPlayerSettingsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    
+    LLM_SCOPE_BYTAG(AnimDemo_SaveGame);
+    Settings = Cast<UPlayerSettingsSave>(UGameplayStatics::CreateSaveGameObject(UPlayerSettingsSave::StaticClass()));
+    
+    // Checking for the slot and reading it both happen on a worker thread
+    UGameplayStatics::AsyncLoadGameFromSlot(
+        UPlayerSettingsSave::SlotName,
+        UPlayerSettingsSave::UserIndex,
+        FAsyncLoadGameFromSlotDelegate::CreateUObject(this, &UPlayerSettingsSubsystem::HandleSlotLoaded)
+    );
+}
+
+void UPlayerSettingsSubsystem::Deinitialize()
+{
+    Flush(true);
+    SettingsChanged.Clear();
+    
+    Super::Deinitialize();
+}
+
+UPlayerSettingsSubsystem* UPlayerSettingsSubsystem::Get(const APawn* Pawn)
+{
+    const APlayerController* PC = Pawn ? Cast<APlayerController>(Pawn->GetController()) : nullptr;
+    if (!PC || !PC->IsLocalController())
+        return nullptr;
+    
+    return ULocalPlayer::GetSubsystem<UPlayerSettingsSubsystem>(PC->GetLocalPlayer());
+}
+
+void UPlayerSettingsSubsystem::HandleSlotLoaded(const FString& SlotName, const int32 UserIndex, USaveGame* LoadedGame)
+{
+    bLoaded = true;
+    
+    const UPlayerSettingsSave* Loaded = Cast<UPlayerSettingsSave>(LoadedGame);
+    if (!Loaded)
+        return;
+    
+    // Changes made while the load was in flight are newer than what is on disk, even once
+    // they have been written
+    if (bModified)
+        return;
+    
+    Settings->MouseSensitivity = Loaded->MouseSensitivity;
+    Settings->MouseSmoothing = Loaded->MouseSmoothing;
+    Settings->bInvertY = Loaded->bInvertY;
+    
+    SettingsChanged.Broadcast(*Settings);
+}
+
+void UPlayerSettingsSubsystem::SetMouseSensitivity(float NewSens)
+{
+    NewSens = UPlayerSettingsSave::ClampMouseSensitivity(NewSens);
+    if (Settings->MouseSensitivity != NewSens)
+    {
+        Settings->MouseSensitivity = NewSens;
+        NotifyChanged();
+    }
+}
+
+void UPlayerSettingsSubsystem::SetMouseSmoothing(float NewSmooth)
+{
+    NewSmooth = UPlayerSettingsSave::ClampMouseSmoothing(NewSmooth);
+    if (Settings->MouseSmoothing != NewSmooth)
+    {
+        Settings->MouseSmoothing = NewSmooth;
+        NotifyChanged();
+    }
+}
+
+void UPlayerSettingsSubsystem::SetInvertY(bool bNewInvert)
+{
+    if (Settings->bInvertY != bNewInvert)
+    {
+        Settings->bInvertY = bNewInvert;
+        NotifyChanged();
+    }
+}
+
+void UPlayerSettingsSubsystem::NotifyChanged()
+{
+    SettingsChanged.Broadcast(*Settings);
+    
+    bDirty = true;
+    bModified = true;
+    LastChangeTime = FPlatformTime::Seconds();
+    
+    if (!DebounceHandle.IsValid())
+    {
+        DebounceHandle = FTSTicker::GetCoreTicker().AddTicker(
+            FTickerDelegate::CreateUObject(this, &UPlayerSettingsSubsystem::TickDebounce)
+        );
+    }
+}
+
+bool UPlayerSettingsSubsystem::TickDebounce(float DeltaTime)
+{
+    if (FPlatformTime::Seconds() - LastChangeTime < CVarSettingsSaveDebounce.GetValueOnGameThread())
+        return true;
+    
+    DebounceHandle.Reset();
+    WriteAsync();
+    return false;
+}
+
+UPlayerSettingsWidget* UPlayerSettingsSubsystem::GetOrCreateSettingsWidget(APlayerController* OwningPlayer, TSubclassOf<UPlayerSettingsWidget> WidgetClass)
+{
+    if (!OwningPlayer || !WidgetClass)
+        return nullptr;
+    
+    // A new class or a new player controller (e.g. after a map change) needs a new widget
+    if (SettingsWidget && (SettingsWidget->GetClass() != WidgetClass || SettingsWidget->GetOwningPlayer() != OwningPlayer))
+    {
+        SettingsWidget->RemoveFromParent();
+        SettingsWidget = nullptr;
+    }
+    
+    if (!SettingsWidget)
+    {
+        LLM_SCOPE_BYTAG(AnimDemo_SettingsUI);
+        SettingsWidget = CreateWidget<UPlayerSettingsWidget>(OwningPlayer, WidgetClass);
+        if (SettingsWidget)
+        {
+            // Collapsed widgets take no part in layout or prepass until opened
+            SettingsWidget->SetVisibility(ESlateVisibility::Collapsed);
+            SettingsWidget->AddToViewport();
+        }
+    }
+    
+    return SettingsWidget;
+}
+
+void UPlayerSettingsSubsystem::Flush(bool bWait)
+{
+    if (DebounceHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(DebounceHandle);
+        DebounceHandle.Reset();
+    }
+    
+    WriteAsync();
+    
+    if (bWait)
+    {
+        WritePipe.WaitUntilEmpty();
+    }
+}
+
+void UPlayerSettingsSubsystem::WriteAsync()
+{
+    if (!bDirty || !Settings)
+        return;
+    
+    bDirty = false;
+    
+    LLM_SCOPE_BYTAG(AnimDemo_SaveGame);
+    
+    // Serializing the few settings fields is cheap; only the file I/O leaves the game thread
+    TArray<uint8> Data;
+    if (!UGameplayStatics::SaveGameToMemory(Settings, Data))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to serialize player settings."));
+        return;
+    }
+    
+    // The pipe keeps writes ordered, so an older write never lands after a newer one
+#if ANIMDEMO_SETTINGS_REPLACE_SLOT_FILE
+    // The file the generic save game system loads the slot from; writing a temp file then
+    // renaming it means a crash or a full disk mid-write never leaves a truncated slot behind
+    const FString SlotPath = FPaths::ProjectSavedDir() / TEXT("SaveGames") / FString(UPlayerSettingsSave::SlotName) + TEXT(".sav");
+    
+    WritePipe.Launch(UE_SOURCE_LOCATION, [SlotPath, Data = MoveTemp(Data)]()
+    {
+        const FString TempPath = SlotPath + TEXT(".tmp");
+        if (!FFileHelper::SaveArrayToFile(Data, *TempPath) || !IFileManager::Get().Move(*SlotPath, *TempPath, true))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to write player settings to '%s'."), *SlotPath);
+            IFileManager::Get().Delete(*TempPath);
+        }
+    });
+#else
+    // Platform save game systems commit a slot as a whole
+    ISaveGameSystem* SaveSystem = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+    if (!SaveSystem)
+    {
+        UE_LOG(LogTemp, Error, TEXT("No save game system to write player settings with."));
+        return;
+    }
+    
+    WritePipe.Launch(UE_SOURCE_LOCATION, [SaveSystem, Data = MoveTemp(Data)]()
+    {
+        if (!SaveSystem->SaveGame(false, UPlayerSettingsSave::SlotName, UPlayerSettingsSave::UserIndex, Data))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to write player settings to slot '%s'."), UPlayerSettingsSave::SlotName);
+        }
+    });
+#endif
+}
@@ -13,6 +13,8 @@
 #include "Components/VerticalBoxSlot.h"
 #include "Components/HorizontalBoxSlot.h"
 #include "Components/BorderSlot.h"
+#include "Components/InvalidationBox.h"
+#include "Blueprint/WidgetTree.h"
 
 // For advanced styling
 #include "Engine/Texture2D.h"           // If using custom textures
@@ -21,25 +23,39 @@
 #include "Styling/SlateColor.h"
 #include "Engine/Font.h"
 
-void UPlayerSettingsWidget::NativeConstruct()
+const FPlayerSettingsWidgetStyle& FPlayerSettingsWidgetStyle::Get()
 {
-    Super::NativeConstruct();
+    static const FPlayerSettingsWidgetStyle Style = []()
+    {
+        FPlayerSettingsWidgetStyle NewStyle;
+        NewStyle.BackgroundColor = FLinearColor(0.1f, 0.1f, 0.1f, 0.8f); // 80% opacity
+        NewStyle.BackgroundPadding = FMargin(24.0f, 24.0f, 24.0f, 24.0f);
+        NewStyle.StandardPadding = FMargin(8.0f, 4.0f, 8.0f, 4.0f);
+        NewStyle.TextColor = FLinearColor::White;
+        NewStyle.FontSize = 14.0f;
+        NewStyle.ButtonColor = FLinearColor(0.2f, 0.2f, 0.2f, 1.0f);
+        NewStyle.SliderBarColor = FLinearColor(0.3f, 0.3f, 0.3f, 1.0f);
+        NewStyle.SliderHandleColor = FLinearColor(0.7f, 0.7f, 0.7f, 1.0f);
+        NewStyle.SliderStepSize = 0.01f; // Smooth sliding
+        return NewStyle;
+    }();
+    return Style;
+}
+
+void UPlayerSettingsWidget::NativeOnInitialized()
+{
+    Super::NativeOnInitialized();
+
+    // Runs once per widget instance. The widget is pooled per local player and collapsed
+    // while closed, so styling and delegate binding are not repeated on every open.
+    WrapInInvalidationBox();
 
     // Get the border widget (assuming it's bound)
     if (BackgroundBorder)
     {
-        // Create a custom brush
-        FSlateBrush CustomBrush;
-        CustomBrush.DrawAs = ESlateBrushDrawType::RoundedBox;
-        CustomBrush.SetResourceObject(nullptr); // Use solid color
-        CustomBrush.OutlineSettings.RoundingType = ESlateBrushRoundingType::FixedRadius;
-        CustomBrush.OutlineSettings.CornerRadii = FVector4(10.0f, 10.0f, 10.0f, 10.0f); // Rounded corners
-        
-        // Set color with transparency
-        FLinearColor BackgroundColor = FLinearColor(0.1f, 0.1f, 0.1f, 0.85f);
-        BackgroundColor.A = 0.8f; // 80% opacity
-        BackgroundBorder->SetBrushColor(BackgroundColor);
-        BackgroundBorder->SetPadding(FMargin(24.0f, 24.0f, 24.0f, 24.0f));
+        const FPlayerSettingsWidgetStyle& Style = FPlayerSettingsWidgetStyle::Get();
+        BackgroundBorder->SetBrushColor(Style.BackgroundColor);
+        BackgroundBorder->SetPadding(Style.BackgroundPadding);
         
         // Apply consistent styling to all child widgets
         ApplyConsistentStyling();
@@ -67,6 +83,21 @@ void UPlayerSettingsWidget::NativeConstruct()
 }
 
 
+void UPlayerSettingsWidget::WrapInInvalidationBox()
+{
+    // The menu is static apart from its sliders, so cache its layout and draw elements
+    // instead of re-running prepass and paint for the whole tree every frame
+    if (!WidgetTree || !WidgetTree->RootWidget || WidgetTree->RootWidget->IsA<UInvalidationBox>())
+        return;
+    
+    UWidget* Content = WidgetTree->RootWidget;
+    UInvalidationBox* InvalidationBox = WidgetTree->ConstructWidget<UInvalidationBox>(UInvalidationBox::StaticClass(), TEXT("SettingsInvalidationBox"));
+    InvalidationBox->SetCanCache(true);
+    WidgetTree->RootWidget = InvalidationBox;
+    InvalidationBox->SetContent(Content);
+}
+
+
 void UPlayerSettingsWidget::HandleSensitivitySlider(float Value)
 {
     OnSensitivityChanged.Broadcast(Value);
@@ -115,17 +146,16 @@ void UPlayerSettingsWidget::SetInvertY(bool bInvert)
 
 void UPlayerSettingsWidget::ApplyConsistentStyling()
 {
-    // Define your consistent styling values
-    const FMargin StandardPadding(8.0f, 4.0f, 8.0f, 4.0f);
-    const FLinearColor TextColor = FLinearColor::White;
-    const float StandardFontSize = 14.0f;
-    
     // Style all child widgets recursively
-    StyleChildWidgets(BackgroundBorder, StandardPadding, TextColor, StandardFontSize);
+    StyleChildWidgets(BackgroundBorder, FPlayerSettingsWidgetStyle::Get());
 }
 
-void UPlayerSettingsWidget::StyleChildWidgets(UWidget* ParentWidget, const FMargin& Padding, const FLinearColor& TextColor, float FontSize)
+void UPlayerSettingsWidget::StyleChildWidgets(UWidget* ParentWidget, const FPlayerSettingsWidgetStyle& Style)
 {
+    const FMargin& Padding = Style.StandardPadding;
+    const FLinearColor& TextColor = Style.TextColor;
+    const float FontSize = Style.FontSize;
+    
     if (!ParentWidget) return;
     
     // Check if this widget is a panel that contains other widgets
@@ -172,7 +202,7 @@ void UPlayerSettingsWidget::StyleChildWidgets(UWidget* ParentWidget, const FMarg
                 // Note: Advanced button styling is often better done in UMG Designer
                 
                 // Try to set background color (this may or may not work depending on UE version)
-                Button->SetBackgroundColor(FLinearColor(0.2f, 0.2f, 0.2f, 1.0f));
+                Button->SetBackgroundColor(Style.ButtonColor);
                 
                 // Style button text if it has any
                 if (Button->GetChildrenCount() > 0)
@@ -189,11 +219,11 @@ void UPlayerSettingsWidget::StyleChildWidgets(UWidget* ParentWidget, const FMarg
             else if (USlider* Slider = Cast<USlider>(ChildWidget))
             {
                 // Style sliders - USlider doesn't have GetStyle(), use direct property access
-                Slider->SetSliderBarColor(FLinearColor(0.3f, 0.3f, 0.3f, 1.0f));
-                Slider->SetSliderHandleColor(FLinearColor(0.7f, 0.7f, 0.7f, 1.0f));
+                Slider->SetSliderBarColor(Style.SliderBarColor);
+                Slider->SetSliderHandleColor(Style.SliderHandleColor);
                 
                 // Optional: Set other slider properties
-                Slider->SetStepSize(0.01f); // Smooth sliding
+                Slider->SetStepSize(Style.SliderStepSize);
             }
             else if (UCheckBox* CheckBox = Cast<UCheckBox>(ChildWidget))
             {
@@ -205,7 +235,7 @@ void UPlayerSettingsWidget::StyleChildWidgets(UWidget* ParentWidget, const FMarg
             }
             
             // Recursively style children of this widget
-            StyleChildWidgets(ChildWidget, Padding, TextColor, FontSize);
+            StyleChildWidgets(ChildWidget, Style);
         }
     }
 }
@@ -0,0 +1,242 @@
+//
+//  PoseSearchBuildCommandlet.cpp
+//
+#include "PoseSearchBuildCommandlet.h"
+#include "AnimCppChar.h"
+#include "PoseSearchDatabase.h"
+#include "PoseSearchSubsystem.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/BlendSpace.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+using namespace AnimDemoPoseSearch;
+
+namespace PoseSearchBuild
+{
+    // Root motion slower than this is an in-place sequence and uses its nominal speed instead
+    static constexpr float MinRootMotionSpeed = 1.f;
+
+    struct FSourceDesc
+    {
+        const UAnimSequence* Sequence = nullptr;
+        ECharacterAnimState Kind = ECharacterAnimState::Idle;
+        int32 BlendSampleIndex = 0;
+        bool bLooping = true;
+        float NominalSpeed = 0.f;
+    };
+
+    struct FContext
+    {
+        FQuat MeshToActor = FQuat::Identity;
+        float JumpZVelocity = 0.f;
+        float Gravity = 980.f;
+        int32 SampleRate = 30;
+    };
+
+    class FSampler
+    {
+    public:
+        FSampler(const FSourceDesc& InSource, const FContext& InContext)
+            : Source(InSource)
+            , Context(InContext)
+            , PlayLength(InSource.Sequence->GetPlayLength())
+        {
+            const FVector Total = RootOffset(0.f, PlayLength);
+            bInPlace = PlayLength <= 0.f || Total.Size2D() / PlayLength < MinRootMotionSpeed;
+        }
+
+        float GetPlayLength() const { return PlayLength; }
+
+        void GetFeatures(float Time, float OutFeatures[NumFeatures]) const
+        {
+            const float HalfStep = 0.5f / Context.SampleRate;
+            const FVector Current = Velocity(Time, HalfStep);
+            const FVector Past = Velocity(Time - PastVelocityTime, HalfStep);
+
+            OutFeatures[0] = Current.X;
+            OutFeatures[1] = Current.Y;
+            OutFeatures[2] = Past.X;
+            OutFeatures[3] = Past.Y;
+            for (int32 Future = 0; Future < UE_ARRAY_COUNT(FutureTimes); ++Future)
+            {
+                const FVector Offset = Displacement(Time, Time + FutureTimes[Future]);
+                OutFeatures[4 + Future * 2] = Offset.X;
+                OutFeatures[5 + Future * 2] = Offset.Y;
+            }
+
+            // Jumps are in place; their vertical velocity follows the character's ballistic arc
+            OutFeatures[10] = Source.Kind == ECharacterAnimState::Jump ? Context.JumpZVelocity - Context.Gravity * Time : 0.f;
+            OutFeatures[11] = 0.f;
+        }
+
+    private:
+        const FSourceDesc& Source;
+        const FContext& Context;
+        float PlayLength = 0.f;
+        bool bInPlace = false;
+
+        // Root translation between two times within the sequence, in actor space
+        FVector RootOffset(float Start, float End) const
+        {
+            const FTransform Delta = Source.Sequence->ExtractRootMotionFromRange(Start, End, FAnimExtractContext());
+            return Context.MeshToActor.RotateVector(Delta.GetTranslation());
+        }
+
+        // Root translation over any time range, wrapping looping sequences and holding the ends of the others
+        FVector Displacement(float Start, float End) const
+        {
+            if (bInPlace)
+            {
+                const float Duration = Source.bLooping ? End - Start : FMath::Clamp(End, 0.f, PlayLength) - FMath::Clamp(Start, 0.f, PlayLength);
+                return FVector(Source.NominalSpeed * Duration, 0.f, 0.f);
+            }
+
+            if (!Source.bLooping)
+            {
+                return RootOffset(FMath::Clamp(Start, 0.f, PlayLength), FMath::Clamp(End, 0.f, PlayLength));
+            }
+
+            FVector Result = FVector::ZeroVector;
+            float Cursor = FMath::Fmod(Start, PlayLength);
+            Cursor = Cursor < 0.f ? Cursor + PlayLength : Cursor;
+            float Remaining = End - Start;
+            while (Remaining > UE_KINDA_SMALL_NUMBER)
+            {
+                const float Step = FMath::Min(Remaining, PlayLength - Cursor);
+                Result += RootOffset(Cursor, Cursor + Step);
+                Remaining -= Step;
+                Cursor = 0.f;
+            }
+            return Result;
+        }
+
+        FVector Velocity(float Time, float HalfStep) const
+        {
+            return Displacement(Time - HalfStep, Time + HalfStep) / (2.f * HalfStep);
+        }
+    };
+
+    static void AddSequence(TArray<FSourceDesc>& Sources, const UAnimSequence* Sequence, ECharacterAnimState Kind, bool bLooping, float NominalSpeed)
+    {
+        if (!Sequence)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("No %s sequence on the character, skipped."), *UEnum::GetDisplayValueAsText(Kind).ToString());
+            return;
+        }
+
+        FSourceDesc& Source = Sources.AddDefaulted_GetRef();
+        Source.Sequence = Sequence;
+        Source.Kind = Kind;
+        Source.bLooping = bLooping;
+        Source.NominalSpeed = NominalSpeed;
+    }
+}
+
+UPoseSearchBuildCommandlet::UPoseSearchBuildCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UPoseSearchBuildCommandlet::Main(const FString& Params)
+{
+    using namespace PoseSearchBuild;
+
+    FString CharacterPath = TEXT("/Game/AnimCppCharacter.AnimCppCharacter_C");
+    FParse::Value(*Params, TEXT("Character="), CharacterPath);
+
+    FString Output = UPoseSearchSubsystem::GetDefaultDatabasePath();
+    FParse::Value(*Params, TEXT("Output="), Output);
+
+    FContext Context;
+    FParse::Value(*Params, TEXT("SampleRate="), Context.SampleRate);
+    Context.SampleRate = FMath::Clamp(Context.SampleRate, 1, 120);
+
+    float WalkSpeed = 150.f;
+    float RunSpeed = 500.f;
+    FParse::Value(*Params, TEXT("WalkSpeed="), WalkSpeed);
+    FParse::Value(*Params, TEXT("RunSpeed="), RunSpeed);
+
+    UClass* CharacterClass = LoadClass<AAnimCppChar>(nullptr, *CharacterPath);
+    if (!CharacterClass)
+    {
+        UE_LOG(LogTemp, Error, TEXT("'%s' is not an AAnimCppChar class."), *CharacterPath);
+        return 1;
+    }
+
+    const AAnimCppChar* Character = CharacterClass->GetDefaultObject<AAnimCppChar>();
+    Context.MeshToActor = Character->GetMesh()->GetRelativeRotation().Quaternion();
+    if (const UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement())
+    {
+        Context.JumpZVelocity = MoveComp->JumpZVelocity;
+        Context.Gravity = 980.f * MoveComp->GravityScale;
+    }
+
+    TArray<FSourceDesc> Sources;
+    AddSequence(Sources, Character->IdleAnimation, ECharacterAnimState::Idle, true, 0.f);
+    AddSequence(Sources, Character->WalkAnimation, ECharacterAnimState::Walk, true, WalkSpeed);
+    AddSequence(Sources, Character->RunAnimation, ECharacterAnimState::Run, true, RunSpeed);
+    AddSequence(Sources, Character->JumpAnimation, ECharacterAnimState::Jump, false, 0.f);
+
+    if (const UBlendSpace* BlendSpace = Character->MovementBlendSpace)
+    {
+        const TArray<FBlendSample>& Samples = BlendSpace->GetBlendSamples();
+        for (int32 Index = 0; Index < Samples.Num(); ++Index)
+        {
+            // The blend space's first axis is the ground speed UMyAnimInstance feeds it
+            const int32 First = Sources.Num();
+            AddSequence(Sources, Samples[Index].Animation, ECharacterAnimState::Locomotion, true, Samples[Index].SampleValue.X);
+            if (Sources.Num() > First)
+            {
+                Sources.Last().BlendSampleIndex = Index;
+            }
+        }
+    }
+
+    FPoseSearchDatabaseBuilder Builder;
+    for (const FSourceDesc& Source : Sources)
+    {
+        const FSampler Sampler(Source, Context);
+        const int32 SourceIndex = Builder.AddSource(Source.Kind, Source.BlendSampleIndex, Sampler.GetPlayLength(), Source.bLooping);
+
+        const int32 NumSamples = FMath::Max(1, FMath::FloorToInt32(Sampler.GetPlayLength() * Context.SampleRate) + 1);
+        for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+        {
+            const float Time = FMath::Min(static_cast<float>(Sample) / Context.SampleRate, Sampler.GetPlayLength());
+
+            float Features[NumFeatures];
+            Sampler.GetFeatures(Time, Features);
+            Builder.AddPose(SourceIndex, Time, Features);
+        }
+
+        UE_LOG(LogTemp, Display, TEXT("  %-40s %-10s %6.2f s  %4d poses"),
+            *Source.Sequence->GetName(), *UEnum::GetDisplayValueAsText(Source.Kind).ToString(), Sampler.GetPlayLength(), NumSamples);
+    }
+
+    if (Builder.GetNumPoses() == 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("'%s' has no animation assigned, nothing to build."), *CharacterPath);
+        return 1;
+    }
+
+    float Weights[NumFeatures];
+    GetDefaultWeights(Weights);
+    const TArray<uint8> Bytes = Builder.Build(Weights, Context.SampleRate);
+
+    FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*FPaths::GetPath(Output));
+    if (!FFileHelper::SaveArrayToFile(Bytes, *Output))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to write '%s'."), *Output);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("Pose search database '%s': %d poses from %d sources, %d bytes."),
+        *Output, Builder.GetNumPoses(), Sources.Num(), Bytes.Num());
+    return 0;
+}
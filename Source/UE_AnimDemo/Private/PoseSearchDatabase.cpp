@@ -0,0 +1,390 @@
+//
+//  PoseSearchDatabase.cpp
+//
+#include "PoseSearchDatabase.h"
+#include "Algo/Sort.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Math/VectorRegister.h"
+#include "Misc/FileHelper.h"
+
+using namespace AnimDemoPoseSearch;
+
+void AnimDemoPoseSearch::GetDefaultWeights(float OutWeights[NumFeatures])
+{
+    static const float Weights[NumFeatures] =
+    {
+        1.f, 1.f,       // current velocity
+        0.5f, 0.5f,     // past velocity
+        1.f, 1.f,       // offset in 0.25 s
+        0.75f, 0.75f,   // offset in 0.5 s
+        0.5f, 0.5f,     // offset in 0.75 s
+        1.5f,           // vertical velocity, keeps jumps apart from ground poses
+        0.f,            // padding
+    };
+    FMemory::Memcpy(OutWeights, Weights, sizeof(Weights));
+}
+
+namespace PoseSearchDatabaseImpl
+{
+    static uint64 Align16(uint64 Offset)
+    {
+        return Align(Offset, 16);
+    }
+
+    template<typename T>
+    static void AppendSection(TArray<uint8>& Bytes, uint64& OutOffset, const T* Items, int32 Num)
+    {
+        Bytes.SetNumZeroed(Align16(Bytes.Num()));
+        OutOffset = Bytes.Num();
+        Bytes.Append(reinterpret_cast<const uint8*>(Items), Num * sizeof(T));
+    }
+
+    // Squared distance of one pose to the query, three SIMD lanes of four features
+    FORCEINLINE static float PoseCost(const float* Pose, const VectorRegister4Float Query[NumFeatureVectors])
+    {
+        VectorRegister4Float Sum = VectorZeroFloat();
+        for (int32 Lane = 0; Lane < NumFeatureVectors; ++Lane)
+        {
+            const VectorRegister4Float Delta = VectorSubtract(VectorLoad(Pose + Lane * 4), Query[Lane]);
+            Sum = VectorMultiplyAdd(Delta, Delta, Sum);
+        }
+        return VectorGetComponent(VectorDot4(Sum, GlobalVectorConstants::FloatOne), 0);
+    }
+}
+
+FPoseSearchDatabase::~FPoseSearchDatabase()
+{
+    // The region has to go before the handle it was mapped from
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+}
+
+bool FPoseSearchDatabase::Load(const FString& Filename)
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    MappedHandle.Reset(PlatformFile.OpenMapped(*Filename));
+    if (MappedHandle && MappedHandle->GetFileSize() > 0)
+    {
+        MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+    }
+
+    if (MappedRegion)
+    {
+        Data = MappedRegion->GetMappedPtr();
+        Size = MappedRegion->GetMappedSize();
+    }
+    else if (FFileHelper::LoadFileToArray(OwnedData, *Filename))
+    {
+        Data = OwnedData.GetData();
+        Size = OwnedData.Num();
+    }
+
+    return Validate(Filename);
+}
+
+bool FPoseSearchDatabase::InitFromMemory(TArray<uint8>&& Bytes)
+{
+    OwnedData = MoveTemp(Bytes);
+    Data = OwnedData.GetData();
+    Size = OwnedData.Num();
+    return Validate(TEXT("<memory>"));
+}
+
+bool FPoseSearchDatabase::Validate(const FString& Name)
+{
+    Header = nullptr;
+
+    const FPoseSearchDbHeader* Candidate = Data && Size >= static_cast<int64>(sizeof(FPoseSearchDbHeader))
+        ? reinterpret_cast<const FPoseSearchDbHeader*>(Data)
+        : nullptr;
+
+    auto SectionFits = [this](uint64 Offset, uint64 Bytes)
+    {
+        return Offset % 16 == 0 && Offset + Bytes <= static_cast<uint64>(Size);
+    };
+
+    if (!Candidate
+        || Candidate->Magic != FPoseSearchDbHeader::MagicValue
+        || Candidate->Version != FPoseSearchDbHeader::CurrentVersion
+        || Candidate->NumFeatures != NumFeatures
+        || Candidate->NumPoses == 0
+        || Candidate->SampleRate == 0
+        || !SectionFits(Candidate->SourcesOffset, Candidate->NumSources * sizeof(FPoseSearchSourceRecord))
+        || !SectionFits(Candidate->PosesOffset, Candidate->NumPoses * sizeof(FPoseSearchPoseRecord))
+        || !SectionFits(Candidate->FeaturesOffset, Candidate->NumPoses * static_cast<uint64>(NumFeatures) * sizeof(float))
+        || !SectionFits(Candidate->NodesOffset, Candidate->NumNodes * sizeof(FPoseSearchNode))
+        || !SectionFits(Candidate->SourcePosesOffset, Candidate->NumPoses * sizeof(uint32)))
+    {
+        UE_LOG(LogTemp, Error, TEXT("'%s' is not a valid pose search database."), *Name);
+        Data = nullptr;
+        Size = 0;
+        return false;
+    }
+
+    Header = Candidate;
+    Sources = reinterpret_cast<const FPoseSearchSourceRecord*>(Data + Header->SourcesOffset);
+    Poses = reinterpret_cast<const FPoseSearchPoseRecord*>(Data + Header->PosesOffset);
+    Features = reinterpret_cast<const float*>(Data + Header->FeaturesOffset);
+    Nodes = reinterpret_cast<const FPoseSearchNode*>(Data + Header->NodesOffset);
+    SourcePoses = reinterpret_cast<const uint32*>(Data + Header->SourcePosesOffset);
+    return true;
+}
+
+void FPoseSearchDatabase::NormalizeQuery(const float* RawQuery, float* OutQuery) const
+{
+    for (int32 Feature = 0; Feature < NumFeatures; ++Feature)
+    {
+        OutQuery[Feature] = (RawQuery[Feature] - Header->Mean[Feature]) * Header->Scale[Feature];
+    }
+}
+
+float FPoseSearchDatabase::GetCost(int32 PoseIndex, const float* Query) const
+{
+    VectorRegister4Float QueryLanes[NumFeatureVectors];
+    for (int32 Lane = 0; Lane < NumFeatureVectors; ++Lane)
+    {
+        QueryLanes[Lane] = VectorLoad(Query + Lane * 4);
+    }
+    return PoseSearchDatabaseImpl::PoseCost(Features + PoseIndex * NumFeatures, QueryLanes);
+}
+
+void FPoseSearchDatabase::ScanLeaf(uint32 First, uint32 Count, const float* Query, FPoseSearchResult& Best) const
+{
+    VectorRegister4Float QueryLanes[NumFeatureVectors];
+    for (int32 Lane = 0; Lane < NumFeatureVectors; ++Lane)
+    {
+        QueryLanes[Lane] = VectorLoad(Query + Lane * 4);
+    }
+
+    const float* Pose = Features + First * NumFeatures;
+    for (uint32 Index = First; Index < First + Count; ++Index, Pose += NumFeatures)
+    {
+        const float Cost = PoseSearchDatabaseImpl::PoseCost(Pose, QueryLanes);
+        if (Cost < Best.Cost)
+        {
+            Best.Cost = Cost;
+            Best.PoseIndex = static_cast<int32>(Index);
+        }
+    }
+}
+
+FPoseSearchResult FPoseSearchDatabase::Search(const float* Query) const
+{
+    FPoseSearchResult Best;
+    if (!Header || Header->NumNodes == 0)
+        return Best;
+
+    struct FPending
+    {
+        uint32 Node;
+        float MinCost;
+    };
+
+    // Depth is about log2(NumPoses / leaf size); this covers far more than any database we build
+    TArray<FPending, TInlineAllocator<64>> Stack;
+    Stack.Add({ 0, 0.f });
+
+    while (Stack.Num() > 0)
+    {
+        const FPending Pending = Stack.Pop(EAllowShrinking::No);
+        if (Pending.MinCost >= Best.Cost)
+            continue;
+
+        const FPoseSearchNode& Node = Nodes[Pending.Node];
+        if (Node.bLeaf)
+        {
+            ScanLeaf(Node.First, Node.Second, Query, Best);
+            continue;
+        }
+
+        // Visit the side the query is on first; the other side is at least the plane distance away
+        const float Delta = Query[Node.SplitDim] - Node.SplitValue;
+        const uint32 Near = Delta < 0.f ? Pending.Node + 1 : Node.Second;
+        const uint32 Far = Delta < 0.f ? Node.Second : Pending.Node + 1;
+
+        Stack.Add({ Far, FMath::Max(Pending.MinCost, Delta * Delta) });
+        Stack.Add({ Near, Pending.MinCost });
+    }
+
+    return Best;
+}
+
+FPoseSearchResult FPoseSearchDatabase::SearchBruteForce(const float* Query) const
+{
+    FPoseSearchResult Best;
+    if (Header)
+    {
+        ScanLeaf(0, Header->NumPoses, Query, Best);
+    }
+    return Best;
+}
+
+int32 FPoseSearchDatabase::FindPose(int32 Source, float Time) const
+{
+    const FPoseSearchSourceRecord& Record = Sources[Source];
+    if (Record.NumSamples == 0)
+        return INDEX_NONE;
+
+    const int32 Sample = FMath::Clamp(FMath::RoundToInt32(Time * Header->SampleRate), 0, static_cast<int32>(Record.NumSamples) - 1);
+    return static_cast<int32>(SourcePoses[Record.FirstSample + Sample]);
+}
+
+int32 FPoseSearchDatabaseBuilder::AddSource(ECharacterAnimState Kind, int32 BlendSampleIndex, float PlayLength, bool bLooping)
+{
+    FPoseSearchSourceRecord& Source = Sources.AddDefaulted_GetRef();
+    Source.Kind = Kind;
+    Source.bLooping = bLooping ? 1 : 0;
+    Source.BlendSampleIndex = static_cast<uint16>(BlendSampleIndex);
+    Source.PlayLength = PlayLength;
+    return Sources.Num() - 1;
+}
+
+void FPoseSearchDatabaseBuilder::AddPose(int32 Source, float Time, const float RawFeatures[NumFeatures])
+{
+    check(Sources.IsValidIndex(Source));
+
+    FPendingPose& Pose = Poses.AddDefaulted_GetRef();
+    Pose.Source = Source;
+    Pose.Time = Time;
+    FMemory::Memcpy(Pose.Features, RawFeatures, sizeof(Pose.Features));
+}
+
+TArray<uint8> FPoseSearchDatabaseBuilder::Build(const float Weights[NumFeatures], int32 SampleRate, int32 MaxLeafSize) const
+{
+    const int32 NumPoses = Poses.Num();
+    check(NumPoses > 0 && SampleRate > 0);
+    MaxLeafSize = FMath::Max(MaxLeafSize, 1);
+
+    FPoseSearchDbHeader Header;
+    Header.NumSources = Sources.Num();
+    Header.NumPoses = NumPoses;
+    Header.SampleRate = SampleRate;
+
+    // Per-feature deviation normalization; constant features get a zero scale and drop out
+    for (int32 Feature = 0; Feature < NumFeatures; ++Feature)
+    {
+        double Sum = 0.0;
+        double SumSq = 0.0;
+        for (const FPendingPose& Pose : Poses)
+        {
+            Sum += Pose.Features[Feature];
+            SumSq += FMath::Square(static_cast<double>(Pose.Features[Feature]));
+        }
+        const double Mean = Sum / NumPoses;
+        const double Deviation = FMath::Sqrt(FMath::Max(SumSq / NumPoses - Mean * Mean, 0.0));
+
+        Header.Mean[Feature] = static_cast<float>(Mean);
+        Header.Scale[Feature] = Deviation > UE_KINDA_SMALL_NUMBER ? static_cast<float>(Weights[Feature] / Deviation) : 0.f;
+    }
+
+    TArray<float> Normalized;
+    Normalized.SetNumUninitialized(NumPoses * NumFeatures);
+    for (int32 Pose = 0; Pose < NumPoses; ++Pose)
+    {
+        for (int32 Feature = 0; Feature < NumFeatures; ++Feature)
+        {
+            Normalized[Pose * NumFeatures + Feature] = (Poses[Pose].Features[Feature] - Header.Mean[Feature]) * Header.Scale[Feature];
+        }
+    }
+
+    // KD-tree over pose indices; the final order is the leaf order the features are stored in
+    TArray<int32> Order;
+    Order.SetNumUninitialized(NumPoses);
+    for (int32 Pose = 0; Pose < NumPoses; ++Pose)
+    {
+        Order[Pose] = Pose;
+    }
+
+    TArray<FPoseSearchNode> Nodes;
+    TFunction<uint32(int32, int32)> BuildNode = [&](int32 Begin, int32 End) -> uint32
+    {
+        const uint32 NodeIndex = Nodes.AddDefaulted();
+        if (End - Begin <= MaxLeafSize)
+        {
+            Nodes[NodeIndex].bLeaf = 1;
+            Nodes[NodeIndex].First = Begin;
+            Nodes[NodeIndex].Second = End - Begin;
+            return NodeIndex;
+        }
+
+        // Split the widest dimension at its median
+        int32 SplitDim = 0;
+        float WidestRange = -1.f;
+        for (int32 Feature = 0; Feature < NumFeatures; ++Feature)
+        {
+            float Min = TNumericLimits<float>::Max();
+            float Max = TNumericLimits<float>::Lowest();
+            for (int32 Index = Begin; Index < End; ++Index)
+            {
+                const float Value = Normalized[Order[Index] * NumFeatures + Feature];
+                Min = FMath::Min(Min, Value);
+                Max = FMath::Max(Max, Value);
+            }
+            if (Max - Min > WidestRange)
+            {
+                WidestRange = Max - Min;
+                SplitDim = Feature;
+            }
+        }
+
+        Algo::Sort(MakeArrayView(Order.GetData() + Begin, End - Begin), [&Normalized, SplitDim](int32 A, int32 B)
+        {
+            return Normalized[A * NumFeatures + SplitDim] < Normalized[B * NumFeatures + SplitDim];
+        });
+
+        const int32 Mid = Begin + (End - Begin) / 2;
+        Nodes[NodeIndex].SplitDim = static_cast<uint16>(SplitDim);
+        Nodes[NodeIndex].SplitValue = Normalized[Order[Mid] * NumFeatures + SplitDim];
+
+        BuildNode(Begin, Mid);
+        const uint32 Right = BuildNode(Mid, End);
+        Nodes[NodeIndex].Second = Right;
+        return NodeIndex;
+    };
+    BuildNode(0, NumPoses);
+    Header.NumNodes = Nodes.Num();
+
+    TArray<int32> TreePosition;
+    TreePosition.SetNumUninitialized(NumPoses);
+    TArray<FPoseSearchPoseRecord> PoseRecords;
+    PoseRecords.SetNumUninitialized(NumPoses);
+    TArray<float> Features;
+    Features.SetNumUninitialized(NumPoses * NumFeatures);
+    for (int32 Position = 0; Position < NumPoses; ++Position)
+    {
+        const int32 Pose = Order[Position];
+        TreePosition[Pose] = Position;
+        PoseRecords[Position].Source = Poses[Pose].Source;
+        PoseRecords[Position].Time = Poses[Pose].Time;
+        FMemory::Memcpy(&Features[Position * NumFeatures], &Normalized[Pose * NumFeatures], NumFeatures * sizeof(float));
+    }
+
+    // Poses are added in time order per source, so each source's samples come out in time order
+    TArray<FPoseSearchSourceRecord> SourceRecords = Sources;
+    TArray<uint32> SourcePoses;
+    SourcePoses.Reserve(NumPoses);
+    for (int32 Source = 0; Source < SourceRecords.Num(); ++Source)
+    {
+        SourceRecords[Source].FirstSample = SourcePoses.Num();
+        for (int32 Pose = 0; Pose < NumPoses; ++Pose)
+        {
+            if (Poses[Pose].Source == Source)
+            {
+                SourcePoses.Add(TreePosition[Pose]);
+            }
+        }
+        SourceRecords[Source].NumSamples = SourcePoses.Num() - SourceRecords[Source].FirstSample;
+    }
+
+    TArray<uint8> Bytes;
+    Bytes.AddZeroed(sizeof(FPoseSearchDbHeader));
+    PoseSearchDatabaseImpl::AppendSection(Bytes, Header.SourcesOffset, SourceRecords.GetData(), SourceRecords.Num());
+    PoseSearchDatabaseImpl::AppendSection(Bytes, Header.PosesOffset, PoseRecords.GetData(), PoseRecords.Num());
+    PoseSearchDatabaseImpl::AppendSection(Bytes, Header.FeaturesOffset, Features.GetData(), Features.Num());
+    PoseSearchDatabaseImpl::AppendSection(Bytes, Header.NodesOffset, Nodes.GetData(), Nodes.Num());
+    PoseSearchDatabaseImpl::AppendSection(Bytes, Header.SourcePosesOffset, SourcePoses.GetData(), SourcePoses.Num());
+    FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(Header));
+    return Bytes;
+}
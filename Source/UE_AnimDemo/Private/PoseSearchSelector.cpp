@@ -0,0 +1,145 @@
+//
+//  PoseSearchSelector.cpp
+//
+#include "PoseSearchSelector.h"
+#include "AnimDemoStats.h"
+
+using namespace AnimDemoPoseSearch;
+
+void FPoseSearchTrajectory::AddSample(float DeltaTime, const FVector& Velocity)
+{
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        History[(Head + HistorySize - Index) % HistorySize].Age += DeltaTime;
+    }
+
+    // Samples older than the past feature needs are no longer read
+    while (Num > 1 && History[(Head + HistorySize - (Num - 1)) % HistorySize].Age > PastVelocityTime * 2.f)
+    {
+        --Num;
+    }
+
+    Head = (Head + 1) % HistorySize;
+    History[Head] = { 0.f, FVector3f(Velocity) };
+    Num = FMath::Min(Num + 1, HistorySize);
+}
+
+void FPoseSearchTrajectory::Reset()
+{
+    Head = 0;
+    Num = 0;
+}
+
+FVector3f FPoseSearchTrajectory::GetVelocityAt(float Age) const
+{
+    if (Num == 0)
+        return FVector3f::ZeroVector;
+
+    // Newest to oldest, interpolating between the samples around Age
+    const FSample* Newer = &History[Head];
+    for (int32 Index = 1; Index < Num; ++Index)
+    {
+        const FSample* Older = &History[(Head + HistorySize - Index) % HistorySize];
+        if (Older->Age >= Age)
+        {
+            const float Span = Older->Age - Newer->Age;
+            const float Alpha = Span > UE_SMALL_NUMBER ? (Age - Newer->Age) / Span : 0.f;
+            return FMath::Lerp(Newer->Velocity, Older->Velocity, Alpha);
+        }
+        Newer = Older;
+    }
+    return Newer->Velocity;
+}
+
+void FPoseSearchTrajectory::BuildQuery(const FRotator& Rotation, float OutRawQuery[NumFeatures]) const
+{
+    const FQuat4f ToLocal = FQuat4f(FRotator3f(Rotation)).Inverse();
+    const FVector3f Current = Num > 0 ? History[Head].Velocity : FVector3f::ZeroVector;
+    const FVector3f Past = GetVelocityAt(PastVelocityTime);
+
+    const FVector3f LocalCurrent = ToLocal.RotateVector(Current);
+    const FVector3f LocalPast = ToLocal.RotateVector(Past);
+
+    // The future is the current velocity carried on by the recent acceleration
+    FVector3f Acceleration = (LocalCurrent - LocalPast) / PastVelocityTime;
+    Acceleration.Z = 0.f;
+    Acceleration = Acceleration.GetClampedToMaxSize(MaxAcceleration);
+
+    OutRawQuery[0] = LocalCurrent.X;
+    OutRawQuery[1] = LocalCurrent.Y;
+    OutRawQuery[2] = LocalPast.X;
+    OutRawQuery[3] = LocalPast.Y;
+    for (int32 Future = 0; Future < UE_ARRAY_COUNT(FutureTimes); ++Future)
+    {
+        const float Time = FutureTimes[Future];
+        OutRawQuery[4 + Future * 2] = LocalCurrent.X * Time + 0.5f * Acceleration.X * Time * Time;
+        OutRawQuery[5 + Future * 2] = LocalCurrent.Y * Time + 0.5f * Acceleration.Y * Time * Time;
+    }
+    OutRawQuery[10] = LocalCurrent.Z;
+    OutRawQuery[11] = 0.f;
+}
+
+void FPoseSearchSelector::Reset()
+{
+    CurrentSource = INDEX_NONE;
+    CurrentTime = 0.f;
+    TimeSinceSearch = 0.f;
+    LastCost = 0.f;
+}
+
+void FPoseSearchSelector::AdvanceTime(const FPoseSearchDatabase& Database, float DeltaTime)
+{
+    const FPoseSearchSourceRecord& Source = Database.GetSource(CurrentSource);
+    CurrentTime += DeltaTime;
+    if (Source.bLooping && Source.PlayLength > 0.f)
+    {
+        CurrentTime = FMath::Fmod(CurrentTime, Source.PlayLength);
+    }
+    else
+    {
+        CurrentTime = FMath::Min(CurrentTime, Source.PlayLength);
+    }
+}
+
+bool FPoseSearchSelector::Update(const FPoseSearchDatabase& Database, const float RawQuery[NumFeatures], float DeltaTime)
+{
+    if (HasSelection())
+    {
+        AdvanceTime(Database, DeltaTime);
+    }
+
+    TimeSinceSearch += DeltaTime;
+    if (HasSelection() && TimeSinceSearch < SearchInterval)
+        return false;
+
+    ANIMDEMO_SCOPE_CYCLE_COUNTER(PoseSearchQuery);
+    TimeSinceSearch = 0.f;
+
+    alignas(16) float Query[NumFeatures];
+    Database.NormalizeQuery(RawQuery, Query);
+
+    const FPoseSearchResult Best = Database.Search(Query);
+    if (!Best.IsValid())
+        return false;
+
+    if (HasSelection())
+    {
+        const int32 Continuing = Database.FindPose(CurrentSource, CurrentTime);
+        if (Continuing != INDEX_NONE)
+        {
+            const float ContinuingCost = Database.GetCost(Continuing, Query);
+            if (Best.Cost >= ContinuingCost * ContinuingCostBias)
+            {
+                LastCost = ContinuingCost;
+                return false;
+            }
+        }
+    }
+
+    const FPoseSearchPoseRecord& Pose = Database.GetPose(Best.PoseIndex);
+    const bool bChanged = !HasSelection() || static_cast<int32>(Pose.Source) != CurrentSource || !FMath::IsNearlyEqual(Pose.Time, CurrentTime, 0.1f);
+    CurrentSource = Pose.Source;
+    CurrentTime = Pose.Time;
+    LastCost = Best.Cost;
+    return bChanged;
+}
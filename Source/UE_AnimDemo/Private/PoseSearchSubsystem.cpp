@@ -0,0 +1,61 @@
+//
+//  PoseSearchSubsystem.cpp
+//
+#include "PoseSearchSubsystem.h"
+#include "AnimDemoMemory.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<bool> CVarPoseSearchEnable(
+    TEXT("AnimDemo.PoseSearch.Enable"),
+    false,
+    TEXT("Select the locomotion pose of AAnimCppChar characters from the pose search database instead of the speed blend space.\n")
+    TEXT("Needs a database built by the PoseSearchBuild commandlet."));
+
+bool UPoseSearchSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Nobody sees the poses on a dedicated server
+    return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UPoseSearchSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    const FString Path = GetDefaultDatabasePath();
+    if (!FPaths::FileExists(Path))
+    {
+        UE_LOG(LogTemp, Log, TEXT("No pose search database at '%s', pose search is unavailable."), *Path);
+        return;
+    }
+
+    // Mapping only reserves address space; pages are read as the searches touch them
+    LLM_SCOPE_BYTAG(AnimDemo_PoseSearch);
+    Database = MakeUnique<FPoseSearchDatabase>();
+    if (Database->Load(Path))
+    {
+        UE_LOG(LogTemp, Display, TEXT("Pose search database '%s': %d poses from %d sources, %lld bytes."),
+            *Path, Database->GetNumPoses(), Database->GetNumSources(), Database->GetSizeBytes());
+    }
+    else
+    {
+        Database.Reset();
+    }
+}
+
+void UPoseSearchSubsystem::Deinitialize()
+{
+    Database.Reset();
+
+    Super::Deinitialize();
+}
+
+const FPoseSearchDatabase* UPoseSearchSubsystem::GetDatabase() const
+{
+    return Database && CVarPoseSearchEnable.GetValueOnGameThread() ? Database.Get() : nullptr;
+}
+
+FString UPoseSearchSubsystem::GetDefaultDatabasePath()
+{
+    return FPaths::ProjectContentDir() / TEXT("PoseSearch") / TEXT("Locomotion.posedb");
+}
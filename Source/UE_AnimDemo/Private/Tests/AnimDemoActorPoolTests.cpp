@@ -0,0 +1,75 @@
+//
+//  AnimDemoActorPoolTests.cpp
+//
+//  Automation tests for UAnimDemoActorPoolSubsystem: a released character is parked with its
+//  per-life state dropped, and the next acquire reuses it in place of a spawn.
+//
+#include "AnimDemoActorPoolSubsystem.h"
+#include "AnimCppChar.h"
+#include "AnimDemoTestWorld.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoActorPoolResetTest, "AnimDemo.ActorPool.Reset",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoActorPoolResetTest::RunTest(const FString& Parameters)
+{
+    FAnimDemoTestWorld TestWorld;
+    UAnimDemoActorPoolSubsystem* Pool = TestWorld.Get().GetSubsystem<UAnimDemoActorPoolSubsystem>();
+    if (!TestNotNull(TEXT("Actor pool subsystem"), Pool))
+        return false;
+
+    const FTransform FirstTransform(FVector(100.f, 200.f, 300.f));
+    AAnimCppChar* Character = Cast<AAnimCppChar>(Pool->Acquire(AAnimCppChar::StaticClass(), FirstTransform));
+    if (!TestNotNull(TEXT("Acquired character"), Character))
+        return false;
+
+    TestEqual(TEXT("First acquire spawns"), Pool->GetTimings().NumSpawned, 1);
+    TestFalse(TEXT("Acquired character is visible"), Character->IsHidden());
+    TestTrue(TEXT("Acquired character is at the requested spot"), Character->GetActorLocation().Equals(FirstTransform.GetLocation()));
+
+    // Mid-jump, as a character would be when a wave ends
+    FAnimCppCharSnapshot Airborne;
+    Character->SaveSnapshot(Airborne);
+    Airborne.Velocity = FVector(300.f, 0.f, 420.f);
+    Airborne.MovementMode = MOVE_Falling;
+    Airborne.Locomotion.Velocity = Airborne.Velocity;
+    Airborne.Locomotion.bIsFalling = true;
+    Airborne.Locomotion.bIsMovingOnGround = false;
+    Airborne.CurrentAnimState = ECharacterAnimState::Jump;
+    Airborne.CurrentBlendSpaceInput = 300.f;
+    Character->RestoreSnapshot(Airborne);
+
+    Pool->Release(Character);
+    TestEqual(TEXT("Released character is pooled"), Pool->GetNumPooled(AAnimCppChar::StaticClass()), 1);
+    TestTrue(TEXT("Released character is hidden"), Character->IsHidden());
+    TestFalse(TEXT("Released character has no collision"), Character->GetActorEnableCollision());
+    TestFalse(TEXT("Released character does not tick"), Character->IsActorTickEnabled());
+    TestFalse(TEXT("Released character's movement is off"), Character->GetCharacterMovement()->IsActive());
+
+    FAnimCppCharSnapshot Parked;
+    Character->SaveSnapshot(Parked);
+    TestTrue(TEXT("Released character has stopped"), Parked.Velocity.IsZero());
+    TestTrue(TEXT("Released character's locomotion is reset"), Parked.Locomotion.Velocity.IsZero() && !Parked.Locomotion.bIsFalling);
+    TestTrue(TEXT("Released character is back in Idle"), Parked.CurrentAnimState == ECharacterAnimState::Idle);
+    TestEqual(TEXT("Released character's blend space input is reset"), Parked.CurrentBlendSpaceInput, 0.f);
+
+    const FTransform SecondTransform(FVector(-500.f, 0.f, 300.f));
+    AActor* Reacquired = Pool->Acquire(AAnimCppChar::StaticClass(), SecondTransform);
+    TestTrue(TEXT("Second acquire reuses the released character"), Reacquired == Character);
+    TestEqual(TEXT("Second acquire spawns nothing"), Pool->GetTimings().NumSpawned, 1);
+    TestEqual(TEXT("Second acquire is a pool hit"), Pool->GetTimings().NumReused, 1);
+    TestEqual(TEXT("Pool is empty again"), Pool->GetNumPooled(AAnimCppChar::StaticClass()), 0);
+    TestFalse(TEXT("Reacquired character is visible"), Character->IsHidden());
+    TestTrue(TEXT("Reacquired character has collision"), Character->GetActorEnableCollision());
+    TestTrue(TEXT("Reacquired character ticks"), Character->IsActorTickEnabled());
+    TestTrue(TEXT("Reacquired character's movement is on"), Character->GetCharacterMovement()->IsActive());
+    TestTrue(TEXT("Reacquired character is at the requested spot"), Character->GetActorLocation().Equals(SecondTransform.GetLocation()));
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,228 @@
+//
+//  AnimDemoAllocTests.cpp
+//
+//  Zero-allocation automation tests for the hot scopes (see AnimDemoAllocTracker.h). They need the
+//  counting allocator, so they only count in a monolithic build started with -AnimDemoAllocTracking;
+//  the character test also needs a running game world:
+//
+//      UE_AnimDemo -game -nullrhi -unattended -AnimDemoAllocTracking -ExecCmds="Automation RunTests AnimDemo.Alloc; Quit"
+//
+//  Without the switch they are skipped with a warning; with it but no allocator they fail.
+//  Stat, CSV and Insights captures buffer their own data, so run them with those off.
+//
+#include "AnimDemoAllocTracker.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && ANIMDEMO_ALLOC_TRACKING
+
+#include "AnimCppChar.h"
+#include "AnimDemoBenchmarkUtils.h"
+#include "AnimationStateMachine.h"
+#include "LocomotionSnapshot.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+
+namespace AnimDemoAllocTests
+{
+    static bool CanCount(FAutomationTestBase& Test)
+    {
+        if (FAnimDemoAllocScope::IsAvailable())
+            return true;
+
+        if (FAnimDemoAllocScope::IsRequested())
+        {
+            Test.AddError(TEXT("-AnimDemoAllocTracking was given but the counting allocator is not installed; run a monolithic build."));
+        }
+        else
+        {
+            Test.AddWarning(TEXT("Skipped: start the process with -AnimDemoAllocTracking to count allocations."));
+        }
+        return false;
+    }
+
+    static void CheckReport(FAutomationTestBase& Test, const TCHAR* Title, const FAnimDemoAllocReport& Report)
+    {
+        Report.Log(Title);
+
+        if (Report.GetTotalAllocs() > 0 || Report.GetTotalObjects() > 0)
+        {
+            Test.AddError(FString::Printf(TEXT("%s: expected zero allocations per frame, got %llu allocations and %llu new UObjects over %d frames."),
+                Title, Report.GetTotalAllocs(), Report.GetTotalObjects(), Report.NumFrames));
+        }
+    }
+
+    static UWorld* FindGameWorld()
+    {
+        for (const FWorldContext& Context : GEngine->GetWorldContexts())
+        {
+            if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.World())
+            {
+                return Context.World();
+            }
+        }
+        return nullptr;
+    }
+
+    enum class EPhase : uint8
+    {
+        Settle,
+        Idle,
+        WalkWarmup,
+        Walk,
+    };
+
+    // Spawns a character, lets it settle, then counts a stretch of idle frames and one of walking frames
+    class FCharacterCommand : public IAutomationLatentCommand
+    {
+    public:
+        FCharacterCommand(FAutomationTestBase& InTest, UWorld* InWorld)
+            : Test(InTest)
+            , World(InWorld)
+        {
+            AnimDemoBenchmark::SpawnCharacters(InWorld, 1, Spawned);
+        }
+
+        virtual bool Update() override
+        {
+            AAnimCppChar* Character = Spawned.Num() > 0 ? Spawned[0].Get() : nullptr;
+            if (!World.IsValid() || !Character)
+            {
+                if (FAnimDemoAllocScope::IsCapturing())
+                {
+                    FAnimDemoAllocScope::StopCapture(0);
+                }
+                Test.AddError(TEXT("The world or the character went away."));
+                return true;
+            }
+
+            ++Frame;
+
+            // Input is consumed by the movement component during the next world tick
+            if (Phase == EPhase::WalkWarmup || Phase == EPhase::Walk)
+            {
+                Character->AddMovementInput(FVector::ForwardVector, 1.f);
+            }
+
+            switch (Phase)
+            {
+            case EPhase::Settle:
+                // Landing, the first state animation and any lazy setup happen here
+                if (Frame >= SettleFrames)
+                {
+                    FAnimDemoAllocScope::StartCapture(true);
+                    Phase = EPhase::Idle;
+                    Frame = 0;
+                }
+                break;
+
+            case EPhase::Idle:
+                if (Frame >= NumFrames)
+                {
+                    CheckReport(Test, TEXT("Idle"), FAnimDemoAllocScope::StopCapture(Frame));
+                    Phase = EPhase::WalkWarmup;
+                    Frame = 0;
+                }
+                break;
+
+            case EPhase::WalkWarmup:
+                if (Frame >= SettleFrames)
+                {
+                    FAnimDemoAllocScope::StartCapture(true);
+                    Phase = EPhase::Walk;
+                    Frame = 0;
+                }
+                break;
+
+            case EPhase::Walk:
+                if (Frame >= NumFrames)
+                {
+                    CheckReport(Test, TEXT("Walk"), FAnimDemoAllocScope::StopCapture(Frame));
+                    AnimDemoBenchmark::DestroyCharacters(Spawned);
+                    return true;
+                }
+                break;
+            }
+            return false;
+        }
+
+    private:
+        static constexpr int32 SettleFrames = 60;
+        static constexpr int32 NumFrames = 120;
+
+        FAutomationTestBase& Test;
+        TWeakObjectPtr<UWorld> World;
+        TArray<TWeakObjectPtr<AAnimCppChar>> Spawned;
+        EPhase Phase = EPhase::Settle;
+        int32 Frame = 0;
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoAllocStateMachineTest, "AnimDemo.Alloc.StateMachineTick",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoAllocStateMachineTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimDemoAllocTests;
+
+    if (!CanCount(*this))
+        return true;
+
+    constexpr float TickSeconds = 1.f / 60.f;
+
+    FLocomotionSnapshot Snapshot;
+    UAnimationStateMachine* Machine = UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), AnimDemoLocomotion::GetDefinition(FLocomotionArchetype()), &Snapshot);
+
+    // Idle, walk, run, jump and land, so every transition is taken at least once
+    auto Drive = [Machine, &Snapshot](int32 Frame)
+    {
+        const int32 Phase = (Frame / 30) % 5;
+        Snapshot = FLocomotionSnapshot();
+        Snapshot.Velocity = FVector(Phase == 1 ? 150.f : Phase == 2 ? 500.f : 0.f, 0.f, Phase == 3 ? 420.f : 0.f);
+        Snapshot.bIsFalling = Phase == 3;
+        Snapshot.bIsMovingOnGround = Phase != 3;
+        Machine->Tick(TickSeconds);
+    };
+
+    // One untracked lap for any lazy setup
+    constexpr int32 NumFrames = 150;
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        Drive(Frame);
+    }
+
+    FAnimDemoAllocScope::StartCapture(true);
+    {
+        ANIMDEMO_ALLOC_SCOPE(StateMachineTick);
+        for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            Drive(Frame);
+        }
+    }
+    CheckReport(*this, TEXT("State machine tick"), FAnimDemoAllocScope::StopCapture(NumFrames));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoAllocCharacterTest, "AnimDemo.Alloc.Character",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoAllocCharacterTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimDemoAllocTests;
+
+    if (!CanCount(*this))
+        return true;
+
+    UWorld* World = FindGameWorld();
+    if (!World)
+    {
+        AddError(TEXT("No game world; run with -game or in PIE."));
+        return false;
+    }
+
+    ADD_LATENT_AUTOMATION_COMMAND(FCharacterCommand(*this, World));
+    return true;
+}
+
+#endif
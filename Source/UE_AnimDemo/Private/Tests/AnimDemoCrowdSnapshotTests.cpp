@@ -0,0 +1,114 @@
+//
+//  AnimDemoCrowdSnapshotTests.cpp
+//
+//  Automation tests for UCrowdSnapshotSubsystem: restoring a capture puts every character and
+//  test actor back into the captured state, so capturing again gives the same records.
+//
+#include "CrowdSnapshotSubsystem.h"
+#include "AnimDemoTestWorld.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AnimDemoCrowdSnapshotTests
+{
+    // A character somewhere mid-run, different for every Seed
+    static FAnimCppCharSnapshot MakeCharacterState(const AAnimCppChar& Character, int32 Seed, bool bInAir)
+    {
+        FAnimCppCharSnapshot State;
+        Character.SaveSnapshot(State);
+        State.Location = FVector(300.f * Seed, -150.f * Seed, 200.f + Seed);
+        State.Rotation = FRotator(0.f, 30.f * Seed, 0.f).Quaternion();
+        State.Velocity = bInAir ? FVector(100.f * Seed, 0.f, 420.f) : FVector(0.f, 50.f * Seed, 0.f);
+        State.MovementMode = bInAir ? MOVE_Falling : MOVE_Walking;
+        State.JumpCurrentCount = bInAir ? 1 : 0;
+        State.Locomotion.Velocity = State.Velocity;
+        State.Locomotion.bIsFalling = bInAir;
+        State.Locomotion.bIsMovingOnGround = !bInAir;
+        State.CurrentAnimState = bInAir ? ECharacterAnimState::Jump : ECharacterAnimState::Locomotion;
+        State.CurrentBlendSpaceInput = 50.f * Seed;
+        return State;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoCrowdSnapshotRoundTripTest, "AnimDemo.CrowdSnapshot.RoundTrip",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoCrowdSnapshotRoundTripTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimDemoCrowdSnapshotTests;
+
+    FAnimDemoTestWorld TestWorld;
+    UWorld& World = TestWorld.Get();
+    UCrowdSnapshotSubsystem* Snapshots = World.GetSubsystem<UCrowdSnapshotSubsystem>();
+    if (!TestNotNull(TEXT("Crowd snapshot subsystem"), Snapshots))
+        return false;
+
+    constexpr int32 NumCharacters = 3;
+    TArray<AAnimCppChar*> Characters;
+    for (int32 Index = 0; Index < NumCharacters; ++Index)
+    {
+        AAnimCppChar* Character = World.SpawnActor<AAnimCppChar>();
+        if (!TestNotNull(TEXT("Spawned character"), Character))
+            return false;
+
+        Character->RestoreSnapshot(MakeCharacterState(*Character, Index + 1, Index % 2 == 1));
+        Characters.Add(Character);
+    }
+    AAnimTestActor* TestActor = World.SpawnActor<AAnimTestActor>(FVector(-400.f, 250.f, 0.f), FRotator(0.f, 75.f, 0.f));
+    if (!TestNotNull(TEXT("Spawned test actor"), TestActor))
+        return false;
+
+    FCrowdSnapshot Captured;
+    Snapshots->Capture(Captured);
+    TestEqual(TEXT("Captured characters"), Captured.GetNumCharacters(), NumCharacters);
+    TestEqual(TEXT("Captured test actors"), Captured.GetNumTestActors(), 1);
+    TestTrue(TEXT("Character records are 16-byte aligned"), IsAligned(Captured.GetCharacterRecords().GetData(), 16));
+    TestTrue(TEXT("Test actor records are 16-byte aligned"), IsAligned(Captured.GetTestActorRecords().GetData(), 16));
+
+    // Move everything on, the way a benchmark iteration would
+    for (int32 Index = 0; Index < NumCharacters; ++Index)
+    {
+        Characters[Index]->RestoreSnapshot(MakeCharacterState(*Characters[Index], Index + 10, Index % 2 == 0));
+    }
+    TestActor->SetActorLocationAndRotation(FVector(900.f, -900.f, 0.f), FRotator(0.f, -120.f, 0.f));
+
+    TestEqual(TEXT("Actors missing on restore"), Snapshots->Restore(Captured), 0);
+
+    FCrowdSnapshot Recaptured;
+    Snapshots->Capture(Recaptured);
+    if (!TestEqual(TEXT("Recaptured characters"), Recaptured.GetNumCharacters(), NumCharacters)
+        || !TestEqual(TEXT("Recaptured test actors"), Recaptured.GetNumTestActors(), 1))
+        return false;
+
+    // Both captures iterate the same actors in the same order
+    for (int32 Index = 0; Index < NumCharacters; ++Index)
+    {
+        const FAnimCppCharSnapshot& Expected = Captured.GetCharacterRecords()[Index].Character;
+        const FAnimCppCharSnapshot& Actual = Recaptured.GetCharacterRecords()[Index].Character;
+        const FString Name = FString::Printf(TEXT("Character %d"), Index);
+
+        TestTrue(Name + TEXT(" location"), Actual.Location.Equals(Expected.Location, 0.01f));
+        TestTrue(Name + TEXT(" rotation"), Actual.Rotation.Equals(Expected.Rotation, 1.e-4f));
+        TestTrue(Name + TEXT(" velocity"), Actual.Velocity.Equals(Expected.Velocity));
+        TestEqual(Name + TEXT(" movement mode"), static_cast<int32>(Actual.MovementMode), static_cast<int32>(Expected.MovementMode));
+        TestEqual(Name + TEXT(" jump count"), Actual.JumpCurrentCount, Expected.JumpCurrentCount);
+        TestTrue(Name + TEXT(" locomotion velocity"), Actual.Locomotion.Velocity.Equals(Expected.Locomotion.Velocity));
+        TestTrue(Name + TEXT(" falling"), Actual.Locomotion.bIsFalling == Expected.Locomotion.bIsFalling);
+        TestTrue(Name + TEXT(" anim state"), Actual.CurrentAnimState == Expected.CurrentAnimState);
+        TestEqual(Name + TEXT(" blend space input"), Actual.CurrentBlendSpaceInput, Expected.CurrentBlendSpaceInput);
+    }
+
+    const FAnimTestActorSnapshot& ExpectedActor = Captured.GetTestActorRecords()[0];
+    const FAnimTestActorSnapshot& ActualActor = Recaptured.GetTestActorRecords()[0];
+    TestTrue(TEXT("Test actor location"), ActualActor.Location.Equals(ExpectedActor.Location, 0.01f));
+    TestTrue(TEXT("Test actor rotation"), ActualActor.Rotation.Equals(ExpectedActor.Rotation, 1.e-4f));
+
+    // Destroyed actors are reported and skipped, the rest still restore
+    Characters[0]->Destroy();
+    TestEqual(TEXT("Actors missing after one was destroyed"), Snapshots->Restore(Captured), 1);
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,177 @@
+//
+//  AnimDemoCrowdSpatialHashTests.cpp
+//
+//  Automation tests for FCrowdSpatialHash: neighbor queries and the separation pass agree with a
+//  brute force scan over every pair, on crowds spanning negative and positive cells.
+//
+#include "CrowdSpatialHash.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AnimDemoCrowdSpatialHashTests
+{
+    static constexpr float Radius = 120.f;
+
+    // Scattered around the origin, plus every tenth agent exactly on a cell corner
+    static void MakeCrowd(int32 NumAgents, float AreaPerAgent, int32 Seed, TArray<float>& OutX, TArray<float>& OutY)
+    {
+        FRandomStream Random(Seed);
+        const float HalfSide = 0.5f * FMath::Sqrt(NumAgents * AreaPerAgent);
+
+        OutX.Reset(NumAgents);
+        OutY.Reset(NumAgents);
+        for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+        {
+            if (Agent % 10 == 0)
+            {
+                OutX.Add(Radius * (Agent / 10 % 8 - 4));
+                OutY.Add(Radius * (Agent / 80 % 8 - 4));
+            }
+            else
+            {
+                OutX.Add(Random.FRandRange(-HalfSide, HalfSide));
+                OutY.Add(Random.FRandRange(-HalfSide, HalfSide));
+            }
+        }
+    }
+
+    static bool IsInRange(float FromX, float FromY, float ToX, float ToY)
+    {
+        const float DeltaX = FromX - ToX;
+        const float DeltaY = FromY - ToY;
+        return DeltaX * DeltaX + DeltaY * DeltaY < Radius * Radius;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoCrowdSpatialHashNeighborTest, "AnimDemo.CrowdSpatialHash.Neighbors",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoCrowdSpatialHashNeighborTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimDemoCrowdSpatialHashTests;
+
+    // Sparse, as dense as the benchmark, and packed tighter than the radius
+    const float AreasPerAgent[] = { 200000.f, 15000.f, 500.f };
+    for (int32 Density = 0; Density < UE_ARRAY_COUNT(AreasPerAgent); ++Density)
+    {
+        TArray<float> X;
+        TArray<float> Y;
+        MakeCrowd(1500, AreasPerAgent[Density], Density + 1, X, Y);
+
+        FCrowdSpatialHash Hash;
+        Hash.Build(X, Y, Radius);
+        if (!TestEqual(TEXT("Hashed agents"), Hash.Num(), X.Num()))
+            return false;
+
+        // Sorted arrays are a permutation of the input
+        TBitArray<> Seen(false, X.Num());
+        int32 NumMisplaced = 0;
+        for (int32 Sorted = 0; Sorted < Hash.Num(); ++Sorted)
+        {
+            const int32 Agent = Hash.GetSortedIndices()[Sorted];
+            if (!X.IsValidIndex(Agent) || Seen[Agent] || Hash.GetSortedX()[Sorted] != X[Agent] || Hash.GetSortedY()[Sorted] != Y[Agent])
+            {
+                ++NumMisplaced;
+                continue;
+            }
+            Seen[Agent] = true;
+        }
+        TestEqual(FString::Printf(TEXT("Agents misplaced in the sorted arrays at density %d"), Density), NumMisplaced, 0);
+
+        int32 NumMissed = 0;
+        int32 NumExtra = 0;
+        int32 NumNeighbors = 0;
+        TArray<int32> Found;
+        for (int32 Agent = 0; Agent < X.Num(); ++Agent)
+        {
+            Found.Reset();
+            Hash.ForEachNeighborRange(X[Agent], Y[Agent], [&](int32 Begin, int32 End)
+            {
+                for (int32 Sorted = Begin; Sorted < End; ++Sorted)
+                {
+                    if (IsInRange(X[Agent], Y[Agent], Hash.GetSortedX()[Sorted], Hash.GetSortedY()[Sorted]))
+                    {
+                        Found.Add(Hash.GetSortedIndices()[Sorted]);
+                    }
+                }
+            });
+
+            int32 NumExpected = 0;
+            for (int32 Other = 0; Other < X.Num(); ++Other)
+            {
+                if (IsInRange(X[Agent], Y[Agent], X[Other], Y[Other]))
+                {
+                    ++NumExpected;
+                    NumMissed += Found.Contains(Other) ? 0 : 1;
+                }
+            }
+            NumExtra += FMath::Max(0, Found.Num() - NumExpected);
+            NumNeighbors += NumExpected;
+        }
+
+        TestTrue(FString::Printf(TEXT("Density %d has neighbors to find"), Density), NumNeighbors > X.Num());
+        TestEqual(FString::Printf(TEXT("Neighbors missed at density %d"), Density), NumMissed, 0);
+        TestEqual(FString::Printf(TEXT("Neighbors reported twice or out of range at density %d"), Density), NumExtra, 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoCrowdSeparationTest, "AnimDemo.CrowdSpatialHash.Separation",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoCrowdSeparationTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimDemoCrowdSpatialHashTests;
+
+    TArray<float> X;
+    TArray<float> Y;
+    MakeCrowd(3000, 15000.f, 7, X, Y);
+
+    FCrowdSpatialHash Hash;
+    Hash.Build(X, Y, Radius);
+
+    TArray<float> PushX;
+    TArray<float> PushY;
+    PushX.SetNumZeroed(X.Num());
+    PushY.SetNumZeroed(X.Num());
+    CrowdSeparation::ComputeSeparation(Hash, Radius, PushX, PushY);
+
+    // The SIMD path uses an estimated reciprocal square root, so compare with a tolerance
+    constexpr double Tolerance = 1.e-2;
+    int32 NumMismatches = 0;
+    for (int32 Agent = 0; Agent < X.Num(); ++Agent)
+    {
+        double ExpectedX = 0.0;
+        double ExpectedY = 0.0;
+        for (int32 Other = 0; Other < X.Num(); ++Other)
+        {
+            const double DeltaX = X[Agent] - X[Other];
+            const double DeltaY = Y[Agent] - Y[Other];
+            const double DistSq = DeltaX * DeltaX + DeltaY * DeltaY;
+            if (DistSq < Radius * Radius && DistSq > 1.e-4)
+            {
+                const double Dist = FMath::Sqrt(DistSq);
+                const double Scale = (1.0 - Dist / Radius) / Dist;
+                ExpectedX += DeltaX * Scale;
+                ExpectedY += DeltaY * Scale;
+            }
+        }
+
+        if (!FMath::IsNearlyEqual(static_cast<double>(PushX[Agent]), ExpectedX, Tolerance) || !FMath::IsNearlyEqual(static_cast<double>(PushY[Agent]), ExpectedY, Tolerance))
+        {
+            if (NumMismatches++ == 0)
+            {
+                AddError(FString::Printf(TEXT("Agent %d pushed (%f, %f), brute force gives (%f, %f)"),
+                    Agent, PushX[Agent], PushY[Agent], ExpectedX, ExpectedY));
+            }
+        }
+    }
+    TestEqual(TEXT("Agents pushed differently from brute force"), NumMismatches, 0);
+
+    return true;
+}
+
+#endif
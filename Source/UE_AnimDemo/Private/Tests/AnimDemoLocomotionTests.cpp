@@ -0,0 +1,145 @@
+//
+//  AnimDemoLocomotionTests.cpp
+//
+//  Automation tests for the locomotion state machine AAnimCppChar runs and the idle hibernation
+//  decision it feeds, on logic-only machines without a world. Run them with "Automation RunTests AnimDemo" or from the Session Frontend.
+//
+#include "AnimationStateMachine.h"
+#include "AnimHibernationSubsystem.h"
+#include "LocomotionSnapshot.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace AnimDemoLocomotionTests
+{
+    constexpr float TickSeconds = 1.f / 60.f;
+
+    static UAnimationStateMachine* NewLocomotionMachine(const FLocomotionSnapshot& Snapshot)
+    {
+        return UAnimationStateMachine::CreateLogicOnly(GetTransientPackage(), AnimDemoLocomotion::GetDefinition(FLocomotionArchetype()), &Snapshot);
+    }
+
+    static void TickFor(UAnimationStateMachine& Machine, float Seconds)
+    {
+        for (float Time = 0.f; Time < Seconds; Time += TickSeconds)
+        {
+            Machine.Tick(TickSeconds);
+        }
+    }
+
+    static FLocomotionSnapshot OnGround(float Speed)
+    {
+        FLocomotionSnapshot Snapshot;
+        Snapshot.Velocity = FVector(Speed, 0.f, 0.f);
+        Snapshot.bIsFalling = false;
+        Snapshot.bIsMovingOnGround = true;
+        return Snapshot;
+    }
+
+    static FLocomotionSnapshot InAir(float VerticalSpeed)
+    {
+        FLocomotionSnapshot Snapshot;
+        Snapshot.Velocity = FVector(0.f, 0.f, VerticalSpeed);
+        Snapshot.bIsFalling = true;
+        Snapshot.bIsMovingOnGround = false;
+        return Snapshot;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoJumpLandTest, "AnimDemo.StateMachine.JumpLand",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoJumpLandTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimDemoLocomotionTests;
+
+    // Conditions read this snapshot, so every phase just overwrites it
+    FLocomotionSnapshot Snapshot = OnGround(0.f);
+    UAnimationStateMachine* Machine = NewLocomotionMachine(Snapshot);
+
+    TickFor(*Machine, 0.5f);
+    TestTrue(TEXT("Standing still is Idle"), Machine->GetCurrentState() == ECharacterAnimState::Idle);
+
+    Snapshot = InAir(420.f);
+    TickFor(*Machine, 0.3f);
+    TestTrue(TEXT("Taking off from Idle enters Jump"), Machine->GetCurrentState() == ECharacterAnimState::Jump);
+
+    Snapshot = InAir(-300.f);
+    TickFor(*Machine, 0.3f);
+    TestTrue(TEXT("Falling stays in Jump"), Machine->GetCurrentState() == ECharacterAnimState::Jump);
+
+    Snapshot = OnGround(0.f);
+    TickFor(*Machine, 0.5f);
+    TestTrue(TEXT("Landing standing returns to Idle"), Machine->GetCurrentState() == ECharacterAnimState::Idle);
+    TestEqual(TEXT("The landing blend has finished"), Machine->GetTransitionAlpha(), 1.f);
+
+    // Take off again while walking and land at running speed
+    Snapshot = OnGround(150.f);
+    TickFor(*Machine, 0.5f);
+    TestTrue(TEXT("Walking is Locomotion"), Machine->GetCurrentState() == ECharacterAnimState::Locomotion);
+
+    Snapshot = InAir(420.f);
+    TickFor(*Machine, 0.3f);
+    TestTrue(TEXT("Taking off from Locomotion enters Jump"), Machine->GetCurrentState() == ECharacterAnimState::Jump);
+
+    Snapshot = OnGround(450.f);
+    TickFor(*Machine, 0.5f);
+    TestTrue(TEXT("Landing while running returns to Locomotion"), Machine->GetCurrentState() == ECharacterAnimState::Locomotion);
+
+    Snapshot = OnGround(0.f);
+    TickFor(*Machine, 0.5f);
+    TestTrue(TEXT("Stopping after the landing returns to Idle"), Machine->GetCurrentState() == ECharacterAnimState::Idle);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoJumpLandHibernateTest, "AnimDemo.Hibernation.JumpLandHibernate",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoJumpLandHibernateTest::RunTest(const FString& Parameters)
+{
+    using namespace AnimDemoLocomotionTests;
+
+    constexpr float IdleSeconds = 1.f;
+
+    FLocomotionSnapshot Snapshot = OnGround(0.f);
+    UAnimationStateMachine* Machine = NewLocomotionMachine(Snapshot);
+
+    // The same per-tick decision AAnimCppChar::UpdateHibernation makes, without input
+    float StableIdleTime = 0.f;
+    auto RunFor = [&](float Seconds)
+    {
+        bool bHibernate = false;
+        for (float Time = 0.f; Time < Seconds && !bHibernate; Time += TickSeconds)
+        {
+            Machine->Tick(TickSeconds);
+            const bool bStableIdle = UAnimHibernationSubsystem::IsSettledIdle(Snapshot, Machine);
+            bHibernate = UAnimHibernationSubsystem::UpdateStableIdleTime(StableIdleTime, bStableIdle, TickSeconds, IdleSeconds);
+        }
+        return bHibernate;
+    };
+
+    TestFalse(TEXT("Standing for less than IdleSeconds does not hibernate"), RunFor(IdleSeconds * 0.5f));
+
+    Snapshot = InAir(420.f);
+    TestFalse(TEXT("Taking off does not hibernate"), RunFor(0.3f));
+    TestEqual(TEXT("Taking off resets the stable idle time"), StableIdleTime, 0.f);
+
+    Snapshot = InAir(-300.f);
+    TestFalse(TEXT("Falling does not hibernate"), RunFor(0.3f));
+
+    Snapshot = OnGround(0.f);
+    RunFor(0.1f);
+    TestEqual(TEXT("The landing blend does not count as stable idle"), StableIdleTime, 0.f);
+    TestTrue(TEXT("Standing after a landing hibernates"), RunFor(IdleSeconds + 1.f));
+    TestTrue(TEXT("The character hibernates in Idle"), Machine->GetCurrentState() == ECharacterAnimState::Idle);
+
+    StableIdleTime = 0.f;
+    TestFalse(TEXT("IdleSeconds of 0 never hibernates"), UAnimHibernationSubsystem::UpdateStableIdleTime(StableIdleTime, true, 10.f, 0.f));
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,40 @@
+//
+//  AnimDemoTestWorld.h
+//
+//  An empty game world for automation tests, with its world subsystems but no map, no game
+//  mode and no BeginPlay. Destroyed when the scope ends.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class FAnimDemoTestWorld
+{
+public:
+    FAnimDemoTestWorld()
+    {
+        World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("AnimDemoTestWorld"));
+        FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+        Context.SetCurrentWorld(World);
+    }
+
+    ~FAnimDemoTestWorld()
+    {
+        GEngine->DestroyWorldContext(World);
+        World->DestroyWorld(false);
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    UE_NONCOPYABLE(FAnimDemoTestWorld);
+
+    UWorld& Get() const { return *World; }
+
+private:
+    UWorld* World = nullptr;
+};
+
+#endif
@@ -0,0 +1,128 @@
+//
+//  AnimDemoTransitionEventTests.cpp
+//
+//  Automation tests for the transition event bus: the landing transition reaches subscribers,
+//  and under contention every pushed event is either delivered or counted as dropped.
+//
+#include "AnimTransitionEventSubsystem.h"
+#include "AnimationStateMachine.h"
+#include "LocomotionSnapshot.h"
+#include "AnimDemoTestWorld.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+#include "Tasks/Task.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoTransitionEventLandingTest, "AnimDemo.TransitionEvents.Landing",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoTransitionEventLandingTest::RunTest(const FString& Parameters)
+{
+    constexpr float TickSeconds = 1.f / 60.f;
+
+    FAnimDemoTestWorld TestWorld;
+    UAnimTransitionEventSubsystem* Events = TestWorld.Get().GetSubsystem<UAnimTransitionEventSubsystem>();
+    if (!TestNotNull(TEXT("Transition event subsystem"), Events))
+        return false;
+
+    int32 NumJumpStarts = 0;
+    int32 NumLandings = 0;
+    ECharacterAnimState LandedIn = ECharacterAnimState::None;
+    Events->Subscribe(ECharacterAnimState::None, ECharacterAnimState::Jump,
+        FOnAnimTransitionEvent::FDelegate::CreateLambda([&NumJumpStarts](const FAnimTransitionEvent&) { ++NumJumpStarts; }));
+    Events->Subscribe(ECharacterAnimState::Jump, ECharacterAnimState::None,
+        FOnAnimTransitionEvent::FDelegate::CreateLambda([&NumLandings, &LandedIn](const FAnimTransitionEvent& Event)
+        {
+            ++NumLandings;
+            LandedIn = Event.To;
+        }));
+
+    // The machine finds the world's queue through its owning actor
+    AActor* Owner = TestWorld.Get().SpawnActor<AActor>();
+    FLocomotionSnapshot Snapshot;
+    UAnimationStateMachine* Machine = UAnimationStateMachine::CreateLogicOnly(Owner, AnimDemoLocomotion::GetDefinition(FLocomotionArchetype()), &Snapshot);
+
+    auto RunFor = [Machine, Events](float Seconds)
+    {
+        for (float Time = 0.f; Time < Seconds; Time += TickSeconds)
+        {
+            Machine->Tick(TickSeconds);
+            Events->Tick(TickSeconds);
+        }
+    };
+
+    RunFor(0.5f);
+
+    Snapshot.Velocity = FVector(0.f, 0.f, 420.f);
+    Snapshot.bIsFalling = true;
+    Snapshot.bIsMovingOnGround = false;
+    RunFor(0.5f);
+    TestEqual(TEXT("Jump starts delivered"), NumJumpStarts, 1);
+    TestEqual(TEXT("Landings delivered while in the air"), NumLandings, 0);
+
+    Snapshot = FLocomotionSnapshot();
+    RunFor(0.5f);
+    TestEqual(TEXT("Landings delivered"), NumLandings, 1);
+    TestTrue(TEXT("Landing standing still enters Idle"), LandedIn == ECharacterAnimState::Idle);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAnimDemoTransitionEventQueueTest, "AnimDemo.TransitionEvents.QueueAccounting",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FAnimDemoTransitionEventQueueTest::RunTest(const FString& Parameters)
+{
+    // Small enough that the producers overrun a frame's buffer between drains
+    constexpr uint32 Capacity = 256;
+    constexpr int32 NumProducers = 8;
+    constexpr int32 EventsPerProducer = 20000;
+
+    FAnimTransitionEventQueue Queue(Capacity);
+    std::atomic<int64> NumPushed{ 0 };
+
+    TArray<UE::Tasks::FTask> Producers;
+    for (int32 Producer = 0; Producer < NumProducers; ++Producer)
+    {
+        Producers.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&Queue, &NumPushed]
+        {
+            FAnimTransitionEvent Event;
+            Event.From = ECharacterAnimState::Idle;
+            Event.To = ECharacterAnimState::Jump;
+            for (int32 Index = 0; Index < EventsPerProducer; ++Index)
+            {
+                Queue.Push(Event);
+                NumPushed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }));
+    }
+
+    int64 NumDelivered = 0;
+    int64 NumDropped = 0;
+    bool bWellFormed = true;
+    auto Drain = [&]
+    {
+        NumDelivered += Queue.Drain([&bWellFormed](const FAnimTransitionEvent& Event)
+        {
+            bWellFormed &= Event.From == ECharacterAnimState::Idle && Event.To == ECharacterAnimState::Jump;
+        });
+        NumDropped += Queue.ConsumeNumDropped();
+    };
+
+    // Drain concurrently with the producers, then once more for what they pushed last
+    while (!UE::Tasks::WaitAll(Producers, FTimespan::FromMilliseconds(0.5)))
+    {
+        Drain();
+    }
+    Drain();
+
+    const int64 Expected = static_cast<int64>(NumProducers) * EventsPerProducer;
+    TestEqual(TEXT("Events pushed"), NumPushed.load(), Expected);
+    TestEqual(TEXT("Delivered plus dropped equals pushed"), NumDelivered + NumDropped, Expected);
+    TestTrue(TEXT("Every delivered event arrived intact"), bWellFormed);
+
+    return true;
+}
+
+#endif
@@ -12,16 +12,39 @@
 #include "InputActionValue.h"          // For FInputActionValue
 #include "InputMappingContext.h"       // For UInputMappingContext
 #include "PlayerSettingsWidget.h"      // For UPlayerSettingsWidget
+#include "PlayerSettingsComponent.h"
 #include "MyAnimInstance.h"
+#include "AnimDemoLiteAnimInstance.h"
+#include "LocomotionSnapshot.h"
+#include "AnimTrace.h"
+#include "AnimDemoPoolable.h"
+#include "PoseSearchSelector.h"
 #include "AnimCppChar.generated.h"
 
+// Runtime state of a character, copied out and back in by crowd snapshots
+struct FAnimCppCharSnapshot
+{
+    FVector Location = FVector::ZeroVector;
+    FQuat Rotation = FQuat::Identity;
+    FRotator ControlRotation = FRotator::ZeroRotator;
+    FVector Velocity = FVector::ZeroVector;
+    FLocomotionSnapshot Locomotion;
+    FAnimStateMachineSnapshot StateMachine;
+    FMyAnimInstanceSnapshot AnimInstance;
+    float CurrentBlendSpaceInput = 0.f;
+    int32 JumpCurrentCount = 0;
+    ECharacterAnimState CurrentAnimState = ECharacterAnimState::Idle;
+    uint8 MovementMode = 0;
+    uint8 CustomMovementMode = 0;
+};
+
 UCLASS()
-class UE_ANIMDEMO_API AAnimCppChar : public ACharacter
+class UE_ANIMDEMO_API AAnimCppChar : public ACharacter, public IAnimDemoPoolable
 {
     GENERATED_BODY()
 
 public:
-    AAnimCppChar();
+    AAnimCppChar(const FObjectInitializer& ObjectInitializer);
     
     FORCEINLINE UAnimationStateMachine* GetAnimStateMachine() const { return AnimStateMachine; }
 
@@ -38,6 +61,8 @@ public:
     
     UFUNCTION()
     void ToggleSettingsMenu();
+    
+    virtual void Jump() override;
       
     // Input Actions
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Input")
@@ -79,6 +104,27 @@ public:
     UFUNCTION(BlueprintCallable, Category="Settings")
     void ShowSettingsWidget();
     
+    virtual void NotifyControllerChanged() override;
+    
+    // IAnimDemoPoolable
+    virtual void OnReleasedToPool() override;
+    virtual void OnAcquiredFromPool() override;
+    
+    // Restoring teleports the character and drops pending input, montages and the pose search history
+    void SaveSnapshot(FAnimCppCharSnapshot& OutSnapshot) const;
+    void RestoreSnapshot(const FAnimCppCharSnapshot& Snapshot);
+    
+    // Idle hibernation: after AnimDemo.Hibernate.IdleSeconds of standing still without input the
+    // character stops ticking until UAnimHibernationSubsystem or an input handler wakes it
+    bool IsHibernating() const { return bHibernating; }
+    bool ShouldWakeFromHibernation() const;
+    void WakeFromHibernation();
+    
+    // Animation LOD, switched by UAnimLODSubsystem. The lite anim instance picks up the state and
+    // montage time of the full one, and the full one the state and sequence time of the lite one.
+    EAnimDemoAnimLOD GetAnimLOD() const { return AnimLOD; }
+    void SetAnimLOD(EAnimDemoAnimLOD NewLOD);
+    
     // Components
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Camera")
     class USpringArmComponent* CameraBoom;
@@ -102,24 +148,38 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Animation Assets")
     UBlendSpace* MovementBlendSpace;
     
+    /** Speed thresholds and blend times of the Idle/Locomotion/Jump transitions, read when the state machine is set up */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Animation")
+    FLocomotionTuning LocomotionTuning;
+    
     /** AnimInstance reference */
     UPROPERTY(Transient)
     UMyAnimInstance* OwningAnimInstance;
     
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
     
     // Widget class to spawn (set in Blueprint)
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="UI")
     TSubclassOf<UPlayerSettingsWidget> SettingsWidgetClass;
 
-    UPROPERTY()
-    UPlayerSettingsWidget* SettingsWidget;
+    /** Look input settings and the settings menu of the local player possessing this character */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Settings")
+    UPlayerSettingsComponent* PlayerSettings;
     
     UPROPERTY()
     UAnimationStateMachine* AnimStateMachine;
     
+    /** Set while the lite LOD runs, OwningAnimInstance is null then */
+    UPROPERTY(Transient)
+    UAnimDemoLiteAnimInstance* LiteAnimInstance;
+    
+    /** Anim class of the full LOD, usually the Anim Blueprint */
+    UPROPERTY(Transient)
+    TSubclassOf<UAnimInstance> FullAnimInstanceClass;
+    
 private:
     /** Current state */
     ECharacterAnimState CurrentAnimState;
@@ -127,9 +187,48 @@ private:
     /** Current blend space input (speed) */
     float CurrentBlendSpaceInput;
     
+    /** Movement data captured once per tick; transition conditions read from it */
+    FLocomotionSnapshot LocomotionSnapshot;
+    
+    /** Velocity history and current match of the pose search, used while AnimDemo.PoseSearch.Enable is set */
+    FPoseSearchTrajectory PoseSearchTrajectory;
+    FPoseSearchSelector PoseSearchSelector;
+    
+    EAnimDemoAnimLOD AnimLOD = EAnimDemoAnimLOD::Full;
+    
+    /** Game-thread state of the full anim instance, kept while the lite one runs */
+    FMyAnimInstanceSnapshot FullAnimInstanceState;
+    
+    /** Seconds the character has stood still in Idle without input, see UpdateHibernation */
+    float StableIdleTime = 0.f;
+    bool bHibernating = false;
+    bool bInputThisFrame = false;
+    
+    /** Mesh tick interval to go back to on waking, the idle loop of a hibernated mesh ticks slower */
+    float AwakeMeshTickInterval = 0.f;
+    
+    /** Session recorder, only present while AnimDemo.Trace.Record is enabled */
+    TUniquePtr<FAnimTraceWriter> TraceWriter;
+    
+    void HandleAnimStateTransition(ECharacterAnimState From, ECharacterAnimState To, float Duration);
+    
     void SetupAnimationStateMachine();
     void UpdateAnimationInputs();
     void UpdateAnimationState(float DelaTime);
+    void UpdatePoseSearch(float DeltaTime);
+    void UpdateLiteAnimation(float StartTime = 0.f);
+    void UpdateHibernation(float DeltaTime);
+    void Hibernate();
+    void LeaveHibernation();
+    static bool CanTickMesh();
+    void SetMeshTickEnabled(bool bEnabled);
+    void NoteInput();
+    
+    // The asset a pose search source was built from
+    UAnimSequence* GetPoseSearchSequence(const FPoseSearchSourceRecord& Source) const;
+    
+    // The sequence the lite anim instance plays for a state
+    UAnimSequence* GetLiteSequence(ECharacterAnimState State, float Speed, bool& bOutLooping) const;
     
     // Helper functions for transition conditions
     bool ShouldWalk() const;
@@ -137,13 +236,7 @@ private:
     bool ShouldJump() const;
     bool ShouldIdle() const;
     
-    float MouseSensitivity = 1.0f;
-    float MouseSmoothing = 5.0f; // higher = smoother, slower response
-    bool bInvertY = false;
-    
     float SmoothedYaw = 0.f;
     float SmoothedPitch = 0.f;
-    
-    bool bIsToggling = false;
 };
 
@@ -0,0 +1,93 @@
+//
+//  AnimDemoActorPoolSubsystem.h
+//
+//  Recycles actors instead of destroying and constructing them. Pools are pre-warmed while
+//  loading, released actors are parked hidden with their state reset, and spawn requests are
+//  served over several frames within a per-frame millisecond budget.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AnimDemoActorPoolSubsystem.generated.h"
+
+DECLARE_DELEGATE_OneParam(FOnPooledActorSpawned, AActor* /*Actor*/);
+
+USTRUCT()
+struct FAnimDemoActorPoolBucket
+{
+    GENERATED_BODY()
+    
+    UPROPERTY()
+    TArray<TObjectPtr<AActor>> Actors;
+};
+
+// Cost of getting actors into the world, fresh spawns and pool hits measured separately
+struct FAnimDemoSpawnTimings
+{
+    int32 NumSpawned = 0;
+    int32 NumReused = 0;
+    double SpawnMs = 0.0;
+    double ReuseMs = 0.0;
+    double MaxSpawnMs = 0.0;
+    double MaxReuseMs = 0.0;
+    
+    // Most time spent serving spawn requests in one frame, the hitch players see
+    double MaxFrameMs = 0.0;
+};
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimDemoActorPoolSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    
+    // Queues Count parked instances of Class, built within the prewarm budget
+    void Prewarm(TSubclassOf<AActor> Class, int32 Count);
+    
+    // Queues a spawn, served from the pool when possible and within the per-frame spawn budget
+    void RequestSpawn(TSubclassOf<AActor> Class, const FTransform& Transform, FOnPooledActorSpawned OnSpawned = FOnPooledActorSpawned());
+    
+    // Gets an actor into the world right away, from the pool when possible
+    AActor* Acquire(TSubclassOf<AActor> Class, const FTransform& Transform);
+    
+    // Parks the actor for reuse; it stays alive, hidden and not ticking
+    void Release(AActor* Actor);
+    
+    int32 GetNumPooled(TSubclassOf<AActor> Class) const;
+    int32 GetNumPendingSpawns() const { return SpawnQueue.Num() - SpawnQueueHead; }
+    bool IsPrewarming() const { return PrewarmQueue.Num() > 0; }
+    
+    const FAnimDemoSpawnTimings& GetTimings() const { return Timings; }
+    void ResetTimings() { Timings = FAnimDemoSpawnTimings(); }
+
+private:
+    UPROPERTY()
+    TMap<TObjectPtr<UClass>, FAnimDemoActorPoolBucket> Pools;
+    
+    struct FPrewarmRequest
+    {
+        TSubclassOf<AActor> Class;
+        int32 Remaining = 0;
+    };
+    TArray<FPrewarmRequest> PrewarmQueue;
+    
+    struct FSpawnRequest
+    {
+        TSubclassOf<AActor> Class;
+        FTransform Transform;
+        FOnPooledActorSpawned OnSpawned;
+    };
+    TArray<FSpawnRequest> SpawnQueue;
+    int32 SpawnQueueHead = 0;
+    
+    FAnimDemoSpawnTimings Timings;
+    
+    AActor* SpawnParked(UClass* Class);
+    void Park(AActor* Actor);
+    void Activate(AActor* Actor, const FTransform& Transform);
+};
@@ -0,0 +1,125 @@
+//
+//  AnimDemoAllocTracker.h
+//
+//  Counts heap allocations and new UObjects made inside the module's hot scopes; every
+//  ANIMDEMO_SCOPE_CYCLE_COUNTER is also an allocation scope. Outside of a capture a scope costs
+//  one branch. The counting allocator is installed during engine startup, before the task graph
+//  starts, and only when the process runs with -AnimDemoAllocTracking; modular (editor) builds
+//  load the module too late, so tracking needs a monolithic build. See AnimDemo.Alloc.Capture and
+//  the AnimDemo.Alloc automation tests.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+
+#ifndef ANIMDEMO_ALLOC_TRACKING
+#define ANIMDEMO_ALLOC_TRACKING !UE_BUILD_SHIPPING
+#endif
+
+#if ANIMDEMO_ALLOC_TRACKING
+
+class UClass;
+
+// Counts are exclusive: an allocation belongs to the innermost scope it was made in
+struct FAnimDemoAllocScopeResult
+{
+    const TCHAR* Name = nullptr;
+    uint64 NumCalls = 0;
+    uint64 NumAllocs = 0;
+    uint64 AllocBytes = 0;
+    uint64 NumObjects = 0;
+};
+
+// One attributed allocation, only recorded when the capture asked for call sites
+struct FAnimDemoAllocSite
+{
+    const TCHAR* Scope = nullptr;
+    FString What;
+    FString Callstack;
+};
+
+struct UE_ANIMDEMO_API FAnimDemoAllocReport
+{
+    TArray<FAnimDemoAllocScopeResult> Scopes;
+    TArray<FAnimDemoAllocSite> Sites;
+    int32 NumFrames = 0;
+
+    uint64 GetTotalAllocs() const;
+    uint64 GetTotalObjects() const;
+
+    void Log(const TCHAR* Title) const;
+};
+
+extern UE_ANIMDEMO_API bool GAnimDemoAllocTrackingActive;
+
+class UE_ANIMDEMO_API FAnimDemoAllocScope
+{
+public:
+    explicit FAnimDemoAllocScope(const TCHAR* InName)
+    {
+        if (UNLIKELY(GAnimDemoAllocTrackingActive))
+        {
+            Enter(InName);
+        }
+    }
+
+    ~FAnimDemoAllocScope()
+    {
+        if (UNLIKELY(Name != nullptr))
+        {
+            Leave();
+        }
+    }
+
+    UE_NONCOPYABLE(FAnimDemoAllocScope);
+
+    // Starts counting on all threads. With bCaptureSites the first allocations of each scope
+    // also record a callstack, which is slow but says exactly where a regression comes from.
+    // Returns false, and counts nothing, when the counting allocator is not installed.
+    static bool StartCapture(bool bCaptureSites);
+
+    // Stops counting and returns everything counted since StartCapture
+    static FAnimDemoAllocReport StopCapture(int32 NumFrames);
+
+    static bool IsCapturing() { return GAnimDemoAllocTrackingActive; }
+
+    // Whether the process was started with -AnimDemoAllocTracking
+    static bool IsRequested();
+
+    // Whether the counting allocator was installed at startup, so captures can run
+    static bool IsAvailable();
+
+private:
+    friend struct FAnimDemoAllocTracker;
+
+    static constexpr int32 MaxSitesPerScope = 2;
+    static constexpr int32 MaxSiteDepth = 20;
+
+    // Raw program counters only; they are symbolicated once the scope is left
+    struct FPendingSite
+    {
+        uint64 Frames[MaxSiteDepth];
+        int32 Depth;
+        SIZE_T Size;
+        const UClass* Class;
+    };
+
+    void Enter(const TCHAR* InName);
+    void Leave();
+
+    const TCHAR* Name = nullptr;
+    FAnimDemoAllocScope* Parent = nullptr;
+    uint64 NumAllocs = 0;
+    uint64 AllocBytes = 0;
+    uint64 NumObjects = 0;
+    int32 NumPendingSites = 0;
+    FPendingSite PendingSites[MaxSitesPerScope];
+};
+
+#define ANIMDEMO_ALLOC_SCOPE(Name) FAnimDemoAllocScope PREPROCESSOR_JOIN(AnimDemoAllocScope_, __LINE__)(TEXT(#Name))
+
+#else
+
+#define ANIMDEMO_ALLOC_SCOPE(Name)
+
+#endif
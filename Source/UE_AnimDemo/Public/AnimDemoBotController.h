@@ -0,0 +1,140 @@
+//
+//  AnimDemoBotController.h
+//
+//  Headless stand-in for a player. The bot builds the possessed AAnimCppChar's Enhanced Input
+//  bindings through SetupPlayerInputComponent and fires them with scripted or seeded-random
+//  values every frame, so Move, Turn, LookUp and Jump run exactly as they do for a local
+//  player, without a local player, player controller or input mapping.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Controller.h"
+#include "InputAction.h"
+#include "Math/RandomStream.h"
+#include "AnimDemoBotController.generated.h"
+
+class UEnhancedInputComponent;
+struct FEnhancedInputActionEventBinding;
+
+UENUM()
+enum class EAnimDemoBotBehavior : uint8
+{
+    Idle,
+    Walk,
+    Run,
+    JumpSpam,
+};
+
+USTRUCT(BlueprintType)
+struct FAnimDemoBotStep
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, Category="Bot")
+    EAnimDemoBotBehavior Behavior = EAnimDemoBotBehavior::Idle;
+
+    UPROPERTY(EditAnywhere, Category="Bot", meta=(ClampMin="0.1"))
+    float Duration = 2.f;
+
+    /** Turn input per second while the step runs; a constant rate walks a loop */
+    UPROPERTY(EditAnywhere, Category="Bot")
+    float TurnRate = 0.f;
+};
+
+// Script position and random state of a bot, copied out and back in by crowd snapshots
+struct FAnimDemoBotSnapshot
+{
+    FAnimDemoBotStep CurrentStep;
+    int32 RandomState = 0;
+    int32 StepIndex = INDEX_NONE;
+    float StepTime = 0.f;
+    float JumpCooldown = 0.f;
+    float LookPhase = 0.f;
+};
+
+// Totals over all bots, read by AnimDemo.Bench.ServerTick
+struct FAnimDemoBotCounters
+{
+    uint64 NumInputEvents = 0;
+    uint64 NumJumpPresses = 0;
+    uint64 DispatchCycles = 0;
+};
+
+UCLASS()
+class UE_ANIMDEMO_API AAnimDemoBotController : public AController
+{
+    GENERATED_BODY()
+
+public:
+    AAnimDemoBotController();
+
+    virtual void Tick(float DeltaTime) override;
+
+    /** Steps run in order and loop; when empty the bot draws random steps from RandomSeed */
+    UPROPERTY(EditAnywhere, Category="Bot")
+    TArray<FAnimDemoBotStep> Script;
+
+    UPROPERTY(EditAnywhere, Category="Bot")
+    int32 RandomSeed = 0;
+
+    /** Move input magnitude of Walk steps, Run steps push the stick all the way */
+    UPROPERTY(EditAnywhere, Category="Bot", meta=(ClampMin="0", ClampMax="1"))
+    float WalkInput = 0.4f;
+
+    /** Seconds between jump presses of JumpSpam steps, 0 holds the button every frame */
+    UPROPERTY(EditAnywhere, Category="Bot", meta=(ClampMin="0"))
+    float JumpInterval = 0.f;
+
+    // Restarts the script, or the random sequence from a new seed
+    void Restart(int32 InRandomSeed);
+
+    void SaveSnapshot(FAnimDemoBotSnapshot& OutSnapshot) const;
+    void RestoreSnapshot(const FAnimDemoBotSnapshot& Snapshot);
+
+    static FAnimDemoBotCounters& GetCounters();
+
+protected:
+    virtual void OnPossess(APawn* InPawn) override;
+    virtual void OnUnPossess() override;
+
+private:
+    // An action instance in the Triggered state carrying a scripted value. Default constructed,
+    // so it duplicates none of the action's triggers or modifiers.
+    struct FBotActionInstance : public FInputActionInstance
+    {
+        void Set(const FInputActionValue& InValue)
+        {
+            Value = InValue;
+            TriggerEvent = ETriggerEvent::Triggered;
+        }
+    };
+
+    struct FBotBinding
+    {
+        const UInputAction* Action = nullptr;
+        const FEnhancedInputActionEventBinding* Binding = nullptr;
+    };
+
+    /** Holds the possessed character's bindings; never registered or pushed on an input stack */
+    UPROPERTY(Transient)
+    TObjectPtr<UEnhancedInputComponent> BotInput;
+
+    // The Triggered bindings of the character's actions, which a held input fires every frame
+    TArray<FBotBinding> Bindings;
+    TWeakObjectPtr<const UInputAction> MoveAction;
+    TWeakObjectPtr<const UInputAction> TurnAction;
+    TWeakObjectPtr<const UInputAction> LookUpAction;
+    TWeakObjectPtr<const UInputAction> JumpAction;
+
+    FBotActionInstance ActionInstance;
+    FRandomStream Random;
+    FAnimDemoBotStep CurrentStep;
+    int32 StepIndex = INDEX_NONE;
+    float StepTime = 0.f;
+    float JumpCooldown = 0.f;
+    float LookPhase = 0.f;
+
+    void NextStep();
+    void Dispatch(const UInputAction* Action, const FInputActionValue& Value);
+};
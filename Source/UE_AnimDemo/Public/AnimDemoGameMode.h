@@ -14,4 +14,11 @@ class UE_ANIMDEMO_API AAnimDemoGameMode : public AGameModeBase
 public:
     // Make sure this exactly matches the cpp constructor
     AAnimDemoGameMode();
+    
+    virtual void BeginPlay() override;
+    
+    // Instances of each class built into the actor pool while the level starts, so waves
+    // spawned later recycle them instead of constructing new actors
+    UPROPERTY(EditDefaultsOnly, Category = "Pooling")
+    TMap<TSubclassOf<AActor>, int32> PrewarmActors;
 };
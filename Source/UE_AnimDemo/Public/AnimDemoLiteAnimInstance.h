@@ -0,0 +1,73 @@
+//
+//  AnimDemoLiteAnimInstance.h
+//
+//  Anim instance distant AAnimCppChar switch to in place of UMyAnimInstance and its
+//  Blueprint graph. It has no graph and no game-thread update: the character hands it one
+//  sequence per state, and its proxy advances the time and samples that sequence straight
+//  into the output pose on the animation worker.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "AnimationState.h"
+#include "AnimDemoLiteAnimInstance.generated.h"
+
+class UAnimSequence;
+
+UENUM()
+enum class EAnimDemoAnimLOD : uint8
+{
+    Full,   // UMyAnimInstance and the Anim Blueprint
+    Lite,   // UAnimDemoLiteAnimInstance
+};
+
+struct FAnimDemoLiteAnimInstanceProxy : public FAnimInstanceProxy
+{
+    FAnimDemoLiteAnimInstanceProxy() = default;
+    explicit FAnimDemoLiteAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+    virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+    virtual void Update(float DeltaSeconds) override;
+    virtual void PostUpdate(UAnimInstance* InAnimInstance) const override;
+    virtual bool Evaluate(FPoseContext& Output) override;
+
+private:
+    UAnimSequence* Sequence = nullptr;
+    float Time = 0.f;
+    bool bLooping = true;
+};
+
+UCLASS(Transient, NotBlueprintable)
+class UE_ANIMDEMO_API UAnimDemoLiteAnimInstance : public UAnimInstance
+{
+    GENERATED_BODY()
+
+public:
+    // Starts Sequence at Time for State; a state that is already playing its sequence keeps going
+    void PlayState(ECharacterAnimState InState, UAnimSequence* InSequence, bool bInLooping, float InTime = 0.f);
+
+    ECharacterAnimState GetState() const { return State; }
+    UAnimSequence* GetSequence() const { return Sequence; }
+
+    // Playback position as of the last update
+    float GetTime() const { return Time; }
+
+protected:
+    virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+    virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
+
+private:
+    friend struct FAnimDemoLiteAnimInstanceProxy;
+
+    UPROPERTY(Transient)
+    TObjectPtr<UAnimSequence> Sequence;
+
+    ECharacterAnimState State = ECharacterAnimState::None;
+    float Time = 0.f;
+    bool bLooping = true;
+
+    // Set by PlayState, makes the next update start the proxy over at Time
+    bool bRestart = false;
+};
@@ -0,0 +1,22 @@
+//
+//  AnimDemoMemory.h
+//
+//  Low-level memory tracker tags for the module. Run with -llm to see them under AnimDemo in
+//  `stat LLM`/`stat LLMFULL` and in memreport; AnimDemo.MemReport prints the same split next
+//  to per-object and per-character sizes.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// Underscores become '/' in the tag name, so these all nest under AnimDemo
+LLM_DECLARE_TAG_API(AnimDemo, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_Characters, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_StateMachine, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_Montages, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_Camera, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_SettingsUI, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_SaveGame, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_Trace, UE_ANIMDEMO_API);
+LLM_DECLARE_TAG_API(AnimDemo_PoseSearch, UE_ANIMDEMO_API);
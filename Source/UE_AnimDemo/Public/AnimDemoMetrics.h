@@ -0,0 +1,130 @@
+//
+//  AnimDemoMetrics.h
+//
+//  Live counters for UAnimDemoMetricsSubsystem's HTTP endpoint. Every ANIMDEMO_SCOPE_CYCLE_COUNTER
+//  is also a metric scope that adds its time to a per-name timer, and the AnimDemoStats helpers
+//  feed the state, transition and montage counters. Until the endpoint is started a scope and a
+//  counter cost one branch each.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationState.h"
+#include <atomic>
+
+// UE_AnimDemo.Build.cs sets it, and links the HTTPServer module only when it is on
+#ifndef ANIMDEMO_METRICS
+#define ANIMDEMO_METRICS !UE_BUILD_SHIPPING
+#endif
+
+struct FAnimDemoMetricTimer;
+
+namespace AnimDemoMetrics
+{
+    constexpr int32 NumStates = static_cast<int32>(ECharacterAnimState::None) + 1;
+}
+
+#if ANIMDEMO_METRICS
+
+extern UE_ANIMDEMO_API bool GAnimDemoMetricsActive;
+
+// Totals since the process started; readers take differences between two samples
+struct UE_ANIMDEMO_API FAnimDemoMetricTimer
+{
+    explicit FAnimDemoMetricTimer(const TCHAR* InName);
+
+    // Every timer a scope has been entered for, most recently created first
+    static const FAnimDemoMetricTimer* GetFirst();
+
+    const TCHAR* const Name;
+    std::atomic<uint64> Cycles{ 0 };
+    std::atomic<uint64> NumCalls{ 0 };
+    const FAnimDemoMetricTimer* Next = nullptr;
+
+    UE_NONCOPYABLE(FAnimDemoMetricTimer);
+};
+
+class FAnimDemoMetricScope
+{
+public:
+    explicit FAnimDemoMetricScope(FAnimDemoMetricTimer& InTimer)
+    {
+        if (UNLIKELY(GAnimDemoMetricsActive))
+        {
+            Timer = &InTimer;
+            StartCycles = FPlatformTime::Cycles64();
+        }
+    }
+
+    ~FAnimDemoMetricScope()
+    {
+        if (UNLIKELY(Timer != nullptr))
+        {
+            Timer->Cycles.fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+            Timer->NumCalls.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    UE_NONCOPYABLE(FAnimDemoMetricScope);
+
+private:
+    FAnimDemoMetricTimer* Timer = nullptr;
+    uint64 StartCycles = 0;
+};
+
+namespace AnimDemoMetrics
+{
+    // Counted by the AnimDemoStats helpers while the endpoint runs, on any thread
+    struct FCounters
+    {
+        // Characters counted in each state; a per-frame count, taken and reset once a frame
+        std::atomic<uint32> CharactersInState[NumStates] = {};
+
+        std::atomic<uint64> TransitionsTaken{ 0 };
+        std::atomic<uint64> MontagesStarted{ 0 };
+    };
+
+    UE_ANIMDEMO_API FCounters& GetCounters();
+
+    inline void CountCharactersInState(ECharacterAnimState State, uint32 NumCharacters = 1)
+    {
+        if (UNLIKELY(GAnimDemoMetricsActive))
+        {
+            GetCounters().CharactersInState[static_cast<int32>(State)].fetch_add(NumCharacters, std::memory_order_relaxed);
+        }
+    }
+
+    inline void CountTransitionTaken()
+    {
+        if (UNLIKELY(GAnimDemoMetricsActive))
+        {
+            GetCounters().TransitionsTaken.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    inline void CountMontageStarted()
+    {
+        if (UNLIKELY(GAnimDemoMetricsActive))
+        {
+            GetCounters().MontagesStarted.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+// The timer is created the first time its scope runs, so only the scopes that ran are reported
+#define ANIMDEMO_METRIC_SCOPE(Name) \
+    static FAnimDemoMetricTimer PREPROCESSOR_JOIN(AnimDemoMetricTimer_, __LINE__)(TEXT(#Name)); \
+    FAnimDemoMetricScope PREPROCESSOR_JOIN(AnimDemoMetricScope_, __LINE__)(PREPROCESSOR_JOIN(AnimDemoMetricTimer_, __LINE__))
+
+#else
+
+namespace AnimDemoMetrics
+{
+    inline void CountCharactersInState(ECharacterAnimState State, uint32 NumCharacters = 1) {}
+    inline void CountTransitionTaken() {}
+    inline void CountMontageStarted() {}
+}
+
+#define ANIMDEMO_METRIC_SCOPE(Name)
+
+#endif
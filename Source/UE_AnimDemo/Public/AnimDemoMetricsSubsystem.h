@@ -0,0 +1,111 @@
+//
+//  AnimDemoMetricsSubsystem.h
+//
+//  Serves live performance counters over HTTP on localhost for soak runs, so a local scraper
+//  can chart them without Insights:
+//
+//      GET /metrics        Prometheus text format
+//      GET /metrics.json   the same numbers as JSON
+//
+//  Off unless AnimDemo.Metrics.Port is set at startup or AnimDemo.Metrics.Start is run. While
+//  off nothing ticks and the metric scopes and counters are one branch each. Stop closes the
+//  HTTP listeners Start opened; listeners another system had already started stay up.
+//  Rates and averages cover the last whole window of AnimDemo.Metrics.WindowSeconds.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Templates/PimplPtr.h"
+#include "AnimDemoMetrics.h"
+#include "AnimDemoMetricsSubsystem.generated.h"
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimDemoMetricsSubsystem : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // Binds the routes on Port and starts sampling; false when the port cannot be bound
+    bool Start(int32 InPort);
+    void Stop();
+
+    bool IsRunning() const { return Endpoint.IsValid(); }
+
+private:
+    // One published window; the endpoint always serves the last complete one
+    struct FStageSample
+    {
+        const TCHAR* Name = nullptr;
+        double MsPerFrame = 0.0;
+        double CallsPerFrame = 0.0;
+    };
+
+    struct FWindow
+    {
+        double Seconds = 0.0;
+        int32 NumFrames = 0;
+        double FrameMs = 0.0;
+        double MaxFrameMs = 0.0;
+        double GameThreadMs = 0.0;
+        double TransitionsPerSecond = 0.0;
+        double MontagesStartedPerSecond = 0.0;
+        int32 NumGCs = 0;
+        double GCMs = 0.0;
+        double MaxGCMs = 0.0;
+        TArray<FStageSample> Stages;
+    };
+
+    bool Tick(float DeltaTime);
+    void Publish(double Now);
+
+    FString FormatPrometheus() const;
+    FString FormatJson() const;
+
+    void OnPreGarbageCollect();
+    void OnPostGarbageCollect();
+
+    // Dynamic montages alive right now, counted when scraped since it walks every UAnimMontage
+    static int32 CountDynamicMontages();
+
+    // Router and bound routes while running; defined in the cpp, so only builds with
+    // ANIMDEMO_METRICS on depend on the HTTPServer module
+    struct FEndpoint;
+    TPimplPtr<FEndpoint> Endpoint;
+    FTSTicker::FDelegateHandle TickHandle;
+    FDelegateHandle PreGCHandle;
+    FDelegateHandle PostGCHandle;
+    int32 Port = 0;
+    bool bStartedListeners = false;
+
+    // Characters per state in the last frame
+    uint32 CharactersInState[AnimDemoMetrics::NumStates] = {};
+
+    // Window being accumulated
+    double WindowStart = 0.0;
+    int32 WindowFrames = 0;
+    double WindowFrameSeconds = 0.0;
+    double WindowMaxFrameSeconds = 0.0;
+    double WindowGameThreadMs = 0.0;
+    int32 WindowGCs = 0;
+    double WindowGCSeconds = 0.0;
+    double WindowMaxGCSeconds = 0.0;
+    double GCStart = 0.0;
+
+    // Counter and timer totals at the start of the window
+    uint64 TransitionsAtStart = 0;
+    uint64 MontagesAtStart = 0;
+    TMap<const FAnimDemoMetricTimer*, TPair<uint64, uint64>> TimersAtStart;
+
+    FWindow Published;
+
+    // Since Start
+    int64 TotalFrames = 0;
+    int64 TotalGCs = 0;
+    double TotalGCSeconds = 0.0;
+    double StartTime = 0.0;
+};
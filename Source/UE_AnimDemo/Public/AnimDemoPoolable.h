@@ -0,0 +1,29 @@
+//
+//  AnimDemoPoolable.h
+//
+//  Implemented by actors that UAnimDemoActorPoolSubsystem recycles instead of destroying.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "AnimDemoPoolable.generated.h"
+
+UINTERFACE(MinimalAPI, meta=(CannotImplementInterfaceInBlueprint))
+class UAnimDemoPoolable : public UInterface
+{
+    GENERATED_BODY()
+};
+
+class UE_ANIMDEMO_API IAnimDemoPoolable
+{
+    GENERATED_BODY()
+
+public:
+    // Drop all per-life state and stop per-frame work. The pool has already hidden the actor
+    // and disabled its collision and tick.
+    virtual void OnReleasedToPool() = 0;
+    
+    // The pool has moved the actor into place and made it visible, collidable and ticking again
+    virtual void OnAcquiredFromPool() = 0;
+};
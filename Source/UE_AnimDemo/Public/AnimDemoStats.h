@@ -0,0 +1,96 @@
+//
+//  AnimDemoStats.h
+//
+//  `stat animdemo` group and the AnimDemo CSV profiler category. Every hot path in the
+//  module is wrapped in ANIMDEMO_SCOPE_CYCLE_COUNTER so it shows up in both, and in the
+//  allocation tracker.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "AnimationState.h"
+#include "AnimDemoAllocTracker.h"
+#include "AnimDemoMetrics.h"
+
+DECLARE_STATS_GROUP(TEXT("AnimDemo"), STATGROUP_AnimDemo, STATCAT_Advanced);
+
+// Timings
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AnimCppChar Tick"), STAT_AnimDemo_CharacterTick, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateAnimationInputs"), STAT_AnimDemo_UpdateAnimationInputs, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("StateMachine Tick"), STAT_AnimDemo_StateMachineTick, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("StateMachine UpdateTransitions"), STAT_AnimDemo_UpdateTransitions, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AnimInstance PlayAnimations"), STAT_AnimDemo_PlayAnimations, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Crowd Gather"), STAT_AnimDemo_CrowdGather, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Crowd Hash Build"), STAT_AnimDemo_CrowdHashBuild, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Crowd Separation"), STAT_AnimDemo_CrowdSeparation, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Crowd Move"), STAT_AnimDemo_CrowdMove, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FootPlacement Issue Traces"), STAT_AnimDemo_FootPlacementIssue, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FootPlacement Solve"), STAT_AnimDemo_FootPlacementSolve, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CameraBoom Update"), STAT_AnimDemo_CameraBoomUpdate, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TransitionEvent Drain"), STAT_AnimDemo_TransitionEventDrain, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PoseSearch Query"), STAT_AnimDemo_PoseSearchQuery, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ActorPool Tick"), STAT_AnimDemo_PoolTick, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bot Input"), STAT_AnimDemo_BotInput, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hibernation Check"), STAT_AnimDemo_HibernationCheck, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AnimLOD Update"), STAT_AnimDemo_AnimLODUpdate, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AnimLOD Swap"), STAT_AnimDemo_AnimLODSwap, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CrowdPose Gather"), STAT_AnimDemo_CrowdPoseGather, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CrowdPose Sample"), STAT_AnimDemo_CrowdPoseSample, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CrowdPose Write Back"), STAT_AnimDemo_CrowdPoseWriteBack, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+
+// Counts
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("State Machines"), STAT_AnimDemo_NumStateMachines, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("State Machine Definitions"), STAT_AnimDemo_NumStateMachineDefinitions, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Crowd Walkers"), STAT_AnimDemo_CrowdWalkers, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pool Pending Spawns"), STAT_AnimDemo_PoolPendingSpawns, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Characters Hibernated"), STAT_AnimDemo_CharactersHibernated, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Characters Full Anim LOD"), STAT_AnimDemo_CharactersFullLOD, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Characters Lite Anim LOD"), STAT_AnimDemo_CharactersLiteLOD, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("CrowdPose Instances"), STAT_AnimDemo_CrowdPoseInstances, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("CrowdPose Clips"), STAT_AnimDemo_CrowdPoseClips, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pool Hits"), STAT_AnimDemo_PoolHits, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pool Misses"), STAT_AnimDemo_PoolMisses, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Transitions Taken"), STAT_AnimDemo_TransitionsTaken, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Transition Events"), STAT_AnimDemo_TransitionEvents, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Transition Events Dropped"), STAT_AnimDemo_TransitionEventsDropped, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("StateMachine Logic Steps"), STAT_AnimDemo_StateMachineSteps, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("StateMachine Ticks Without Step"), STAT_AnimDemo_StateMachineStepsSaved, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bot Input Events"), STAT_AnimDemo_BotInputEvents, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Montages Started"), STAT_AnimDemo_MontagesStarted, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hibernation Wakes"), STAT_AnimDemo_HibernationWakes, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Anim LOD Swaps"), STAT_AnimDemo_AnimLODSwaps, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Foot Traces"), STAT_AnimDemo_FootTraces, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Camera Sync Sweeps"), STAT_AnimDemo_CameraSyncSweeps, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Camera Async Sweeps"), STAT_AnimDemo_CameraAsyncSweeps, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Camera Clip Incidents"), STAT_AnimDemo_CameraClipIncidents, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Characters Idle"), STAT_AnimDemo_CharactersIdle, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Characters Locomotion"), STAT_AnimDemo_CharactersLocomotion, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Characters Jump"), STAT_AnimDemo_CharactersJump, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Characters Other State"), STAT_AnimDemo_CharactersOther, STATGROUP_AnimDemo, UE_ANIMDEMO_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(UE_ANIMDEMO_API, AnimDemo);
+
+// Cycle counter for `stat animdemo` plus a CSV timing stat, an allocation scope and a metric scope of the same name
+#define ANIMDEMO_SCOPE_CYCLE_COUNTER(Name) \
+    SCOPE_CYCLE_COUNTER(STAT_AnimDemo_##Name); \
+    CSV_SCOPED_TIMING_STAT(AnimDemo, Name); \
+    ANIMDEMO_ALLOC_SCOPE(Name); \
+    ANIMDEMO_METRIC_SCOPE(Name)
+
+namespace AnimDemoStats
+{
+    // Per-frame count of characters in each state, for both stats and CSV
+    UE_ANIMDEMO_API void CountCharacterInState(ECharacterAnimState State);
+    
+    UE_ANIMDEMO_API void CountTransitionTaken();
+    
+    // Logic steps a state machine ran in one Tick; a Tick without one is work saved by the fixed step
+    UE_ANIMDEMO_API void CountStateMachineSteps(int32 NumSteps);
+    UE_ANIMDEMO_API void CountMontageStarted();
+    
+    // Hibernated characters don't tick, so they are counted here, as idle too, once per frame
+    UE_ANIMDEMO_API void CountHibernatedCharacters(int32 NumCharacters);
+    UE_ANIMDEMO_API void CountHibernationWake();
+}
@@ -0,0 +1,52 @@
+//
+//  AnimDemoTrace.h
+//
+//  Unreal Insights events for the animation state machine and anim instance. Enable with
+//  -trace=cpu,animdemo (or `trace.enable animdemo`). When the channel is off every macro
+//  below costs one branch on the channel flag.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "AnimationState.h"
+
+#ifndef ANIMDEMO_TRACE_ENABLED
+#define ANIMDEMO_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+#endif
+
+class UAnimSequenceBase;
+
+enum class EAnimDemoTransitionKind : uint8
+{
+    Condition,
+    Forced,
+};
+
+#if ANIMDEMO_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(AnimDemoChannel, UE_ANIMDEMO_API);
+
+struct UE_ANIMDEMO_API FAnimDemoTrace
+{
+    static void OutputTransition(uint32 ActorId, ECharacterAnimState From, ECharacterAnimState To, float Duration, uint64 ConditionCycles, EAnimDemoTransitionKind Kind);
+    static void OutputPlayStateAnimation(uint32 ActorId, ECharacterAnimState State, const UAnimSequenceBase* Animation);
+    static void OutputMontageStarted(uint32 ActorId, ECharacterAnimState State, const UAnimSequenceBase* Animation);
+};
+
+#define ANIMDEMO_TRACE_IS_ENABLED() UE_TRACE_CHANNELEXPR_IS_ENABLED(AnimDemoChannel)
+#define ANIMDEMO_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("AnimDemo::" #Name, AnimDemoChannel)
+#define ANIMDEMO_TRACE_TRANSITION(ActorId, From, To, Duration, ConditionCycles, Kind) FAnimDemoTrace::OutputTransition(ActorId, From, To, Duration, ConditionCycles, Kind)
+#define ANIMDEMO_TRACE_PLAY_STATE_ANIMATION(ActorId, State, Animation) FAnimDemoTrace::OutputPlayStateAnimation(ActorId, State, Animation)
+#define ANIMDEMO_TRACE_MONTAGE_STARTED(ActorId, State, Animation) FAnimDemoTrace::OutputMontageStarted(ActorId, State, Animation)
+
+#else
+
+#define ANIMDEMO_TRACE_IS_ENABLED() false
+#define ANIMDEMO_TRACE_SCOPE(Name)
+#define ANIMDEMO_TRACE_TRANSITION(ActorId, From, To, Duration, ConditionCycles, Kind)
+#define ANIMDEMO_TRACE_PLAY_STATE_ANIMATION(ActorId, State, Animation)
+#define ANIMDEMO_TRACE_MONTAGE_STARTED(ActorId, State, Animation)
+
+#endif
@@ -0,0 +1,54 @@
+//
+//  AnimHibernationSubsystem.h
+//
+//  Keeps the list of AAnimCppChar that have been standing idle long enough to hibernate. A
+//  hibernated character stops ticking, and with it its state machine and anim instance
+//  update; its mesh either keeps the last evaluated pose or plays on its idle loop at a low
+//  rate. Once per frame the subsystem checks the hibernated characters for movement or
+//  pending input and wakes them; input handlers wake their character directly.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AnimHibernationSubsystem.generated.h"
+
+class AAnimCppChar;
+class UAnimationStateMachine;
+struct FLocomotionSnapshot;
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimHibernationSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Seconds of stable idle before a character hibernates, 0 when hibernation is off
+    static float GetIdleSeconds();
+
+    // Rate the mesh of a hibernated character keeps playing its idle loop at, 0 freezes the pose
+    static float GetIdleLoopHz();
+
+    // The input-independent half of a character's stable idle test: standing on the ground
+    // without velocity, with its state machine, if any, settled in Idle past any blend into it
+    static bool IsSettledIdle(const FLocomotionSnapshot& Locomotion, const UAnimationStateMachine* Machine);
+
+    // Counts StableIdleTime up while bStableIdle holds and back to zero otherwise; true once it
+    // reaches IdleSeconds, never when IdleSeconds is 0
+    static bool UpdateStableIdleTime(float& StableIdleTime, bool bStableIdle, float DeltaTime, float IdleSeconds);
+
+    void Register(AAnimCppChar* Character);
+    void Unregister(AAnimCppChar* Character);
+
+    int32 GetNumHibernating() const { return Hibernating.Num(); }
+
+    // Wakes every hibernated character, e.g. before a benchmark compares against an awake crowd
+    void WakeAll();
+
+private:
+    TArray<TWeakObjectPtr<AAnimCppChar>> Hibernating;
+};
@@ -0,0 +1,56 @@
+//
+//  AnimLODSubsystem.h
+//
+//  Picks the animation LOD of every AAnimCppChar from its distance to the closest local
+//  camera. Past AnimDemo.AnimLOD.LiteDistance a character swaps its mesh from UMyAnimInstance
+//  and the Anim Blueprint to UAnimDemoLiteAnimInstance, and back once it comes closer than the
+//  distance minus AnimDemo.AnimLOD.Hysteresis. Swaps re-create the anim instance, so only
+//  AnimDemo.AnimLOD.SwapsPerFrame happen per frame, those back to full fidelity first.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AnimDemoLiteAnimInstance.h"
+#include "AnimLODSubsystem.generated.h"
+
+class AAnimCppChar;
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimLODSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void Register(AAnimCppChar* Character);
+    void Unregister(AAnimCppChar* Character);
+
+    int32 GetNumCharacters(EAnimDemoAnimLOD LOD) const { return NumCharacters[static_cast<int32>(LOD)]; }
+
+    // Characters that want another LOD than they have, left over by the swap budget
+    int32 GetNumPendingSwaps() const { return NumPendingSwaps; }
+
+    // Totals since the subsystem was created, read by AnimDemo.Bench.AnimLOD
+    int64 GetNumSwaps() const { return NumSwaps; }
+    uint64 GetSwapCycles() const { return SwapCycles; }
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    TArray<TWeakObjectPtr<AAnimCppChar>> Characters;
+
+    // Swap candidates of the current frame, kept to reuse the allocations
+    TArray<AAnimCppChar*> ToFull;
+    TArray<AAnimCppChar*> ToLite;
+
+    int32 NumCharacters[2] = {};
+    int32 NumPendingSwaps = 0;
+    int64 NumSwaps = 0;
+    uint64 SwapCycles = 0;
+};
@@ -0,0 +1,41 @@
+//
+//  AnimSimSweepCommandlet.h
+//
+//  Sweeps FLocomotionTuning values across many independent headless simulations in one
+//  process. Every combination of the listed values gets its own simulation and all results
+//  are gathered into one report.
+//
+//      UnrealEditor-Cmd UE_AnimDemo.uproject -run=AnimSimSweep [-IdleSpeed=5,10,20] [-RunSpeed=250,300,350]
+//          [-Blend=0.1,0.25] [-Seeds=<N>] [-Characters=<N>] [-Seconds=<S>] [-TickHz=<Hz>] [-FixedStepHz=<Hz>]
+//          [-Jobs=<N>] [-InProcess] [-Fast] [-Report=<File.csv>]
+//
+//  By default every simulation is its own game world, with a floor and a crowd of the game
+//  mode's characters driven by seeded bots, so CharacterMovement, input and anim instances run
+//  as in game. A UWorld only ticks on its process's game thread, so each world runs in a child
+//  process of its own, -Jobs at a time (half the cores by default), and the parent merges the
+//  children's rows into the report.
+//
+//  -InProcess runs all the worlds in this process instead, one after another each frame; the
+//  children use it for their single world.
+//
+//  -Fast skips the worlds: each simulation is a crowd of logic-only state machines driven by a
+//  kinematic stand-in for the character movement, stepped concurrently, one task each. It shares
+//  nothing mutable with the others, and the stats and trace counters the machines update are
+//  thread-safe. Its characters stay on the ground, so it only measures Idle/Locomotion tuning.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AnimSimSweepCommandlet.generated.h"
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimSimSweepCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAnimSimSweepCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
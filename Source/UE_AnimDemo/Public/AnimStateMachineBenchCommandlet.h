@@ -0,0 +1,30 @@
+//
+//  AnimStateMachineBenchCommandlet.h
+//
+//  Microbenchmarks for logic-only UAnimationStateMachine instances and the FLocomotionSnapshot
+//  predicates AAnimCppChar's transitions are built from. No map or world is loaded.
+//
+//      UnrealEditor-Cmd UE_AnimDemo.uproject -run=AnimStateMachineBench [-States=4,16,64,256]
+//          [-Transitions=1,4,16,64] [-Characters=5000] [-Ops=<N>] [-Filter=<Name>]
+//
+//  Every case logs ns/op, heap allocations and bytes per op and, on Linux, last level cache
+//  misses per op from perf_event_open (n/a when the kernel denies it, see perf_event_paranoid).
+//  Synthetic machines use the raw values of ECharacterAnimState's uint8 range as their states.
+//  The Setup cases set up -Characters locomotion machines and count per character.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AnimStateMachineBenchCommandlet.generated.h"
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimStateMachineBenchCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAnimStateMachineBenchCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -3,10 +3,20 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Animation/AnimSequence.h" // Needed for UAnimSequence
+#include "AnimDemoPoolable.h"
 #include "AnimTestActor.generated.h"
 
+// Runtime state of a test actor, copied out and back in by crowd snapshots
+struct FAnimTestActorSnapshot
+{
+    FVector Location = FVector::ZeroVector;
+    FQuat Rotation = FQuat::Identity;
+    float AnimPosition = 0.f;
+    bool bPlaying = false;
+};
+
 UCLASS()
-class UE_ANIMDEMO_API AAnimTestActor : public AActor
+class UE_ANIMDEMO_API AAnimTestActor : public AActor, public IAnimDemoPoolable
 {
     GENERATED_BODY()
 
@@ -15,9 +25,15 @@ public:
     
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
-    virtual void Tick(float DeltaTime) override;
+    // IAnimDemoPoolable
+    virtual void OnReleasedToPool() override;
+    virtual void OnAcquiredFromPool() override;
+    
+    void SaveSnapshot(FAnimTestActorSnapshot& OutSnapshot) const;
+    void RestoreSnapshot(const FAnimTestActorSnapshot& Snapshot);
     
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     USkeletalMeshComponent* SkeletalMeshComp;
@@ -28,4 +44,28 @@ public:
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     UAnimationAsset* RunAnim;
+    
+    // Forward speed in units/s; UCrowdSeparationSubsystem moves the actor and keeps it out of its neighbors
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement")
+    float WalkSpeed = 100.f;
+    
+    // True while UCrowdPoseSubsystem samples the pose in place of the mesh component's own animation
+    bool IsPoseBatched() const { return bBatchedPose; }
+    
+private:
+    friend class UCrowdPoseSubsystem;
+    
+    // Plays AnimationToPlay or RunAnim on the mesh component's own single node instance
+    void PlayOnMesh();
+    
+    // The sequence UCrowdPoseSubsystem can play in place of the mesh, RunAnim taking precedence as in BeginPlay
+    UAnimSequence* GetBatchedSequence() const;
+    
+    // Hands the animation to UCrowdPoseSubsystem, false when it cannot take it
+    bool StartBatchedPose();
+    void StopBatchedPose();
+    
+    bool bBatchedPose = false;
+    bool bBatchedPosePaused = false;
+    float BatchedPoseTime = 0.f;
 };
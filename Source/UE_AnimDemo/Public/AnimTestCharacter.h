@@ -6,6 +6,7 @@
 #include "InputActionValue.h"          // For FInputActionValue
 #include "InputMappingContext.h"       // For UInputMappingContext
 #include "PlayerSettingsWidget.h"      // For UPlayerSettingsWidget
+#include "PlayerSettingsComponent.h"
 #include "AnimTestCharacter.generated.h"
 
 UCLASS()
@@ -14,27 +15,23 @@ class UE_ANIMDEMO_API AAnimTestCharacter : public ACharacter
     GENERATED_BODY()
 
 public:
-    AAnimTestCharacter();
+    AAnimTestCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     
     // Widget class to spawn (set in Blueprint)
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="UI")
     TSubclassOf<UPlayerSettingsWidget> SettingsWidgetClass;
 
-    UPROPERTY()
-    UPlayerSettingsWidget* SettingsWidget;
+    /** Look input settings and the settings menu of the local player possessing this character */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Settings")
+    UPlayerSettingsComponent* PlayerSettings;
     
 private:
-    float MouseSensitivity = 1.0f;
-    float MouseSmoothing = 5.0f; // higher = smoother, slower response
-    bool bInvertY = false;
-    
     float SmoothedYaw = 0.f;
     float SmoothedPitch = 0.f;
-    
-    bool bIsToggling = false;
 
 public:
     virtual void Tick(float DeltaTime) override;
@@ -102,6 +99,8 @@ public:
     UFUNCTION(BlueprintCallable, Category="Settings")
     void ShowSettingsWidget();
     
+    virtual void NotifyControllerChanged() override;
+    
     // Components
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="Camera")
     class USpringArmComponent* CameraBoom;
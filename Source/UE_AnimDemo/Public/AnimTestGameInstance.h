@@ -8,20 +8,19 @@
 
 #include "CoreMinimal.h"
 #include "Engine/GameInstance.h"
-#include "PlayerSettingsSave.h"
 #include "AnimTestGameInstance.generated.h"
 
+/**
+ * Player settings are owned by UPlayerSettingsSubsystem (one per local player);
+ * these helpers only forward to it.
+ */
 UCLASS()
 class UE_ANIMDEMO_API UAnimTestGameInstance : public UGameInstance
 {
     GENERATED_BODY()
 
 public:
-    UPROPERTY()
-    UPlayerSettingsSave* PlayerSettings;
-
-    virtual void Init() override;
-
+    /** Writes pending settings changes of every local player now instead of after the debounce */
     void SavePlayerSettings();
 
     void ApplySettingsToCharacter(class AAnimCppChar* Character);
@@ -0,0 +1,155 @@
+//
+//  AnimTrace.h
+//
+//  Compact binary traces of a play session: per-frame input values, locomotion snapshot and
+//  anim state transitions. Written in the background while playing, memory-mapped for replay.
+//
+//  File layout: FAnimTraceHeader, then one FAnimTraceFrame per frame, each followed by
+//  NumTransitions FAnimTraceTransition records.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationState.h"
+#include "LocomotionSnapshot.h"
+#include "Tasks/Pipe.h"
+#include <atomic>
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+struct FAnimTraceHeader
+{
+    static constexpr uint32 MagicValue = 0x52544441; // 'ADTR'
+    static constexpr uint32 CurrentVersion = 2;
+    
+    uint32 Magic = MagicValue;
+    uint32 Version = CurrentVersion;
+    uint32 FrameSize = 0;
+    uint32 TransitionSize = 0;
+    
+    // Logic rate of the recorded state machine, 0 when it stepped once per frame
+    float FixedStepHz = 0.f;
+    uint32 Reserved = 0;
+};
+
+enum class EAnimTraceFrameFlags : uint8
+{
+    None            = 0,
+    Falling         = 1 << 0,
+    MovingOnGround  = 1 << 1,
+    JumpPressed     = 1 << 2,
+};
+ENUM_CLASS_FLAGS(EAnimTraceFrameFlags);
+
+struct FAnimTraceFrame
+{
+    float DeltaTime = 0.f;
+    
+    // Enhanced Input values accumulated over the frame
+    float MoveX = 0.f;
+    float MoveY = 0.f;
+    float Turn = 0.f;
+    float LookUp = 0.f;
+    
+    FVector3f Velocity = FVector3f::ZeroVector;
+    
+    EAnimTraceFrameFlags Flags = EAnimTraceFrameFlags::None;
+    ECharacterAnimState State = ECharacterAnimState::Idle;
+    uint8 NumTransitions = 0;
+    uint8 Padding = 0;
+    
+    FLocomotionSnapshot ToSnapshot() const;
+};
+static_assert(sizeof(FAnimTraceFrame) == 36, "FAnimTraceFrame is part of the file format");
+
+struct FAnimTraceTransition
+{
+    float Duration = 0.f;
+    ECharacterAnimState From = ECharacterAnimState::Idle;
+    ECharacterAnimState To = ECharacterAnimState::Idle;
+    uint8 Padding[2] = {};
+};
+static_assert(sizeof(FAnimTraceTransition) == 8, "FAnimTraceTransition is part of the file format");
+
+/**
+ * Streams trace frames to disk. Frames are appended to an in-memory block on the game thread;
+ * full blocks are handed to a background pipe that performs the file writes in order. A failed
+ * write (e.g. a full disk) stops the recording, and Close deletes the incomplete file.
+ */
+class UE_ANIMDEMO_API FAnimTraceWriter
+{
+public:
+    explicit FAnimTraceWriter(const FString& InFilename, float InFixedStepHz = 0.f);
+    ~FAnimTraceWriter();
+    
+    bool IsOpen() const { return bIsOpen; }
+    bool HasWriteError() const { return bWriteFailed; }
+    
+    // Writes the pending frames and closes the file. Returns false, and deletes the file, when
+    // any write failed, so a truncated trace is never replayed. Called by the destructor.
+    bool Close();
+    
+    void AddMoveInput(const FVector2D& Value);
+    void AddTurnInput(float Value);
+    void AddLookUpInput(float Value);
+    void AddJumpInput();
+    void AddTransition(ECharacterAnimState From, ECharacterAnimState To, float Duration);
+    
+    // Seals the current frame and starts a new one
+    void EndFrame(float DeltaTime, const FLocomotionSnapshot& Snapshot, ECharacterAnimState State);
+    
+    static FString MakeDefaultFilename(const FString& Prefix);
+
+private:
+    void FlushBlock();
+    
+    static constexpr int32 BlockSize = 64 * 1024;
+    
+    FString Filename;
+    TSharedPtr<IFileHandle> FileHandle;
+    UE::Tasks::FPipe WritePipe;
+    bool bIsOpen = false;
+    
+    // Latched by the write pipe; later blocks are dropped rather than written after a gap
+    std::atomic<bool> bWriteFailed{ false };
+    
+    TArray<uint8> Block;
+    FAnimTraceFrame CurrentFrame;
+    TArray<FAnimTraceTransition, TInlineAllocator<4>> CurrentTransitions;
+};
+
+/**
+ * Sequential reader over a memory-mapped trace file. Falls back to reading the whole file
+ * when the platform cannot map it.
+ */
+class UE_ANIMDEMO_API FAnimTraceReader
+{
+public:
+    explicit FAnimTraceReader(const FString& InFilename);
+    ~FAnimTraceReader();
+    
+    bool IsValid() const { return Data != nullptr; }
+    
+    // Whether NextFrame stopped at a partial record instead of the end of the file
+    bool IsTruncated() const { return bTruncated; }
+    const FString& GetFilename() const { return Filename; }
+    float GetFixedStepHz() const { return FixedStepHz; }
+    
+    // Returns false at end of file or on a truncated record
+    bool NextFrame(const FAnimTraceFrame*& OutFrame, TArrayView<const FAnimTraceTransition>& OutTransitions);
+    void Rewind();
+
+private:
+    FString Filename;
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    TArray<uint8> FallbackData;
+    
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+    float FixedStepHz = 0.f;
+    int64 Cursor = 0;
+    bool bTruncated = false;
+};
@@ -0,0 +1,26 @@
+//
+//  AnimTraceReplayCommandlet.h
+//
+//  Replays recorded anim traces through logic-only UAnimationStateMachine instances, one per
+//  trace file, in parallel across all cores. No world or rendering is created.
+//
+//      UnrealEditor-Cmd UE_AnimDemo.uproject -run=AnimTraceReplay [-Traces=<Dir>] [-Repeat=<N>] [-FixedStepHz=<Hz>]
+//
+//  Machines step at the rate each trace was recorded with unless -FixedStepHz overrides it.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AnimTraceReplayCommandlet.generated.h"
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimTraceReplayCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAnimTraceReplayCommandlet();
+    
+    virtual int32 Main(const FString& Params) override;
+};
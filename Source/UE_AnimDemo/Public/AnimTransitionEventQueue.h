@@ -0,0 +1,114 @@
+//
+//  AnimTransitionEventQueue.h
+//
+//  Multi-producer, single-consumer queue of anim state transitions. Any thread pushes with one
+//  atomic add and one store: no locks, no retries and no allocations. The game thread drains
+//  once per frame.
+//
+//  Two fixed buffers alternate by frame. The frame number and the count of claimed slots share
+//  one 64-bit atomic, so a push claims a slot in exactly one frame's buffer, and draining
+//  closes that frame with a single exchange. Slots are stamped with their frame once written;
+//  the consumer only waits on a producer caught between claiming and writing its slot.
+//  Events pushed after a buffer is full are counted and dropped, never blocking the producer.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationState.h"
+#include "HAL/PlatformProcess.h"
+#include <atomic>
+
+struct FAnimTransitionEvent
+{
+    // Resolved on the game thread; producers only copy the handle
+    TWeakObjectPtr<AActor> Actor;
+    float Duration = 0.f;
+    ECharacterAnimState From = ECharacterAnimState::Idle;
+    ECharacterAnimState To = ECharacterAnimState::Idle;
+};
+
+class FAnimTransitionEventQueue
+{
+public:
+    explicit FAnimTransitionEventQueue(uint32 InCapacity = 4096)
+        : Capacity(InCapacity)
+    {
+        for (FBuffer& Buffer : Buffers)
+        {
+            Buffer.Events.SetNum(Capacity);
+            Buffer.Stamps = MakeUnique<std::atomic<uint32>[]>(Capacity);
+            for (uint32 Index = 0; Index < Capacity; ++Index)
+            {
+                Buffer.Stamps[Index].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    FAnimTransitionEventQueue(const FAnimTransitionEventQueue&) = delete;
+    FAnimTransitionEventQueue& operator=(const FAnimTransitionEventQueue&) = delete;
+
+    // Wait-free, callable from any thread. Returns false if this frame's buffer is full.
+    bool Push(const FAnimTransitionEvent& Event)
+    {
+        const uint64 Claim = State.fetch_add(1, std::memory_order_acquire);
+        const uint32 Frame = static_cast<uint32>(Claim >> 32);
+        const uint32 Index = static_cast<uint32>(Claim);
+        if (Index >= Capacity)
+        {
+            NumDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        FBuffer& Buffer = Buffers[Frame & 1];
+        Buffer.Events[Index] = Event;
+        Buffer.Stamps[Index].store(MakeStamp(Frame), std::memory_order_release);
+        return true;
+    }
+
+    // Single consumer. Closes the current frame and calls Func for each of its events in claim order.
+    template<typename FuncType>
+    int32 Drain(FuncType&& Func)
+    {
+        const uint64 Closed = State.exchange(static_cast<uint64>(ConsumerFrame + 1) << 32, std::memory_order_acq_rel);
+        const uint32 Frame = ConsumerFrame++;
+        const uint32 NumEvents = FMath::Min(static_cast<uint32>(Closed), Capacity);
+
+        FBuffer& Buffer = Buffers[Frame & 1];
+        const uint32 Stamp = MakeStamp(Frame);
+        for (uint32 Index = 0; Index < NumEvents; ++Index)
+        {
+            // A producer that claimed the slot may not have written it yet
+            while (Buffer.Stamps[Index].load(std::memory_order_acquire) != Stamp)
+            {
+                FPlatformProcess::YieldThread();
+            }
+            Func(Buffer.Events[Index]);
+        }
+        return static_cast<int32>(NumEvents);
+    }
+
+    uint32 GetCapacity() const { return Capacity; }
+
+    // Events dropped because a frame's buffer was full, since the last call
+    uint32 ConsumeNumDropped() { return NumDropped.exchange(0, std::memory_order_relaxed); }
+
+private:
+    struct FBuffer
+    {
+        TArray<FAnimTransitionEvent> Events;
+        TUniquePtr<std::atomic<uint32>[]> Stamps;
+    };
+
+    // Never 0, so a fresh slot is never mistaken for a written one
+    static uint32 MakeStamp(uint32 Frame) { return Frame + 1; }
+
+    const uint32 Capacity;
+    FBuffer Buffers[2];
+
+    // Frame in the high half, slots claimed in that frame in the low half
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> State{ 0 };
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> NumDropped{ 0 };
+
+    // Consumer only
+    uint32 ConsumerFrame = 0;
+};
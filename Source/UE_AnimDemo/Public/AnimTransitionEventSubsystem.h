@@ -0,0 +1,42 @@
+//
+//  AnimTransitionEventSubsystem.h
+//
+//  Publishes the anim state transitions of every state machine in the world to game-thread
+//  subscribers. State machines push into a wait-free queue from whichever thread steps them;
+//  the subsystem drains it once per frame and calls the subscribers of each (From, To) pair.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AnimTransitionEventQueue.h"
+#include "AnimTransitionEventSubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAnimTransitionEvent, const FAnimTransitionEvent& /*Event*/);
+
+UCLASS()
+class UE_ANIMDEMO_API UAnimTransitionEventSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Shared with the producers so a state machine outliving the world never pushes into freed memory
+    const TSharedPtr<FAnimTransitionEventQueue>& GetQueue() const { return Queue; }
+
+    // From or To may be ECharacterAnimState::None to match any state. Called on the game thread.
+    FDelegateHandle Subscribe(ECharacterAnimState From, ECharacterAnimState To, FOnAnimTransitionEvent::FDelegate&& Delegate);
+    void Unsubscribe(ECharacterAnimState From, ECharacterAnimState To, FDelegateHandle Handle);
+
+private:
+    static constexpr int32 NumStates = static_cast<int32>(ECharacterAnimState::None) + 1;
+
+    TSharedPtr<FAnimTransitionEventQueue> Queue;
+    FOnAnimTransitionEvent Subscribers[NumStates][NumStates];
+
+    void Dispatch(const FAnimTransitionEvent& Event);
+};
@@ -9,8 +9,16 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "AnimationState.h"
+#include "AnimTransitionEventQueue.h"
+#include "UObject/GCObject.h"
 #include "AnimationStateMachine.generated.h"
 
+struct FLocomotionSnapshot;
+
+// Evaluated against the context snapshot of whichever machine is being stepped, so one
+// condition serves every character sharing the definition it belongs to
+using FAnimStateCondition = TFunction<bool(const FLocomotionSnapshot&)>;
+
 USTRUCT()
 struct FAnimationStateData
 {
@@ -44,7 +52,7 @@ struct FStateTransition
     
     ECharacterAnimState FromState;
     ECharacterAnimState ToState;
-    TFunction<bool()> Condition;
+    FAnimStateCondition Condition;
     float TransitionDuration;
     
     FStateTransition()
@@ -60,6 +68,73 @@ struct FStateTransition
     {}
 };
 
+// The immutable half of a state machine: state animations and transitions, built once per
+// character archetype and shared through TSharedRef<const FAnimStateMachineDefinition> by every
+// machine of that archetype. Holds the animation assets alive for as long as it is shared.
+class UE_ANIMDEMO_API FAnimStateMachineDefinition : public FGCObject
+{
+public:
+    FAnimStateMachineDefinition();
+    FAnimStateMachineDefinition(const FAnimStateMachineDefinition& Other);
+    virtual ~FAnimStateMachineDefinition() override;
+    
+    FAnimStateMachineDefinition& operator=(const FAnimStateMachineDefinition&) = delete;
+    
+    // Building; only valid before the definition is shared
+    void RegisterStateAnimation(ECharacterAnimState State, UAnimSequence* Animation, bool bLooping = true, float PlayRate = 1.0f);
+    void RegisterStateBlendSpace(ECharacterAnimState State, UBlendSpace* BlendSpace, bool bLooping = true, float PlayRate = 1.0f);
+    
+    // Transitions out of a state are tried in the order they were added
+    void AddTransition(ECharacterAnimState FromState, ECharacterAnimState ToState, FAnimStateCondition Condition, float Duration = 0.25f);
+    
+    const FAnimationStateData* FindStateData(ECharacterAnimState State) const { return StateAnimations.Find(State); }
+    
+    // The first transition out of State whose condition holds for Context, or null
+    const FStateTransition* FindTransition(ECharacterAnimState State, const FLocomotionSnapshot& Context) const;
+    
+    int32 GetNumTransitions() const { return Transitions.Num(); }
+    
+    // Heap owned by the definition, not counting what the conditions' functors allocated
+    SIZE_T GetAllocatedSize() const;
+    
+    // FGCObject
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+    virtual FString GetReferencerName() const override { return TEXT("FAnimStateMachineDefinition"); }
+
+private:
+    TMap<ECharacterAnimState, FAnimationStateData> StateAnimations;
+    
+    // Sorted by FromState, in the order added within a state, so a lookup only visits the
+    // transitions of the current state
+    TArray<FStateTransition> Transitions;
+};
+
+// The per-character half of a state machine, everything a machine needs besides its shared
+// definition. Crowd snapshots copy it out and back in whole.
+struct FAnimStateMachineRuntime
+{
+    float StateTime = 0.0f;
+    float TransitionTime = 0.0f;
+    float CurrentTransitionDuration = 0.0f;
+    float StepAccumulator = 0.0f;
+    ECharacterAnimState CurrentState = ECharacterAnimState::Idle;
+    ECharacterAnimState PreviousState = ECharacterAnimState::Idle;
+    bool bIsTransitioning = false;
+    
+    // Advances the clocks by StepSeconds and ends a finished transition; true when the machine
+    // is free to look for its next one
+    bool Advance(float StepSeconds);
+    
+    void Enter(ECharacterAnimState NewState, float Duration);
+    void Reset(ECharacterAnimState InitialState);
+};
+
+// Snapshots are the runtime record itself
+using FAnimStateMachineSnapshot = FAnimStateMachineRuntime;
+
+// Fired whenever the machine enters a new state: (From, To, TransitionDuration)
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnAnimStateTransition, ECharacterAnimState, ECharacterAnimState, float);
+
 UCLASS()
 class UE_ANIMDEMO_API UAnimationStateMachine : public UObject
 {
@@ -68,19 +143,52 @@ class UE_ANIMDEMO_API UAnimationStateMachine : public UObject
 public:
     UAnimationStateMachine();
     
+    virtual void BeginDestroy() override;
+    virtual void GetResourceSizeEx(FResourceSizeEx& CumulativeResourceSize) override;
+    
     // Initialize the state machine
     void Initialize(USkeletalMeshComponent* InMeshComponent);
     
+    // Logic-only machines (dedicated servers, offline tools) run transitions without a mesh
+    // and never touch the anim instance
+    void SetLogicOnly(bool bInLogicOnly) { bLogicOnly = bInLogicOnly; }
+    bool IsLogicOnly() const { return bLogicOnly; }
+    
+    // Initialized logic-only machine running InDefinition against InContext, as tools and tests use them
+    static UAnimationStateMachine* CreateLogicOnly(UObject* Outer, const TSharedRef<const FAnimStateMachineDefinition>& InDefinition, const FLocomotionSnapshot* InContext);
+    
     // Update the state machine each frame
     void Tick(float DeltaTime);
     
+    // Run the transition logic on a fixed step of 1/Hz seconds instead of once per Tick, which
+    // makes transition decisions independent of the frame rate; 0 steps once per Tick
+    void SetFixedStepRate(float Hz);
+    float GetFixedStepRate() const { return FixedStepSeconds > 0.f ? 1.f / FixedStepSeconds : 0.f; }
+    
+    // Presentation values, interpolated between fixed steps
+    float GetStateTime() const { return Runtime.StateTime + Runtime.StepAccumulator; }
+    float GetTransitionAlpha() const;
+    
     // Manually force a state change
     void ForceState(ECharacterAnimState NewState);
     
+    // Drop all runtime state and start over in InitialState, without notifying or playing anything
+    void Reset(ECharacterAnimState InitialState = ECharacterAnimState::Idle);
+    
+    // Copy the runtime state out or back in; restoring notifies and plays nothing, like Reset
+    void SaveSnapshot(FAnimStateMachineSnapshot& OutSnapshot) const;
+    void RestoreSnapshot(const FAnimStateMachineSnapshot& Snapshot);
+    
     // Get current state
-    ECharacterAnimState GetCurrentState() const { return CurrentState; }
+    ECharacterAnimState GetCurrentState() const { return Runtime.CurrentState; }
+    
+    // Share a definition built once for the character's archetype; its conditions are evaluated
+    // against Context, which must outlive the machine
+    void SetDefinition(const TSharedRef<const FAnimStateMachineDefinition>& InDefinition, const FLocomotionSnapshot* InContext);
+    const FAnimStateMachineDefinition* GetDefinition() const { return Definition.Get(); }
     
-    // Register animations for states
+    // Register animations for states. These and AddTransition give the machine a definition of
+    // its own, copied from the shared one if it had one; prefer SetDefinition for characters.
     void RegisterStateAnimation(ECharacterAnimState State, UAnimSequence* Animation, bool bLooping = true, float PlayRate = 1.0f);
     void RegisterStateBlendSpace(ECharacterAnimState State, UBlendSpace* BlendSpace, bool bLooping = true, float PlayRate = 1.0f);
     
@@ -89,30 +197,42 @@ public:
     
     // Set input parameters for blend spaces
     void SetBlendSpaceInput(float Value) { BlendSpaceInputValue = Value; }
+    
+    // Transition notifications (recording, debugging, gameplay reactions)
+    FOnAnimStateTransition& OnTransition() { return TransitionEvent; }
 
 private:
     UPROPERTY()
     USkeletalMeshComponent* MeshComponent;
     
-    UPROPERTY()
-    TMap<ECharacterAnimState, FAnimationStateData> StateAnimations;
-    
-    TArray<FStateTransition> Transitions;
+    // Shared with every machine of the archetype unless bOwnsDefinition
+    TSharedPtr<const FAnimStateMachineDefinition> Definition;
+    const FLocomotionSnapshot* Context;
     
-    ECharacterAnimState CurrentState;
-    ECharacterAnimState PreviousState;
+    FAnimStateMachineRuntime Runtime;
+    bool bOwnsDefinition;
+    bool bLogicOnly;
     
-    float StateTime;
-    float TransitionTime;
-    float CurrentTransitionDuration;
-    bool bIsTransitioning;
+    // Fixed-step mode; Runtime.StepAccumulator holds the time not yet consumed by a step
+    float FixedStepSeconds;
+    static constexpr int32 MaxStepsPerTick = 4;
+    bool bInitialized;
+    uint32 TraceActorId;
     
     float BlendSpaceInputValue;
     
+    FOnAnimStateTransition TransitionEvent;
+    
+    // World event bus the transitions are published to, from whichever thread steps the machine
+    TSharedPtr<FAnimTransitionEventQueue> EventQueue;
+    TWeakObjectPtr<AActor> EventActor;
+    
     // Internal methods
+    FAnimStateMachineDefinition& GetOwnDefinition();
+    void StepLogic(float StepSeconds);
     void UpdateTransitions();
     void PlayStateAnimation(ECharacterAnimState State);
-    void StartTransition(ECharacterAnimState NewState, float Duration);
+    void StartTransition(ECharacterAnimState NewState, float Duration, uint64 ConditionCycles = 0, bool bForced = false);
     bool CanTransitionTo(ECharacterAnimState NewState) const;
 };
 
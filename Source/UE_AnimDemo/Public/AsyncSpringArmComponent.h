@@ -0,0 +1,71 @@
+//
+//  AsyncSpringArmComponent.h
+//
+//  Spring arm whose collision probe is an async sweep. Each frame uses the previous frame's
+//  result, smoothed and extrapolated, and queues the next probe; only camera cuts and the first
+//  frame fall back to a synchronous sweep. AnimDemo.Camera.AsyncProbe 0 restores the stock
+//  behavior for comparison.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "WorldCollision.h"
+#include "AsyncSpringArmComponent.generated.h"
+
+// Totals over all arms, read by AnimDemo.Bench.CameraBoom
+struct FAsyncSpringArmCounters
+{
+    uint64 NumUpdates = 0;
+    uint64 UpdateCycles = 0;
+    uint64 NumSyncSweeps = 0;
+    uint64 NumAsyncSweeps = 0;
+    uint64 NumClipIncidents = 0;
+};
+
+UCLASS(ClassGroup=Camera, meta=(BlueprintSpawnableComponent))
+class UE_ANIMDEMO_API UAsyncSpringArmComponent : public USpringArmComponent
+{
+    GENERATED_BODY()
+
+public:
+    /** The desired camera location moving further than this in one frame is a cut and gets a synchronous sweep */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraCollision)
+    float CameraCutDistance = 150.f;
+
+    /** The arm turning further than this in one frame is a cut and gets a synchronous sweep */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraCollision)
+    float CameraCutAngle = 45.f;
+
+    /** How fast the arm extends again once an obstruction clears; it always shortens immediately */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraCollision)
+    float ProbeRecoverySpeed = 8.f;
+
+    static FAsyncSpringArmCounters& GetCounters();
+
+    // Initializer for a character constructor that leaves its optional camera rig subobjects out of
+    // instances on a dedicated server. Class default objects and archetypes keep them on every
+    // target, so Blueprints and cooked data see the same defaults on server and client.
+    static const FObjectInitializer& SkipRigOnDedicatedServer(const FObjectInitializer& ObjectInitializer, FName BoomName, FName CameraName);
+
+protected:
+    virtual void UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime) override;
+
+private:
+    FTraceDelegate ProbeDelegate;
+    FTraceHandle PendingProbe;
+
+    /** Free fraction of the arm from the latest probe, and from the one before it */
+    float ProbeFraction = 1.f;
+    float PreviousProbeFraction = 1.f;
+    float SmoothedFraction = 1.f;
+    bool bHasProbeResult = false;
+
+    FVector LastDesiredLocation = FVector::ZeroVector;
+    FRotator LastDesiredRotation = FRotator::ZeroRotator;
+
+    void UpdateArmWithAsyncProbe(bool bDoLocationLag, bool bDoRotationLag, float DeltaTime);
+    void HandleProbeDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+    float SweepSync(const FVector& Origin, const FVector& Desired) const;
+    void CountClipping();
+};
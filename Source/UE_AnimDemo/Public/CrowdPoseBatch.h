@@ -0,0 +1,74 @@
+//
+//  CrowdPoseBatch.h
+//
+//  Batched pose sampling for crowds playing the same looping sequence. A FCrowdPoseClip bakes
+//  the sequence once into local bone transforms at a fixed rate, so sampling an instance is a
+//  blend of two keys and a walk down the hierarchy, with no compression codec or graph. Items
+//  sorted by clip and time are sampled in chunks small enough to keep their output in cache;
+//  workers claim the next chunk from a shared cursor until none are left, so a worker that
+//  finishes early takes over the chunks the others have not reached.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAnimSequence;
+class USkeletalMesh;
+
+class UE_ANIMDEMO_API FCrowdPoseClip
+{
+public:
+    // Samples Sequence on Mesh's reference skeleton at about InSampleHz; false when it has no keys to bake
+    bool Bake(const UAnimSequence& Sequence, USkeletalMesh& Mesh, float InSampleHz);
+
+    // Sizes an empty clip for the given hierarchy, for callers that fill in the keys themselves
+    void Init(TArray<int32> InParentIndices, int32 InNumKeys, float InSampleHz);
+
+    // Local bone transforms of one key, GetNumBones() of them
+    TArrayView<FTransform3f> GetKey(int32 Key) { return MakeArrayView(Keys.GetData() + Key * NumBones, NumBones); }
+
+    // Writes the component-space pose at Time, wrapped into the clip, to OutComponentSpace.
+    // Scratch holds the float pose of the bones, it is sized here and can be reused across calls.
+    void SamplePose(float Time, TArray<FTransform3f>& Scratch, FTransform* OutComponentSpace) const;
+
+    int32 GetNumBones() const { return NumBones; }
+    int32 GetNumKeys() const { return NumKeys; }
+    float GetLength() const { return Length; }
+    SIZE_T GetSizeBytes() const { return Keys.GetAllocatedSize() + ParentIndices.GetAllocatedSize(); }
+
+private:
+    // Parents come before their children, as in FReferenceSkeleton
+    TArray<int32> ParentIndices;
+
+    // NumKeys runs of NumBones local transforms; the last key is the first one again, so the
+    // loop blends back without a wrap test
+    TArray<FTransform3f> Keys;
+
+    int32 NumBones = 0;
+    int32 NumKeys = 0;
+    float SampleHz = 30.f;
+    float Length = 0.f;
+};
+
+// One instance to sample, Dest points at its GetNumBones() component-space transforms
+struct FCrowdPoseItem
+{
+    const FCrowdPoseClip* Clip = nullptr;
+    float Time = 0.f;
+    FTransform* Dest = nullptr;
+};
+
+namespace CrowdPoseBatch
+{
+    // Calling thread plus the task graph's workers
+    UE_ANIMDEMO_API int32 GetMaxWorkers();
+
+    // Items per chunk so a chunk's output is about ChunkBytes
+    UE_ANIMDEMO_API int32 GetChunkSize(int32 NumBones, int32 ChunkBytes);
+
+    // Groups the items by clip and orders them by time, so neighbors in a chunk read the same keys
+    UE_ANIMDEMO_API void SortItems(TArray<FCrowdPoseItem>& Items);
+
+    // Samples every item on at most NumWorkers threads, the calling one included. Returns once all are written.
+    UE_ANIMDEMO_API void Sample(TConstArrayView<FCrowdPoseItem> Items, int32 ChunkSize, int32 NumWorkers);
+}
@@ -0,0 +1,60 @@
+//
+//  CrowdPoseSubsystem.h
+//
+//  Animates AAnimTestActor crowds in one batch per frame instead of one evaluation task per
+//  skeletal mesh component. Every actor playing the same sequence on the same mesh shares a
+//  baked FCrowdPoseClip; the subsystem advances their times, samples all poses with
+//  CrowdPoseBatch::Sample and writes them straight into each component's component-space
+//  transforms. The components themselves neither tick nor update their skeleton.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "CrowdPoseBatch.h"
+#include "CrowdPoseSubsystem.generated.h"
+
+class AAnimTestActor;
+class UAnimSequence;
+class USkeletalMesh;
+
+UCLASS()
+class UE_ANIMDEMO_API UCrowdPoseSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // AnimDemo.CrowdPose.Batched, read by AAnimTestActor when it starts playing
+    static bool IsBatchingEnabled();
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // False when the sequence cannot be baked for the actor's mesh, the actor then animates on its own
+    bool Register(AAnimTestActor* Actor, UAnimSequence* Sequence);
+    void Unregister(AAnimTestActor* Actor);
+
+    int32 GetNumInstances() const { return Instances.Num(); }
+    int32 GetNumClips() const { return Clips.Num(); }
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    struct FInstance
+    {
+        TWeakObjectPtr<AAnimTestActor> Actor;
+        const FCrowdPoseClip* Clip = nullptr;
+    };
+
+    const FCrowdPoseClip* FindOrBakeClip(UAnimSequence* Sequence, USkeletalMesh* Mesh);
+
+    TArray<FInstance> Instances;
+    TMap<TPair<TObjectKey<UAnimSequence>, TObjectKey<USkeletalMesh>>, TUniquePtr<FCrowdPoseClip>> Clips;
+
+    // Rebuilt every frame, kept to reuse the allocation
+    TArray<FCrowdPoseItem> Items;
+};
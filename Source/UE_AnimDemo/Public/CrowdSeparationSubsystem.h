@@ -0,0 +1,41 @@
+//
+//  CrowdSeparationSubsystem.h
+//
+//  Walks every registered AAnimTestActor forward and keeps the crowd from interpenetrating.
+//  Positions are packed into flat arrays each frame, a FCrowdSpatialHash is built over them and
+//  a batched separation pass pushes overlapping walkers apart, without any physics queries.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CrowdSpatialHash.h"
+#include "CrowdSeparationSubsystem.generated.h"
+
+class AAnimTestActor;
+
+UCLASS()
+class UE_ANIMDEMO_API UCrowdSeparationSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void Register(AAnimTestActor* Walker);
+    void Unregister(AAnimTestActor* Walker);
+
+    int32 GetNumWalkers() const { return Walkers.Num(); }
+
+private:
+    TArray<TWeakObjectPtr<AAnimTestActor>> Walkers;
+
+    // Packed per-walker data, rebuilt every frame and kept to reuse the allocations
+    TArray<float> PosX;
+    TArray<float> PosY;
+    TArray<float> PushX;
+    TArray<float> PushY;
+    FCrowdSpatialHash SpatialHash;
+};
@@ -0,0 +1,83 @@
+//
+//  CrowdSnapshotSubsystem.h
+//
+//  Captures the runtime state of every AAnimCppChar, its bot and AAnimTestActor in the world
+//  into one flat buffer of fixed-size records, and copies it back onto the same actors in
+//  place. Benchmarks restore a scenario this way instead of reloading the map.
+//
+//  Buffer layout, each section 16-byte aligned: FCrowdSnapshotHeader, the character records
+//  and the test actor records. The records are plain data, read and written in place. Actors
+//  spawned after the capture are left alone, and pool membership is not part of the snapshot.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AnimCppChar.h"
+#include "AnimTestActor.h"
+#include "AnimDemoBotController.h"
+#include "CrowdSnapshotSubsystem.generated.h"
+
+struct FCrowdSnapshotHeader
+{
+    uint32 NumCharacters = 0;
+    uint32 NumTestActors = 0;
+    uint64 CharactersOffset = 0;
+    uint64 TestActorsOffset = 0;
+};
+
+struct FCrowdCharacterRecord
+{
+    FAnimCppCharSnapshot Character;
+    FAnimDemoBotSnapshot Bot;
+    bool bHasBot = false;
+};
+
+static_assert(std::is_trivially_copyable_v<FCrowdCharacterRecord>, "Snapshot records are copied as raw memory");
+static_assert(std::is_trivially_copyable_v<FAnimTestActorSnapshot>, "Snapshot records are copied as raw memory");
+
+class UE_ANIMDEMO_API FCrowdSnapshot
+{
+public:
+    bool IsEmpty() const { return Buffer.Num() == 0; }
+    int32 GetNumCharacters() const { return Characters.Num(); }
+    int32 GetNumTestActors() const { return TestActors.Num(); }
+    int64 GetSizeBytes() const { return Buffer.Num(); }
+
+    // Lays the buffer out for the given actor counts, keeping its allocation when it is big enough
+    void Reset(int32 NumCharacters, int32 NumTestActors);
+
+    TArrayView<FCrowdCharacterRecord> GetCharacterRecords();
+    TArrayView<const FCrowdCharacterRecord> GetCharacterRecords() const;
+    TArrayView<FAnimTestActorSnapshot> GetTestActorRecords();
+    TArrayView<const FAnimTestActorSnapshot> GetTestActorRecords() const;
+
+private:
+    friend class UCrowdSnapshotSubsystem;
+
+    TArray<uint8, TAlignedHeapAllocator<16>> Buffer;
+
+    // The actors the records belong to, in record order
+    TArray<TWeakObjectPtr<AAnimCppChar>> Characters;
+    TArray<TWeakObjectPtr<AAnimTestActor>> TestActors;
+
+    const FCrowdSnapshotHeader& GetHeader() const { return *reinterpret_cast<const FCrowdSnapshotHeader*>(Buffer.GetData()); }
+};
+
+UCLASS()
+class UE_ANIMDEMO_API UCrowdSnapshotSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    void Capture(FCrowdSnapshot& OutSnapshot) const;
+
+    // Copies the snapshot back onto the actors it was taken from; returns how many of them are gone
+    int32 Restore(const FCrowdSnapshot& Snapshot) const;
+
+    // The slot the AnimDemo.Snapshot.* console commands use
+    FCrowdSnapshot& GetDefaultSnapshot() { return DefaultSnapshot; }
+
+private:
+    FCrowdSnapshot DefaultSnapshot;
+};
@@ -0,0 +1,86 @@
+//
+//  CrowdSpatialHash.h
+//
+//  Uniform grid over packed 2D agent positions, rebuilt from scratch every frame. Grid cells
+//  hash into a power-of-two bucket table and the agents are counting-sorted by bucket, so the
+//  agents of a cell are one contiguous run of the sorted position arrays and neighbor queries
+//  stream through memory instead of chasing pointers.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UE_ANIMDEMO_API FCrowdSpatialHash
+{
+public:
+    // Positions are indexed by agent; CellSize should be at least the largest query radius
+    void Build(TConstArrayView<float> X, TConstArrayView<float> Y, float InCellSize);
+
+    int32 Num() const { return SortedIndices.Num(); }
+    float GetCellSize() const { return CellSize; }
+
+    // Agent positions in bucket order, and the agent index at each sorted position
+    TConstArrayView<float> GetSortedX() const { return SortedX; }
+    TConstArrayView<float> GetSortedY() const { return SortedY; }
+    TConstArrayView<int32> GetSortedIndices() const { return SortedIndices; }
+
+    // Calls Func(Begin, End) with the sorted ranges of the buckets covering the 3x3 cells around
+    // (X, Y). Buckets are visited once even when several cells hash into the same one, and may
+    // hold agents of unrelated cells, so callers still test the distance.
+    template<typename FuncType>
+    void ForEachNeighborRange(float X, float Y, FuncType&& Func) const
+    {
+        const int32 CellX = GetCellCoord(X);
+        const int32 CellY = GetCellCoord(Y);
+
+        uint32 Visited[9];
+        int32 NumVisited = 0;
+        for (int32 OffsetY = -1; OffsetY <= 1; ++OffsetY)
+        {
+            for (int32 OffsetX = -1; OffsetX <= 1; ++OffsetX)
+            {
+                const uint32 Bucket = HashCell(CellX + OffsetX, CellY + OffsetY);
+                bool bSeen = false;
+                for (int32 Index = 0; Index < NumVisited && !bSeen; ++Index)
+                {
+                    bSeen = Visited[Index] == Bucket;
+                }
+                if (bSeen)
+                    continue;
+
+                Visited[NumVisited++] = Bucket;
+                if (BucketStart[Bucket] != BucketStart[Bucket + 1])
+                {
+                    Func(BucketStart[Bucket], BucketStart[Bucket + 1]);
+                }
+            }
+        }
+    }
+
+private:
+    float CellSize = 100.f;
+    float InvCellSize = 0.01f;
+    uint32 BucketMask = 0;
+
+    TArray<uint32> AgentBuckets;
+    TArray<int32> BucketStart;
+    TArray<int32> BucketCursor;
+    TArray<int32> SortedIndices;
+    TArray<float> SortedX;
+    TArray<float> SortedY;
+
+    int32 GetCellCoord(float Value) const { return FMath::FloorToInt32(Value * InvCellSize); }
+
+    uint32 HashCell(int32 CellX, int32 CellY) const
+    {
+        return ((static_cast<uint32>(CellX) * 73856093u) ^ (static_cast<uint32>(CellY) * 19349663u)) & BucketMask;
+    }
+};
+
+namespace CrowdSeparation
+{
+    // Separation push of every agent away from the neighbors within Radius, weighted linearly
+    // from 1 at contact to 0 at Radius. Written by agent index; Radius must not exceed the
+    // hash's cell size. Runs in parallel over the sorted agents, four neighbors per SIMD step.
+    UE_ANIMDEMO_API void ComputeSeparation(const FCrowdSpatialHash& Hash, float Radius, TArrayView<float> OutPushX, TArrayView<float> OutPushY);
+}
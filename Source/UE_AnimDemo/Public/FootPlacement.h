@@ -0,0 +1,29 @@
+//
+//  FootPlacement.h
+//
+//  Ground under each foot, as found by UFootPlacementSubsystem's batched traces and handed to
+//  the anim instance for its worker-thread IK solve.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace AnimDemoFootPlacement
+{
+    constexpr int32 LeftFoot = 0;
+    constexpr int32 RightFoot = 1;
+    constexpr int32 NumFeet = 2;
+}
+
+struct FFootPlacementInput
+{
+    // False when the character is out of range; the solve then blends foot placement out
+    bool bValid = false;
+
+    bool bHit[AnimDemoFootPlacement::NumFeet] = { false, false };
+
+    // Ground height relative to the bottom of the capsule at trace time
+    float GroundOffset[AnimDemoFootPlacement::NumFeet] = { 0.f, 0.f };
+
+    FVector GroundNormal[AnimDemoFootPlacement::NumFeet] = { FVector::UpVector, FVector::UpVector };
+};
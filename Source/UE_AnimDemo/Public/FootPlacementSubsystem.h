@@ -0,0 +1,60 @@
+//
+//  FootPlacementSubsystem.h
+//
+//  Issues the foot ground traces of every registered character as async line traces in one
+//  batch once all actors have ticked. Results come back at the start of the next frame and are
+//  handed to each character's anim instance, which solves the IK on a worker thread. Distant,
+//  unrendered and idle characters are traced less often, or not at all.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "FootPlacement.h"
+#include "FootPlacementSubsystem.generated.h"
+
+class AAnimCppChar;
+class UMyAnimInstance;
+
+UCLASS()
+class UE_ANIMDEMO_API UFootPlacementSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    void Register(AAnimCppChar* Character, UMyAnimInstance* AnimInstance);
+    void Unregister(AAnimCppChar* Character);
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    struct FEntry
+    {
+        TWeakObjectPtr<AAnimCppChar> Character;
+        TWeakObjectPtr<UMyAnimInstance> AnimInstance;
+        FTraceHandle Handles[AnimDemoFootPlacement::NumFeet];
+        float TraceBaseZ = 0.f;
+        FFootPlacementInput Input;
+    };
+
+    // Slots are reused rather than removed so pending trace results can find their entry
+    TArray<FEntry> Entries;
+    TArray<int32> FreeEntries;
+
+    FTraceDelegate TraceDelegate;
+    FDelegateHandle PostActorTickHandle;
+    uint32 FrameCounter = 0;
+
+    void IssueTraces(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    void HandleTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+    // Frames between traces for this character, 0 to stop tracing it
+    uint32 GetTraceInterval(const AAnimCppChar& Character, TConstArrayView<FVector> ViewLocations) const;
+};
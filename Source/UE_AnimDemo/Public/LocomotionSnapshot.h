@@ -0,0 +1,88 @@
+//
+//  LocomotionSnapshot.h
+//
+//  Movement data the animation state machine transitions are evaluated against.
+//  Characters fill one per tick; offline tools fill it from recorded traces.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LocomotionSnapshot.generated.h"
+
+class FAnimStateMachineDefinition;
+class UAnimSequence;
+class UBlendSpace;
+class UCharacterMovementComponent;
+
+// Speed thresholds and blend times of the locomotion transitions. They are part of the
+// archetype, so simulations with different values run side by side on separate definitions.
+USTRUCT(BlueprintType)
+struct FLocomotionTuning
+{
+    GENERATED_BODY()
+    
+    /** At or below this speed a grounded character is idle */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Locomotion", meta=(ClampMin="0"))
+    float IdleSpeed = 10.0f;
+    
+    /** At or above this speed a grounded character runs rather than walks */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Locomotion", meta=(ClampMin="0"))
+    float RunSpeed = 300.0f;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Locomotion", meta=(ClampMin="0"))
+    float IdleToLocomotionBlend = 0.25f;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Locomotion", meta=(ClampMin="0"))
+    float LocomotionToIdleBlend = 0.25f;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Locomotion", meta=(ClampMin="0"))
+    float JumpBlend = 0.25f;
+    
+    /** Blend out of Jump once the character is back on the ground */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Locomotion", meta=(ClampMin="0"))
+    float LandBlend = 0.2f;
+};
+
+struct UE_ANIMDEMO_API FLocomotionSnapshot
+{
+    FVector Velocity = FVector::ZeroVector;
+    bool bIsFalling = false;
+    bool bIsMovingOnGround = true;
+    
+    float GetSpeed() const { return Velocity.Size(); }
+    
+    void Capture(const FVector& InVelocity, const UCharacterMovementComponent& MoveComp);
+    
+    // Transition conditions
+    bool ShouldWalk(const FLocomotionTuning& Tuning = FLocomotionTuning()) const;
+    bool ShouldRun(const FLocomotionTuning& Tuning = FLocomotionTuning()) const;
+    bool ShouldJump() const;
+    bool ShouldIdle(const FLocomotionTuning& Tuning = FLocomotionTuning()) const;
+    bool ShouldLandMoving(const FLocomotionTuning& Tuning = FLocomotionTuning()) const;
+};
+
+// Everything a locomotion state machine definition is built from. Characters with equal
+// archetypes share one definition.
+struct UE_ANIMDEMO_API FLocomotionArchetype
+{
+    UAnimSequence* IdleAnimation = nullptr;
+    UAnimSequence* JumpAnimation = nullptr;
+    UBlendSpace* LocomotionBlendSpace = nullptr;
+    FLocomotionTuning Tuning;
+    
+    bool operator==(const FLocomotionArchetype& Other) const;
+    friend uint32 GetTypeHash(const FLocomotionArchetype& Archetype);
+};
+
+namespace AnimDemoLocomotion
+{
+    // Adds the Idle/Locomotion/Jump transitions used by AAnimCppChar, including the landings
+    // that bring Jump back to Idle or Locomotion. The conditions read the
+    // machine's context snapshot; Tuning is copied.
+    UE_ANIMDEMO_API void AddLocomotionTransitions(FAnimStateMachineDefinition& Definition,
+        const FLocomotionTuning& Tuning = FLocomotionTuning());
+    
+    // The definition of Archetype, built by the first machine that asks and kept for as long
+    // as any machine still uses it. Game thread only.
+    UE_ANIMDEMO_API TSharedRef<const FAnimStateMachineDefinition> GetDefinition(const FLocomotionArchetype& Archetype);
+}
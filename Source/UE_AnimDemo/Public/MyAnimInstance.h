@@ -10,8 +10,25 @@
 #include "Animation/AnimInstance.h"
 #include "AnimationState.h"
 #include "Animation/BlendSpace.h"
+#include "FootPlacement.h"
 #include "MyAnimInstance.generated.h"
 
+// Game-thread driven state of the anim instance, copied out and back in by crowd snapshots
+struct FMyAnimInstanceSnapshot
+{
+    FVector LeftFootEffectorOffset = FVector::ZeroVector;
+    FVector RightFootEffectorOffset = FVector::ZeroVector;
+    FRotator LeftFootRotation = FRotator::ZeroRotator;
+    FRotator RightFootRotation = FRotator::ZeroRotator;
+    float FootOffsets[AnimDemoFootPlacement::NumFeet] = { 0.f, 0.f };
+    float PelvisOffset = 0.f;
+    float FootPlacementAlpha = 0.f;
+    float LocomotionBlendSpaceInput = 0.f;
+    ECharacterAnimState CurrentState = ECharacterAnimState::Idle;
+    bool bIsJumping = false;
+    bool bIsIdle = true;
+};
+
 UCLASS()
 class UE_ANIMDEMO_API UMyAnimInstance : public UAnimInstance
 {
@@ -33,15 +50,36 @@ public:
 
     /** Called from character to set current state */
     void SetCurrentAnimState(ECharacterAnimState NewState) { CurrentState = NewState; }
+    
+    /** Ground under the feet, set on the game thread by UFootPlacementSubsystem before the anim update */
+    void SetFootPlacementInput(const FFootPlacementInput& Input) { FootPlacementInput = Input; }
+    
+    /** Pose picked by the pose search; bJumped is set when it is not the continuation of the previous one */
+    void SetPoseSearchMatch(UAnimSequence* Sequence, float Time, bool bJumped);
+    void ClearPoseSearchMatch();
+    
+    /** Picks up from a lite LOD: the next update starts the state's montage at Time, without blending in */
+    void ResumeState(ECharacterAnimState State, float Time);
+    
+    /** Position of the montage the current state plays, 0 without one */
+    float GetStateMontagePosition() const;
+    
+    /** Restoring drops the pose search match and restarts the state's montage on the next update */
+    void SaveSnapshot(FMyAnimInstanceSnapshot& OutSnapshot) const;
+    void RestoreSnapshot(const FMyAnimInstanceSnapshot& Snapshot);
+    
+    FName GetFootBoneName(int32 Foot) const { return Foot == AnimDemoFootPlacement::LeftFoot ? LeftFootBone : RightFootBone; }
 
 protected:
     virtual void NativeInitializeAnimation() override;
     virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+    virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
     
     // Current state for the state machine
     UPROPERTY(BlueprintReadOnly, Category = "Animation")
     ECharacterAnimState CurrentState;
     
+    UPROPERTY()
     UBlendSpace* LocomotionBlendSpace;
     
     UPROPERTY(BlueprintReadOnly)
@@ -63,9 +101,66 @@ protected:
     
     /** Update animations each tick */
     void PlayAnimations(float DeltaSeconds);
+    
+    /** Pose search match, played by a sequence evaluator in the Anim Blueprint while active */
+    UPROPERTY(BlueprintReadOnly, Category = "Pose Search")
+    bool bPoseSearchActive = false;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Pose Search")
+    UAnimSequence* PoseSearchSequence = nullptr;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Pose Search")
+    float PoseSearchTime = 0.f;
+    
+    /** Incremented on every jump to a new pose, so the Anim Blueprint can blend into it */
+    UPROPERTY(BlueprintReadOnly, Category = "Pose Search")
+    int32 PoseSearchJumpCount = 0;
+    
+    /** Foot placement, solved on a worker thread and applied by IK nodes in the Anim Blueprint */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+    FName LeftFootBone = TEXT("foot_l");
+    
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+    FName RightFootBone = TEXT("foot_r");
+    
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+    float MaxFootOffset = 45.f;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+    float FootInterpSpeed = 15.f;
+    
+    /** World space effector offsets for the leg IK, relative to the lowered pelvis */
+    UPROPERTY(BlueprintReadOnly, Category = "Foot Placement")
+    FVector LeftFootEffectorOffset = FVector::ZeroVector;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Foot Placement")
+    FVector RightFootEffectorOffset = FVector::ZeroVector;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Foot Placement")
+    FRotator LeftFootRotation = FRotator::ZeroRotator;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Foot Placement")
+    FRotator RightFootRotation = FRotator::ZeroRotator;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Foot Placement")
+    float PelvisOffset = 0.f;
+    
+    UPROPERTY(BlueprintReadOnly, Category = "Foot Placement")
+    float FootPlacementAlpha = 0.f;
 
 private:
     class AAnimCppChar* OwningCharacter;
+    
+    /** State PlayAnimations last ran for, montages are only (re)started on a change */
+    ECharacterAnimState LastPlayedState = ECharacterAnimState::None;
+    
+    /** Start position of the next state montage, set by ResumeState; negative when not resuming */
+    float ResumeTime = -1.f;
+    
+    FFootPlacementInput FootPlacementInput;
+    float FootOffsets[AnimDemoFootPlacement::NumFeet] = { 0.f, 0.f };
+    
+    void SolveFootPlacement(float DeltaSeconds);
     void UpdateAnimationState(float DeltaTime);
 
 };
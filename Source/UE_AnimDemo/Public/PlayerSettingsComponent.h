@@ -0,0 +1,78 @@
+//
+//  PlayerSettingsComponent.h
+//
+//  Pawn side of the player settings: follows the UPlayerSettingsSubsystem of the local player
+//  possessing the owner, keeps the look input values the pawn reads every frame, and binds the
+//  pooled settings menu while it is this pawn's. Characters forward their settings input and
+//  Blueprint calls to it.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "PlayerSettingsComponent.generated.h"
+
+class UPlayerSettingsSave;
+class UPlayerSettingsSubsystem;
+class UPlayerSettingsWidget;
+
+UCLASS(ClassGroup=Settings)
+class UE_ANIMDEMO_API UPlayerSettingsComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UPlayerSettingsComponent();
+
+    // Subscribes to the settings of the local player controlling the owning pawn, dropping any
+    // previous subscription; without one the values stay local to this component
+    void Bind();
+    void Unbind();
+
+    float GetMouseSensitivity() const { return MouseSensitivity; }
+    float GetMouseSmoothing() const { return MouseSmoothing; }
+    bool GetInvertY() const { return bInvertY; }
+
+    // Bound to the settings widget while it is open for this pawn
+    UFUNCTION()
+    void SetMouseSensitivity(float Value);
+
+    UFUNCTION()
+    void SetMouseSmoothing(float Value);
+
+    UFUNCTION()
+    void SetInvertY(bool bInvert);
+
+    void SaveSettings();
+    void LoadSettings();
+
+    // Opens or closes the settings menu, fetching WidgetClass from the local player's pool the first time
+    void ToggleSettingsMenu(TSubclassOf<UPlayerSettingsWidget> WidgetClass);
+    void ShowSettingsWidget();
+    void HideSettingsWidget();
+
+protected:
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    void ApplySettings(const UPlayerSettingsSave& Settings);
+
+    // Fetches the pooled settings widget on first use and binds it to this component
+    bool AcquireSettingsWidget(TSubclassOf<UPlayerSettingsWidget> WidgetClass);
+    void ReleaseSettingsWidget();
+
+    UFUNCTION()
+    void HandleCloseButtonPressed();
+
+    UPROPERTY(Transient)
+    TObjectPtr<UPlayerSettingsWidget> SettingsWidget;
+
+    TWeakObjectPtr<UPlayerSettingsSubsystem> PlayerSettings;
+    FDelegateHandle PlayerSettingsChangedHandle;
+
+    float MouseSensitivity = 1.0f;
+    float MouseSmoothing = 5.0f; // higher = smoother, slower response
+    bool bInvertY = false;
+
+    bool bIsToggling = false;
+};
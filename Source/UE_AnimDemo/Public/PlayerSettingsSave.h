@@ -17,6 +17,13 @@ class UE_ANIMDEMO_API UPlayerSettingsSave : public USaveGame
     GENERATED_BODY()
 
 public:
+    /** Slot and user index the settings are persisted under */
+    static constexpr const TCHAR* SlotName = TEXT("PlayerSettings");
+    static constexpr int32 UserIndex = 0;
+    
+    static float ClampMouseSensitivity(float Value) { return FMath::Clamp(Value, 0.1f, 10.0f); }
+    static float ClampMouseSmoothing(float Value) { return FMath::Clamp(Value, 0.f, 20.f); }
+    
     UPROPERTY(BlueprintReadWrite, Category="Camera")
     float MouseSensitivity = 1.0f;
 
@@ -0,0 +1,85 @@
+//
+//  PlayerSettingsSubsystem.h
+//
+//  Single owner of a local player's settings. The slot is loaded once, asynchronously, when
+//  the local player is created and then kept in memory; characters subscribe to changes
+//  instead of reading the save game themselves. Writes are debounced and done off the game
+//  thread, in order, and replace the slot atomically:
+//    - Desktop platforms load through the generic save game system, which overwrites the file in
+//      place, so the slot is written to a temp file beside Saved/SaveGames/<Slot>.sav and renamed
+//      over it (ANIMDEMO_SETTINGS_REPLACE_SLOT_FILE).
+//    - Other platforms write through their ISaveGameSystem, whose slot commits are atomic.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "Containers/Ticker.h"
+#include "Tasks/Pipe.h"
+#include "PlayerSettingsSubsystem.generated.h"
+
+class APawn;
+class APlayerController;
+class USaveGame;
+class UPlayerSettingsSave;
+class UPlayerSettingsWidget;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnPlayerSettingsChanged, const UPlayerSettingsSave& /*Settings*/);
+
+UCLASS()
+class UE_ANIMDEMO_API UPlayerSettingsSubsystem : public ULocalPlayerSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    
+    // Subsystem of the local player controlling Pawn, if any
+    static UPlayerSettingsSubsystem* Get(const APawn* Pawn);
+    
+    // Current settings; defaults until the slot finished loading
+    const UPlayerSettingsSave& GetSettings() const { return *Settings; }
+    bool IsLoaded() const { return bLoaded; }
+    
+    // Broadcast after every change, including the one caused by the initial load
+    FOnPlayerSettingsChanged& OnSettingsChanged() { return SettingsChanged; }
+    
+    UFUNCTION(BlueprintCallable, Category="Settings")
+    void SetMouseSensitivity(float NewSens);
+    
+    UFUNCTION(BlueprintCallable, Category="Settings")
+    void SetMouseSmoothing(float NewSmooth);
+    
+    UFUNCTION(BlueprintCallable, Category="Settings")
+    void SetInvertY(bool bNewInvert);
+    
+    // Settings menu shared by every pawn this player controls. Created and added to the viewport
+    // (collapsed) on first request, then kept across respawns and possession changes.
+    UPlayerSettingsWidget* GetOrCreateSettingsWidget(APlayerController* OwningPlayer, TSubclassOf<UPlayerSettingsWidget> WidgetClass);
+    
+    // Starts a pending write immediately instead of waiting for the debounce; bWait blocks until it is on disk
+    void Flush(bool bWait = false);
+
+private:
+    void HandleSlotLoaded(const FString& SlotName, const int32 UserIndex, USaveGame* LoadedGame);
+    void NotifyChanged();
+    bool TickDebounce(float DeltaTime);
+    void WriteAsync();
+    
+    UPROPERTY()
+    TObjectPtr<UPlayerSettingsSave> Settings;
+    
+    UPROPERTY()
+    TObjectPtr<UPlayerSettingsWidget> SettingsWidget;
+    
+    FOnPlayerSettingsChanged SettingsChanged;
+    
+    UE::Tasks::FPipe WritePipe{ TEXT("PlayerSettingsSubsystem") };
+    FTSTicker::FDelegateHandle DebounceHandle;
+    double LastChangeTime = 0.0;
+    bool bDirty = false;
+    // Set by the first change and never cleared, unlike bDirty which every write resets
+    bool bModified = false;
+    bool bLoaded = false;
+};
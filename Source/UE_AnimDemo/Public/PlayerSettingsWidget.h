@@ -14,6 +14,25 @@
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnFloatChanged, float, Value);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnBoolChanged, bool, Value);
 
+/**
+ * Styling shared by every settings widget. Built once per process instead of being
+ * recomputed each time a widget is constructed.
+ */
+struct FPlayerSettingsWidgetStyle
+{
+    FLinearColor BackgroundColor;
+    FMargin BackgroundPadding;
+    FMargin StandardPadding;
+    FLinearColor TextColor;
+    float FontSize;
+    FLinearColor ButtonColor;
+    FLinearColor SliderBarColor;
+    FLinearColor SliderHandleColor;
+    float SliderStepSize;
+    
+    static const FPlayerSettingsWidgetStyle& Get();
+};
+
 /**
  * Widget for player settings
  */
@@ -23,7 +42,7 @@ class UE_ANIMDEMO_API UPlayerSettingsWidget : public UUserWidget
     GENERATED_BODY()
 
 public:
-    virtual void NativeConstruct() override;
+    virtual void NativeOnInitialized() override;
 
     /** Delegates to call when sliders/checkbox change */
     UPROPERTY(BlueprintAssignable, Category="Settings")
@@ -82,6 +101,7 @@ private:
     UPlayerSettingsWidget* SettingsWidget;
     
     /** Styling functions */
+    void WrapInInvalidationBox();
     void ApplyConsistentStyling();
-    void StyleChildWidgets(UWidget* ParentWidget, const FMargin& Padding, const FLinearColor& TextColor, float FontSize);  // for button click
+    void StyleChildWidgets(UWidget* ParentWidget, const FPlayerSettingsWidgetStyle& Style);  // for button click
 };
@@ -0,0 +1,28 @@
+//
+//  PoseSearchBuildCommandlet.h
+//
+//  Builds the pose search database offline from a character class's Idle, Walk, Run and Jump
+//  sequences and the samples of its movement blend space.
+//
+//      UnrealEditor-Cmd UE_AnimDemo.uproject -run=PoseSearchBuild [-Character=<ClassPath>] [-Output=<File>]
+//          [-SampleRate=<Hz>] [-WalkSpeed=<cm/s>] [-RunSpeed=<cm/s>]
+//
+//  In-place sequences have no root motion to measure; their trajectory is a constant forward
+//  velocity, the blend space sample's speed or -WalkSpeed / -RunSpeed.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PoseSearchBuildCommandlet.generated.h"
+
+UCLASS()
+class UE_ANIMDEMO_API UPoseSearchBuildCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UPoseSearchBuildCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
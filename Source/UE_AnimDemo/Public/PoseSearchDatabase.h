@@ -0,0 +1,175 @@
+//
+//  PoseSearchDatabase.h
+//
+//  Motion-matching style index over the character's animation set. Each pose is a normalized
+//  feature vector describing the root trajectory around one sampled frame; the database is
+//  built offline by the PoseSearchBuild commandlet and memory-mapped at runtime.
+//
+//  File layout, every section 16-byte aligned: FPoseSearchDbHeader, the source table, the pose
+//  table and the features in KD-tree leaf order, the KD-tree nodes in preorder, and for every
+//  source the tree position of each of its samples in time order.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationState.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+namespace AnimDemoPoseSearch
+{
+    // Current velocity XY, velocity 0.25 s ago XY, root offsets 0.25/0.5/0.75 s ahead XY,
+    // vertical velocity and one padding lane, all in character space
+    constexpr int32 NumFeatures = 12;
+    constexpr int32 NumFeatureVectors = NumFeatures / 4;
+
+    constexpr float PastVelocityTime = 0.25f;
+    constexpr float FutureTimes[3] = { 0.25f, 0.5f, 0.75f };
+
+    // Relative importance of each feature, folded into the normalization
+    UE_ANIMDEMO_API void GetDefaultWeights(float OutWeights[NumFeatures]);
+}
+
+struct FPoseSearchDbHeader
+{
+    static constexpr uint32 MagicValue = 0x53504441; // 'ADPS'
+    static constexpr uint32 CurrentVersion = 1;
+
+    uint32 Magic = MagicValue;
+    uint32 Version = CurrentVersion;
+    uint32 NumFeatures = AnimDemoPoseSearch::NumFeatures;
+    uint32 NumSources = 0;
+    uint32 NumPoses = 0;
+    uint32 NumNodes = 0;
+    uint32 SampleRate = 30;
+    uint32 Reserved = 0;
+
+    // A normalized feature is (Raw - Mean) * Scale, Scale being the weight over the deviation
+    float Mean[AnimDemoPoseSearch::NumFeatures] = {};
+    float Scale[AnimDemoPoseSearch::NumFeatures] = {};
+
+    uint64 SourcesOffset = 0;
+    uint64 PosesOffset = 0;
+    uint64 FeaturesOffset = 0;
+    uint64 NodesOffset = 0;
+    uint64 SourcePosesOffset = 0;
+};
+static_assert(sizeof(FPoseSearchDbHeader) % 16 == 0, "FPoseSearchDbHeader is part of the file format");
+
+struct FPoseSearchSourceRecord
+{
+    // Idle, Walk, Run and Jump are the character's sequences; Locomotion is a blend space sample
+    ECharacterAnimState Kind = ECharacterAnimState::Idle;
+    uint8 bLooping = 0;
+    uint16 BlendSampleIndex = 0;
+    float PlayLength = 0.f;
+
+    // Range of this source in the source poses section
+    uint32 FirstSample = 0;
+    uint32 NumSamples = 0;
+};
+static_assert(sizeof(FPoseSearchSourceRecord) == 16, "FPoseSearchSourceRecord is part of the file format");
+
+struct FPoseSearchPoseRecord
+{
+    uint32 Source = 0;
+    float Time = 0.f;
+};
+static_assert(sizeof(FPoseSearchPoseRecord) == 8, "FPoseSearchPoseRecord is part of the file format");
+
+struct FPoseSearchNode
+{
+    // Interior nodes split on SplitDim; the left child follows the node, the right one is at Second.
+    // Leaves hold Second poses starting at First.
+    float SplitValue = 0.f;
+    uint16 SplitDim = 0;
+    uint16 bLeaf = 0;
+    uint32 First = 0;
+    uint32 Second = 0;
+};
+static_assert(sizeof(FPoseSearchNode) == 16, "FPoseSearchNode is part of the file format");
+
+struct FPoseSearchResult
+{
+    int32 PoseIndex = INDEX_NONE;
+    float Cost = TNumericLimits<float>::Max();
+
+    bool IsValid() const { return PoseIndex != INDEX_NONE; }
+};
+
+/** Read-only view of a pose search database, mapped from disk or held in memory */
+class UE_ANIMDEMO_API FPoseSearchDatabase
+{
+public:
+    FPoseSearchDatabase() = default;
+    ~FPoseSearchDatabase();
+
+    FPoseSearchDatabase(const FPoseSearchDatabase&) = delete;
+    FPoseSearchDatabase& operator=(const FPoseSearchDatabase&) = delete;
+
+    bool Load(const FString& Filename);
+    bool InitFromMemory(TArray<uint8>&& Bytes);
+
+    bool IsValid() const { return Header != nullptr; }
+    int32 GetNumPoses() const { return Header ? Header->NumPoses : 0; }
+    int32 GetNumSources() const { return Header ? Header->NumSources : 0; }
+    int64 GetSizeBytes() const { return Size; }
+
+    const FPoseSearchSourceRecord& GetSource(int32 Source) const { return Sources[Source]; }
+    const FPoseSearchPoseRecord& GetPose(int32 PoseIndex) const { return Poses[PoseIndex]; }
+
+    // Raw query features to the database's normalized, weighted space
+    void NormalizeQuery(const float* RawQuery, float* OutQuery) const;
+
+    // Closest pose to a normalized query, through the KD-tree or by scanning every pose
+    FPoseSearchResult Search(const float* Query) const;
+    FPoseSearchResult SearchBruteForce(const float* Query) const;
+
+    // Squared distance between a normalized query and one pose
+    float GetCost(int32 PoseIndex, const float* Query) const;
+
+    // The pose of Source sampled closest to Time, INDEX_NONE if the source has no samples
+    int32 FindPose(int32 Source, float Time) const;
+
+private:
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    TArray<uint8> OwnedData;
+
+    const uint8* Data = nullptr;
+    int64 Size = 0;
+
+    const FPoseSearchDbHeader* Header = nullptr;
+    const FPoseSearchSourceRecord* Sources = nullptr;
+    const FPoseSearchPoseRecord* Poses = nullptr;
+    const float* Features = nullptr;
+    const FPoseSearchNode* Nodes = nullptr;
+    const uint32* SourcePoses = nullptr;
+
+    bool Validate(const FString& Name);
+    void ScanLeaf(uint32 First, uint32 Count, const float* Query, FPoseSearchResult& Best) const;
+};
+
+/** Collects raw pose features and writes the normalized, indexed database */
+class UE_ANIMDEMO_API FPoseSearchDatabaseBuilder
+{
+public:
+    int32 AddSource(ECharacterAnimState Kind, int32 BlendSampleIndex, float PlayLength, bool bLooping);
+    void AddPose(int32 Source, float Time, const float RawFeatures[AnimDemoPoseSearch::NumFeatures]);
+
+    int32 GetNumPoses() const { return Poses.Num(); }
+
+    TArray<uint8> Build(const float Weights[AnimDemoPoseSearch::NumFeatures], int32 SampleRate, int32 MaxLeafSize = 16) const;
+
+private:
+    struct FPendingPose
+    {
+        int32 Source = 0;
+        float Time = 0.f;
+        float Features[AnimDemoPoseSearch::NumFeatures] = {};
+    };
+
+    TArray<FPoseSearchSourceRecord> Sources;
+    TArray<FPendingPose> Poses;
+};
@@ -0,0 +1,65 @@
+//
+//  PoseSearchSelector.h
+//
+//  Runtime side of the pose search. FPoseSearchTrajectory keeps a short velocity history and
+//  turns it into query features; FPoseSearchSelector plays the matched pose forward and only
+//  jumps to a new one when it is clearly better than continuing.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PoseSearchDatabase.h"
+
+struct UE_ANIMDEMO_API FPoseSearchTrajectory
+{
+    // Velocities are world space; Rotation is the character's, features are built relative to it
+    void AddSample(float DeltaTime, const FVector& Velocity);
+    void Reset();
+
+    void BuildQuery(const FRotator& Rotation, float OutRawQuery[AnimDemoPoseSearch::NumFeatures]) const;
+
+    // Acceleration the future trajectory is extrapolated with is capped to this
+    float MaxAcceleration = 2048.f;
+
+private:
+    static constexpr int32 HistorySize = 16;
+
+    struct FSample
+    {
+        float Age = 0.f;
+        FVector3f Velocity = FVector3f::ZeroVector;
+    };
+
+    // Ring buffer, newest at Head
+    FSample History[HistorySize];
+    int32 Head = 0;
+    int32 Num = 0;
+
+    FVector3f GetVelocityAt(float Age) const;
+};
+
+struct UE_ANIMDEMO_API FPoseSearchSelector
+{
+    // Seconds between searches; the matched pose just plays on in between
+    float SearchInterval = 0.1f;
+
+    // Continuing the current pose wins unless the best match costs less than this fraction of it
+    float ContinuingCostBias = 0.8f;
+
+    // Returns true when the selection jumped to a different pose
+    bool Update(const FPoseSearchDatabase& Database, const float RawQuery[AnimDemoPoseSearch::NumFeatures], float DeltaTime);
+    void Reset();
+
+    bool HasSelection() const { return CurrentSource != INDEX_NONE; }
+    int32 GetSource() const { return CurrentSource; }
+    float GetTime() const { return CurrentTime; }
+    float GetLastCost() const { return LastCost; }
+
+private:
+    int32 CurrentSource = INDEX_NONE;
+    float CurrentTime = 0.f;
+    float TimeSinceSearch = 0.f;
+    float LastCost = 0.f;
+
+    void AdvanceTime(const FPoseSearchDatabase& Database, float DeltaTime);
+};
@@ -0,0 +1,32 @@
+//
+//  PoseSearchSubsystem.h
+//
+//  Owns the memory-mapped pose search database for the game instance. Characters query it
+//  through their own FPoseSearchSelector; the database itself is immutable and shared.
+//
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "PoseSearchDatabase.h"
+#include "PoseSearchSubsystem.generated.h"
+
+UCLASS()
+class UE_ANIMDEMO_API UPoseSearchSubsystem : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // The loaded database while AnimDemo.PoseSearch.Enable is set, otherwise null
+    const FPoseSearchDatabase* GetDatabase() const;
+
+    // Where the PoseSearchBuild commandlet writes and the game reads the database
+    static FString GetDefaultDatabasePath();
+
+private:
+    TUniquePtr<FPoseSearchDatabase> Database;
+};
@@ -21,6 +21,14 @@ public class UE_AnimDemo : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[] {  });
 
+		// The live metrics endpoint (ANIMDEMO_METRICS) is compiled out of shipping builds, and so is its HTTP server
+		bool bWithMetrics = Target.Configuration != UnrealTargetConfiguration.Shipping;
+		PublicDefinitions.Add("ANIMDEMO_METRICS=" + (bWithMetrics ? "1" : "0"));
+		if (bWithMetrics)
+		{
+			PrivateDependencyModuleNames.Add("HTTPServer");
+		}
+
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 		